@@ -23,6 +23,7 @@
 /****************/
 #define PIPELINE_SIZE 4
 #define MIN_BUFFER_SIZE (2 << 15) /* 11 Stop at 4KB buffer size */
+#define HG_TEST_BULK_TIMEOUT (60 * 1000) /* Deadline of bulk transfers */
 
 //#define HG_TEST_DEBUG
 #ifdef HG_TEST_DEBUG
@@ -260,6 +261,107 @@ HG_TEST_RPC_CB(hg_test_rpc_open_no_resp, handle)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Not executed from the thread pool so that requests that follow also wait */
+hg_return_t
+hg_test_rpc_sleep_cb(hg_handle_t handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+    rpc_open_in_t  in_struct;
+    rpc_open_out_t out_struct;
+    hg_time_t sleep_time;
+
+    /* Get input buffer */
+    ret = HG_Get_input(handle, &in_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not get input\n");
+        return ret;
+    }
+
+    /* Cookie is the time to sleep in ms */
+    sleep_time = hg_time_from_double(
+        (double) in_struct.handle.cookie / 1000.0);
+    hg_time_sleep(sleep_time);
+
+    /* Fill output structure */
+    out_struct.event_id = (hg_int32_t) in_struct.handle.cookie;
+    out_struct.ret = 0;
+
+    HG_Free_input(handle, &in_struct);
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not respond\n");
+        return ret;
+    }
+
+    HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/* Not executed from the thread pool so that the context triggering it is
+ * the one reported by info */
+hg_return_t
+hg_test_rpc_context_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    hg_return_t ret = HG_SUCCESS;
+    rpc_handle_t in_struct;
+    rpc_open_out_t out_struct;
+
+    /* Get input buffer */
+    ret = HG_Get_input(handle, &in_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not get input\n");
+        return ret;
+    }
+
+    /* Fill output structure */
+    out_struct.event_id = (hg_int32_t) HG_Context_get_id(hg_info->context);
+    out_struct.ret = 0;
+
+    HG_Free_input(handle, &in_struct);
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not respond\n");
+        return ret;
+    }
+
+    HG_Destroy(handle);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+hg_test_rpc_post_count_cb(hg_handle_t handle)
+{
+    const struct hg_info *hg_info = HG_Get_info(handle);
+    hg_return_t ret = HG_SUCCESS;
+    rpc_open_out_t out_struct;
+
+    /* Fill output structure */
+    out_struct.event_id = (hg_int32_t) HG_Context_get_post_count(
+        hg_info->context);
+    out_struct.ret = 0;
+
+    /* Send response back */
+    ret = HG_Respond(handle, NULL, NULL, &out_struct);
+    if (ret != HG_SUCCESS) {
+        fprintf(stderr, "Could not respond\n");
+        return ret;
+    }
+
+    HG_Destroy(handle);
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 HG_TEST_RPC_CB(hg_test_bulk_write, handle)
 {
@@ -310,10 +412,11 @@ HG_TEST_RPC_CB(hg_test_bulk_write, handle)
     HG_TEST_LOG_DEBUG("Requesting transfer_size=%zu, origin_offset=%zu, "
         "target_offset=%zu", bulk_args->transfer_size, bulk_args->origin_offset,
         bulk_args->target_offset);
-    ret = HG_Bulk_transfer_id(hg_info->context, hg_test_bulk_transfer_cb,
+    ret = HG_Bulk_transfer_timed(hg_info->context, hg_test_bulk_transfer_cb,
         bulk_args, HG_BULK_PULL, hg_info->addr, hg_info->context_id,
         origin_bulk_handle, bulk_args->origin_offset, local_bulk_handle,
-        bulk_args->target_offset, bulk_args->transfer_size, &hg_bulk_op_id);
+        bulk_args->target_offset, bulk_args->transfer_size,
+        HG_TEST_BULK_TIMEOUT, &hg_bulk_op_id);
     if (ret != HG_SUCCESS) {
         fprintf(stderr, "Could not read bulk data\n");
         return ret;
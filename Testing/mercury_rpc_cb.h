@@ -23,6 +23,24 @@ hg_test_rpc_open_cb(hg_handle_t handle);
 hg_return_t
 hg_test_rpc_open_no_resp_cb(hg_handle_t handle);
 
+/**
+ * test_rpc (delayed response)
+ */
+hg_return_t
+hg_test_rpc_sleep_cb(hg_handle_t handle);
+
+/**
+ * test_rpc (processing context)
+ */
+hg_return_t
+hg_test_rpc_context_cb(hg_handle_t handle);
+
+/**
+ * test_rpc (posted handles)
+ */
+hg_return_t
+hg_test_rpc_post_count_cb(hg_handle_t handle);
+
 /**
  * test_bulk
  */
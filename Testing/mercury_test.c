@@ -69,6 +69,11 @@ extern const struct na_test_opt na_test_opt_g[];
 /* test_rpc */
 hg_id_t hg_test_rpc_open_id_g = 0;
 hg_id_t hg_test_rpc_open_id_no_resp_g = 0;
+hg_id_t hg_test_rpc_sleep_id_g = 0;
+hg_id_t hg_test_rpc_open_id_high_g = 0;
+hg_id_t hg_test_rpc_open_id_direct_g = 0;
+hg_id_t hg_test_rpc_context_id_g = 0;
+hg_id_t hg_test_rpc_post_count_id_g = 0;
 
 /* test_bulk */
 hg_id_t hg_test_bulk_write_id_g = 0;
@@ -135,6 +140,33 @@ hg_test_parse_options(int argc, char *argv[], struct hg_test_info *hg_test_info)
             case 'm': /* memory */
                 hg_test_info->auto_sm = HG_TRUE;
                 break;
+            case 'i': /* inline */
+                hg_test_info->self_inline = HG_TRUE;
+                break;
+            case 'D': /* dispatch */
+                hg_test_info->dispatch = HG_TRUE;
+                break;
+            case 'F': /* flow control */
+                hg_test_info->flow = HG_TRUE;
+                break;
+            case 'A': /* address cache */
+                hg_test_info->addr_cache = HG_TRUE;
+                break;
+            case 'O': /* coalescing */
+                hg_test_info->coalesce = HG_TRUE;
+                break;
+            case 'Q': /* completion queue shards */
+                hg_test_info->shards = HG_TRUE;
+                break;
+            case 'R': /* rails */
+                hg_test_info->rails = HG_TRUE;
+                break;
+            case 'P': /* handle pool */
+                hg_test_info->handle_pool = HG_TRUE;
+                break;
+            case 'T': /* post limits */
+                hg_test_info->post_limits = HG_TRUE;
+                break;
             case 't': /* number of threads */
                 hg_test_info->thread_count =
                     (unsigned int) atoi(na_test_opt_arg_g);
@@ -230,10 +262,30 @@ hg_test_finalize_rpc_cb(const struct hg_cb_info *callback_info)
     return HG_SUCCESS;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint64_t
+hg_test_dispatch_key_cb(hg_handle_t handle, void *arg)
+{
+    hg_uint64_t key = 0;
+    void *buf;
+    hg_size_t buf_size;
+
+    /* Key is the first input member, left as encoded */
+    (void) arg;
+    if (HG_Get_input_buf(handle, &buf, &buf_size) == HG_SUCCESS
+        && buf_size >= sizeof(key))
+        memcpy(&key, buf, sizeof(key));
+
+    return key;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_finalize_cb(hg_handle_t handle)
 {
+    struct hg_test_info *hg_test_info =
+        (struct hg_test_info *) HG_Class_get_data(
+            HG_Get_info(handle)->hg_class);
     struct hg_test_context_info *hg_test_context_info =
         (struct hg_test_context_info *) HG_Context_get_data(
             HG_Get_info(handle)->context);
@@ -242,6 +294,22 @@ hg_test_finalize_cb(hg_handle_t handle)
     /* Set finalize for context data */
     hg_atomic_set32(&hg_test_context_info->finalizing, 1);
 
+    /* Client only finalizes the context it targets, which may not be the one
+     * running this callback, stop all the contexts that RPCs are dispatched
+     * to */
+    if (hg_test_info->dispatch && hg_test_info->secondary_contexts) {
+        hg_uint8_t i;
+
+        hg_test_context_info = (struct hg_test_context_info *)
+            HG_Context_get_data(hg_test_info->context);
+        hg_atomic_set32(&hg_test_context_info->finalizing, 1);
+        for (i = 0; i < hg_test_info->na_test_info.max_contexts - 1; i++) {
+            hg_test_context_info = (struct hg_test_context_info *)
+                HG_Context_get_data(hg_test_info->secondary_contexts[i]);
+            hg_atomic_set32(&hg_test_context_info->finalizing, 1);
+        }
+    }
+
     /* Free handle and send response back */
     ret = HG_Respond(handle, NULL, NULL, NULL);
     if (ret != HG_SUCCESS) {
@@ -274,6 +342,34 @@ hg_test_register(hg_class_t *hg_class)
     HG_Registered_disable_response(hg_class, hg_test_rpc_open_id_no_resp_g,
         HG_TRUE);
 
+    /* Delay response */
+    hg_test_rpc_sleep_id_g = MERCURY_REGISTER(hg_class, "hg_test_rpc_sleep",
+            rpc_open_in_t, rpc_open_out_t, hg_test_rpc_sleep_cb);
+
+    /* High priority */
+    hg_test_rpc_open_id_high_g = MERCURY_REGISTER(hg_class,
+        "hg_test_rpc_open_high", rpc_open_in_t, rpc_open_out_t,
+        hg_test_rpc_open_cb);
+    HG_Registered_priority(hg_class, hg_test_rpc_open_id_high_g,
+        HG_PRIORITY_HIGH);
+
+    /* Pass structures by pointer to self */
+    hg_test_rpc_open_id_direct_g = MERCURY_REGISTER(hg_class,
+        "hg_test_rpc_open_direct", rpc_open_in_t, rpc_open_out_t,
+        hg_test_rpc_open_cb);
+    HG_Registered_self_direct(hg_class, hg_test_rpc_open_id_direct_g,
+        sizeof(rpc_open_in_t), sizeof(rpc_open_out_t));
+
+    /* Report processing context */
+    hg_test_rpc_context_id_g = MERCURY_REGISTER(hg_class,
+        "hg_test_rpc_context", rpc_handle_t, rpc_open_out_t,
+        hg_test_rpc_context_cb);
+
+    /* Report number of posted handles */
+    hg_test_rpc_post_count_id_g = MERCURY_REGISTER(hg_class,
+        "hg_test_rpc_post_count", void, rpc_open_out_t,
+        hg_test_rpc_post_count_cb);
+
     /* test_bulk */
     hg_test_bulk_write_id_g = MERCURY_REGISTER(hg_class, "hg_test_bulk_write",
             bulk_write_in_t, bulk_write_out_t, hg_test_bulk_write_cb);
@@ -324,6 +420,8 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
 {
     struct hg_init_info hg_init_info;
     struct hg_test_context_info *hg_test_context_info;
+    char rail_info_string[NA_TEST_MAX_ADDR_NAME];
+    const char *na_routes[1] = { rail_info_string };
     hg_return_t ret = HG_SUCCESS;
 
     /* Get HG test options */
@@ -369,10 +467,61 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
         hg_init_info.na_init_info.max_contexts =
             hg_test_info->na_test_info.max_contexts;
 
+    /* Limit requests in flight and reject requests once target falls
+     * behind */
+    if (hg_test_info->flow) {
+        hg_init_info.request_credits = HG_TEST_REQUEST_CREDITS;
+        if (hg_test_info->na_test_info.listen)
+            hg_init_info.busy_queue_depth = HG_TEST_BUSY_QUEUE_DEPTH;
+    }
+
+    /* Keep looked up addresses */
+    if (hg_test_info->addr_cache)
+        hg_init_info.addr_cache = HG_TRUE;
+
+    /* Coalesce requests sent to the same target */
+    if (hg_test_info->coalesce) {
+        hg_init_info.coalesce_count = HG_TEST_COALESCE_COUNT;
+        hg_init_info.coalesce_size = HG_TEST_COALESCE_SIZE;
+        hg_init_info.coalesce_timeout = HG_TEST_COALESCE_TIMEOUT * 1000;
+    }
+
+    /* Split completion queues */
+    if (hg_test_info->shards)
+        hg_init_info.completion_queue_shards = HG_TEST_COMPLETION_SHARDS;
+
+    /* Adapt number of posted handles within bounds */
+    if (hg_test_info->post_limits) {
+        hg_init_info.request_post_min = HG_TEST_POST_MIN;
+        hg_init_info.request_post_max = HG_TEST_POST_MAX;
+    }
+
+    /* Reuse destroyed handles */
+    if (hg_test_info->handle_pool)
+        hg_init_info.handle_pool_size = HG_TEST_HANDLE_POOL_SIZE;
+
+    /* Add a second rail of the same transport to stripe transfers across */
+    if (hg_test_info->rails) {
+        snprintf(rail_info_string, sizeof(rail_info_string), "%s+%s",
+            hg_test_info->na_test_info.comm,
+            hg_test_info->na_test_info.protocol);
+        hg_init_info.na_routes = na_routes;
+        hg_init_info.na_route_count = 1;
+        hg_init_info.bulk_stripe_size = HG_TEST_BULK_STRIPE_SIZE;
+    }
+
     /* Set auto SM mode */
     if (hg_test_info->auto_sm)
         hg_init_info.auto_sm = HG_TRUE;
 
+    /* Set self inline mode */
+    if (hg_test_info->self_inline)
+        hg_init_info.self_inline = HG_TRUE;
+
+    /* Dispatch received RPCs by key */
+    if (hg_test_info->na_test_info.listen && hg_test_info->dispatch)
+        hg_init_info.dispatch_policy = HG_DISPATCH_HASH;
+
     /* Assign NA class */
     hg_init_info.na_class = hg_test_info->na_test_info.na_class;
 
@@ -388,6 +537,14 @@ HG_Test_init(int argc, char *argv[], struct hg_test_info *hg_test_info)
     /* Attach test info to class */
     HG_Class_set_data(hg_test_info->hg_class, hg_test_info, NULL);
 
+    /* Key RPCs by their input, secondary contexts that RPCs are dispatched
+     * to are created along with the thread pool */
+    if (hg_test_info->na_test_info.listen && hg_test_info->dispatch) {
+        HG_Class_set_dispatch_key_callback(hg_test_info->hg_class,
+            hg_test_dispatch_key_cb, NULL);
+        hg_test_info->na_test_info.max_contexts = HG_TEST_DISPATCH_CONTEXTS;
+    }
+
 #ifdef MERCURY_TESTING_HAS_THREAD_POOL
     /* Attach handle created */
     HG_Class_set_handle_create_callback(hg_test_info->hg_class,
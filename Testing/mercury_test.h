@@ -49,6 +49,15 @@ struct hg_test_info {
     uint32_t cookie;
 #endif
     hg_bool_t auto_sm;
+    hg_bool_t self_inline;
+    hg_bool_t dispatch;
+    hg_bool_t flow;
+    hg_bool_t addr_cache;
+    hg_bool_t coalesce;
+    hg_bool_t shards;
+    hg_bool_t rails;
+    hg_bool_t handle_pool;
+    hg_bool_t post_limits;
     struct na_test_info na_test_info;
     unsigned int thread_count;
 #ifdef MERCURY_TESTING_HAS_THREAD_POOL
@@ -96,6 +105,32 @@ struct hg_test_context_info {
 
 #define MERCURY_TESTING_NUM_THREADS_DEFAULT 8
 
+/* Requests each origin may have in flight to a target (--flow) */
+#define HG_TEST_REQUEST_CREDITS 128
+#define HG_TEST_BUSY_QUEUE_DEPTH (HG_TEST_REQUEST_CREDITS / 2)
+
+/* Requests coalesced into a single message, max size of that message and
+ * delay (ms) before it is sent (--coalesce) */
+#define HG_TEST_COALESCE_COUNT 4
+#define HG_TEST_COALESCE_SIZE 1024
+#define HG_TEST_COALESCE_TIMEOUT 50
+
+/* Completion queue shards of each context (--shards) */
+#define HG_TEST_COMPLETION_SHARDS 4
+
+/* Handles kept for reuse by each context (--handle_pool) */
+#define HG_TEST_HANDLE_POOL_SIZE 16
+
+/* Bounds of number of handles posted by target (--post_limits) */
+#define HG_TEST_POST_MIN 2
+#define HG_TEST_POST_MAX 16
+
+/* Min size of bulk transfers striped across the second rail (--rails) */
+#define HG_TEST_BULK_STRIPE_SIZE (64 * 1024)
+
+/* Number of contexts that RPCs are dispatched to (--dispatch) */
+#define HG_TEST_DISPATCH_CONTEXTS 4
+
 /*********************/
 /* Public Prototypes */
 /*********************/
@@ -17,7 +17,7 @@
 
 int na_test_opt_ind_g = 1; /* token pointer */
 const char *na_test_opt_arg_g = NULL; /* flag argument (or value) */
-const char *na_test_short_opt_g = "hc:p:H:LsSak:l:t:bmC:V";
+const char *na_test_short_opt_g = "hc:p:H:LsSak:l:t:bmiDFAOQRPTC:V";
 const struct na_test_opt na_test_opt_g[] = {
     { "help", no_arg, 'h'},
     { "comm", require_arg, 'c' },
@@ -32,6 +32,15 @@ const struct na_test_opt na_test_opt_g[] = {
     { "threads", require_arg, 't'},
     { "busy", no_arg, 'b'},
     { "memory", no_arg, 'm'},
+    { "inline", no_arg, 'i'},
+    { "dispatch", no_arg, 'D'},
+    { "flow", no_arg, 'F'},
+    { "addr_cache", no_arg, 'A'},
+    { "coalesce", no_arg, 'O'},
+    { "shards", no_arg, 'Q'},
+    { "rails", no_arg, 'R'},
+    { "handle_pool", no_arg, 'P'},
+    { "post_limits", no_arg, 'T'},
     { "contexts", require_arg, 'C'},
     { "verbose", no_arg, 'V' },
     { NULL, 0, '\0' } /* Must add this at the end */
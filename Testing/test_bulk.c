@@ -9,20 +9,43 @@
  */
 
 #include "mercury_test.h"
+#include "mercury_hl.h"
+#include "mercury_atomic.h"
+#include "mercury_thread.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 extern hg_id_t hg_test_bulk_write_id_g;
+extern hg_id_t hg_test_perf_bulk_read_id_g;
 
 #define BUFSIZE (MERCURY_TESTING_BUFFER_SIZE * 1024 * 1024)
 
+#define HG_TEST_LOCAL_THREADS 2     /* Threads issuing local transfers */
+#define HG_TEST_LOCAL_COUNT 4096    /* Transfers per thread, more than a
+                                     * completion queue initially holds */
+#define HG_TEST_STRIPE_ROUNDS 4     /* Striped transfers of each kind, rails
+                                     * of origin are looked up by first one */
+
 struct forward_cb_args {
     hg_request_t *request;
     size_t expected_bytes;
     hg_return_t ret;
 };
 
+struct bulk_local_args {
+    hg_context_t *context;
+    hg_addr_t addr;
+    hg_bulk_t origin_handle;
+    hg_bulk_t local_handle;
+    char *origin_buf;
+    char *local_buf;
+    hg_atomic_int32_t *completed;
+    hg_atomic_int32_t *failed;
+    hg_return_t ret;
+};
+
 //#define HG_TEST_DEBUG
 #ifdef HG_TEST_DEBUG
 #define HG_TEST_LOG_DEBUG(...)                                \
@@ -76,6 +99,182 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Forward callback (no output)
+ */
+static hg_return_t
+hg_test_bulk_read_forward_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_cb_args *args = (struct forward_cb_args *) callback_info->arg;
+
+    args->ret = callback_info->ret;
+    if (callback_info->ret != HG_SUCCESS)
+        HG_TEST_LOG_ERROR("Return from callback info is not HG_SUCCESS");
+    hg_request_complete(args->request);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Bulk_transfer callback (local transfers)
+ */
+static hg_return_t
+hg_test_bulk_local_cb(const struct hg_cb_info *callback_info)
+{
+    struct bulk_local_args *args =
+        (struct bulk_local_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS)
+        hg_atomic_incr32(args->failed);
+    hg_atomic_incr32(args->completed);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_test_bulk_local_thread(void *arg)
+{
+    struct bulk_local_args *args = (struct bulk_local_args *) arg;
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    unsigned int i;
+
+    /* One byte at a time, transfers to self complete right away and are
+     * queued until triggered */
+    for (i = 0; i < HG_TEST_LOCAL_COUNT; i++) {
+        args->ret = HG_Bulk_transfer(args->context, hg_test_bulk_local_cb,
+            args, HG_BULK_PUSH, args->addr, args->origin_handle, i,
+            args->local_handle, i, 1, HG_OP_ID_IGNORE);
+        if (args->ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not transfer bulk data");
+            break;
+        }
+    }
+
+    hg_thread_exit(thread_ret);
+    return thread_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_local(hg_class_t *hg_class, hg_context_t *context)
+{
+    struct bulk_local_args args_m[HG_TEST_LOCAL_THREADS];
+    hg_thread_t thread_m[HG_TEST_LOCAL_THREADS];
+    hg_atomic_int32_t completed, failed;
+    hg_addr_t addr = HG_ADDR_NULL;
+    hg_size_t buf_size = HG_TEST_LOCAL_COUNT;
+    hg_return_t hg_ret;
+    unsigned int i, j, count = 0, n_threads = 0;
+
+    hg_atomic_init32(&completed, 0);
+    hg_atomic_init32(&failed, 0);
+    memset(args_m, 0, sizeof(args_m));
+
+    hg_ret = HG_Addr_self(hg_class, &addr);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get self addr");
+        goto done;
+    }
+
+    for (i = 0; i < HG_TEST_LOCAL_THREADS; i++) {
+        struct bulk_local_args *args = &args_m[i];
+
+        args->context = context;
+        args->addr = addr;
+        args->completed = &completed;
+        args->failed = &failed;
+        args->origin_buf = (char *) calloc(buf_size, 1);
+        args->local_buf = (char *) malloc(buf_size);
+        if (!args->origin_buf || !args->local_buf) {
+            HG_TEST_LOG_ERROR("Could not allocate buffers");
+            hg_ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        for (j = 0; j < buf_size; j++)
+            args->local_buf[j] = (char) (i + j);
+
+        hg_ret = HG_Bulk_create(hg_class, 1, (void **) &args->origin_buf,
+            &buf_size, HG_BULK_READWRITE, &args->origin_handle);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create bulk data handle");
+            goto done;
+        }
+        hg_ret = HG_Bulk_create(hg_class, 1, (void **) &args->local_buf,
+            &buf_size, HG_BULK_READ_ONLY, &args->local_handle);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create bulk data handle");
+            goto done;
+        }
+    }
+
+    /* Each thread queues its completions to its own shard, which must grow
+     * to hold them all */
+    for (i = 0; i < HG_TEST_LOCAL_THREADS; i++, n_threads++) {
+        if (hg_thread_create(&thread_m[i], hg_test_bulk_local_thread,
+            &args_m[i]) != HG_UTIL_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create thread");
+            hg_ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+    for (i = 0; i < n_threads; i++)
+        hg_thread_join(thread_m[i]);
+    n_threads = 0;
+    for (i = 0; i < HG_TEST_LOCAL_THREADS; i++) {
+        if (args_m[i].ret != HG_SUCCESS) {
+            hg_ret = args_m[i].ret;
+            goto done;
+        }
+    }
+
+    /* Every completion is triggered once */
+    while (count < HG_TEST_LOCAL_THREADS * HG_TEST_LOCAL_COUNT) {
+        unsigned int actual_count = 0;
+
+        hg_ret = HG_Trigger(context, 0,
+            HG_TEST_LOCAL_THREADS * HG_TEST_LOCAL_COUNT, &actual_count);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Triggered %u callbacks instead of %u", count,
+                HG_TEST_LOCAL_THREADS * HG_TEST_LOCAL_COUNT);
+            goto done;
+        }
+        count += actual_count;
+    }
+    if (hg_atomic_get32(&completed) != (hg_util_int32_t) count
+        || hg_atomic_get32(&failed)) {
+        HG_TEST_LOG_ERROR("%d callbacks for %u completions, %d failed",
+            hg_atomic_get32(&completed), count, hg_atomic_get32(&failed));
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    for (i = 0; i < HG_TEST_LOCAL_THREADS; i++) {
+        if (memcmp(args_m[i].origin_buf, args_m[i].local_buf, buf_size)) {
+            HG_TEST_LOG_ERROR("Data of thread %u was not transferred", i);
+            hg_ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+done:
+    for (i = 0; i < n_threads; i++)
+        hg_thread_join(thread_m[i]);
+    for (i = 0; i < HG_TEST_LOCAL_THREADS; i++) {
+        if (args_m[i].origin_handle != HG_BULK_NULL)
+            HG_Bulk_free(args_m[i].origin_handle);
+        if (args_m[i].local_handle != HG_BULK_NULL)
+            HG_Bulk_free(args_m[i].local_handle);
+        free(args_m[i].origin_buf);
+        free(args_m[i].local_buf);
+    }
+    if (addr != HG_ADDR_NULL)
+        HG_Addr_free(hg_class, addr);
+    return hg_ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_bulk_contig(hg_class_t *hg_class, hg_context_t *context,
@@ -375,6 +574,137 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_read(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr,
+    hg_size_t transfer_size)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle = HG_HANDLE_NULL;
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    hg_return_t ret = HG_SUCCESS;
+    struct forward_cb_args forward_cb_args;
+    bulk_write_in_t bulk_read_in_struct;
+    char *bulk_buf = NULL;
+    void *buf_ptrs[2];
+    hg_size_t buf_sizes[2];
+    size_t i;
+
+    if (transfer_size > BUFSIZE) {
+        HG_LOG_ERROR("Exceeding bulk size");
+        ret = HG_SIZE_ERROR;
+        goto done;
+    }
+
+    /* Two segments that do not end where rails split transfer */
+    bulk_buf = (char *) calloc(transfer_size, 1);
+    if (!bulk_buf) {
+        HG_TEST_LOG_ERROR("Could not allocate bulk buf");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    buf_ptrs[0] = bulk_buf;
+    buf_sizes[0] = transfer_size / 3;
+    buf_ptrs[1] = bulk_buf + buf_sizes[0];
+    buf_sizes[1] = transfer_size - buf_sizes[0];
+
+    request = hg_request_create(request_class);
+
+    ret = HG_Create(context, target_addr, hg_test_perf_bulk_read_id_g,
+        &handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create handle");
+        goto done;
+    }
+
+    /* Register memory */
+    ret = HG_Bulk_create(hg_class, 2, buf_ptrs, buf_sizes, HG_BULK_WRITE_ONLY,
+        &bulk_handle);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create bulk handle");
+        goto done;
+    }
+
+    /* Target pushes its buffer into the whole bulk handle */
+    bulk_read_in_struct.fildes = 0;
+    bulk_read_in_struct.transfer_size = transfer_size;
+    bulk_read_in_struct.origin_offset = 0;
+    bulk_read_in_struct.target_offset = 0;
+    bulk_read_in_struct.bulk_handle = bulk_handle;
+
+    forward_cb_args.request = request;
+    forward_cb_args.expected_bytes = transfer_size;
+    forward_cb_args.ret = HG_SUCCESS;
+    ret = HG_Forward(handle, hg_test_bulk_read_forward_cb, &forward_cb_args,
+        &bulk_read_in_struct);
+    if (ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not forward call");
+        goto done;
+    }
+
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    ret = forward_cb_args.ret;
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    /* Target buffer holds (char) i at offset i */
+    for (i = 0; i < transfer_size; i++) {
+        if (bulk_buf[i] != (char) i) {
+            HG_TEST_LOG_ERROR("Error detected in bulk transfer, buf[%zu] = %d, "
+                "was expecting %d!", i, bulk_buf[i], (char) i);
+            ret = HG_PROTOCOL_ERROR;
+            break;
+        }
+    }
+
+done:
+    if (bulk_handle != HG_BULK_NULL && HG_Bulk_free(bulk_handle) != HG_SUCCESS)
+    {
+        HG_TEST_LOG_ERROR("Could not destroy bulk handle");
+        ret = HG_PROTOCOL_ERROR;
+    }
+    if (handle != HG_HANDLE_NULL && HG_Destroy(handle) != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy handle");
+        ret = HG_PROTOCOL_ERROR;
+    }
+    if (request)
+        hg_request_destroy(request);
+    free(bulk_buf);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_bulk_stripe(hg_class_t *hg_class, hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t target_addr)
+{
+    hg_size_t transfer_size = 2 * HG_TEST_BULK_STRIPE_SIZE + 3;
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Target gets data from odd offsets and puts data across the point where
+     * transfer is split between rails */
+    for (i = 0; i < HG_TEST_STRIPE_ROUNDS; i++) {
+        ret = hg_test_bulk_contig(hg_class, context, request_class,
+            target_addr, transfer_size, 1, 5);
+        if (ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Striped get %u failed", i);
+            goto done;
+        }
+        ret = hg_test_bulk_read(hg_class, context, request_class,
+            target_addr, transfer_size);
+        if (ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Striped put %u failed", i);
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 int main(int argc, char *argv[])
 {
@@ -502,6 +832,51 @@ int main(int argc, char *argv[])
     }
     HG_PASSED();
 
+    /* Bulk transfer pulled by target through its second route */
+    if (hg_test_info.rails && !hg_test_info.na_test_info.self_send) {
+        const char *route_name =
+            strchr(hg_test_info.na_test_info.target_name, ';');
+        hg_addr_t route_addr = HG_ADDR_NULL;
+
+        HG_TEST("contiguous RPC bulk through second route of target");
+        hg_ret = route_name ? HG_Hl_addr_lookup_wait(hg_test_info.context,
+            hg_test_info.request_class, route_name + 1, &route_addr,
+            HG_MAX_IDLE_TIME) : HG_PROTOCOL_ERROR;
+        if (hg_ret == HG_SUCCESS) {
+            hg_ret = hg_test_bulk_contig(hg_test_info.hg_class,
+                hg_test_info.context, hg_test_info.request_class, route_addr,
+                HG_TEST_BULK_STRIPE_SIZE / 2, 1, 3);
+            HG_Addr_free(hg_test_info.hg_class, route_addr);
+        }
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* Transfers above stripe size split between both rails of target */
+    if (hg_test_info.rails && !hg_test_info.na_test_info.self_send) {
+        HG_TEST("RPC bulk striped across rails (put and get)");
+        hg_ret = hg_test_bulk_stripe(hg_test_info.hg_class,
+            hg_test_info.context, hg_test_info.request_class,
+            hg_test_info.target_addr);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* Completions queued by several threads before being triggered */
+    HG_TEST("local bulk transfers queued from threads");
+    hg_ret = hg_test_bulk_local(hg_test_info.hg_class, hg_test_info.context);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
 done:
     if (ret != EXIT_SUCCESS)
         HG_FAILED();
@@ -9,18 +9,76 @@
  */
 
 #include "mercury_test.h"
+#include "mercury_hl.h"
+#include "mercury_time.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 extern hg_id_t hg_test_rpc_open_id_g;
 extern hg_id_t hg_test_rpc_open_id_no_resp_g;
+extern hg_id_t hg_test_rpc_sleep_id_g;
+extern hg_id_t hg_test_rpc_open_id_high_g;
+extern hg_id_t hg_test_rpc_open_id_direct_g;
+extern hg_id_t hg_test_rpc_context_id_g;
+extern hg_id_t hg_test_rpc_post_count_id_g;
 
 #define NINFLIGHT 32
 
+#define HG_TEST_RPC_SLEEP   500 /* Time (ms) target takes to respond */
+#define HG_TEST_RPC_TIMEOUT 100 /* Deadline (ms) of timed RPCs */
+#define HG_TEST_DISPATCH_KEYS 8 /* Distinct keys of dispatched RPCs */
+#define HG_TEST_LOOKUP_COUNT  4 /* Names looked up in batch */
+#define HG_TEST_RESEND_COUNT  8 /* Forwards of persistent encoded input */
+#define HG_TEST_COALESCE_BLOCK 1000 /* Block timeout (ms) of progress thread
+                                     * while requests are coalesced */
+#define HG_TEST_COALESCE_MAX  4 /* Max requests of coalescing tests */
+#define HG_TEST_COALESCE_EXTRA_SIZE (64 * 1024) /* Path that does not fit in
+                                                 * unexpected message */
+#define HG_TEST_POOL_ROUNDS   8 /* Handles created again from pool */
+#define HG_TEST_PROGRESS_BLOCK 10000 /* Block timeout (ms) of progress thread
+                                      * that is stopped while blocking */
+#define HG_TEST_POST_IDLE  1500 /* Time (ms) target stays idle, longer than
+                                 * it waits before releasing handles */
+#define HG_TEST_ROUTE_COUNT   2 /* Routes of origin and target (--rails) */
+#define HG_TEST_ROUTE_UNKNOWN "foo+bar://none" /* Address of a transport
+                                                * that no route matches */
+
 struct forward_cb_args {
     hg_request_t *request;
     rpc_handle_t *rpc_handle;
+    hg_return_t ret;
+};
+
+struct forward_order_cb_args {
+    unsigned int *trigger_count;
+    unsigned int trigger_index;
+};
+
+struct forward_context_cb_args {
+    hg_request_t *request;
+    hg_int32_t context_id;
+    hg_return_t ret;
+};
+
+struct lookup_cb_args {
+    hg_request_t *request;
+    hg_return_t ret;
+};
+
+struct forward_progress_cb_args {
+    hg_atomic_int32_t completed;
+    hg_atomic_int32_t failed;
+    hg_atomic_int32_t notified;
+};
+
+struct forward_coalesce_cb_args {
+    hg_atomic_int32_t *completed;
+    hg_time_t start;
+    double elapsed; /* Time (ms) from first forward to callback */
+    hg_int32_t cookie;
+    hg_return_t ret;
 };
 
 //#define HG_TEST_DEBUG
@@ -45,6 +103,7 @@ hg_test_rpc_forward_cb(const struct hg_cb_info *callback_info)
     rpc_open_out_t rpc_open_out_struct;
     hg_return_t ret = HG_SUCCESS;
 
+    args->ret = callback_info->ret;
     if (callback_info->ret != HG_SUCCESS) {
         HG_TEST_LOG_DEBUG("Return from callback info is not HG_SUCCESS");
         goto done;
@@ -65,7 +124,7 @@ hg_test_rpc_forward_cb(const struct hg_cb_info *callback_info)
     (void)rpc_open_ret;
     if (rpc_open_event_id != (int) args->rpc_handle->cookie) {
         HG_TEST_LOG_ERROR("Cookie did not match RPC response");
-        goto done;
+        args->ret = HG_PROTOCOL_ERROR;
     }
 
     /* Free request */
@@ -80,6 +139,21 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Addr_lookup_batch callback
+ */
+static hg_return_t
+hg_test_rpc_lookup_cb(const struct hg_cb_info *callback_info)
+{
+    struct lookup_cb_args *args = (struct lookup_cb_args *) callback_info->arg;
+
+    args->ret = callback_info->ret;
+    hg_request_complete(args->request);
+
+    return HG_SUCCESS;
+}
+
 /*---------------------------------------------------------------------------*/
 /**
  * HG_Forward callback (no response)
@@ -123,6 +197,122 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Forward callback (trigger order)
+ */
+static hg_return_t
+hg_test_rpc_forward_order_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_order_cb_args *args =
+        (struct forward_order_cb_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS)
+        HG_TEST_LOG_ERROR("Return from callback info is not HG_SUCCESS");
+
+    args->trigger_index = (*args->trigger_count)++;
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Forward callback (processing context)
+ */
+static hg_return_t
+hg_test_rpc_forward_context_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_context_cb_args *args =
+        (struct forward_context_cb_args *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+
+    args->ret = callback_info->ret;
+    if (callback_info->ret != HG_SUCCESS)
+        goto done;
+
+    args->ret = HG_Get_output(callback_info->info.forward.handle,
+        &rpc_open_out_struct);
+    if (args->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get output");
+        goto done;
+    }
+    args->context_id = rpc_open_out_struct.event_id;
+    HG_Free_output(callback_info->info.forward.handle, &rpc_open_out_struct);
+
+done:
+    hg_request_complete(args->request);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Forward callback (progress thread)
+ */
+static hg_return_t
+hg_test_rpc_forward_progress_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_progress_cb_args *args =
+        (struct forward_progress_cb_args *) callback_info->arg;
+
+    if (callback_info->ret != HG_SUCCESS)
+        hg_atomic_incr32(&args->failed);
+    hg_atomic_incr32(&args->completed);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * HG_Forward callback (coalesced requests)
+ */
+static hg_return_t
+hg_test_rpc_forward_coalesce_cb(const struct hg_cb_info *callback_info)
+{
+    struct forward_coalesce_cb_args *args =
+        (struct forward_coalesce_cb_args *) callback_info->arg;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+    args->elapsed =
+        hg_time_to_double(hg_time_subtract(now, args->start)) * 1000.0;
+
+    args->ret = callback_info->ret;
+    if (callback_info->ret != HG_SUCCESS)
+        goto done;
+
+    /* Response must be the one of that request */
+    args->ret = HG_Get_output(callback_info->info.forward.handle,
+        &rpc_open_out_struct);
+    if (args->ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get output");
+        goto done;
+    }
+    if (rpc_open_out_struct.event_id != args->cookie) {
+        HG_TEST_LOG_ERROR("Got cookie %d instead of %d",
+            rpc_open_out_struct.event_id, args->cookie);
+        args->ret = HG_PROTOCOL_ERROR;
+    }
+    HG_Free_output(callback_info->info.forward.handle, &rpc_open_out_struct);
+
+done:
+    hg_atomic_incr32(args->completed);
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+/**
+ * Progress thread trigger callback
+ */
+static void
+hg_test_rpc_trigger_notify(void *arg)
+{
+    struct forward_progress_cb_args *args =
+        (struct forward_progress_cb_args *) arg;
+
+    hg_atomic_incr32(&args->notified);
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_test_rpc(hg_context_t *context, hg_request_class_t *request_class,
@@ -436,99 +626,1458 @@ done:
 }
 
 /*---------------------------------------------------------------------------*/
-int
-main(int argc, char *argv[])
+static hg_return_t
+hg_test_rpc_timed(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id, hg_uint64_t cookie, unsigned int timeout,
+    hg_return_t expected_ret)
 {
-    struct hg_test_info hg_test_info = { 0 };
-    hg_return_t hg_ret;
-    hg_id_t inv_id;
-    int ret = EXIT_SUCCESS;
+    hg_request_t *request = NULL;
+    hg_handle_t handle;
+    hg_return_t hg_ret = HG_SUCCESS;
+    struct forward_cb_args forward_cb_args;
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_handle_t rpc_open_handle;
+    rpc_open_in_t  rpc_open_in_struct;
 
-    /* Initialize the interface */
-    HG_Test_init(argc, argv, &hg_test_info);
+    request = hg_request_create(request_class);
 
-    /* Simple RPC test */
-    HG_TEST("simple RPC");
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_g,
-        hg_test_rpc_forward_cb);
+    hg_ret = HG_Create(context, addr, rpc_id, &handle);
     if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+        HG_TEST_LOG_ERROR("Could not create handle");
         goto done;
     }
-    HG_PASSED();
 
-    /* RPC reset test */
-    HG_TEST("RPC reset");
-    hg_ret = hg_test_rpc_reset(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_g,
-        hg_test_rpc_forward_cb);
+    /* Fill input structure */
+    rpc_open_handle.cookie = cookie;
+    rpc_open_in_struct.path = rpc_open_path;
+    rpc_open_in_struct.handle = rpc_open_handle;
+
+    /* Forward call to remote addr with a deadline */
+    HG_TEST_LOG_DEBUG("Forwarding rpc_open, op id: %u...", rpc_id);
+    forward_cb_args.request = request;
+    forward_cb_args.rpc_handle = &rpc_open_handle;
+    forward_cb_args.ret = HG_SUCCESS;
+    hg_ret = HG_Forward_timed(handle, hg_test_rpc_forward_cb, &forward_cb_args,
+        &rpc_open_in_struct, timeout);
     if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+        HG_TEST_LOG_ERROR("Could not forward call");
         goto done;
     }
-    HG_PASSED();
 
-    /* RPC test with tag mask */
-    HG_TEST("tagged RPC");
-    hg_ret = hg_test_rpc_mask(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_g,
-        hg_test_rpc_forward_cb);
-    if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
-        goto done;
+    hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+
+    if (forward_cb_args.ret != expected_ret) {
+        HG_TEST_LOG_ERROR("Forward completed with %s instead of %s",
+            HG_Error_to_string(forward_cb_args.ret),
+            HG_Error_to_string(expected_ret));
+        hg_ret = HG_PROTOCOL_ERROR;
     }
-    HG_PASSED();
 
-    /* RPC test with no response */
-    HG_TEST("no response RPC");
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_no_resp_g,
-        hg_test_rpc_forward_no_resp_cb);
-    if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+    /* Complete */
+    if (HG_Destroy(handle) != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy handle");
+        hg_ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    HG_PASSED();
 
-    /* RPC test with unregistered ID */
-    HG_TEST("unregistered RPC");
-    inv_id = MERCURY_REGISTER(hg_test_info.hg_class, "unreg_id", void, void, NULL);
-    hg_ret = HG_Deregister(hg_test_info.hg_class, inv_id);
-    if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+done:
+    hg_request_destroy(request);
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_credits(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
+{
+    unsigned int count = HG_TEST_REQUEST_CREDITS + NINFLIGHT;
+    hg_request_t **request_m = NULL;
+    hg_handle_t *handle_m = NULL;
+    struct forward_cb_args *forward_cb_args_m = NULL;
+    rpc_handle_t *rpc_open_handle_m = NULL;
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t  rpc_open_in_struct;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i;
+
+    request_m = (hg_request_t **) calloc(count, sizeof(hg_request_t *));
+    handle_m = (hg_handle_t *) calloc(count, sizeof(hg_handle_t));
+    forward_cb_args_m = (struct forward_cb_args *) calloc(count,
+        sizeof(struct forward_cb_args));
+    rpc_open_handle_m = (rpc_handle_t *) calloc(count, sizeof(rpc_handle_t));
+    if (!request_m || !handle_m || !forward_cb_args_m || !rpc_open_handle_m) {
+        HG_TEST_LOG_ERROR("Could not allocate requests");
+        hg_ret = HG_NOMEM_ERROR;
         goto done;
     }
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, inv_id, hg_test_rpc_forward_cb);
-    if (hg_ret == HG_SUCCESS) {
-        ret = EXIT_FAILURE;
-        goto done;
+
+    /* First request stalls target, the ones that follow use up all credits
+     * (target rejects those queued past its busy depth) and timed requests
+     * wait for a credit until their deadline */
+    for (i = 0; i < count; i++) {
+        request_m[i] = hg_request_create(request_class);
+        hg_ret = HG_Create(context, addr, i ? rpc_id : hg_test_rpc_sleep_id_g,
+            &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        rpc_open_handle_m[i].cookie = i ? i : HG_TEST_RPC_SLEEP;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handle_m[i];
+        forward_cb_args_m[i].request = request_m[i];
+        forward_cb_args_m[i].rpc_handle = &rpc_open_handle_m[i];
+        forward_cb_args_m[i].ret = HG_SUCCESS;
+        if (i < HG_TEST_REQUEST_CREDITS)
+            hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_cb,
+                &forward_cb_args_m[i], &rpc_open_in_struct);
+        else
+            hg_ret = HG_Forward_timed(handle_m[i], hg_test_rpc_forward_cb,
+                &forward_cb_args_m[i], &rpc_open_in_struct,
+                HG_TEST_RPC_TIMEOUT);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            goto done;
+        }
     }
-    HG_PASSED();
 
-    /* RPC test with invalid ID (not registered on server) */
-    HG_TEST("invalid RPC");
-    inv_id = MERCURY_REGISTER(hg_test_info.hg_class, "inv_id", void, void, NULL);
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, inv_id, hg_test_rpc_forward_cb);
+    /* Complete */
+    for (i = 0; i < count; i++) {
+        hg_return_t expected_ret;
+
+        if (i >= HG_TEST_REQUEST_CREDITS)
+            expected_ret = HG_TIMEOUT;
+        else if (i > HG_TEST_BUSY_QUEUE_DEPTH)
+            expected_ret = HG_BUSY;
+        else
+            expected_ret = HG_SUCCESS;
+
+        hg_request_wait(request_m[i], HG_MAX_IDLE_TIME, NULL);
+        /* Target may or may not have dequeued first request when receiving
+         * the one at its busy depth */
+        if (i == HG_TEST_BUSY_QUEUE_DEPTH
+            && forward_cb_args_m[i].ret == HG_BUSY)
+            continue;
+        if (forward_cb_args_m[i].ret != expected_ret) {
+            HG_TEST_LOG_ERROR("Forward %u completed with %s instead of %s", i,
+                HG_Error_to_string(forward_cb_args_m[i].ret),
+                HG_Error_to_string(expected_ret));
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+
+done:
+    for (i = 0; request_m && i < count; i++) {
+        if (handle_m[i] && HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (request_m[i])
+            hg_request_destroy(request_m[i]);
+    }
+    free(request_m);
+    free(handle_m);
+    free(forward_cb_args_m);
+    free(rpc_open_handle_m);
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_priority(hg_context_t *context, hg_addr_t addr, hg_id_t rpc_id,
+    hg_id_t high_rpc_id)
+{
+    hg_handle_t handle_m[NINFLIGHT];
+    struct forward_order_cb_args forward_cb_args_m[NINFLIGHT];
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t  rpc_open_in_struct;
+    unsigned int trigger_count = 0;
+    hg_time_t t1, t2;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i, count = 0;
+
+    /* Last request is of high priority */
+    for (i = 0; i < NINFLIGHT; i++, count++) {
+        hg_ret = HG_Create(context, addr,
+            (i == NINFLIGHT - 1) ? high_rpc_id : rpc_id, &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle.cookie = i;
+        forward_cb_args_m[i].trigger_count = &trigger_count;
+        forward_cb_args_m[i].trigger_index = NINFLIGHT;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_order_cb,
+            &forward_cb_args_m[i], &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            HG_Destroy(handle_m[i]);
+            goto done;
+        }
+    }
+
+    /* Let responses arrive before triggering any callback */
+    hg_time_get_current(&t1);
+    do {
+        HG_Progress(context, 10);
+        hg_time_get_current(&t2);
+    } while (hg_time_to_double(hg_time_subtract(t2, t1)) * 1000.0
+        < HG_TEST_RPC_SLEEP);
+
+    while (trigger_count < NINFLIGHT) {
+        unsigned int actual_count = 0;
+
+        HG_Trigger(context, 0, 1, &actual_count);
+        if (!actual_count)
+            HG_Progress(context, 10);
+    }
+
+    /* High priority callback must be triggered first */
+    if (forward_cb_args_m[NINFLIGHT - 1].trigger_index != 0) {
+        HG_TEST_LOG_ERROR("High priority RPC triggered at position %u",
+            forward_cb_args_m[NINFLIGHT - 1].trigger_index);
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    for (i = 0; i < count; i++) {
+        if (HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_progress_and_trigger(hg_context_t *context, hg_addr_t addr,
+    hg_id_t rpc_id)
+{
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
+    hg_handle_t handle_m[NINFLIGHT];
+    struct forward_order_cb_args forward_cb_args_m[NINFLIGHT];
+    unsigned int trigger_count = 0, total_count = 0;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i, count = 0;
+
+    for (i = 0; i < NINFLIGHT; i++, count++) {
+        hg_ret = HG_Create(context, addr, rpc_id, &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle.cookie = i;
+        forward_cb_args_m[i].trigger_count = &trigger_count;
+        forward_cb_args_m[i].trigger_index = NINFLIGHT;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_order_cb,
+            &forward_cb_args_m[i], &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            HG_Destroy(handle_m[i]);
+            goto done;
+        }
+    }
+
+    /* Progress and trigger from this thread only, reported count must cover
+     * callbacks that were run (RPCs to self also trigger target callbacks) */
+    while (trigger_count < NINFLIGHT) {
+        unsigned int actual_count = 0;
+
+        hg_ret = HG_Progress_and_trigger(context, 10, NINFLIGHT,
+            &actual_count);
+        if ((hg_ret == HG_SUCCESS && !actual_count)
+            || (hg_ret == HG_TIMEOUT && actual_count)
+            || (hg_ret != HG_SUCCESS && hg_ret != HG_TIMEOUT)) {
+            HG_TEST_LOG_ERROR("Progress and trigger returned %s with count %u",
+                HG_Error_to_string(hg_ret), actual_count);
+            hg_ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        total_count += actual_count;
+    }
+    hg_ret = HG_SUCCESS;
+
+    if (total_count < NINFLIGHT) {
+        HG_TEST_LOG_ERROR("Triggered %u callbacks instead of at least %u",
+            total_count, NINFLIGHT);
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    for (i = 0; i < count; i++) {
+        if (HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_progress_thread(hg_context_t *context, hg_addr_t addr,
+    hg_id_t rpc_id, hg_progress_mode_t mode, hg_bool_t user_trigger)
+{
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t rpc_open_in_struct;
+    hg_handle_t handle_m[NINFLIGHT];
+    struct forward_progress_cb_args forward_cb_args;
+    struct hg_progress_info progress_info;
+    hg_bool_t started = HG_FALSE;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i, count = 0;
+
+    hg_atomic_init32(&forward_cb_args.completed, 0);
+    hg_atomic_init32(&forward_cb_args.failed, 0);
+    hg_atomic_init32(&forward_cb_args.notified, 0);
+
+    memset(&progress_info, 0, sizeof(progress_info));
+    progress_info.mode = mode;
+    progress_info.spin_count = 100;
+    if (user_trigger) {
+        progress_info.trigger_callback = hg_test_rpc_trigger_notify;
+        progress_info.trigger_arg = &forward_cb_args;
+    }
+    hg_ret = HG_Context_start_progress(context, &progress_info);
     if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+        HG_TEST_LOG_ERROR("Could not start progress thread");
         goto done;
     }
-    HG_PASSED();
+    started = HG_TRUE;
 
-    /* RPC test with reset */
-    HG_TEST("reset RPC");
-    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
-        hg_test_info.target_addr, hg_test_rpc_open_id_g,
-        hg_test_rpc_forward_reset_cb);
-    if (hg_ret != HG_SUCCESS) {
-        ret = EXIT_FAILURE;
+    /* Context can only have one progress thread */
+    if (HG_Context_start_progress(context, NULL) == HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Progress thread started twice");
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    for (i = 0; i < NINFLIGHT; i++, count++) {
+        hg_ret = HG_Create(context, addr, rpc_id, &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle.cookie = i;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_progress_cb,
+            &forward_cb_args, &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            HG_Destroy(handle_m[i]);
+            goto done;
+        }
+    }
+
+    /* Progress thread makes progress, callbacks are triggered either by that
+     * thread or by this one once notified */
+    while (hg_atomic_get32(&forward_cb_args.completed) < NINFLIGHT) {
+        if (user_trigger && hg_atomic_get32(&forward_cb_args.notified))
+            HG_Trigger(context, 0, NINFLIGHT, NULL);
+        else
+            hg_time_sleep(hg_time_from_double(0.001));
+    }
+
+    if (hg_atomic_get32(&forward_cb_args.failed)) {
+        HG_TEST_LOG_ERROR("%d forwards did not succeed",
+            hg_atomic_get32(&forward_cb_args.failed));
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+    if (user_trigger && !hg_atomic_get32(&forward_cb_args.notified)) {
+        HG_TEST_LOG_ERROR("Trigger callback was not called");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    if (started && HG_Context_stop_progress(context) != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not stop progress thread");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+    for (i = 0; i < count; i++) {
+        if (HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_progress_stop(hg_context_t *context)
+{
+    struct hg_progress_info progress_info;
+    hg_time_t t1, t2;
+    double elapsed;
+    hg_return_t hg_ret = HG_SUCCESS;
+
+    memset(&progress_info, 0, sizeof(progress_info));
+    progress_info.mode = HG_PROGRESS_BLOCK;
+    progress_info.timeout = HG_TEST_PROGRESS_BLOCK;
+    hg_ret = HG_Context_start_progress(context, &progress_info);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not start progress thread");
+        goto done;
+    }
+
+    /* Let thread block before stopping it */
+    hg_time_sleep(hg_time_from_double(0.1));
+
+    hg_time_get_current(&t1);
+    hg_ret = HG_Context_stop_progress(context);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not stop progress thread");
+        goto done;
+    }
+    hg_time_get_current(&t2);
+
+    /* Thread must be woken up rather than waiting for its block timeout */
+    elapsed = hg_time_to_double(hg_time_subtract(t2, t1)) * 1000.0;
+    if (elapsed >= HG_TEST_PROGRESS_BLOCK / 2) {
+        HG_TEST_LOG_ERROR("Progress thread took %f ms to stop", elapsed);
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_dispatch(hg_context_t *context, hg_request_class_t *request_class,
+    hg_addr_t addr, hg_id_t rpc_id)
+{
+    hg_request_t *request_m[NINFLIGHT];
+    hg_handle_t handle_m[NINFLIGHT];
+    struct forward_context_cb_args forward_cb_args_m[NINFLIGHT];
+    hg_int32_t key_context_ids[HG_TEST_DISPATCH_KEYS];
+    hg_bool_t dispatched = HG_FALSE;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i, count = 0;
+
+    /* Key of each RPC is its cookie */
+    for (i = 0; i < NINFLIGHT; i++, count++) {
+        rpc_handle_t rpc_handle;
+
+        request_m[i] = hg_request_create(request_class);
+        hg_ret = HG_Create(context, addr, rpc_id, &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            hg_request_destroy(request_m[i]);
+            goto done;
+        }
+        rpc_handle.cookie = i % HG_TEST_DISPATCH_KEYS;
+        forward_cb_args_m[i].request = request_m[i];
+        forward_cb_args_m[i].context_id = -1;
+        forward_cb_args_m[i].ret = HG_SUCCESS;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_context_cb,
+            &forward_cb_args_m[i], &rpc_handle);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            HG_Destroy(handle_m[i]);
+            hg_request_destroy(request_m[i]);
+            goto done;
+        }
+    }
+
+    for (i = 0; i < HG_TEST_DISPATCH_KEYS; i++)
+        key_context_ids[i] = -1;
+
+    /* RPCs of same ID and key are processed on the same context */
+    for (i = 0; i < NINFLIGHT; i++) {
+        hg_int32_t *key_context_id =
+            &key_context_ids[i % HG_TEST_DISPATCH_KEYS];
+
+        hg_request_wait(request_m[i], HG_MAX_IDLE_TIME, NULL);
+        if (forward_cb_args_m[i].ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Forward %u completed with %s", i,
+                HG_Error_to_string(forward_cb_args_m[i].ret));
+            hg_ret = HG_PROTOCOL_ERROR;
+            continue;
+        }
+        if (*key_context_id < 0)
+            *key_context_id = forward_cb_args_m[i].context_id;
+        else if (*key_context_id != forward_cb_args_m[i].context_id) {
+            HG_TEST_LOG_ERROR("Key %u processed on contexts %d and %d",
+                i % HG_TEST_DISPATCH_KEYS, *key_context_id,
+                forward_cb_args_m[i].context_id);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (forward_cb_args_m[i].context_id != 0)
+            dispatched = HG_TRUE;
+    }
+
+    /* Keys must not all map to the receiving context */
+    if (!dispatched) {
+        HG_TEST_LOG_ERROR("No RPC was dispatched to another context");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    for (i = 0; i < count; i++) {
+        if (HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        hg_request_destroy(request_m[i]);
+    }
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_lookup_batch(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, const char *name,
+    hg_id_t rpc_id, hg_bool_t cached)
+{
+    hg_class_t *hg_class = HG_Context_get_class(context);
+    const char *names[HG_TEST_LOOKUP_COUNT];
+    hg_addr_t addrs[HG_TEST_LOOKUP_COUNT];
+    struct lookup_cb_args lookup_cb_args;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Target was already looked up, cached address is returned for every
+     * name of batch if addresses are kept, new addresses otherwise */
+    for (i = 0; i < HG_TEST_LOOKUP_COUNT; i++)
+        names[i] = name;
+    lookup_cb_args.request = hg_request_create(request_class);
+    lookup_cb_args.ret = HG_SUCCESS;
+    hg_ret = HG_Addr_lookup_batch(context, hg_test_rpc_lookup_cb,
+        &lookup_cb_args, names, HG_TEST_LOOKUP_COUNT, addrs, HG_OP_ID_IGNORE);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not lookup addresses");
+        hg_request_destroy(lookup_cb_args.request);
+        goto done;
+    }
+    hg_request_wait(lookup_cb_args.request, HG_MAX_IDLE_TIME, NULL);
+    hg_request_destroy(lookup_cb_args.request);
+    if (lookup_cb_args.ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Lookup completed with %s",
+            HG_Error_to_string(lookup_cb_args.ret));
+        hg_ret = lookup_cb_args.ret;
+        goto done;
+    }
+
+    for (i = 0; i < HG_TEST_LOOKUP_COUNT; i++) {
+        if (cached ? addrs[i] != addr
+            : (addrs[i] == HG_ADDR_NULL || addrs[i] == addr)) {
+            HG_TEST_LOG_ERROR("Address %u was %scached", i,
+                cached ? "not " : "");
+            hg_ret = HG_PROTOCOL_ERROR;
+        } else if (hg_test_rpc_timed(context, request_class, addrs[i], rpc_id,
+            i, 0, HG_SUCCESS) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward to address %u", i);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (HG_Addr_free(hg_class, addrs[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not free address");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    if (hg_ret != HG_SUCCESS)
+        goto done;
+
+    /* Names that cannot be resolved fail batch without affecting others */
+    names[HG_TEST_LOOKUP_COUNT - 1] = "invalid";
+    lookup_cb_args.request = hg_request_create(request_class);
+    lookup_cb_args.ret = HG_SUCCESS;
+    hg_ret = HG_Addr_lookup_batch(context, hg_test_rpc_lookup_cb,
+        &lookup_cb_args, names, HG_TEST_LOOKUP_COUNT, addrs, HG_OP_ID_IGNORE);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not lookup addresses");
+        hg_request_destroy(lookup_cb_args.request);
+        goto done;
+    }
+    hg_request_wait(lookup_cb_args.request, HG_MAX_IDLE_TIME, NULL);
+    hg_request_destroy(lookup_cb_args.request);
+    if (lookup_cb_args.ret == HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Lookup of invalid name succeeded");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+    for (i = 0; i < HG_TEST_LOOKUP_COUNT; i++) {
+        hg_bool_t resolved = (i < HG_TEST_LOOKUP_COUNT - 1);
+
+        if (resolved ? (addrs[i] == HG_ADDR_NULL
+            || (cached && addrs[i] != addr)) : addrs[i] != HG_ADDR_NULL) {
+            HG_TEST_LOG_ERROR("Unexpected address %u", i);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (addrs[i] != HG_ADDR_NULL
+            && HG_Addr_free(hg_class, addrs[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not free address");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+
+done:
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_persistent(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id)
+{
+    hg_request_t *request = NULL;
+    hg_handle_t handle;
+    hg_return_t hg_ret = HG_SUCCESS;
+    struct forward_cb_args forward_cb_args;
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_handle_t rpc_open_handle;
+    rpc_open_in_t  rpc_open_in_struct;
+    unsigned int i;
+
+    request = hg_request_create(request_class);
+
+    hg_ret = HG_Create(context, addr, rpc_id, &handle);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create handle");
+        goto done;
+    }
+
+    hg_ret = HG_Set_persistent(handle, HG_TRUE);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not set handle persistent");
+        goto destroy;
+    }
+
+    rpc_open_in_struct.path = rpc_open_path;
+    forward_cb_args.request = request;
+    forward_cb_args.rpc_handle = &rpc_open_handle;
+
+    /* Input is encoded on first forward of each round and sent again as-is
+     * by the forwards that follow, response must match encoded cookie */
+    for (i = 0; i < 2 * HG_TEST_RESEND_COUNT; i++) {
+        hg_bool_t encode = (i % HG_TEST_RESEND_COUNT) == 0;
+
+        if (encode) {
+            rpc_open_handle.cookie = i;
+            rpc_open_in_struct.handle = rpc_open_handle;
+        }
+        forward_cb_args.ret = HG_SUCCESS;
+        hg_request_reset(request);
+        hg_ret = HG_Forward(handle, hg_test_rpc_forward_cb, &forward_cb_args,
+            encode ? &rpc_open_in_struct : NULL);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            goto destroy;
+        }
+
+        hg_request_wait(request, HG_MAX_IDLE_TIME, NULL);
+        if (forward_cb_args.ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Forward %u completed with %s", i,
+                HG_Error_to_string(forward_cb_args.ret));
+            hg_ret = HG_PROTOCOL_ERROR;
+            goto destroy;
+        }
+    }
+
+destroy:
+    if (HG_Destroy(handle) != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not destroy handle");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+
+done:
+    hg_request_destroy(request);
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_coalesce(hg_context_t *context, hg_addr_t addr, hg_id_t rpc_id,
+    unsigned int count, const size_t *path_sizes, const hg_bool_t *due,
+    hg_bool_t cancel)
+{
+    hg_handle_t handle_m[HG_TEST_COALESCE_MAX];
+    struct forward_coalesce_cb_args forward_cb_args_m[HG_TEST_COALESCE_MAX];
+    char *path_m[HG_TEST_COALESCE_MAX] = {NULL};
+    rpc_open_in_t rpc_open_in_struct;
+    struct hg_progress_info progress_info;
+    hg_atomic_int32_t completed;
+    hg_time_t start;
+    hg_bool_t started = HG_FALSE;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i, n_handles = 0, n_forwarded = 0;
+
+    hg_atomic_init32(&completed, 0);
+
+    /* Progress thread is already blocking when requests get coalesced and
+     * must be woken up to send them once their delay expires */
+    memset(&progress_info, 0, sizeof(progress_info));
+    progress_info.mode = HG_PROGRESS_BLOCK;
+    progress_info.timeout = HG_TEST_COALESCE_BLOCK;
+    hg_ret = HG_Context_start_progress(context, &progress_info);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not start progress thread");
+        goto done;
+    }
+    started = HG_TRUE;
+    hg_time_sleep(hg_time_from_double(0.01));
+
+    /* Coalescing delay runs from the first request of a message */
+    hg_time_get_current(&start);
+    for (i = 0; i < count; i++) {
+        path_m[i] = (char *) malloc(path_sizes[i] + 1);
+        if (!path_m[i]) {
+            HG_TEST_LOG_ERROR("Could not allocate path");
+            hg_ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        memset(path_m[i], 'a', path_sizes[i]);
+        path_m[i][path_sizes[i]] = '\0';
+
+        hg_ret = HG_Create(context, addr, rpc_id, &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        n_handles++;
+        rpc_open_in_struct.path = path_m[i];
+        rpc_open_in_struct.handle.cookie = i;
+        forward_cb_args_m[i].completed = &completed;
+        forward_cb_args_m[i].cookie = (hg_int32_t) i;
+        forward_cb_args_m[i].ret = HG_SUCCESS;
+        forward_cb_args_m[i].start = start;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_coalesce_cb,
+            &forward_cb_args_m[i], &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            goto done;
+        }
+        n_forwarded++;
+        if (cancel) {
+            hg_ret = HG_Cancel(handle_m[i]);
+            if (hg_ret != HG_SUCCESS) {
+                HG_TEST_LOG_ERROR("Could not cancel call");
+                goto done;
+            }
+        }
+    }
+
+    while (hg_atomic_get32(&completed) < (hg_util_int32_t) count)
+        hg_time_sleep(hg_time_from_double(0.001));
+
+    /* Requests sent once coalesced message is full, does not fit or carries
+     * extra data complete before coalescing delay, the others are sent once
+     * it expires without waiting for the progress thread block timeout */
+    for (i = 0; i < count; i++) {
+        if (forward_cb_args_m[i].ret != (cancel ? HG_CANCELED : HG_SUCCESS)) {
+            HG_TEST_LOG_ERROR("Forward %u completed with %s", i,
+                HG_Error_to_string(forward_cb_args_m[i].ret));
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (cancel)
+            continue;
+        if (due[i] && forward_cb_args_m[i].elapsed >= HG_TEST_COALESCE_TIMEOUT) {
+            HG_TEST_LOG_ERROR("Forward %u completed after %f ms", i,
+                forward_cb_args_m[i].elapsed);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (!due[i] && (forward_cb_args_m[i].elapsed < HG_TEST_COALESCE_TIMEOUT
+            || forward_cb_args_m[i].elapsed >= HG_TEST_COALESCE_BLOCK / 2)) {
+            HG_TEST_LOG_ERROR("Coalesced forward %u completed after %f ms", i,
+                forward_cb_args_m[i].elapsed);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+
+done:
+    /* Wait for callbacks of requests forwarded before failure */
+    while (hg_ret != HG_SUCCESS && started
+        && hg_atomic_get32(&completed) < (hg_util_int32_t) n_forwarded)
+        hg_time_sleep(hg_time_from_double(0.001));
+    if (started && HG_Context_stop_progress(context) != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not stop progress thread");
+        hg_ret = HG_PROTOCOL_ERROR;
+    }
+    for (i = 0; i < n_handles; i++) {
+        if (HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    for (i = 0; i < count; i++)
+        free(path_m[i]);
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_handle_pool(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id,
+    hg_id_t no_resp_rpc_id)
+{
+    hg_handle_t pooled_handle = HG_HANDLE_NULL;
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i;
+
+    /* Handle destroyed last is taken from pool again, alternate between RPCs
+     * with and without response so that state of previous one must have
+     * been reset */
+    for (i = 0; i < HG_TEST_POOL_ROUNDS; i++) {
+        hg_id_t id = (i % 2) ? no_resp_rpc_id : rpc_id;
+        struct forward_cb_args forward_cb_args;
+        rpc_handle_t rpc_open_handle;
+        rpc_open_in_t rpc_open_in_struct;
+        const struct hg_info *hg_info;
+        hg_handle_t handle;
+
+        hg_ret = HG_Create(context, addr, id, &handle);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        hg_info = HG_Get_info(handle);
+        if (i > 0 && handle != pooled_handle) {
+            HG_TEST_LOG_ERROR("Handle was not reused from pool");
+            hg_ret = HG_PROTOCOL_ERROR;
+        } else if (!hg_info || hg_info->addr != addr || hg_info->id != id
+            || hg_info->context != context || hg_info->context_id != 0) {
+            HG_TEST_LOG_ERROR("Handle info was not reset");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (hg_ret != HG_SUCCESS) {
+            HG_Destroy(handle);
+            goto done;
+        }
+
+        rpc_open_handle.cookie = i;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handle;
+        forward_cb_args.request = hg_request_create(request_class);
+        forward_cb_args.rpc_handle = &rpc_open_handle;
+        forward_cb_args.ret = HG_SUCCESS;
+        hg_ret = HG_Forward(handle, (i % 2) ? hg_test_rpc_forward_no_resp_cb
+            : hg_test_rpc_forward_cb, &forward_cb_args, &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS)
+            HG_TEST_LOG_ERROR("Could not forward call");
+        else {
+            hg_request_wait(forward_cb_args.request, HG_MAX_IDLE_TIME, NULL);
+            hg_ret = forward_cb_args.ret;
+        }
+        hg_request_destroy(forward_cb_args.request);
+
+        if (HG_Destroy(handle) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (hg_ret != HG_SUCCESS)
+            goto done;
+        pooled_handle = handle;
+    }
+
+done:
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_post_count(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, unsigned int *count)
+{
+    hg_handle_t handle;
+    rpc_open_out_t rpc_open_out_struct;
+    hg_return_t hg_ret = HG_SUCCESS;
+
+    hg_ret = HG_Create(context, addr, hg_test_rpc_post_count_id_g, &handle);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not create handle");
+        goto done;
+    }
+
+    hg_ret = HG_Hl_forward_wait(request_class, handle, NULL, HG_MAX_IDLE_TIME);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not forward call");
+        HG_Destroy(handle);
+        goto done;
+    }
+
+    hg_ret = HG_Get_output(handle, &rpc_open_out_struct);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get output");
+        HG_Destroy(handle);
+        goto done;
+    }
+    *count = (unsigned int) rpc_open_out_struct.event_id;
+    HG_Free_output(handle, &rpc_open_out_struct);
+
+    hg_ret = HG_Destroy(handle);
+    if (hg_ret != HG_SUCCESS)
+        HG_TEST_LOG_ERROR("Could not destroy handle");
+
+done:
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_post_limits(hg_context_t *context,
+    hg_request_class_t *request_class, hg_addr_t addr, hg_id_t rpc_id)
+{
+    unsigned int count = HG_TEST_POST_MAX + 1;
+    hg_request_t **request_m = NULL;
+    hg_handle_t *handle_m = NULL;
+    struct forward_cb_args *forward_cb_args_m = NULL;
+    rpc_handle_t *rpc_open_handle_m = NULL;
+    hg_const_string_t rpc_open_path = MERCURY_TESTING_TEMP_DIRECTORY "/test.h5";
+    rpc_open_in_t  rpc_open_in_struct;
+    unsigned int idle_count = 0, burst_count = 0, shrunk_count = 0;
+    hg_return_t hg_ret = HG_SUCCESS;
+    unsigned int i;
+
+    request_m = (hg_request_t **) calloc(count, sizeof(hg_request_t *));
+    handle_m = (hg_handle_t *) calloc(count, sizeof(hg_handle_t));
+    forward_cb_args_m = (struct forward_cb_args *) calloc(count,
+        sizeof(struct forward_cb_args));
+    rpc_open_handle_m = (rpc_handle_t *) calloc(count, sizeof(rpc_handle_t));
+    if (!request_m || !handle_m || !forward_cb_args_m || !rpc_open_handle_m) {
+        HG_TEST_LOG_ERROR("Could not allocate requests");
+        hg_ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    /* Idle target releases handles that it posted initially */
+    hg_time_sleep(hg_time_from_double(HG_TEST_POST_IDLE / 1000.0));
+    hg_ret = hg_test_rpc_post_count(context, request_class, addr, &idle_count);
+    if (hg_ret != HG_SUCCESS)
+        goto done;
+    if (idle_count < HG_TEST_POST_MIN || idle_count >= HG_TEST_POST_MAX) {
+        HG_TEST_LOG_ERROR("Idle target has %u posted handles", idle_count);
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* First request stalls target so that the ones that follow use up its
+     * posted handles, target posts more of them but never more than max */
+    for (i = 0; i < count; i++) {
+        request_m[i] = hg_request_create(request_class);
+        hg_ret = HG_Create(context, addr, i ? rpc_id : hg_test_rpc_sleep_id_g,
+            &handle_m[i]);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not create handle");
+            goto done;
+        }
+        rpc_open_handle_m[i].cookie = i ? i : HG_TEST_RPC_SLEEP;
+        rpc_open_in_struct.path = rpc_open_path;
+        rpc_open_in_struct.handle = rpc_open_handle_m[i];
+        forward_cb_args_m[i].request = request_m[i];
+        forward_cb_args_m[i].rpc_handle = &rpc_open_handle_m[i];
+        forward_cb_args_m[i].ret = HG_SUCCESS;
+        hg_ret = HG_Forward(handle_m[i], hg_test_rpc_forward_cb,
+            &forward_cb_args_m[i], &rpc_open_in_struct);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward call");
+            goto done;
+        }
+    }
+    for (i = 0; i < count; i++) {
+        hg_request_wait(request_m[i], HG_MAX_IDLE_TIME, NULL);
+        if (forward_cb_args_m[i].ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Forward %u completed with %s", i,
+                HG_Error_to_string(forward_cb_args_m[i].ret));
+            hg_ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+    hg_ret = hg_test_rpc_post_count(context, request_class, addr,
+        &burst_count);
+    if (hg_ret != HG_SUCCESS)
+        goto done;
+    if (burst_count <= idle_count || burst_count > HG_TEST_POST_MAX) {
+        HG_TEST_LOG_ERROR("Target has %u posted handles after burst, %u "
+            "before", burst_count, idle_count);
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Handles posted for burst are released once target is idle again */
+    hg_time_sleep(hg_time_from_double(HG_TEST_POST_IDLE / 1000.0));
+    hg_ret = hg_test_rpc_post_count(context, request_class, addr,
+        &shrunk_count);
+    if (hg_ret != HG_SUCCESS)
+        goto done;
+    if (shrunk_count < HG_TEST_POST_MIN || shrunk_count >= burst_count) {
+        HG_TEST_LOG_ERROR("Target has %u posted handles once idle, %u after "
+            "burst", shrunk_count, burst_count);
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    for (i = 0; request_m && i < count; i++) {
+        if (handle_m[i] && HG_Destroy(handle_m[i]) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not destroy handle");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (request_m[i])
+            hg_request_destroy(request_m[i]);
+    }
+    free(request_m);
+    free(handle_m);
+    free(forward_cb_args_m);
+    free(rpc_open_handle_m);
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_test_rpc_route_count(const char *name, const char *transport)
+{
+    size_t transport_len = strlen(transport);
+    unsigned int count = 0;
+    const char *str;
+
+    /* Every NA address string must belong to transport */
+    for (str = name; str; count++) {
+        if (strncmp(str, transport, transport_len) != 0
+            || strncmp(str + transport_len, "://", 3) != 0)
+            return 0;
+        str = strchr(str, ';');
+        if (str)
+            str++;
+    }
+
+    return count;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_test_rpc_routes(hg_context_t *context, hg_request_class_t *request_class,
+    const char *target_name, const char *transport, hg_id_t rpc_id)
+{
+    hg_class_t *hg_class = HG_Context_get_class(context);
+    char self_name[NA_TEST_MAX_ADDR_NAME];
+    hg_size_t self_name_size = sizeof(self_name);
+    hg_addr_t self_addr = HG_ADDR_NULL;
+    const char *str;
+    unsigned int i;
+    hg_return_t hg_ret = HG_SUCCESS;
+
+    /* Self address advertises every route */
+    hg_ret = HG_Addr_self(hg_class, &self_addr);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not get self addr");
+        goto done;
+    }
+    hg_ret = HG_Addr_to_string(hg_class, self_name, &self_name_size,
+        self_addr);
+    HG_Addr_free(hg_class, self_addr);
+    if (hg_ret != HG_SUCCESS) {
+        HG_TEST_LOG_ERROR("Could not convert self addr to string");
+        goto done;
+    }
+    if (hg_test_rpc_route_count(self_name, transport) != HG_TEST_ROUTE_COUNT
+        || hg_test_rpc_route_count(target_name, transport)
+        != HG_TEST_ROUTE_COUNT) {
+        HG_TEST_LOG_ERROR("Self addr %s and target addr %s do not advertise "
+            "%d %s routes", self_name, target_name, HG_TEST_ROUTE_COUNT,
+            transport);
+        hg_ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Lookup selects NA address of a transport that origin has a route for,
+     * even if not advertised first, and reaches target through the route
+     * that NA address belongs to */
+    for (str = target_name, i = 0; str; i++) {
+        const char *end = strchr(str, ';');
+        int len = (int) (end ? (size_t) (end - str) : strlen(str));
+        char name[NA_TEST_MAX_ADDR_NAME], addr_name[NA_TEST_MAX_ADDR_NAME];
+        hg_size_t addr_name_size = sizeof(addr_name);
+        hg_addr_t addr = HG_ADDR_NULL;
+
+        snprintf(name, sizeof(name), HG_TEST_ROUTE_UNKNOWN ";%.*s", len, str);
+        hg_ret = HG_Hl_addr_lookup_wait(context, request_class, name, &addr,
+            HG_MAX_IDLE_TIME);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not lookup %s", name);
+            goto done;
+        }
+        hg_ret = HG_Addr_to_string(hg_class, addr_name, &addr_name_size,
+            addr);
+        if (hg_ret != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not convert addr to string");
+        } else if ((int) strlen(addr_name) != len
+            || strncmp(addr_name, str, (size_t) len) != 0) {
+            HG_TEST_LOG_ERROR("Lookup of %s selected %s", name, addr_name);
+            hg_ret = HG_PROTOCOL_ERROR;
+        } else if (hg_test_rpc_timed(context, request_class, addr, rpc_id, i,
+            0, HG_SUCCESS) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not forward through route %u", i);
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (HG_Addr_free(hg_class, addr) != HG_SUCCESS) {
+            HG_TEST_LOG_ERROR("Could not free address");
+            hg_ret = HG_PROTOCOL_ERROR;
+        }
+        if (hg_ret != HG_SUCCESS)
+            goto done;
+        str = end ? end + 1 : NULL;
+    }
+
+done:
+    return hg_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char *argv[])
+{
+    struct hg_test_info hg_test_info = { 0 };
+    hg_return_t hg_ret;
+    hg_id_t inv_id;
+    int ret = EXIT_SUCCESS;
+
+    /* Initialize the interface */
+    HG_Test_init(argc, argv, &hg_test_info);
+
+    /* Simple RPC test */
+    HG_TEST("simple RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC reset test */
+    HG_TEST("RPC reset");
+    hg_ret = hg_test_rpc_reset(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with tag mask */
+    HG_TEST("tagged RPC");
+    hg_ret = hg_test_rpc_mask(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
         goto done;
     }
     HG_PASSED();
 
+    /* RPC test with no response */
+    HG_TEST("no response RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_no_resp_g,
+        hg_test_rpc_forward_no_resp_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with unregistered ID */
+    HG_TEST("unregistered RPC");
+    inv_id = MERCURY_REGISTER(hg_test_info.hg_class, "unreg_id", void, void, NULL);
+    hg_ret = HG_Deregister(hg_test_info.hg_class, inv_id);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, inv_id, hg_test_rpc_forward_cb);
+    if (hg_ret == HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with invalid ID (not registered on server) */
+    HG_TEST("invalid RPC");
+    inv_id = MERCURY_REGISTER(hg_test_info.hg_class, "inv_id", void, void, NULL);
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, inv_id, hg_test_rpc_forward_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with reset */
+    HG_TEST("reset RPC");
+    hg_ret = hg_test_rpc(hg_test_info.context, hg_test_info.request_class,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_forward_reset_cb);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with deadline */
+    HG_TEST("timed RPC");
+    hg_ret = hg_test_rpc_timed(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g, 100, HG_MAX_IDLE_TIME, HG_SUCCESS);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with deadline expiring before response, RPCs to self do not
+     * time out */
+    if (!hg_test_info.na_test_info.self_send) {
+        HG_TEST("timed out RPC");
+        hg_ret = hg_test_rpc_timed(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_sleep_id_g, HG_TEST_RPC_SLEEP, HG_TEST_RPC_TIMEOUT,
+            HG_TIMEOUT);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with requests rejected by busy target and waiting for a
+     * credit past their deadline, RPCs to self do not use credits and a
+     * dispatching target only stalls the context the first request goes to */
+    if (hg_test_info.flow && !hg_test_info.na_test_info.self_send
+        && !hg_test_info.dispatch) {
+        HG_TEST("busy target and timed RPCs waiting for credits");
+        hg_ret = hg_test_rpc_credits(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_open_id_g);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with structures passed by pointer when sent to self, encoded
+     * otherwise */
+    HG_TEST("self direct RPC");
+    hg_ret = hg_test_rpc_timed(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_direct_g, 100, 0, HG_SUCCESS);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with callback of high priority RPC triggered first */
+    HG_TEST("prioritized RPCs");
+    hg_ret = hg_test_rpc_priority(hg_test_info.context,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g,
+        hg_test_rpc_open_id_high_g);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with callbacks triggered by the progressing thread */
+    HG_TEST("progress and trigger RPCs");
+    hg_ret = hg_test_rpc_progress_and_trigger(hg_test_info.context,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with context progressed by its own thread, callbacks triggered
+     * by that thread or by the user once notified */
+    HG_TEST("progress thread RPCs");
+    hg_ret = hg_test_rpc_progress_thread(hg_test_info.context,
+        hg_test_info.target_addr, hg_test_rpc_open_id_g, HG_PROGRESS_BLOCK,
+        HG_FALSE);
+    if (hg_ret == HG_SUCCESS)
+        hg_ret = hg_test_rpc_progress_thread(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g, HG_PROGRESS_BUSY,
+            HG_FALSE);
+    if (hg_ret == HG_SUCCESS)
+        hg_ret = hg_test_rpc_progress_thread(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g,
+            HG_PROGRESS_SPIN_BLOCK, HG_TRUE);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* Stopping progress thread that blocks, only plugins that expose a poll
+     * fd can be woken up */
+    if (hg_test_info.na_test_info.protocol
+        && strcmp(hg_test_info.na_test_info.protocol, "sm") == 0) {
+        HG_TEST("progress thread stop");
+        hg_ret = hg_test_rpc_progress_stop(hg_test_info.context);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with encoded input sent again as-is */
+    HG_TEST("persistent RPC");
+    hg_ret = hg_test_rpc_persistent(hg_test_info.context,
+        hg_test_info.request_class, hg_test_info.target_addr,
+        hg_test_rpc_open_id_g);
+    if (hg_ret != HG_SUCCESS) {
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    HG_PASSED();
+
+    /* RPC test with target looked up again in batch, self address is not
+     * looked up by name */
+    if (!hg_test_info.na_test_info.self_send) {
+        HG_TEST("batched address lookup");
+        hg_ret = hg_test_rpc_lookup_batch(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_info.na_test_info.target_name, hg_test_rpc_open_id_g,
+            hg_test_info.addr_cache);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with handles taken from pool */
+    if (hg_test_info.handle_pool) {
+        HG_TEST("RPCs with pooled handles");
+        hg_ret = hg_test_rpc_handle_pool(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_open_id_g, hg_test_rpc_open_id_no_resp_g);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with target adapting its posted handles to a burst */
+    if (hg_test_info.post_limits && !hg_test_info.na_test_info.self_send) {
+        HG_TEST("posted handles within bounds");
+        hg_ret = hg_test_rpc_post_limits(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_open_id_g);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with target reached through each of its routes */
+    if (hg_test_info.rails && !hg_test_info.na_test_info.self_send) {
+        char transport[NA_TEST_MAX_ADDR_NAME];
+
+        snprintf(transport, sizeof(transport), "%s+%s",
+            hg_test_info.na_test_info.comm,
+            hg_test_info.na_test_info.protocol);
+        HG_TEST("RPCs through each route of target");
+        hg_ret = hg_test_rpc_routes(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.na_test_info.target_name,
+            transport, hg_test_rpc_open_id_g);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC test with RPCs dispatched by key to contexts of target, only a
+     * separate target makes progress on its secondary contexts */
+    if (hg_test_info.dispatch && !hg_test_info.na_test_info.self_send) {
+        HG_TEST("dispatched RPCs");
+        hg_ret = hg_test_rpc_dispatch(hg_test_info.context,
+            hg_test_info.request_class, hg_test_info.target_addr,
+            hg_test_rpc_context_id_g);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
+    /* RPC tests with requests coalesced into messages sent once full, once
+     * next request does not fit or once their delay expires, requests that
+     * carry extra data are sent on their own */
+    if (hg_test_info.coalesce && !hg_test_info.na_test_info.self_send) {
+        const size_t count_sizes[] = {16, 16, 16, 16};
+        const hg_bool_t count_due[] = {HG_TRUE, HG_TRUE, HG_TRUE, HG_TRUE};
+        const size_t size_sizes[] = {HG_TEST_COALESCE_SIZE / 2,
+            HG_TEST_COALESCE_SIZE / 2};
+        const hg_bool_t size_due[] = {HG_TRUE, HG_FALSE};
+        const size_t timeout_sizes[] = {16, 16, 16};
+        const hg_bool_t timeout_due[] = {HG_FALSE, HG_FALSE, HG_FALSE};
+        const size_t extra_sizes[] = {16, HG_TEST_COALESCE_EXTRA_SIZE, 16};
+        const hg_bool_t extra_due[] = {HG_FALSE, HG_TRUE, HG_FALSE};
+
+        HG_TEST("coalesced RPCs sent on count");
+        hg_ret = hg_test_rpc_coalesce(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g,
+            HG_TEST_COALESCE_COUNT, count_sizes, count_due, HG_FALSE);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+
+        HG_TEST("coalesced RPCs sent on size");
+        hg_ret = hg_test_rpc_coalesce(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g, 2, size_sizes,
+            size_due, HG_FALSE);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+
+        HG_TEST("coalesced RPCs sent on timeout");
+        hg_ret = hg_test_rpc_coalesce(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g,
+            HG_TEST_COALESCE_COUNT - 1, timeout_sizes, timeout_due, HG_FALSE);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+
+        HG_TEST("canceled coalesced RPCs");
+        hg_ret = hg_test_rpc_coalesce(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g,
+            HG_TEST_COALESCE_COUNT - 1, timeout_sizes, timeout_due, HG_TRUE);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+
+        HG_TEST("coalesced RPCs and RPC with extra data");
+        hg_ret = hg_test_rpc_coalesce(hg_test_info.context,
+            hg_test_info.target_addr, hg_test_rpc_open_id_g, 3, extra_sizes,
+            extra_due, HG_FALSE);
+        if (hg_ret != HG_SUCCESS) {
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+        HG_PASSED();
+    }
+
     /* RPC test with multiple handle in flight */
     HG_TEST("concurrent RPCs");
     hg_ret = hg_test_rpc_multiple(hg_test_info.context,
@@ -20,6 +20,9 @@ main(void)
     struct my_entry my_entry1 = { .value = value1 };
     struct my_entry my_entry2 = { .value = value2 };
     struct my_entry *my_entry_ptr;
+    struct my_entry my_entries[HG_TEST_QUEUE_SIZE];
+    void *my_entry_ptrs[HG_TEST_QUEUE_SIZE];
+    int i;
 
     hg_atomic_queue = hg_atomic_queue_alloc(HG_TEST_QUEUE_SIZE);
     if (!hg_atomic_queue) {
@@ -47,6 +50,43 @@ main(void)
         goto done;
     }
 
+    /* Push batch of entries (one slot is always left empty) */
+    for (i = 0; i < HG_TEST_QUEUE_SIZE; i++) {
+        my_entries[i].value = i;
+        my_entry_ptrs[i] = &my_entries[i];
+    }
+    if (hg_atomic_queue_push_n(hg_atomic_queue, my_entry_ptrs,
+        HG_TEST_QUEUE_SIZE) == HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: pushed more entries than queue can hold\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_queue_push_n(hg_atomic_queue, my_entry_ptrs,
+        HG_TEST_QUEUE_SIZE - 1) != HG_UTIL_SUCCESS) {
+        fprintf(stderr, "Error: could not push batch of entries\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    if (hg_atomic_queue_count(hg_atomic_queue) != HG_TEST_QUEUE_SIZE - 1) {
+        fprintf(stderr, "Error: expected %d entries, got %u\n",
+            HG_TEST_QUEUE_SIZE - 1, hg_atomic_queue_count(hg_atomic_queue));
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+    for (i = 0; i < HG_TEST_QUEUE_SIZE - 1; i++) {
+        my_entry_ptr = hg_atomic_queue_pop_mc(hg_atomic_queue);
+        if (!my_entry_ptr || my_entry_ptr->value != i) {
+            fprintf(stderr, "Error: values do not match, expected %d\n", i);
+            ret = EXIT_FAILURE;
+            goto done;
+        }
+    }
+    if (!hg_atomic_queue_is_empty(hg_atomic_queue)) {
+        fprintf(stderr, "Error: queue should be empty\n");
+        ret = EXIT_FAILURE;
+        goto done;
+    }
+
 done:
     hg_atomic_queue_free(hg_atomic_queue);
     return ret;
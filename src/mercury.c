@@ -10,6 +10,7 @@
 
 #include "mercury.h"
 #include "mercury_core.h"
+#include "mercury_private.h"
 #include "mercury_header.h"
 #include "mercury_bulk.h"
 #include "mercury_proc.h"
@@ -47,12 +48,16 @@ struct hg_class {
     /* Callbacks */
     hg_return_t (*handle_create)(hg_handle_t, void *);  /* handle_create */
     void *handle_create_arg;                            /* handle_create arg */
+    hg_uint64_t (*dispatch_key)(hg_handle_t, void *);   /* dispatch_key */
+    void *dispatch_key_arg;                             /* dispatch_key arg */
 };
 
 /* HG context */
 struct hg_context {
     hg_core_context_t *core_context;/* Core context */
     hg_class_t *hg_class;           /* HG class */
+    void *data;                     /* User data */
+    void (*data_free_callback)(void *); /* User data free callback */
 };
 
 /* Info for function map */
@@ -61,6 +66,8 @@ struct hg_proc_info {
     hg_proc_cb_t in_proc_cb;        /* Input proc callback */
     hg_proc_cb_t out_proc_cb;       /* Output proc callback */
     hg_bool_t no_response;          /* RPC response not expected */
+    hg_size_t in_struct_size;       /* Input struct size (self direct) */
+    hg_size_t out_struct_size;      /* Output struct size (self direct) */
     void *data;                     /* User data */
     void (*free_callback)(void *);  /* User data free callback */
 };
@@ -80,6 +87,14 @@ struct hg_handle {
     hg_size_t extra_bulk_buf_size;  /* Extra bulk buffer size */
     hg_bulk_t extra_bulk_handle;    /* Extra bulk handle */
     hg_return_t (*extra_bulk_transfer_cb)(hg_core_handle_t); /* Bulk transfer callback */
+    hg_bool_t is_self;              /* Forwarded to self (self direct) */
+    void *self_in_struct;           /* Origin input struct */
+    void *self_out_struct;          /* Copy of target output struct */
+    void *self_out_buf;             /* Buffer for output struct copy */
+    hg_size_t self_out_buf_size;    /* Output struct copy buffer size */
+    hg_bool_t persistent;           /* Keep encoded input across forwards */
+    hg_bool_t in_encoded;           /* Input buffer holds encoded input */
+    hg_size_t in_payload_size;      /* Size of encoded input */
     void *data;                         /* User data */
     void (*data_free_callback)(void *); /* User data free callback */
 };
@@ -150,6 +165,15 @@ hg_handle_create_cb(
         void *arg
         );
 
+/**
+ * Release handle callback (handle returned to pool).
+ */
+static void
+hg_handle_release_cb(
+        hg_core_handle_t core_handle,
+        void *arg
+        );
+
 /**
  * More data callback.
  */
@@ -175,6 +199,15 @@ hg_core_rpc_cb(
         hg_core_handle_t core_handle
         );
 
+/**
+ * Core dispatch key callback.
+ */
+static hg_uint64_t
+hg_core_dispatch_key_cb(
+        hg_core_handle_t core_handle,
+        void *arg
+        );
+
 /**
  * Core lookup callback.
  */
@@ -183,6 +216,38 @@ hg_core_addr_lookup_cb(
         const struct hg_core_cb_info *callback_info
         );
 
+/**
+ * Size of input/output structure if passed by pointer, 0 if encoded.
+ */
+static HG_INLINE hg_size_t
+hg_struct_direct_size(
+        struct hg_handle *hg_handle,
+        struct hg_proc_info *hg_proc_info,
+        hg_op_t op
+        );
+
+/**
+ * Get input/output structure passed by pointer.
+ */
+static hg_return_t
+hg_get_struct_direct(
+        struct hg_handle *hg_handle,
+        hg_op_t op,
+        void *struct_ptr,
+        hg_size_t struct_size
+        );
+
+/**
+ * Pass input/output structure by pointer.
+ */
+static hg_return_t
+hg_set_struct_direct(
+        struct hg_handle *hg_handle,
+        hg_op_t op,
+        void *struct_ptr,
+        hg_size_t struct_size
+        );
+
 /**
  * Decode and get input/output structure.
  */
@@ -324,6 +389,7 @@ hg_handle_free(void *arg)
     if (hg_handle->out_proc != HG_PROC_NULL)
         hg_proc_free(hg_handle->out_proc);
     hg_mem_aligned_free(hg_handle->extra_bulk_buf);
+    free(hg_handle->self_out_buf);
     hg_header_finalize(&hg_handle->hg_header);
     free(hg_handle);
 }
@@ -336,16 +402,20 @@ hg_handle_create_cb(hg_core_handle_t core_handle, void *arg)
     struct hg_handle *hg_handle;
     hg_return_t ret = HG_SUCCESS;
 
-    hg_handle = hg_handle_create(hg_context->hg_class);
+    /* Private data is kept when handle is taken from pool */
+    hg_handle = (struct hg_handle *) HG_Core_get_data(core_handle);
     if (!hg_handle) {
-        HG_LOG_ERROR("Could not create HG handle");
-        ret = HG_NOMEM_ERROR;
-        goto done;
-    }
-    hg_handle->core_handle = core_handle;
-    hg_handle->hg_info.context = hg_context;
+        hg_handle = hg_handle_create(hg_context->hg_class);
+        if (!hg_handle) {
+            HG_LOG_ERROR("Could not create HG handle");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        hg_handle->core_handle = core_handle;
+        hg_handle->hg_info.context = hg_context;
 
-    HG_Core_set_data(core_handle, hg_handle, hg_handle_free);
+        HG_Core_set_data(core_handle, hg_handle, hg_handle_free);
+    }
 
     /* Call handle create if defined */
     if (hg_context->hg_class->handle_create) {
@@ -361,6 +431,40 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_handle_release_cb(hg_core_handle_t core_handle, void *arg)
+{
+    struct hg_context *hg_context = (struct hg_context *) arg;
+    struct hg_handle *hg_handle =
+        (struct hg_handle *) HG_Core_get_data(core_handle);
+
+    if (!hg_handle)
+        goto done;
+
+    /* Free user data, procs and header are kept for reuse */
+    if (hg_handle->data_free_callback)
+        hg_handle->data_free_callback(hg_handle->data);
+    hg_handle->data = NULL;
+    hg_handle->data_free_callback = NULL;
+    hg_handle->hg_info.context = hg_context;
+    hg_handle->hg_info.addr = HG_ADDR_NULL;
+    hg_handle->hg_info.id = 0;
+    hg_handle->hg_info.context_id = 0;
+    hg_handle->forward_cb = NULL;
+    hg_handle->forward_arg = NULL;
+    hg_handle->respond_cb = NULL;
+    hg_handle->respond_arg = NULL;
+    hg_handle->is_self = HG_FALSE;
+    hg_handle->self_in_struct = NULL;
+    hg_handle->self_out_struct = NULL;
+    hg_handle->persistent = HG_FALSE;
+    hg_handle->in_encoded = HG_FALSE;
+
+done:
+    return;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_more_data_cb(hg_core_handle_t core_handle,
@@ -426,6 +530,10 @@ hg_core_rpc_cb(hg_core_handle_t core_handle)
         (struct hg_handle *) HG_Core_get_data(core_handle);
     hg_return_t ret = HG_SUCCESS;
 
+    /* Report context that runs the callback, which differs from the one
+     * that received the request when it was dispatched */
+    hg_handle->hg_info.context = (struct hg_context *) HG_Core_context_get_data(
+        HG_Core_get_process_context(core_handle));
     hg_handle->hg_info.addr = (hg_addr_t) hg_core_info->addr;
     hg_handle->hg_info.context_id = hg_core_info->context_id;
     hg_handle->hg_info.id = hg_core_info->id;
@@ -443,6 +551,26 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_uint64_t
+hg_core_dispatch_key_cb(hg_core_handle_t core_handle, void *arg)
+{
+    struct hg_class *hg_class = (struct hg_class *) arg;
+    const struct hg_core_info *hg_core_info = HG_Core_get_info(core_handle);
+    struct hg_handle *hg_handle =
+        (struct hg_handle *) HG_Core_get_data(core_handle);
+
+    if (!hg_handle)
+        return 0;
+
+    /* Info is not set yet as RPC callback has not been called */
+    hg_handle->hg_info.addr = (hg_addr_t) hg_core_info->addr;
+    hg_handle->hg_info.context_id = hg_core_info->context_id;
+    hg_handle->hg_info.id = hg_core_info->id;
+
+    return hg_class->dispatch_key(hg_handle, hg_class->dispatch_key_arg);
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_INLINE hg_return_t
 hg_core_addr_lookup_cb(const struct hg_core_cb_info *callback_info)
@@ -462,6 +590,76 @@ hg_core_addr_lookup_cb(const struct hg_core_cb_info *callback_info)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_size_t
+hg_struct_direct_size(struct hg_handle *hg_handle,
+    struct hg_proc_info *hg_proc_info, hg_op_t op)
+{
+    if (!hg_handle->is_self)
+        return 0;
+
+    return (op == HG_INPUT) ? hg_proc_info->in_struct_size :
+        hg_proc_info->out_struct_size;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_get_struct_direct(struct hg_handle *hg_handle, hg_op_t op,
+    void *struct_ptr, hg_size_t struct_size)
+{
+    void *src = (op == HG_INPUT) ? hg_handle->self_in_struct :
+        hg_handle->self_out_struct;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!src) {
+        HG_LOG_ERROR("No structure was passed");
+        ret = HG_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Members are shared, not copied */
+    memcpy(struct_ptr, src, struct_size);
+
+    /* Increment ref count on handle so that it remains valid until free_struct
+     * is called */
+    HG_Core_ref_incr(hg_handle->core_handle);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_set_struct_direct(struct hg_handle *hg_handle, hg_op_t op,
+    void *struct_ptr, hg_size_t struct_size)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Origin keeps input structure valid until its forward completes */
+    if (op == HG_INPUT) {
+        hg_handle->self_in_struct = struct_ptr;
+        goto done;
+    }
+
+    /* Output structure usually lives on the stack of the RPC callback and is
+     * gone by the time the origin gets it, keep a copy in the handle */
+    if (hg_handle->self_out_buf_size < struct_size) {
+        void *buf = realloc(hg_handle->self_out_buf, struct_size);
+        if (!buf) {
+            HG_LOG_ERROR("Could not allocate output structure copy");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        hg_handle->self_out_buf = buf;
+        hg_handle->self_out_buf_size = struct_size;
+    }
+    memcpy(hg_handle->self_out_buf, struct_ptr, struct_size);
+    hg_handle->self_out_struct = hg_handle->self_out_buf;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_get_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
@@ -476,6 +674,7 @@ hg_get_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
     struct hg_header_hash *hg_header_hash = NULL;
 #endif
     hg_size_t header_offset = hg_header_get_size(op);
+    hg_size_t struct_size;
     hg_return_t ret = HG_SUCCESS;
 
     switch (op) {
@@ -522,6 +721,14 @@ hg_get_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
             ret = HG_INVALID_PARAM;
             goto done;
     }
+
+    /* Structure was passed by pointer, nothing to decode */
+    struct_size = hg_struct_direct_size(hg_handle, hg_proc_info, op);
+    if (struct_size) {
+        ret = hg_get_struct_direct(hg_handle, op, struct_ptr, struct_size);
+        goto done;
+    }
+
     if (!proc_cb) {
         HG_LOG_ERROR("No proc set, proc must be set in HG_Register()");
         ret = HG_PROTOCOL_ERROR;
@@ -602,6 +809,7 @@ hg_set_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
     struct hg_header_hash *hg_header_hash = NULL;
 #endif
     hg_size_t header_offset = hg_header_get_size(op);
+    hg_size_t struct_size;
     hg_return_t ret = HG_SUCCESS;
 
     switch (op) {
@@ -648,6 +856,15 @@ hg_set_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
             ret = HG_INVALID_PARAM;
             goto done;
     }
+
+    /* Pass structure by pointer instead of encoding it */
+    struct_size = hg_struct_direct_size(hg_handle, hg_proc_info, op);
+    if (struct_size && struct_ptr) {
+        ret = hg_set_struct_direct(hg_handle, op, struct_ptr, struct_size);
+        *payload_size = 0;
+        goto done;
+    }
+
     if (!proc_cb || !struct_ptr) {
         /* Silently skip */
         *payload_size = 0;
@@ -798,6 +1015,10 @@ hg_free_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
         goto done;
     }
 
+    /* Members of structure passed by pointer belong to the other side */
+    if (hg_struct_direct_size(hg_handle, hg_proc_info, op))
+        goto release;
+
     /* Reset proc */
     ret = hg_proc_reset(proc, NULL, 0, HG_FREE);
     if (ret != HG_SUCCESS) {
@@ -812,6 +1033,7 @@ hg_free_struct(struct hg_handle *hg_handle, struct hg_proc_info *hg_proc_info,
         goto done;
     }
 
+release:
     /* Decrement ref count or free */
     ret = HG_Core_destroy(hg_handle->core_handle);
     if (ret != HG_SUCCESS) {
@@ -888,11 +1110,14 @@ hg_get_extra_input(struct hg_handle *hg_handle,
         goto done;
     }
 
-    /* Read bulk data here and wait for the data to be here  */
+    /* Read bulk data here and wait for the data to be here, extra input is
+     * always acquired on the context that received the request */
     hg_handle->extra_bulk_transfer_cb = done_cb;
-    ret = HG_Bulk_transfer_id(hg_handle->hg_info.context, hg_get_extra_input_cb,
-        hg_handle, HG_BULK_PULL, (hg_addr_t) hg_core_info->addr,
-        hg_core_info->context_id, hg_handle->extra_bulk_handle, 0,
+    ret = HG_Bulk_transfer_id(
+        (struct hg_context *) HG_Core_context_get_data(hg_core_info->context),
+        hg_get_extra_input_cb, hg_handle, HG_BULK_PULL,
+        (hg_addr_t) hg_core_info->addr, hg_core_info->context_id,
+        hg_handle->extra_bulk_handle, 0,
         local_in_handle, 0, hg_handle->extra_bulk_buf_size,
         HG_OP_ID_IGNORE /* TODO not used for now */);
     if (ret != HG_SUCCESS) {
@@ -1021,6 +1246,7 @@ HG_Error_to_string(hg_return_t errnum)
     HG_ERROR_STRING_MACRO(HG_CHECKSUM_ERROR, errnum, hg_error_string);
     HG_ERROR_STRING_MACRO(HG_CANCELED, errnum, hg_error_string);
     HG_ERROR_STRING_MACRO(HG_OTHER_ERROR, errnum, hg_error_string);
+    HG_ERROR_STRING_MACRO(HG_BUSY, errnum, hg_error_string);
 
     return hg_error_string;
 }
@@ -1257,6 +1483,33 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Class_set_dispatch_key_callback(hg_class_t *hg_class,
+    hg_uint64_t (*callback)(hg_handle_t, void *), void *arg)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_class) {
+        HG_LOG_ERROR("NULL HG class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_class->dispatch_key = callback;
+    hg_class->dispatch_key_arg = arg;
+
+    ret = HG_Core_class_set_dispatch_key_callback(hg_class->core_class,
+        callback ? hg_core_dispatch_key_cb : NULL, hg_class);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not set dispatch key callback");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_context_t *
 HG_Context_create(hg_class_t *hg_class)
@@ -1296,10 +1549,18 @@ HG_Context_create_id(hg_class_t *hg_class, hg_uint8_t id)
         goto done;
     }
 
+    /* Core context data points back to HG context, user data is kept in HG
+     * context */
+    HG_Core_context_set_data(hg_context->core_context, hg_context, NULL);
+
     /* Set handle create callback */
     HG_Core_context_set_handle_create_callback(hg_context->core_context,
         hg_handle_create_cb, hg_context);
 
+    /* Set handle release callback (keeps private data of pooled handles) */
+    HG_Core_context_set_handle_release_callback(hg_context->core_context,
+        hg_handle_release_cb, hg_context);
+
     /* If we are listening, start posting requests */
     if (NA_Is_listening(HG_Core_class_get_na(hg_class->core_class))) {
         ret = HG_Core_context_post(hg_context->core_context, request_count,
@@ -1331,6 +1592,8 @@ HG_Context_destroy(hg_context_t *context)
         HG_LOG_ERROR("Could not destroy HG core context");
         goto done;
     }
+    if (context->data_free_callback)
+        context->data_free_callback(context->data);
     free(context);
 
 done:
@@ -1371,6 +1634,23 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+unsigned int
+HG_Context_get_post_count(hg_context_t *context)
+{
+    unsigned int ret = 0;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG context");
+        goto done;
+    }
+
+    ret = HG_Core_context_get_post_count(context->core_context);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Context_set_data(hg_context_t *context, void *data,
@@ -1384,7 +1664,8 @@ HG_Context_set_data(hg_context_t *context, void *data,
         goto done;
     }
 
-    ret = HG_Core_context_set_data(context->core_context, data, free_callback);
+    context->data = data;
+    context->data_free_callback = free_callback;
 
 done:
     return ret;
@@ -1401,7 +1682,44 @@ HG_Context_get_data(const hg_context_t *context)
         goto done;
     }
 
-    ret = HG_Core_context_get_data(context->core_context);
+    ret = context->data;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_start_progress(hg_context_t *context,
+    const struct hg_progress_info *info)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = HG_Core_context_start_progress(context->core_context, info);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Context_stop_progress(hg_context_t *context)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = HG_Core_context_stop_progress(context->core_context);
 
 done:
     return ret;
@@ -1726,6 +2044,64 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_self_direct(hg_class_t *hg_class, hg_id_t id,
+    hg_size_t in_struct_size, hg_size_t out_struct_size)
+{
+    struct hg_proc_info *hg_proc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_class) {
+        HG_LOG_ERROR("NULL HG class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_thread_spin_lock(&hg_class->register_lock);
+
+    /* Retrieve proc function from function map */
+    hg_proc_info = (struct hg_proc_info *) HG_Core_registered_data(
+        hg_class->core_class, id);
+    if (!hg_proc_info) {
+        HG_LOG_ERROR("Could not get registered data");
+        ret = HG_NO_MATCH;
+        hg_thread_spin_unlock(&hg_class->register_lock);
+        goto done;
+    }
+
+    hg_proc_info->in_struct_size = in_struct_size;
+    hg_proc_info->out_struct_size = out_struct_size;
+
+    hg_thread_spin_unlock(&hg_class->register_lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Registered_priority(hg_class_t *hg_class, hg_id_t id,
+    hg_priority_t priority)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_class) {
+        HG_LOG_ERROR("NULL HG class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = HG_Core_registered_priority(hg_class->core_class, id, priority);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not set priority class");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Addr_lookup(hg_context_t *context, hg_cb_t callback, void *arg,
@@ -1764,6 +2140,52 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Addr_lookup_batch(hg_context_t *context, hg_cb_t callback, void *arg,
+    const char **names, unsigned int count, hg_addr_t *addrs,
+    hg_op_id_t *op_id)
+{
+    struct hg_op_id *hg_op_id = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    /* Allocate op_id */
+    hg_op_id = (struct hg_op_id *) malloc(sizeof(struct hg_op_id));
+    if (!hg_op_id) {
+        HG_LOG_ERROR("Could not allocate HG operation ID");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_op_id->context = context;
+    hg_op_id->type = HG_CB_LOOKUP;
+    hg_op_id->callback = callback;
+    hg_op_id->arg = arg;
+    hg_op_id->info.lookup.hg_addr = HG_ADDR_NULL;
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_OP_ID_IGNORE)
+        *op_id = (hg_op_id_t) hg_op_id;
+
+    /* HG addresses are HG core addresses */
+    ret = HG_Core_addr_lookup_batch(context->core_context,
+        hg_core_addr_lookup_cb, hg_op_id, names, count,
+        (hg_core_addr_t *) addrs, &hg_op_id->info.lookup.core_op_id);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not lookup addresses");
+        free(hg_op_id);
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Addr_free(hg_class_t *hg_class, hg_addr_t addr)
@@ -1800,6 +2222,23 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Addr_is_self(hg_class_t *hg_class, hg_addr_t addr)
+{
+    hg_bool_t ret = HG_FALSE;
+
+    if (!hg_class) {
+        HG_LOG_ERROR("NULL HG class");
+        goto done;
+    }
+
+    ret = HG_Core_addr_is_self(hg_class->core_class, (hg_core_addr_t) addr);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Addr_dup(hg_class_t *hg_class, hg_addr_t addr, hg_addr_t *new_addr)
@@ -1916,6 +2355,9 @@ HG_Reset(hg_handle_t handle, hg_addr_t addr, hg_id_t id)
     handle->hg_info.id = id;
     handle->hg_info.context_id = 0;
 
+    /* Encoded input was meant for previous RPC */
+    handle->in_encoded = HG_FALSE;
+
 done:
     return ret;
 }
@@ -2248,9 +2690,36 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Set_persistent(hg_handle_t handle, hg_bool_t persistent)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!handle) {
+        HG_LOG_ERROR("NULL HG handle");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    handle->persistent = persistent;
+    handle->in_encoded = HG_FALSE;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
+{
+    return HG_Forward_timed(handle, callback, arg, in_struct, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Forward_timed(hg_handle_t handle, hg_cb_t callback, void *arg,
+    void *in_struct, unsigned int timeout)
 {
     struct hg_proc_info *hg_proc_info;
     hg_size_t payload_size;
@@ -2277,12 +2746,40 @@ HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
         goto done;
     }
 
-    /* Set input struct */
-    ret = hg_set_struct(handle, hg_proc_info, HG_INPUT, in_struct,
-        &payload_size, &more_data);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not set input");
-        goto done;
+    /* Structures are passed by pointer when forwarding to self, requests to
+     * self otherwise go through NA and must be encoded */
+#ifdef HG_HAS_SELF_FORWARD
+    handle->is_self = (hg_proc_info->in_struct_size
+        || hg_proc_info->out_struct_size)
+        && handle->hg_info.addr != HG_ADDR_NULL
+        && HG_Core_addr_is_self(handle->hg_info.hg_class->core_class,
+            (hg_core_addr_t) handle->hg_info.addr);
+#else
+    handle->is_self = HG_FALSE;
+#endif
+    handle->self_in_struct = NULL;
+    handle->self_out_struct = NULL;
+
+    if (handle->persistent && handle->in_encoded && !in_struct) {
+        /* Input encoded by a previous forward is still in the buffer, send
+         * it again as-is */
+        payload_size = handle->in_payload_size;
+    } else {
+        /* Set input struct */
+        handle->in_encoded = HG_FALSE;
+        ret = hg_set_struct(handle, hg_proc_info, HG_INPUT, in_struct,
+            &payload_size, &more_data);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not set input");
+            goto done;
+        }
+
+        /* Extra input buffer is released when forward completes and input
+         * passed by pointer is not encoded, neither can be sent again */
+        if (handle->persistent && !more_data && !handle->self_in_struct) {
+            handle->in_encoded = HG_TRUE;
+            handle->in_payload_size = payload_size;
+        }
     }
 
     /* Set more data flag on handle so that handle_more_callback is triggered */
@@ -2294,8 +2791,8 @@ HG_Forward(hg_handle_t handle, hg_cb_t callback, void *arg, void *in_struct)
         flags |= HG_CORE_NO_RESPONSE;
 
     /* Send request */
-    ret = HG_Core_forward(handle->core_handle, hg_core_forward_cb, handle,
-        flags, payload_size);
+    ret = HG_Core_forward_timed(handle->core_handle, hg_core_forward_cb,
+        handle, flags, payload_size, timeout);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not forward call");
         goto done;
@@ -2396,6 +2893,26 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Progress_and_trigger(hg_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = HG_Core_progress_and_trigger(context->core_context, timeout,
+        max_count, actual_count);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Cancel(hg_handle_t handle)
@@ -251,6 +251,26 @@ HG_Class_set_handle_create_callback(
         void *arg
         );
 
+/**
+ * Set callback returning the user key of a received RPC, used to select the
+ * context that processes the RPC when the class was initialized with the
+ * HG_DISPATCH_HASH policy. RPCs with the same ID and key are processed on the
+ * same context. The callback is called from the receiving context before the
+ * RPC callback and may only use HG_Get_info() and HG_Get_input_buf().
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Class_set_dispatch_key_callback(
+        hg_class_t *hg_class,
+        hg_uint64_t (*callback)(hg_handle_t, void *),
+        void *arg
+        );
+
 /**
  * Create a new context. Must be destroyed by calling HG_Context_destroy().
  *
@@ -326,6 +346,19 @@ HG_Context_get_id(
         const hg_context_t *context
         );
 
+/**
+ * Retrieve number of handles that context has posted to receive requests,
+ * including those that are in use.
+ *
+ * \param context [IN]          pointer to HG context
+ *
+ * \return Number of posted handles
+ */
+HG_EXPORT unsigned int
+HG_Context_get_post_count(
+        hg_context_t *context
+        );
+
 /**
  * Associate user data to context. When HG_Context_destroy() is called,
  * free_callback (if defined) is called to free the associated data.
@@ -355,6 +388,38 @@ HG_Context_get_data(
         const hg_context_t *context
         );
 
+/**
+ * Start a thread that makes progress on the context using the polling policy
+ * defined in info (default policy if NULL). Unless a trigger_callback is set,
+ * callbacks are also executed from that thread; otherwise trigger_callback is
+ * called whenever progress completed operations and the user is responsible
+ * for calling HG_Trigger() from its own executor. The thread is stopped by
+ * HG_Context_stop_progress() or when the context is destroyed.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param info [IN]             pointer to progress info (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Context_start_progress(
+        hg_context_t *context,
+        const struct hg_progress_info *info
+        );
+
+/**
+ * Stop progress thread previously started with HG_Context_start_progress() and
+ * wait for its completion.
+ *
+ * \param context [IN]          pointer to HG context
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Context_stop_progress(
+        hg_context_t *context
+        );
+
 /**
  * Dynamically register a function func_name as an RPC as well as the
  * RPC callback executed when the RPC request ID associated to func_name is
@@ -528,6 +593,55 @@ HG_Registered_disable_response(
         hg_bool_t disable
         );
 
+/**
+ * Set priority class of a registered RPC ID. Callbacks of RPCs of higher
+ * classes are triggered first, lower classes are still periodically triggered
+ * first so that they do not starve. By default, all RPCs are of class
+ * HG_PRIORITY_NORMAL.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param priority [IN]         priority class:
+ *                                  - HG_PRIORITY_HIGH
+ *                                  - HG_PRIORITY_NORMAL
+ *                                  - HG_PRIORITY_LOW
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Registered_priority(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        hg_priority_t priority
+        );
+
+/**
+ * Pass input and output structures of a registered RPC ID by pointer when
+ * the RPC is forwarded to self, instead of encoding and decoding them with
+ * their proc callbacks. HG_Get_input() and HG_Get_output() then make a
+ * shallow copy of the structure: memory its members point to is shared and
+ * HG_Free_input() / HG_Free_output() do not free it. The origin must keep the
+ * input structure and what it points to valid until its forward callback is
+ * triggered, memory pointed to by the output structure must remain valid
+ * until the origin has called HG_Free_output(). HG_Get_input_buf() and
+ * HG_Get_output_buf() return no payload for these structures. Sizes of 0
+ * (default) encode the structure as for any other target.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param id [IN]               registered function ID
+ * \param in_struct_size [IN]   size of input structure (0 to encode)
+ * \param out_struct_size [IN]  size of output structure (0 to encode)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Registered_self_direct(
+        hg_class_t *hg_class,
+        hg_id_t id,
+        hg_size_t in_struct_size,
+        hg_size_t out_struct_size
+        );
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Addr_free(). After completion, user callback is
@@ -550,6 +664,35 @@ HG_Addr_lookup(
         hg_op_id_t   *op_id
         );
 
+/**
+ * Lookup addrs from a batch of peer addresses/names. All lookups are issued
+ * at once and user callback is placed into a completion queue once they have
+ * all completed, it can then be triggered using HG_Trigger(). Resolved
+ * addresses are stored in addrs and need to be freed by calling
+ * HG_Addr_free(), names that could not be resolved are set to HG_ADDR_NULL
+ * and the callback reports the error.
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of count addresses
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Addr_lookup_batch(
+        hg_context_t *context,
+        hg_cb_t callback,
+        void *arg,
+        const char **names,
+        unsigned int count,
+        hg_addr_t *addrs,
+        hg_op_id_t *op_id
+        );
+
 /**
  * Free the addr from the list of peers.
  *
@@ -578,6 +721,21 @@ HG_Addr_self(
         hg_addr_t  *addr
         );
 
+/**
+ * Indicate whether address refers to self, RPCs forwarded to it are then
+ * processed locally without going through NA.
+ *
+ * \param hg_class [IN]         pointer to HG class
+ * \param addr [IN]             abstract address
+ *
+ * \return HG_TRUE if address is self or HG_FALSE otherwise
+ */
+HG_EXPORT hg_bool_t
+HG_Addr_is_self(
+        hg_class_t *hg_class,
+        hg_addr_t   addr
+        );
+
 /**
  * Duplicate an existing HG abstract address. The duplicated address can be
  * stored for later use and the origin address be freed safely. The duplicated
@@ -861,12 +1019,34 @@ HG_Set_target_id(
         hg_uint8_t id
         );
 
+/**
+ * Keep the input encoded by the next forward on handle in its buffer, later
+ * calls to HG_Forward() on handle with a NULL \in_struct then send that
+ * input again as-is without encoding it (nor computing its checksums). Input
+ * is encoded again when a non-NULL \in_struct is passed. Encoded input is
+ * dropped by HG_Reset() and is not kept for inputs that do not fit into the
+ * handle buffer or that are passed by pointer when forwarding to self.
+ * Handles taken from the pool are not persistent.
+ *
+ * \param handle [IN]           HG handle
+ * \param persistent [IN]       boolean
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Set_persistent(
+        hg_handle_t handle,
+        hg_bool_t persistent
+        );
+
 /**
  * Forward a call to a local/remote target using an existing HG handle.
  * Input structure can be passed and parameters serialized using a previously
  * registered input proc. After completion, user callback is placed into a
  * completion queue and can be triggered using HG_Trigger(). RPC output can
  * be queried using HG_Get_output() and freed using HG_Free_output().
+ * Overloaded targets may reject the call, the callback then reports HG_BUSY
+ * and no output is available.
  *
  * \remark This routine is internally equivalent to:
  *   - HG_Core_get_input()
@@ -888,6 +1068,28 @@ HG_Forward(
         void *in_struct
         );
 
+/**
+ * Forward a call using an existing HG handle, same as HG_Forward() but the
+ * call is canceled if it has not completed within \timeout milliseconds and
+ * the callback then reports HG_TIMEOUT. A timeout of 0 disables the deadline.
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param in_struct [IN]        pointer to input structure
+ * \param timeout [IN]          timeout (in milliseconds)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Forward_timed(
+        hg_handle_t handle,
+        hg_cb_t callback,
+        void *arg,
+        void *in_struct,
+        unsigned int timeout
+        );
+
 /**
  * Respond back to origin using an existing HG handle.
  * Output structure can be passed and parameters serialized using a previously
@@ -952,6 +1154,31 @@ HG_Trigger(
         unsigned int *actual_count
         );
 
+/**
+ * Make progress and execute at most max_count callbacks, combining HG_Progress()
+ * and HG_Trigger(). Callbacks of operations that complete during progress on the
+ * calling thread are executed directly once progress returns, without being
+ * placed into the completion queue, which saves a queue round trip and a
+ * wake-up per operation. Intended for event loops that use a single thread to
+ * both progress and trigger a context. Remaining callbacks are placed into the
+ * completion queue and can be triggered by a subsequent call.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param max_count [IN]        maximum number of callbacks triggered
+ * \param actual_count [IN]     actual number of callbacks triggered
+ *
+ * \return HG_SUCCESS if any callback was triggered, HG_TIMEOUT if none or
+ * corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Progress_and_trigger(
+        hg_context_t *context,
+        unsigned int timeout,
+        unsigned int max_count,
+        unsigned int *actual_count
+        );
+
 /**
  * Cancel an ongoing operation.
  *
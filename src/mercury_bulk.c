@@ -19,12 +19,14 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
 
 /****************/
 /* Local Macros */
 /****************/
 #define HG_BULK_MIN(a, b) \
     (a < b) ? a : b
+#define HG_BULK_ROUTE_NAME_MAX 64 /* Max length of "class+protocol" string */
 
 /* Remove warnings when plugin does not use callback arguments */
 #if defined(__cplusplus)
@@ -49,11 +51,21 @@ struct hg_context {
     hg_core_context_t *core_context;      /* Core context */
 };
 
+/* Rail that part of a bulk transfer goes through */
+struct hg_bulk_rail {
+    unsigned int route;                   /* Index of NA class in HG class */
+    na_class_t *na_class;                 /* NA class */
+    na_context_t *na_context;             /* NA context */
+    na_addr_t na_origin_addr;             /* NA address of origin on rail */
+    unsigned int op_start;                /* Index of first NA operation */
+};
+
 /* HG Bulk op id */
 struct hg_bulk_op_id {
     hg_context_t *context;                /* Context */
-    na_class_t *na_class;                 /* NA class */
-    na_context_t *na_context;             /* NA context */
+    struct hg_bulk_rail rails[HG_CORE_ROUTE_MAX]; /* Rails transfer is
+                                             striped across */
+    unsigned int rail_count;              /* Number of rails */
     hg_cb_t callback;                     /* Callback */
     void *arg;                            /* Callback arguments */
     hg_atomic_int32_t completed;          /* Operation completed TODO needed ? */
@@ -66,6 +78,9 @@ struct hg_bulk_op_id {
     na_op_id_t *na_op_ids ;               /* NA operations IDs */
     hg_bool_t is_self;                    /* Is self operation */
     struct hg_completion_entry hg_completion_entry; /* Entry in completion queue */
+    struct hg_core_timer timer;           /* Deadline timer */
+    hg_bool_t deadline;                   /* Deadline timer armed */
+    hg_atomic_int32_t timed_out;          /* Operation canceled by deadline */
 };
 
 /* Segment used to transfer data and map to NA layer */
@@ -94,18 +109,17 @@ typedef na_return_t (*na_bulk_op_t)(
 
 /* Note to self, get_serialize_size may be updated accordingly */
 struct hg_bulk {
-    na_class_t *na_class;                /* NA class */
-#ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class;             /* NA SM class */
-#endif
+    na_class_t *na_classes[HG_CORE_ROUTE_MAX]; /* NA classes of HG routes */
+    unsigned int na_class_count;         /* Number of NA classes */
     hg_size_t total_size;                /* Total size of data abstracted */
     hg_uint32_t segment_count;           /* Number of segments */
     struct hg_bulk_segment *segments;    /* Array of segments */
-    na_mem_handle_t *na_mem_handles;     /* Array of NA memory handles */
-#ifdef HG_HAS_SM_ROUTING
-    na_mem_handle_t *na_sm_mem_handles;  /* Array of NA SM memory handles */
-#endif
-    hg_uint32_t na_mem_handle_count;     /* Number of handles */
+    na_mem_handle_t *na_mem_handles[HG_CORE_ROUTE_MAX]; /* Arrays of NA memory
+                                            handles, one per NA class (NULL
+                                            if not available on that class) */
+    hg_uint32_t na_mem_handle_count;     /* Number of handles per NA class */
+    char *rail_addr_string;              /* Address string of owner on all
+                                            its rails (NULL if none) */
     hg_bool_t segment_published;         /* NA memory handles published */
     hg_bool_t segment_alloc;             /* Allocated memory to mirror data */
     hg_uint8_t flags;                    /* Permission flags */
@@ -178,9 +192,8 @@ hg_bulk_transfer_cb(
 static hg_return_t
 hg_bulk_transfer_pieces(
         na_bulk_op_t na_bulk_op,
-        na_addr_t origin_addr,
+        struct hg_bulk_rail *hg_bulk_rail,
         na_uint8_t origin_id,
-        hg_bool_t use_sm,
         struct hg_bulk *hg_bulk_origin,
         hg_size_t origin_segment_start_index,
         hg_size_t origin_segment_start_offset,
@@ -193,6 +206,24 @@ hg_bulk_transfer_pieces(
         unsigned int *na_op_count
         );
 
+/**
+ * Transfer range of data through one rail (private).
+ */
+static hg_return_t
+hg_bulk_transfer_rail(
+        na_bulk_op_t na_bulk_op,
+        struct hg_bulk_rail *hg_bulk_rail,
+        na_uint8_t origin_id,
+        struct hg_bulk *hg_bulk_origin,
+        hg_size_t origin_offset,
+        struct hg_bulk *hg_bulk_local,
+        hg_size_t local_offset,
+        hg_size_t size,
+        hg_bool_t scatter_gather,
+        struct hg_bulk_op_id *hg_bulk_op_id,
+        unsigned int *na_op_count
+        );
+
 /**
  * Transfer data.
  */
@@ -209,9 +240,18 @@ hg_bulk_transfer(
         struct hg_bulk *hg_bulk_local,
         hg_size_t local_offset,
         hg_size_t size,
+        unsigned int timeout,
         hg_op_id_t *op_id
         );
 
+/**
+ * Cancel operation ID once its deadline has expired.
+ */
+static void
+hg_bulk_deadline_cb(
+        void *arg
+        );
+
 /**
  * Complete operation ID.
  */
@@ -230,6 +270,25 @@ hg_core_completion_add(
         hg_bool_t self_notify
         );
 
+/**
+ * Arm timer in timer wheel of context.
+ */
+extern void
+hg_core_timer_add(
+        struct hg_core_context *core_context,
+        struct hg_core_timer *hg_core_timer,
+        unsigned int timeout
+        );
+
+/**
+ * Disarm timer, wait for its callback if it is being called.
+ */
+extern void
+hg_core_timer_remove(
+        struct hg_core_context *core_context,
+        struct hg_core_timer *hg_core_timer
+        );
+
 /**
  * Trigger callback from bulk op ID.
  */
@@ -356,6 +415,18 @@ done:
     return ret;
 }
 
+/**
+ * Name identifying NA class in serialized handles ("class+protocol")
+ */
+static HG_INLINE hg_uint8_t
+hg_bulk_na_class_name(na_class_t *na_class, char *name)
+{
+    int len = snprintf(name, HG_BULK_ROUTE_NAME_MAX, "%s+%s",
+        NA_Get_class_name(na_class), NA_Get_class_protocol(na_class));
+
+    return (hg_uint8_t) HG_BULK_MIN(len, HG_BULK_ROUTE_NAME_MAX - 1);
+}
+
 /*******************/
 /* Local Variables */
 /*******************/
@@ -369,13 +440,8 @@ hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
     struct hg_bulk *hg_bulk = NULL;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
-    na_class_t *na_class = HG_Core_class_get_na(hg_class->core_class);
-#ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class = HG_Core_class_get_na_sm(hg_class->core_class);
-#endif
-    hg_bool_t use_register_segments = (hg_bool_t)
-        (na_class->mem_handle_create_segments && count > 1);
-    unsigned int i;
+    hg_bool_t use_register_segments = (hg_bool_t) (count > 1);
+    unsigned int i, j;
 
     hg_bulk = (struct hg_bulk *) malloc(sizeof(struct hg_bulk));
     if (!hg_bulk) {
@@ -384,10 +450,24 @@ hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
         goto done;
     }
     memset(hg_bulk, 0, sizeof(struct hg_bulk));
-    hg_bulk->na_class = na_class;
-#ifdef HG_HAS_SM_ROUTING
-    hg_bulk->na_sm_class = na_sm_class;
-#endif
+    hg_bulk->na_class_count =
+        HG_Core_class_get_na_route_count(hg_class->core_class);
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        hg_bulk->na_classes[j] =
+            HG_Core_class_get_na_route(hg_class->core_class, j);
+        /* Segments can only be registered at once if all classes can */
+        if (!hg_bulk->na_classes[j]->mem_handle_create_segments)
+            use_register_segments = HG_FALSE;
+    }
+    if (HG_Core_class_get_rail_addr_string(hg_class->core_class)) {
+        hg_bulk->rail_addr_string = strdup(
+            HG_Core_class_get_rail_addr_string(hg_class->core_class));
+        if (!hg_bulk->rail_addr_string) {
+            HG_LOG_ERROR("Could not duplicate rail address string");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+    }
     hg_bulk->segment_count = count;
     hg_bulk->na_mem_handle_count = (use_register_segments) ? 1 : count;
     hg_bulk->segment_alloc = (!buf_ptrs);
@@ -424,100 +504,59 @@ hg_bulk_create(struct hg_class *hg_class, hg_uint32_t count,
         }
     }
 
-    /* Allocate NA memory handles */
-    hg_bulk->na_mem_handles = (na_mem_handle_t *) malloc(
-        hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-    if (!hg_bulk->na_mem_handles) {
-        HG_LOG_ERROR("Could not allocate mem handle array");
-        ret = HG_NOMEM_ERROR;
-        goto done;
-    }
-#ifdef HG_HAS_SM_ROUTING
-    if (na_sm_class) {
-        hg_bulk->na_sm_mem_handles = (na_mem_handle_t *) malloc(
+    /* Allocate NA memory handles of each NA class */
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        hg_bulk->na_mem_handles[j] = (na_mem_handle_t *) malloc(
             hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-        if (!hg_bulk->na_sm_mem_handles) {
-            HG_LOG_ERROR("Could not allocate SM mem handle array");
+        if (!hg_bulk->na_mem_handles[j]) {
+            HG_LOG_ERROR("Could not allocate mem handle array");
             ret = HG_NOMEM_ERROR;
             goto done;
         }
-    }
-#endif
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles)
-            hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
-#endif
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++)
+            hg_bulk->na_mem_handles[j][i] = NA_MEM_HANDLE_NULL;
     }
 
     /* Create and register NA memory handles */
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        /* na_mem_handle_count always <= segment_count */
-        if (!hg_bulk->segments[i].address)
-            continue;
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        na_class_t *na_class = hg_bulk->na_classes[j];
 
-        if (use_register_segments) {
-            struct na_segment *na_segments =
-                (struct na_segment *) hg_bulk->segments;
-            na_size_t na_segment_count = (na_size_t) hg_bulk->segment_count;
-            na_ret = NA_Mem_handle_create_segments(na_class, na_segments,
-                na_segment_count, flags, &hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_handle_create_segments failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
-#ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles) {
-                na_ret = NA_Mem_handle_create_segments(na_sm_class, na_segments,
-                    na_segment_count, flags, &hg_bulk->na_sm_mem_handles[i]);
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            /* na_mem_handle_count always <= segment_count */
+            if (!hg_bulk->segments[i].address)
+                continue;
+
+            if (use_register_segments) {
+                struct na_segment *na_segments =
+                    (struct na_segment *) hg_bulk->segments;
+                na_size_t na_segment_count =
+                    (na_size_t) hg_bulk->segment_count;
+                na_ret = NA_Mem_handle_create_segments(na_class, na_segments,
+                    na_segment_count, flags, &hg_bulk->na_mem_handles[j][i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_create_segments for SM failed");
+                    HG_LOG_ERROR("NA_Mem_handle_create_segments failed");
                     ret = HG_NA_ERROR;
                     goto done;
                 }
-            }
-#endif
-        } else {
-            na_ret = NA_Mem_handle_create(na_class,
-                (void *) hg_bulk->segments[i].address,
-                hg_bulk->segments[i].size, flags, &hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_handle_create failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
-#ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles) {
-                na_ret = NA_Mem_handle_create(na_sm_class,
+            } else {
+                na_ret = NA_Mem_handle_create(na_class,
                     (void *) hg_bulk->segments[i].address,
-                    hg_bulk->segments[i].size, flags, &hg_bulk->na_sm_mem_handles[i]);
+                    hg_bulk->segments[i].size, flags,
+                    &hg_bulk->na_mem_handles[j][i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_create for SM failed");
+                    HG_LOG_ERROR("NA_Mem_handle_create failed");
                     ret = HG_NA_ERROR;
                     goto done;
                 }
             }
-#endif
-        }
-        /* Register segment */
-        na_ret = NA_Mem_register(na_class, hg_bulk->na_mem_handles[i]);
-        if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("NA_Mem_register failed");
-            ret = HG_NA_ERROR;
-            goto done;
-        }
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-            na_ret = NA_Mem_register(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
+            /* Register segment */
+            na_ret = NA_Mem_register(na_class, hg_bulk->na_mem_handles[j][i]);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("NA_Mem_register failed");
                 ret = HG_NA_ERROR;
                 goto done;
             }
         }
-#endif
     }
 
     *hg_bulk_ptr = hg_bulk;
@@ -534,7 +573,7 @@ static hg_return_t
 hg_bulk_free(struct hg_bulk *hg_bulk)
 {
     hg_return_t ret = HG_SUCCESS;
-    unsigned int i;
+    unsigned int i, j;
 
     if (!hg_bulk) goto done;
 
@@ -543,73 +582,50 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
         goto done;
     }
 
-    if (hg_bulk->na_mem_handles) {
-        na_class_t *na_class = hg_bulk->na_class;
-#ifdef HG_HAS_SM_ROUTING
-        na_class_t *na_sm_class = hg_bulk->na_sm_class;
-#endif
+    /* Unregister/free NA memory handles of each NA class */
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        na_class_t *na_class = hg_bulk->na_classes[j];
+        na_mem_handle_t *na_mem_handles = hg_bulk->na_mem_handles[j];
+
+        if (!na_mem_handles)
+            continue;
 
-        /* Unregister/free NA memory handles */
         if (hg_bulk->segment_published) {
             for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
                 na_return_t na_ret;
 
-                if (!hg_bulk->na_mem_handles[i])
+                if (!na_mem_handles[i])
                     continue;
 
-                na_ret = NA_Mem_unpublish(na_class, hg_bulk->na_mem_handles[i]);
+                na_ret = NA_Mem_unpublish(na_class, na_mem_handles[i]);
                 if (na_ret != NA_SUCCESS) {
                     HG_LOG_ERROR("NA_Mem_unpublish failed");
                 }
-#ifdef HG_HAS_SM_ROUTING
-                if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                    na_ret = NA_Mem_unpublish(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                    if (na_ret != NA_SUCCESS) {
-                        HG_LOG_ERROR("NA_Mem_unpublish for SM failed");
-                    }
-                }
-#endif
             }
-            hg_bulk->segment_published = HG_FALSE;
         }
 
         for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
             na_return_t na_ret;
 
-            if (!hg_bulk->na_mem_handles[i])
+            if (!na_mem_handles[i])
                 continue;
 
-            na_ret = NA_Mem_deregister(na_class, hg_bulk->na_mem_handles[i]);
+            na_ret = NA_Mem_deregister(na_class, na_mem_handles[i]);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("NA_Mem_deregister failed");
             }
 
-            na_ret = NA_Mem_handle_free(na_class, hg_bulk->na_mem_handles[i]);
+            na_ret = NA_Mem_handle_free(na_class, na_mem_handles[i]);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("NA_Mem_handle_free failed");
             }
-            hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
-
-#ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                na_ret = NA_Mem_deregister(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_deregister for SM failed");
-                }
-                na_ret = NA_Mem_handle_free(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
-                if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_handle_free for SM failed");
-                }
-                hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
-            }
-#endif
+            na_mem_handles[i] = NA_MEM_HANDLE_NULL;
         }
 
-        free(hg_bulk->na_mem_handles);
-#ifdef HG_HAS_SM_ROUTING
-        free(hg_bulk->na_sm_mem_handles);
-#endif
+        free(na_mem_handles);
+        hg_bulk->na_mem_handles[j] = NULL;
     }
+    hg_bulk->segment_published = HG_FALSE;
 
     /* Free segments */
     if (hg_bulk->segment_alloc) {
@@ -618,6 +634,7 @@ hg_bulk_free(struct hg_bulk *hg_bulk)
         }
     }
     free(hg_bulk->segments);
+    free(hg_bulk->rail_addr_string);
     free(hg_bulk);
 
 done:
@@ -730,8 +747,9 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8_t origin_id,
-    hg_bool_t HG_BULK_UNUSED use_sm, struct hg_bulk *hg_bulk_origin,
+hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op,
+    struct hg_bulk_rail *hg_bulk_rail, na_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin,
     hg_size_t origin_segment_start_index, hg_size_t origin_segment_start_offset,
     struct hg_bulk *hg_bulk_local, hg_size_t local_segment_start_index,
     hg_size_t local_segment_start_offset, hg_size_t size,
@@ -746,16 +764,11 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
         hg_bulk_local->na_mem_handle_count > 1 ? local_segment_index : 0;
     hg_size_t origin_segment_offset = origin_segment_start_offset;
     hg_size_t local_segment_offset = local_segment_start_offset;
+    /* Memory handles are not used (NULL) when data is copied */
     na_mem_handle_t *na_origin_mem_handles =
-#ifdef HG_HAS_SM_ROUTING
-        use_sm ? hg_bulk_origin->na_sm_mem_handles :
-#endif
-            hg_bulk_origin->na_mem_handles;
+        hg_bulk_origin->na_mem_handles[hg_bulk_rail->route];
     na_mem_handle_t *na_local_mem_handles =
-#ifdef HG_HAS_SM_ROUTING
-        use_sm ? hg_bulk_local->na_sm_mem_handles :
-#endif
-            hg_bulk_local->na_mem_handles;
+        hg_bulk_local->na_mem_handles[hg_bulk_rail->route];
     hg_size_t remaining_size = size;
     unsigned int count = 0;
     hg_return_t ret = HG_SUCCESS;
@@ -781,15 +794,20 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
         }
 
         if (na_bulk_op) {
-            na_ret = na_bulk_op(hg_bulk_op_id->na_class,
-                hg_bulk_op_id->na_context, hg_bulk_transfer_cb, hg_bulk_op_id,
-                na_local_mem_handles[na_local_segment_index],
+            na_ret = na_bulk_op(hg_bulk_rail->na_class,
+                hg_bulk_rail->na_context, hg_bulk_transfer_cb, hg_bulk_op_id,
+                na_local_mem_handles ?
+                    na_local_mem_handles[na_local_segment_index] :
+                    NA_MEM_HANDLE_NULL,
                 hg_bulk_local->segments[local_segment_index].address,
                 local_segment_offset,
-                na_origin_mem_handles[na_origin_segment_index],
+                na_origin_mem_handles ?
+                    na_origin_mem_handles[na_origin_segment_index] :
+                    NA_MEM_HANDLE_NULL,
                 hg_bulk_origin->segments[origin_segment_index].address,
-                origin_segment_offset, transfer_size, origin_addr, origin_id,
-                &hg_bulk_op_id->na_op_ids[count]);
+                origin_segment_offset, transfer_size,
+                hg_bulk_rail->na_origin_addr, origin_id,
+                &hg_bulk_op_id->na_op_ids[hg_bulk_rail->op_start + count]);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("Could not transfer data");
                 ret = HG_NA_ERROR;
@@ -834,32 +852,66 @@ hg_bulk_transfer_pieces(na_bulk_op_t na_bulk_op, na_addr_t origin_addr, na_uint8
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
-    hg_bulk_op_t op, struct hg_addr *origin_addr, hg_uint8_t origin_id,
+hg_bulk_transfer_rail(na_bulk_op_t na_bulk_op,
+    struct hg_bulk_rail *hg_bulk_rail, na_uint8_t origin_id,
     struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
     struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
-    hg_op_id_t *op_id)
+    hg_bool_t scatter_gather, struct hg_bulk_op_id *hg_bulk_op_id,
+    unsigned int *na_op_count)
 {
     hg_uint32_t origin_segment_start_index = 0, local_segment_start_index = 0;
     hg_size_t origin_segment_start_offset = origin_offset,
         local_segment_start_offset = local_offset;
+
+    /* Translate bulk_offset */
+    if (origin_offset && !scatter_gather)
+        hg_bulk_offset_translate(hg_bulk_origin, origin_offset,
+            &origin_segment_start_index, &origin_segment_start_offset);
+
+    /* Translate block offset */
+    if (local_offset && !scatter_gather)
+        hg_bulk_offset_translate(hg_bulk_local, local_offset,
+            &local_segment_start_index, &local_segment_start_offset);
+
+    return hg_bulk_transfer_pieces(na_bulk_op, hg_bulk_rail, origin_id,
+        hg_bulk_origin, origin_segment_start_index,
+        origin_segment_start_offset, hg_bulk_local, local_segment_start_index,
+        local_segment_start_offset, size, scatter_gather, hg_bulk_op_id,
+        na_op_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, struct hg_addr *origin_addr, hg_uint8_t origin_id,
+    struct hg_bulk *hg_bulk_origin, hg_size_t origin_offset,
+    struct hg_bulk *hg_bulk_local, hg_size_t local_offset, hg_size_t size,
+    unsigned int timeout, hg_op_id_t *op_id)
+{
     struct hg_bulk_op_id *hg_bulk_op_id = NULL;
     na_bulk_op_t na_bulk_op;
     na_addr_t na_origin_addr = HG_Core_addr_get_na((hg_core_addr_t) origin_addr);
-    na_class_t *na_class = hg_bulk_origin->na_class;
-    na_context_t *na_context = HG_Core_context_get_na(context->core_context);
-    hg_bool_t use_sm = HG_FALSE;
-#ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class = hg_bulk_origin->na_sm_class;
-    na_context_t *na_sm_context = HG_Core_context_get_na_sm(context->core_context);
-#endif
     na_class_t *na_origin_addr_class = HG_Core_addr_get_na_class(
         (hg_core_addr_t) origin_addr);
     hg_bool_t is_self = NA_Addr_is_self(na_origin_addr_class, na_origin_addr);
-    hg_bool_t scatter_gather =
-        (na_class->mem_handle_create_segments && !is_self) ? HG_TRUE : HG_FALSE;
+    hg_size_t stripe_size = HG_Core_class_get_bulk_stripe_size(
+        HG_Core_context_get_class(context->core_context));
+    hg_size_t rail_size, rail_offset;
+    hg_bool_t scatter_gather;
     hg_return_t ret = HG_SUCCESS;
-    unsigned int i;
+    unsigned int route, i;
+
+    /* Transfer through the NA class that origin address belongs to */
+    for (route = 0; route < hg_bulk_origin->na_class_count; route++)
+        if (hg_bulk_origin->na_classes[route] == na_origin_addr_class)
+            break;
+    if (route == hg_bulk_origin->na_class_count) {
+        HG_LOG_ERROR("Origin address does not belong to this HG class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    scatter_gather = (na_origin_addr_class->mem_handle_create_segments
+        && !is_self) ? HG_TRUE : HG_FALSE;
 
     /* Map op to NA op */
     switch (op) {
@@ -879,6 +931,16 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
             goto done;
     }
 
+    /* Origin may not have exposed its memory on that NA class */
+    if (na_bulk_op == hg_bulk_na_put || na_bulk_op == hg_bulk_na_get) {
+        if (!hg_bulk_origin->na_mem_handles[route]
+            || !hg_bulk_local->na_mem_handles[route]) {
+            HG_LOG_ERROR("No memory handle for NA class of origin address");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
     /* Allocate op_id */
     hg_bulk_op_id = (struct hg_bulk_op_id *) malloc(
         sizeof(struct hg_bulk_op_id));
@@ -888,23 +950,17 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
         goto done;
     }
     hg_bulk_op_id->context = context;
-#ifdef HG_HAS_SM_ROUTING
-    if (na_sm_class == na_origin_addr_class) {
-        hg_bulk_op_id->na_class = na_sm_class;
-        hg_bulk_op_id->na_context = na_sm_context;
-        use_sm = HG_TRUE;
-    } else {
-#endif
-        hg_bulk_op_id->na_class = na_class;
-        hg_bulk_op_id->na_context = na_context;
-#ifdef HG_HAS_SM_ROUTING
-    }
-#endif
+    hg_bulk_op_id->rails[0].route = route;
+    hg_bulk_op_id->rails[0].na_class = na_origin_addr_class;
+    hg_bulk_op_id->rails[0].na_context =
+        HG_Core_context_get_na_route(context->core_context, route);
+    hg_bulk_op_id->rails[0].na_origin_addr = na_origin_addr;
+    hg_bulk_op_id->rail_count = 1;
     hg_bulk_op_id->callback = callback;
     hg_bulk_op_id->arg = arg;
     hg_atomic_set32(&hg_bulk_op_id->completed, 0);
     hg_atomic_set32(&hg_bulk_op_id->canceled, 0);
-    hg_bulk_op_id->op_count = 1; /* Default */
+    hg_bulk_op_id->op_count = 0;
     hg_atomic_set32(&hg_bulk_op_id->op_completed_count, 0);
     hg_bulk_op_id->op = op;
     hg_bulk_op_id->hg_bulk_origin = hg_bulk_origin;
@@ -913,29 +969,66 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_atomic_incr32(&hg_bulk_local->ref_count); /* Increment ref count */
     hg_bulk_op_id->na_op_ids = NULL;
     hg_bulk_op_id->is_self = is_self;
+    hg_bulk_op_id->deadline = HG_FALSE;
+    hg_atomic_init32(&hg_bulk_op_id->timed_out, 0);
+
+    /* Stripe large transfers across the other rails that origin can be
+     * reached through, rails of origin are looked up in the background and
+     * used by later transfers */
+    if (stripe_size && size >= stripe_size
+        && (na_bulk_op == hg_bulk_na_put || na_bulk_op == hg_bulk_na_get)) {
+        if (hg_bulk_origin->rail_addr_string
+            && HG_Core_addr_lookup_rails(context->core_context,
+                (hg_core_addr_t) origin_addr, hg_bulk_origin->rail_addr_string)
+            != HG_SUCCESS)
+            HG_LOG_WARNING("Could not look up rails of origin");
+
+        for (i = 0; i < hg_bulk_origin->na_class_count; i++) {
+            struct hg_bulk_rail *hg_bulk_rail =
+                &hg_bulk_op_id->rails[hg_bulk_op_id->rail_count];
+            na_addr_t na_rail_addr;
+
+            if (i == route || !hg_bulk_origin->na_mem_handles[i]
+                || !hg_bulk_local->na_mem_handles[i])
+                continue;
+            na_rail_addr = HG_Core_addr_get_na_rail(
+                (hg_core_addr_t) origin_addr, i);
+            if (na_rail_addr == NA_ADDR_NULL)
+                continue;
+            hg_bulk_rail->route = i;
+            hg_bulk_rail->na_class = hg_bulk_origin->na_classes[i];
+            hg_bulk_rail->na_context =
+                HG_Core_context_get_na_route(context->core_context, i);
+            hg_bulk_rail->na_origin_addr = na_rail_addr;
+            hg_bulk_op_id->rail_count++;
+        }
+    }
 
-    /* Translate bulk_offset */
-    if (origin_offset && !scatter_gather)
-        hg_bulk_offset_translate(hg_bulk_origin, origin_offset,
-            &origin_segment_start_index, &origin_segment_start_offset);
-
-    /* Translate block offset */
-    if (local_offset && !scatter_gather)
-        hg_bulk_offset_translate(hg_bulk_local, local_offset,
-            &local_segment_start_index, &local_segment_start_offset);
-
-    /* Figure out number of NA operations required */
-    if (!scatter_gather) {
-        hg_bulk_transfer_pieces(NULL, NA_ADDR_NULL, origin_id, use_sm, hg_bulk_origin,
-            origin_segment_start_index, origin_segment_start_offset,
-            hg_bulk_local, local_segment_start_index,
-            local_segment_start_offset, size, HG_FALSE, NULL,
-            &hg_bulk_op_id->op_count);
-        if (!hg_bulk_op_id->op_count) {
+    /* Each rail transfers a contiguous range, last one also transfers the
+     * remainder */
+    rail_size = size / hg_bulk_op_id->rail_count;
+    if (!rail_size)
+        hg_bulk_op_id->rail_count = 1;
+
+    /* Figure out number of NA operations required on each rail */
+    for (i = 0, rail_offset = 0; i < hg_bulk_op_id->rail_count; i++) {
+        struct hg_bulk_rail *hg_bulk_rail = &hg_bulk_op_id->rails[i];
+        hg_size_t transfer_size = (i == hg_bulk_op_id->rail_count - 1) ?
+            size - rail_offset : rail_size;
+        unsigned int na_op_count = 0;
+
+        hg_bulk_rail->op_start = hg_bulk_op_id->op_count;
+        hg_bulk_transfer_rail(NULL, hg_bulk_rail, origin_id, hg_bulk_origin,
+            origin_offset + rail_offset, hg_bulk_local,
+            local_offset + rail_offset, transfer_size, scatter_gather, NULL,
+            &na_op_count);
+        if (!na_op_count) {
             HG_LOG_ERROR("Could not get bulk op_count");
             ret = HG_INVALID_PARAM;
             goto done;
         }
+        hg_bulk_op_id->op_count += na_op_count;
+        rail_offset += transfer_size;
     }
 
     /* Allocate memory for NA operation IDs */
@@ -951,14 +1044,40 @@ hg_bulk_transfer(hg_context_t *context, hg_cb_t callback, void *arg,
     /* Assign op_id */
     if (op_id && op_id != HG_OP_ID_IGNORE) *op_id = (hg_op_id_t) hg_bulk_op_id;
 
-    /* Do actual transfer */
-    ret = hg_bulk_transfer_pieces(na_bulk_op, na_origin_addr, origin_id, use_sm,
-        hg_bulk_origin, origin_segment_start_index, origin_segment_start_offset,
-        hg_bulk_local, local_segment_start_index, local_segment_start_offset,
-        size, scatter_gather, hg_bulk_op_id, NULL);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not transfer data pieces");
-        goto done;
+    /* Deadline is armed once all NA operations are issued so that it can
+     * cancel them, hold completion until then. memcpy transfers complete
+     * immediately */
+    if (timeout && !is_self && !hg_bulk_origin->eager_mode) {
+        hg_bulk_op_id->timer.callback = hg_bulk_deadline_cb;
+        hg_bulk_op_id->timer.arg = hg_bulk_op_id;
+        hg_atomic_set32(&hg_bulk_op_id->op_completed_count, -1);
+    } else
+        timeout = 0;
+
+    /* Do actual transfer, operations of all rails complete the same op ID */
+    for (i = 0, rail_offset = 0; i < hg_bulk_op_id->rail_count; i++) {
+        hg_size_t transfer_size = (i == hg_bulk_op_id->rail_count - 1) ?
+            size - rail_offset : rail_size;
+
+        ret = hg_bulk_transfer_rail(na_bulk_op, &hg_bulk_op_id->rails[i],
+            origin_id, hg_bulk_origin, origin_offset + rail_offset,
+            hg_bulk_local, local_offset + rail_offset, transfer_size,
+            scatter_gather, hg_bulk_op_id, NULL);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not transfer data pieces");
+            goto done;
+        }
+        rail_offset += transfer_size;
+    }
+
+    /* Arm deadline and release completion, operations may have completed */
+    if (timeout) {
+        hg_bulk_op_id->deadline = HG_TRUE;
+        hg_core_timer_add(context->core_context, &hg_bulk_op_id->timer,
+            timeout);
+        if ((unsigned int) hg_atomic_incr32(&hg_bulk_op_id->op_completed_count)
+            == hg_bulk_op_id->op_count)
+            hg_bulk_complete(hg_bulk_op_id);
     }
 
 done:
@@ -969,6 +1088,18 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static void
+hg_bulk_deadline_cb(void *arg)
+{
+    struct hg_bulk_op_id *hg_bulk_op_id = (struct hg_bulk_op_id *) arg;
+
+    /* Reported as HG_TIMEOUT instead of HG_CANCELED */
+    hg_atomic_set32(&hg_bulk_op_id->timed_out, 1);
+    if (HG_Bulk_cancel((hg_op_id_t) hg_bulk_op_id) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not cancel bulk operation");
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id)
@@ -976,6 +1107,12 @@ hg_bulk_complete(struct hg_bulk_op_id *hg_bulk_op_id)
     hg_context_t *context = hg_bulk_op_id->context;
     hg_return_t ret = HG_SUCCESS;
 
+    /* Disarm deadline, waits for its callback if it is already running */
+    if (hg_bulk_op_id->deadline) {
+        hg_bulk_op_id->deadline = HG_FALSE;
+        hg_core_timer_remove(context->core_context, &hg_bulk_op_id->timer);
+    }
+
     /* Mark operation as completed */
     hg_atomic_incr32(&hg_bulk_op_id->completed);
 
@@ -1017,9 +1154,11 @@ hg_bulk_trigger_entry(struct hg_bulk_op_id *hg_bulk_op_id)
         struct hg_cb_info hg_cb_info;
 
         hg_cb_info.arg = hg_bulk_op_id->arg;
-        hg_cb_info.ret =
-            hg_atomic_get32(&hg_bulk_op_id->canceled) ? HG_CANCELED :
-                HG_SUCCESS;
+        if (hg_atomic_get32(&hg_bulk_op_id->canceled))
+            hg_cb_info.ret = hg_atomic_get32(&hg_bulk_op_id->timed_out) ?
+                HG_TIMEOUT : HG_CANCELED;
+        else
+            hg_cb_info.ret = HG_SUCCESS;
         hg_cb_info.type = HG_CB_BULK;
         hg_cb_info.info.bulk.op = hg_bulk_op_id->op;
         hg_cb_info.info.bulk.origin_handle =
@@ -1209,7 +1348,7 @@ HG_Bulk_get_serialize_size(hg_bulk_t handle, hg_bool_t request_eager)
 {
     struct hg_bulk *hg_bulk = (struct hg_bulk *) handle;
     hg_size_t ret = 0;
-    hg_uint32_t i;
+    hg_uint32_t i, j;
 
     if (!hg_bulk) {
         HG_LOG_ERROR("NULL bulk handle");
@@ -1223,27 +1362,33 @@ HG_Bulk_get_serialize_size(hg_bulk_t handle, hg_bool_t request_eager)
     ret += sizeof(hg_bulk->total_size) + sizeof(hg_bulk->segment_count)
         + hg_bulk->segment_count * sizeof(*hg_bulk->segments);
 
-    /* NA mem handles */
-    ret += sizeof(hg_bulk->na_mem_handle_count);
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        na_size_t serialize_size = 0;
+    /* NA mem handles of each NA class, tagged with the class name */
+    ret += sizeof(hg_bulk->na_mem_handle_count) + sizeof(hg_uint8_t);
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        na_mem_handle_t *na_mem_handles = hg_bulk->na_mem_handles[j];
+        char name[HG_BULK_ROUTE_NAME_MAX];
 
-        if (hg_bulk->na_mem_handles[i]) {
-            serialize_size = NA_Mem_handle_get_serialize_size(
-                hg_bulk->na_class, hg_bulk->na_mem_handles[i]);
-        }
-        ret += sizeof(serialize_size) + serialize_size;
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
-            if (hg_bulk->na_sm_mem_handles[i]) {
+        if (!na_mem_handles)
+            continue;
+
+        ret += sizeof(hg_uint8_t)
+            + hg_bulk_na_class_name(hg_bulk->na_classes[j], name);
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            na_size_t serialize_size = 0;
+
+            if (na_mem_handles[i]) {
                 serialize_size = NA_Mem_handle_get_serialize_size(
-                    hg_bulk->na_sm_class, hg_bulk->na_sm_mem_handles[i]);
+                    hg_bulk->na_classes[j], na_mem_handles[i]);
             }
             ret += sizeof(serialize_size) + serialize_size;
         }
-#endif
     }
 
+    /* Address string of owner on its rails */
+    ret += sizeof(hg_uint16_t);
+    if (hg_bulk->rail_addr_string)
+        ret += strlen(hg_bulk->rail_addr_string);
+
     /* Eager mode */
     ret += sizeof(hg_bulk->eager_mode);
     if (request_eager && (hg_bulk->flags == HG_BULK_READ_ONLY))
@@ -1263,11 +1408,9 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
     ssize_t buf_size_left = (ssize_t) buf_size;
     hg_return_t ret = HG_SUCCESS;
     hg_bool_t eager_mode;
-    na_class_t *na_class;
-#ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class;
-#endif
-    hg_uint32_t i;
+    hg_uint16_t rail_addr_len;
+    hg_uint8_t na_class_count = 0;
+    hg_uint32_t i, j;
 
     if (!hg_bulk) {
         HG_LOG_ERROR("NULL memory handle passed");
@@ -1275,36 +1418,26 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
         goto done;
     }
 
-    /* Get NA class */
-    na_class = hg_bulk->na_class;
-#ifdef HG_HAS_SM_ROUTING
-    na_sm_class = hg_bulk->na_sm_class;
-#endif
-
     /* Publish handle at this point if not published yet */
     if (!hg_bulk->segment_published) {
-        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-            na_return_t na_ret;
-
-            if (!hg_bulk->na_mem_handles[i])
+        for (j = 0; j < hg_bulk->na_class_count; j++) {
+            if (!hg_bulk->na_mem_handles[j])
                 continue;
 
-            na_ret = NA_Mem_publish(na_class, hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("NA_Mem_publish failed");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
-#ifdef HG_HAS_SM_ROUTING
-            if (hg_bulk->na_sm_mem_handles && hg_bulk->na_sm_mem_handles[i]) {
-                na_ret = NA_Mem_publish(na_sm_class, hg_bulk->na_sm_mem_handles[i]);
+            for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+                na_return_t na_ret;
+
+                if (!hg_bulk->na_mem_handles[j][i])
+                    continue;
+
+                na_ret = NA_Mem_publish(hg_bulk->na_classes[j],
+                    hg_bulk->na_mem_handles[j][i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("NA_Mem_publish for SM failed");
+                    HG_LOG_ERROR("NA_Mem_publish failed");
                     ret = HG_NA_ERROR;
                     goto done;
                 }
             }
-#endif
         }
         hg_bulk->segment_published = HG_TRUE;
     }
@@ -1351,51 +1484,61 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
         goto done;
     }
 
-    /* Add the NA memory handles */
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        na_size_t serialize_size = 0;
-        na_return_t na_ret;
+    /* Add the number of NA classes that memory handles are exposed on */
+    for (j = 0; j < hg_bulk->na_class_count; j++)
+        if (hg_bulk->na_mem_handles[j])
+            na_class_count++;
+    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
+        &na_class_count, sizeof(na_class_count));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not encode NA class count");
+        goto done;
+    }
+
+    /* Add the NA memory handles of each NA class, preceded by its name so
+     * that peers can match them to their own NA classes */
+    for (j = 0; j < hg_bulk->na_class_count; j++) {
+        na_class_t *na_class = hg_bulk->na_classes[j];
+        na_mem_handle_t *na_mem_handles = hg_bulk->na_mem_handles[j];
+        char name[HG_BULK_ROUTE_NAME_MAX];
+        hg_uint8_t name_len;
 
-        if (hg_bulk->na_mem_handles[i]) {
-            serialize_size = NA_Mem_handle_get_serialize_size(
-                na_class, hg_bulk->na_mem_handles[i]);
-        }
-        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, &serialize_size,
-            sizeof(serialize_size));
+        if (!na_mem_handles)
+            continue;
+
+        name_len = hg_bulk_na_class_name(na_class, name);
+        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, &name_len,
+            sizeof(name_len));
         if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not encode serialize size");
+            HG_LOG_ERROR("Could not encode NA class name length");
             goto done;
         }
-        if (hg_bulk->na_mem_handles[i]) {
-            na_ret = NA_Mem_handle_serialize(na_class, buf_ptr,
-                (na_size_t) buf_size_left, hg_bulk->na_mem_handles[i]);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("Could not serialize memory handle");
-                ret = HG_NA_ERROR;
-                goto done;
-            }
-            buf_ptr += serialize_size;
-            buf_size_left -= (ssize_t) serialize_size;
+        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, name,
+            name_len);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not encode NA class name");
+            goto done;
         }
 
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
-            if (hg_bulk->na_sm_mem_handles[i]) {
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            na_size_t serialize_size = 0;
+            na_return_t na_ret;
+
+            if (na_mem_handles[i]) {
                 serialize_size = NA_Mem_handle_get_serialize_size(
-                    na_class, hg_bulk->na_sm_mem_handles[i]);
-            } else
-                serialize_size = 0;
+                    na_class, na_mem_handles[i]);
+            }
             ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
                 &serialize_size, sizeof(serialize_size));
             if (ret != HG_SUCCESS) {
                 HG_LOG_ERROR("Could not encode serialize size");
                 goto done;
             }
-            if (hg_bulk->na_sm_mem_handles[i]) {
-                na_ret = NA_Mem_handle_serialize(na_sm_class, buf_ptr,
-                    (na_size_t) buf_size_left, hg_bulk->na_sm_mem_handles[i]);
+            if (na_mem_handles[i]) {
+                na_ret = NA_Mem_handle_serialize(na_class, buf_ptr,
+                    (na_size_t) buf_size_left, na_mem_handles[i]);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("Could not serialize SM memory handle");
+                    HG_LOG_ERROR("Could not serialize memory handle");
                     ret = HG_NA_ERROR;
                     goto done;
                 }
@@ -1403,7 +1546,25 @@ HG_Bulk_serialize(void *buf, hg_size_t buf_size, hg_bool_t request_eager,
                 buf_size_left -= (ssize_t) serialize_size;
             }
         }
-#endif
+    }
+
+    /* Add the address string of owner on its rails, peers use it to reach
+     * memory through all rails */
+    rail_addr_len = (hg_uint16_t) (hg_bulk->rail_addr_string ?
+        strlen(hg_bulk->rail_addr_string) : 0);
+    ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left, &rail_addr_len,
+        sizeof(rail_addr_len));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not encode rail address string length");
+        goto done;
+    }
+    if (rail_addr_len) {
+        ret = hg_bulk_serialize_memcpy(&buf_ptr, &buf_size_left,
+            hg_bulk->rail_addr_string, rail_addr_len);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not encode rail address string");
+            goto done;
+        }
     }
 
     /* Eager mode is used only when data is set to HG_BULK_READ_ONLY */
@@ -1447,7 +1608,9 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
     const char *buf_ptr = (const char *) buf;
     ssize_t buf_size_left = (ssize_t) buf_size;
     hg_return_t ret = HG_SUCCESS;
-    hg_uint32_t i;
+    hg_uint16_t rail_addr_len;
+    hg_uint8_t na_class_count, k;
+    hg_uint32_t i, j;
 
     if (!handle) {
         HG_LOG_ERROR("NULL pointer to memory handle passed");
@@ -1462,10 +1625,11 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
         goto done;
     }
     memset(hg_bulk, 0, sizeof(struct hg_bulk));
-    hg_bulk->na_class = HG_Core_class_get_na(hg_class->core_class);
-#ifdef HG_HAS_SM_ROUTING
-    hg_bulk->na_sm_class = HG_Core_class_get_na_sm(hg_class->core_class);
-#endif
+    hg_bulk->na_class_count =
+        HG_Core_class_get_na_route_count(hg_class->core_class);
+    for (j = 0; j < hg_bulk->na_class_count; j++)
+        hg_bulk->na_classes[j] =
+            HG_Core_class_get_na_route(hg_class->core_class, j);
     hg_atomic_set32(&hg_bulk->ref_count, 1);
 
     /* Get the permission flags */
@@ -1517,75 +1681,111 @@ HG_Bulk_deserialize(hg_class_t *hg_class, hg_bulk_t *handle, const void *buf,
         goto done;
     }
 
-    /* Get the NA memory handles */
-    hg_bulk->na_mem_handles = (na_mem_handle_t *) malloc(
-            hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-    if (!hg_bulk->na_mem_handles) {
-        HG_LOG_ERROR("Could not allocate NA memory handle array");
-        ret = HG_NOMEM_ERROR;
+    /* Get the number of NA classes that memory handles are exposed on */
+    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
+        &na_class_count, sizeof(na_class_count));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not decode NA class count");
         goto done;
     }
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_bulk->na_sm_class) {
-        hg_bulk->na_sm_mem_handles = (na_mem_handle_t *) malloc(
-                hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
-        if (!hg_bulk->na_sm_mem_handles) {
-            HG_LOG_ERROR("Could not allocate NA SM memory handle array");
-            ret = HG_NOMEM_ERROR;
-            goto done;
-        }
-    }
-#endif
 
-    for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
-        na_size_t serialize_size;
-        na_return_t na_ret;
+    /* Get the NA memory handles of the NA classes that this class also has,
+     * skip the others */
+    for (k = 0; k < na_class_count; k++) {
+        char name[HG_BULK_ROUTE_NAME_MAX];
+        char local_name[HG_BULK_ROUTE_NAME_MAX];
+        na_mem_handle_t *na_mem_handles = NULL;
+        hg_uint8_t name_len;
 
-        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
-            &serialize_size, sizeof(serialize_size));
+        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left, &name_len,
+            sizeof(name_len));
         if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not decode serialize size");
+            HG_LOG_ERROR("Could not decode NA class name length");
             goto done;
         }
-        if (serialize_size) {
-            na_ret = NA_Mem_handle_deserialize(hg_bulk->na_class,
-                &hg_bulk->na_mem_handles[i], buf_ptr,
-                (na_size_t) buf_size_left);
-            if (na_ret != NA_SUCCESS) {
-                HG_LOG_ERROR("Could not deserialize memory handle");
-                ret = HG_NA_ERROR;
+        if (name_len >= HG_BULK_ROUTE_NAME_MAX) {
+            HG_LOG_ERROR("NA class name too long");
+            ret = HG_SIZE_ERROR;
+            goto done;
+        }
+        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left, name,
+            name_len);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not decode NA class name");
+            goto done;
+        }
+        name[name_len] = '\0';
+
+        for (j = 0; j < hg_bulk->na_class_count; j++) {
+            hg_bulk_na_class_name(hg_bulk->na_classes[j], local_name);
+            if (!hg_bulk->na_mem_handles[j] && !strcmp(name, local_name))
+                break;
+        }
+        if (j < hg_bulk->na_class_count) {
+            na_mem_handles = (na_mem_handle_t *) malloc(
+                hg_bulk->na_mem_handle_count * sizeof(na_mem_handle_t));
+            if (!na_mem_handles) {
+                HG_LOG_ERROR("Could not allocate NA memory handle array");
+                ret = HG_NOMEM_ERROR;
                 goto done;
             }
-            buf_ptr += serialize_size;
-            buf_size_left -= (ssize_t) serialize_size;
-        } else {
-            hg_bulk->na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+            for (i = 0; i < hg_bulk->na_mem_handle_count; i++)
+                na_mem_handles[i] = NA_MEM_HANDLE_NULL;
+            hg_bulk->na_mem_handles[j] = na_mem_handles;
         }
 
-#ifdef HG_HAS_SM_ROUTING
-        if (hg_bulk->na_sm_mem_handles) {
+        for (i = 0; i < hg_bulk->na_mem_handle_count; i++) {
+            na_size_t serialize_size;
+            na_return_t na_ret;
+
             ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
                 &serialize_size, sizeof(serialize_size));
             if (ret != HG_SUCCESS) {
                 HG_LOG_ERROR("Could not decode serialize size");
                 goto done;
             }
-            if (serialize_size) {
-                na_ret = NA_Mem_handle_deserialize(hg_bulk->na_sm_class,
-                    &hg_bulk->na_sm_mem_handles[i], buf_ptr,
-                    (na_size_t) buf_size_left);
+            if (!serialize_size)
+                continue;
+            if ((ssize_t) serialize_size > buf_size_left) {
+                HG_LOG_ERROR("Buffer size too small");
+                ret = HG_SIZE_ERROR;
+                goto done;
+            }
+            if (na_mem_handles) {
+                na_ret = NA_Mem_handle_deserialize(hg_bulk->na_classes[j],
+                    &na_mem_handles[i], buf_ptr, (na_size_t) buf_size_left);
                 if (na_ret != NA_SUCCESS) {
-                    HG_LOG_ERROR("Could not deserialize SM memory handle");
+                    HG_LOG_ERROR("Could not deserialize memory handle");
                     ret = HG_NA_ERROR;
                     goto done;
                 }
-                buf_ptr += serialize_size;
-                buf_size_left -= (ssize_t) serialize_size;
-            } else {
-                hg_bulk->na_sm_mem_handles[i] = NA_MEM_HANDLE_NULL;
             }
+            buf_ptr += serialize_size;
+            buf_size_left -= (ssize_t) serialize_size;
         }
-#endif
+    }
+
+    /* Get the address string of owner on its rails */
+    ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left, &rail_addr_len,
+        sizeof(rail_addr_len));
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not decode rail address string length");
+        goto done;
+    }
+    if (rail_addr_len) {
+        hg_bulk->rail_addr_string = (char *) malloc(rail_addr_len + 1U);
+        if (!hg_bulk->rail_addr_string) {
+            HG_LOG_ERROR("Could not allocate rail address string");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        ret = hg_bulk_deserialize_memcpy(&buf_ptr, &buf_size_left,
+            hg_bulk->rail_addr_string, rail_addr_len);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not decode rail address string");
+            goto done;
+        }
+        hg_bulk->rail_addr_string[rail_addr_len] = '\0';
     }
 
     /* Get whether data is serialized or not */
@@ -1650,6 +1850,19 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
     hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
     hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
     hg_size_t local_offset, hg_size_t size, hg_op_id_t *op_id)
+{
+    return HG_Bulk_transfer_timed(context, callback, arg, op, origin_addr,
+        origin_id, origin_handle, origin_offset, local_handle, local_offset,
+        size, 0, op_id);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Bulk_transfer_timed(hg_context_t *context, hg_cb_t callback, void *arg,
+    hg_bulk_op_t op, hg_addr_t origin_addr, hg_uint8_t origin_id,
+    hg_bulk_t origin_handle, hg_size_t origin_offset, hg_bulk_t local_handle,
+    hg_size_t local_offset, hg_size_t size, unsigned int timeout,
+    hg_op_id_t *op_id)
 {
     struct hg_bulk *hg_bulk_origin = (struct hg_bulk *) origin_handle;
     struct hg_bulk *hg_bulk_local = (struct hg_bulk *) local_handle;
@@ -1720,7 +1933,7 @@ HG_Bulk_transfer_id(hg_context_t *context, hg_cb_t callback, void *arg,
 
     ret = hg_bulk_transfer(context, callback, arg, op, origin_addr, origin_id,
         hg_bulk_origin, origin_offset, hg_bulk_local, local_offset, size,
-        op_id);
+        timeout, op_id);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not transfer data");
         goto done;
@@ -1744,15 +1957,20 @@ HG_Bulk_cancel(hg_op_id_t op_id)
     }
 
     if (HG_UTIL_TRUE != hg_atomic_cas32(&hg_bulk_op_id->completed, 1, 0)) {
-        unsigned int i = 0;
+        unsigned int i = 0, j = 0;
 
-        /* Cancel all NA operations issued */
+        /* Cancel all NA operations issued, on the rail they were issued on */
         for (i = 0; i < hg_bulk_op_id->op_count; i++) {
             na_return_t na_ret;
 
+            while (j + 1 < hg_bulk_op_id->rail_count
+                && i >= hg_bulk_op_id->rails[j + 1].op_start)
+                j++;
+
             /* Cancel NA operation */
-            na_ret = NA_Cancel(hg_bulk_op_id->na_class,
-                hg_bulk_op_id->na_context, hg_bulk_op_id->na_op_ids[i]);
+            na_ret = NA_Cancel(hg_bulk_op_id->rails[j].na_class,
+                hg_bulk_op_id->rails[j].na_context,
+                hg_bulk_op_id->na_op_ids[i]);
             if (na_ret != NA_SUCCESS) {
                 HG_LOG_ERROR("Could not cancel op id");
                 ret = HG_NA_ERROR;
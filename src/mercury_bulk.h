@@ -272,6 +272,47 @@ HG_Bulk_transfer_id(
         hg_op_id_t *op_id
         );
 
+/**
+ * Transfer data to/from origin, same as HG_Bulk_transfer_id() but the
+ * transfer is canceled if it has not completed within \timeout milliseconds
+ * and the callback then reports HG_TIMEOUT. Deadlines are expired when making
+ * progress on \context. A timeout of 0 disables the deadline.
+ *
+ * \param context [IN]          pointer to HG context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param op [IN]               transfer operation:
+ *                                  - HG_BULK_PUSH
+ *                                  - HG_BULK_PULL
+ * \param origin_addr [IN]      abstract address of origin
+ * \param origin_id [IN]        context ID of origin
+ * \param origin_handle [IN]    abstract bulk handle
+ * \param origin_offset [IN]    offset
+ * \param local_handle [IN]     abstract bulk handle
+ * \param local_offset [IN]     offset
+ * \param size [IN]             size of data to be transferred
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Bulk_transfer_timed(
+        hg_context_t *context,
+        hg_cb_t callback,
+        void *arg,
+        hg_bulk_op_t op,
+        hg_addr_t origin_addr,
+        hg_uint8_t origin_id,
+        hg_bulk_t origin_handle,
+        hg_size_t origin_offset,
+        hg_bulk_t local_handle,
+        hg_size_t local_offset,
+        hg_size_t size,
+        unsigned int timeout,
+        hg_op_id_t *op_id
+        );
+
 /**
  * Cancel an ongoing operation.
  *
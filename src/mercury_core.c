@@ -8,17 +8,22 @@
  * found at the root of the source code distribution tree.
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "mercury_core.h"
 #include "mercury_core_header.h"
 #include "mercury_private.h"
 #include "mercury_error.h"
 
 #include "mercury_hash_table.h"
+#include "mercury_hash_string.h"
 #include "mercury_atomic.h"
 #include "mercury_queue.h"
 #include "mercury_list.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_thread_spin.h"
+#include "mercury_thread_rwlock.h"
 #include "mercury_thread_condition.h"
 #include "mercury_time.h"
 #include "mercury_atomic.h"
@@ -36,6 +41,11 @@
 
 #include <stdlib.h>
 #include <string.h>
+#if defined(__linux__)
+#include <sched.h>
+#elif !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 /****************/
 /* Local Macros */
@@ -44,23 +54,37 @@
 #define HG_CORE_MAX_SELF_THREADS    4
 #define HG_CORE_MASK_NBITS          8
 #define HG_CORE_ATOMIC_QUEUE_SIZE   1024
+#define HG_CORE_ATOMIC_QUEUE_GROW_MAX 6  /* Grow up to 64x initial size */
 #define HG_CORE_PENDING_INCR        256
+#define HG_CORE_TAG_PARTITIONS_MAX  16  /* Max number of tag ranges */
+#define HG_CORE_TAG_RANGE_MIN       1024 /* Min number of tags per range */
+#define HG_CORE_POST_WINDOW         0.1 /* Arrival rate sampling window (s) */
+#define HG_CORE_POST_IDLE_WINDOWS   10  /* Idle windows before shrinking */
+#define HG_CORE_POST_EWMA(avg, val) (0.75 * (avg) + 0.25 * (val))
+#define HG_CORE_FUNC_MAP_MIN_SIZE   16  /* Min number of func map slots */
 #define HG_CORE_PROCESSING_TIMEOUT  1000
+#define HG_CORE_PROGRESS_TIMEOUT    100 /* Progress thread block timeout (ms) */
+#define HG_CORE_PROGRESS_TRIGGER_MAX 64 /* Callbacks per progress iteration */
+#define HG_CORE_SPIN_MAX            0.0005 /* Max spin window before blocking (s) */
+#define HG_CORE_SPIN_FACTOR         2   /* Spin window / average completion gap */
+#define HG_CORE_SPIN_EWMA(avg, val) (0.875 * (avg) + 0.125 * (val))
+#define HG_CORE_SPIN_TIME(t) \
+    ((hg_util_int64_t) (t).tv_sec * 1000000 + (t).tv_usec) /* Time (us) */
+#define HG_CORE_BATCH_ENTRY_SIZE    8   /* Tag and size of coalesced request */
+#define HG_CORE_TIMER_LEVELS        4   /* Levels of timer wheel */
+#define HG_CORE_TIMER_SLOT_BITS     6   /* 64 slots per level */
+#define HG_CORE_TIMER_SLOTS         (1 << HG_CORE_TIMER_SLOT_BITS)
+#define HG_CORE_TIMER_SLOT_MASK     (HG_CORE_TIMER_SLOTS - 1)
+#define HG_CORE_PRIORITY_AGING      8   /* Every Nth entry triggered from a
+                                           backlogged lower priority class */
+#define HG_CORE_ADDR_IDLE_MAX       64  /* Source addresses kept interned per
+                                           context once no longer referenced */
+#define HG_CORE_ADDR_MAX_SIZE       256
+#define HG_CORE_PROTO_DELIMITER     ":"
+#define HG_CORE_ADDR_DELIMITER      ";"
+#define HG_CORE_MIN(a, b)           (a < b) ? a : b /* Min macro */
 #ifdef HG_HAS_SM_ROUTING
 # define HG_CORE_UUID_MAX_LEN       36
-# define HG_CORE_ADDR_MAX_SIZE      256
-# define HG_CORE_PROTO_DELIMITER    ":"
-# define HG_CORE_ADDR_DELIMITER     ";"
-# define HG_CORE_MIN(a, b)          (a < b) ? a : b /* Min macro */
-#endif
-
-/* Remove warnings when routine does not use arguments */
-#if defined(__cplusplus)
-# define HG_UNUSED
-#elif defined(__GNUC__) && (__GNUC__ >= 4)
-# define HG_UNUSED __attribute__((unused))
-#else
-# define HG_UNUSED
 #endif
 
 /* Map stat type to either 32-bit atomic or 64-bit */
@@ -81,19 +105,72 @@ typedef hg_atomic_int32_t hg_core_stat_t;
 /* Local Type and Struct Definition */
 /************************************/
 
+/* Tag counter, kept on its own cache line */
+struct hg_core_tag_counter {
+    hg_atomic_int32_t value __attribute__((aligned(HG_UTIL_CACHE_ALIGNMENT)));
+};
+
+/* Route to peers through one NA class */
+struct hg_core_route {
+    na_class_t *na_class;               /* NA class */
+    hg_bool_t local;                    /* Only reaches processes of node */
+    unsigned int rail_group;            /* First route of same class and
+                                           protocol, routes of a group are
+                                           rails to the same peers */
+};
+
 /* HG class */
 struct hg_core_class {
-    na_class_t *na_class;               /* NA class */
+    na_class_t *na_class;               /* NA class of main route */
+    struct hg_core_route routes[HG_CORE_ROUTE_MAX]; /* Routes, fastest first */
+    unsigned int n_routes;              /* Number of routes */
+    unsigned int main_route;            /* Index of main route */
+    hg_bool_t has_rails;                /* Several routes share a protocol */
+    char *rail_addr_string;             /* Self address string (rails only) */
+    hg_size_t bulk_stripe_size;         /* Min size of striped transfers */
 #ifdef HG_HAS_SM_ROUTING
-    na_class_t *na_sm_class;            /* NA SM class */
     uuid_t na_sm_uuid;                  /* UUID for local identification */
 #endif
     hg_hash_table_t *func_map;          /* Function map */
     hg_thread_spin_t func_map_lock;     /* Function map mutex */
-    hg_atomic_int32_t request_tag;      /* Atomic used for tag generation */
+    hg_hash_table_t *addr_cache;        /* Looked up addresses by name */
+    hg_thread_spin_t addr_cache_lock;   /* Address cache lock */
+    hg_atomic_int64_t func_map_table;   /* Published function map snapshot */
+    hg_atomic_int32_t func_map_dirty;   /* Snapshot misses last changes */
+    struct hg_core_func_map_table *func_map_retired; /* Retired snapshots */
+    struct hg_core_rpc_info *rpc_info_retired;      /* Deregistered RPC info */
+    struct hg_core_tag_counter request_tags[HG_CORE_TAG_PARTITIONS_MAX]; /* Tag counters */
+    unsigned int request_tag_partitions; /* Number of tag ranges */
+    na_tag_t request_tag_range;         /* Number of tags per range */
+    hg_atomic_int32_t request_tag_next; /* Next range assigned to a context */
     na_tag_t request_max_tag;           /* Max value for tag */
     hg_bool_t na_ext_init;              /* NA externally initialized */
     na_progress_mode_t progress_mode;   /* NA progress mode */
+    hg_bool_t progress_spin;            /* Spin before blocking in progress */
+    unsigned int handle_pool_size;      /* Max pooled handles per context */
+    unsigned int request_post_min;      /* Min number of posted handles */
+    unsigned int request_post_max;      /* Max number of posted handles */
+    hg_thread_key_t inline_key;         /* Inline completion queue key */
+    hg_bool_t inline_key_created;       /* Inline key was created */
+    unsigned int completion_queue_shards; /* Completion shards per context */
+    hg_thread_key_t trigger_key;        /* Thread index key (shards) */
+    hg_bool_t trigger_key_created;      /* Trigger key was created */
+    hg_atomic_int32_t trigger_index;    /* Last thread index */
+    hg_thread_key_t timer_key;          /* Timer expiring in this thread */
+    hg_bool_t timer_key_created;        /* Timer key was created */
+    unsigned int request_credits;       /* Requests in flight per origin */
+    unsigned int busy_queue_depth;      /* Requests waiting before rejection */
+    unsigned int busy_latency;          /* Wait (us) before rejection */
+    hg_bool_t self_inline;              /* Process self forwards inline */
+    unsigned int coalesce_count;        /* Max requests per coalesced message */
+    hg_size_t coalesce_size;            /* Max size of coalesced message */
+    double coalesce_timeout;            /* Max coalescing delay (s) */
+    hg_dispatch_policy_t dispatch_policy; /* Dispatch of received RPCs */
+    struct hg_core_context **dispatch_contexts; /* Dispatch targets */
+    unsigned int dispatch_count;        /* Number of dispatch targets */
+    unsigned int dispatch_size;         /* Size of dispatch target array */
+    hg_thread_rwlock_t dispatch_lock;   /* Dispatch targets lock */
+    hg_atomic_int32_t dispatch_next;    /* Next round-robin target */
 #ifdef HG_HAS_COLLECT_STATS
     hg_bool_t stats;                    /* (Debug) Print stats at exit */
 #endif
@@ -106,31 +183,117 @@ struct hg_core_class {
     hg_return_t (*more_data_acquire)(hg_core_handle_t,
         hg_return_t (*done_callback)(hg_core_handle_t)); /* more_data_acquire */
     void (*more_data_release)(hg_core_handle_t); /* more_data_release */
+    hg_uint64_t (*dispatch_key)(hg_core_handle_t, void *); /* dispatch_key */
+    void *dispatch_key_arg;                              /* dispatch_key arg */
+};
+
+/* Pool of origin handles kept for reuse */
+struct hg_core_handle_pool {
+    HG_LIST_HEAD(hg_core_handle) list;  /* List of pooled handles */
+    hg_thread_spin_t lock;              /* Pool lock */
+    unsigned int count;                 /* Number of pooled handles */
+};
+
+/* Adaptive posting of unexpected handles */
+struct hg_core_post_info {
+    hg_thread_spin_t lock;              /* Post info lock */
+    unsigned int count;                 /* Number of handles posted or in use */
+    unsigned int target;                /* Target number of handles */
+    unsigned int min;                   /* Min number of handles */
+    unsigned int max;                   /* Max number of handles (0 if none) */
+    unsigned int window_arrivals;       /* Arrivals in current window */
+    unsigned int idle_windows;          /* Consecutive windows without arrival */
+    hg_time_t window_start;             /* Start of current window */
+    double arrival_rate;                /* Average arrival rate (RPC/s) */
+    double repost_time;                 /* Average time to repost (s) */
+};
+
+/* Completion entries executed inline by HG_Core_progress_and_trigger() */
+struct hg_core_inline_queue {
+    struct hg_core_context *context;    /* Context progressed */
+    HG_QUEUE_HEAD(hg_completion_entry) queue; /* Queue of completed entries */
+};
+
+/* Completion queue shard, queues double in size when full and are kept until
+ * the context is destroyed so that concurrent producers remain safe */
+struct hg_core_completion_shard {
+    struct hg_atomic_queue *queues[HG_CORE_ATOMIC_QUEUE_GROW_MAX + 1]; /* Queues */
+    hg_atomic_int32_t n_queues;         /* Number of queues allocated */
+};
+
+/* Timer states */
+typedef enum {
+    HG_CORE_TIMER_IDLE,          /*!< Not armed */
+    HG_CORE_TIMER_ARMED,         /*!< In timer wheel */
+    HG_CORE_TIMER_EXPIRING       /*!< Expiration callback running */
+} hg_core_timer_state_t;
+
+/* Hierarchical timer wheel with 1 ms ticks, slots of level N span 64^N ticks
+ * and get cascaded down to lower levels as time advances so that adding,
+ * removing and expiring timers does not depend on the number of timers */
+struct hg_core_timer_wheel {
+    HG_LIST_HEAD(hg_core_timer) slots[HG_CORE_TIMER_LEVELS][HG_CORE_TIMER_SLOTS];
+    hg_thread_spin_t lock;              /* Timer wheel lock */
+    hg_time_t start;                    /* Time of tick 0 */
+    hg_util_uint64_t now;               /* Last tick processed */
+    hg_atomic_int32_t count;            /* Number of armed timers */
+};
+
+/* Requests to the same target coalesced into a single unexpected message:
+ * encoded request header followed by (tag, size, request) entries */
+struct hg_core_batch {
+    struct hg_core_context *context;    /* Context batch belongs to */
+    na_class_t *na_class;               /* NA class */
+    na_context_t *na_context;           /* NA context */
+    na_addr_t na_addr;                  /* Target NA addr */
+    hg_uint8_t context_id;              /* Target context ID */
+    void *buf;                          /* Message buffer */
+    void *buf_plugin_data;              /* Message buffer NA plugin data */
+    na_size_t buf_size;                 /* Message buffer size */
+    na_size_t buf_used;                 /* Amount of message buffer used */
+    na_op_id_t na_op_id;                /* Operation ID for send */
+    hg_bool_t na_op_id_mine;            /* Operation ID created by HG */
+    struct hg_core_handle *handles;     /* Coalesced handles */
+    unsigned int count;                 /* Number of coalesced handles */
+    hg_time_t start;                    /* Time first request was added */
+    HG_LIST_ENTRY(hg_core_batch) entry; /* Open/free list entry */
+};
+
+/* Route of a context, handles requests received through its NA class */
+struct hg_core_context_route {
+    struct hg_core_context *context;              /* Context of route */
+    na_class_t *na_class;                         /* NA class */
+    na_context_t *na_context;                     /* NA context */
+    HG_LIST_HEAD(hg_core_handle) pending_list;    /* List of pending handles */
+    hg_thread_spin_t pending_list_lock;           /* Pending list lock */
+    struct hg_core_post_info post_info;           /* Pending list post info */
+    struct hg_core_handle_pool handle_pool;       /* Pool of reusable handles */
 };
 
 /* HG context */
 struct hg_core_context {
     struct hg_core_class *hg_core_class;          /* HG core class */
-    na_context_t *na_context;                     /* NA context */
-#ifdef HG_HAS_SM_ROUTING
-    na_context_t *na_sm_context;                  /* NA SM context */
-#endif
+    na_context_t *na_context;                     /* NA context of main route */
+    struct hg_core_context_route routes[HG_CORE_ROUTE_MAX]; /* Routes, in
+                                                     order of class routes */
     hg_uint8_t id;                                /* Context ID */
     struct hg_poll_set *poll_set;                 /* Context poll set */
     /* Pointer to function used for making progress */
     hg_return_t (*progress)(struct hg_core_context *context, unsigned int timeout);
-    struct hg_atomic_queue *completion_queue;     /* Default completion queue */
+    struct hg_core_completion_shard *completion_shards; /* Completion queues */
+    unsigned int n_completion_shards;             /* Number of shards */
     HG_QUEUE_HEAD(hg_completion_entry) backfill_queue; /* Backfill completion queue */
     hg_atomic_int32_t backfill_queue_count;       /* Backfill queue count */
+    HG_QUEUE_HEAD(hg_completion_entry) high_queue; /* High priority completions */
+    HG_QUEUE_HEAD(hg_completion_entry) low_queue; /* Low priority completions */
+    hg_atomic_int32_t priority_queue_count;       /* High and low queue count */
+    hg_atomic_int32_t priority_served;            /* Entries taken while high or
+                                                     low queues were not empty */
+    hg_thread_spin_t priority_queue_lock;         /* High and low queue lock */
     hg_thread_mutex_t completion_queue_mutex;     /* Completion queue mutex */
     hg_thread_cond_t  completion_queue_cond;      /* Completion queue cond */
     hg_atomic_int32_t trigger_waiting;            /* Waiting in trigger */
-    HG_LIST_HEAD(hg_core_handle) pending_list;    /* List of pending handles */
-    hg_thread_spin_t pending_list_lock;           /* Pending list lock */
-#ifdef HG_HAS_SM_ROUTING
-    HG_LIST_HEAD(hg_core_handle) sm_pending_list; /* List of SM pending handles */
-    hg_thread_spin_t sm_pending_list_lock;        /* SM pending list lock */
-#endif
+    hg_atomic_int32_t inline_count;               /* Inline progress in use */
     HG_LIST_HEAD(hg_core_handle) created_list;    /* List of handles for that context */
     hg_thread_spin_t created_list_lock;           /* Handle list lock */
 #ifdef HG_HAS_SELF_FORWARD
@@ -139,17 +302,67 @@ struct hg_core_context {
 #endif
     hg_return_t (*handle_create)(hg_core_handle_t, void *); /* handle_create */
     void *handle_create_arg;                      /* handle_create arg */
+    void (*handle_release)(hg_core_handle_t, void *); /* handle_release */
+    void *handle_release_arg;                     /* handle_release arg */
     void *data;                                   /* User data */
     void (*data_free_callback)(void *);           /* User data free callback */
     hg_bool_t finalizing;                         /* Prevent reposts */
     hg_atomic_int32_t n_handles;                  /* Atomic used for number of handles */
+    struct hg_core_tag_counter *request_tag;      /* Tag counter of context range */
+    na_tag_t request_tag_base;                    /* First tag of context range */
+    hg_thread_t progress_thread;                  /* Progress thread */
+    hg_bool_t progress_thread_started;            /* Progress thread running */
+    hg_atomic_int32_t progress_thread_stop;       /* Progress thread must exit */
+    struct hg_progress_info progress_info;        /* Progress thread info */
+    hg_atomic_int64_t spin_last;                  /* Last completion time (us) */
+    hg_atomic_int32_t spin_gap;                   /* Average completion gap (ns) */
+    HG_LIST_HEAD(hg_core_batch) batch_list;       /* Open coalesced messages */
+    hg_atomic_int32_t batch_wake;                 /* Progress woken up by
+                                                     opened message */
+    HG_LIST_HEAD(hg_core_batch) batch_free_list;  /* Coalesced messages for reuse */
+    hg_thread_mutex_t batch_mutex;                /* Coalesced message lists mutex */
+    struct hg_core_timer_wheel timer_wheel;       /* Deadlines of operations */
+    hg_atomic_int32_t dispatch_load;              /* RPCs dispatched to context
+                                                     and not yet processed */
+    hg_atomic_int32_t dispatch_high_load;         /* High priority part of it */
+    hg_bool_t dispatch_registered;                /* Context is dispatch target */
+    hg_hash_table_t *addr_table;                  /* Source addresses by NA addr */
+    HG_QUEUE_HEAD(hg_core_addr) addr_idle_queue;  /* Unreferenced source
+                                                     addresses, oldest first */
+    unsigned int addr_idle_count;                 /* Idle queue count */
+    hg_thread_spin_t addr_table_lock;             /* Source address table lock */
+    hg_atomic_int32_t process_count;              /* Received RPCs waiting for
+                                                     their callback */
+    hg_atomic_int32_t process_delay;              /* Average wait (us) of RPCs
+                                                     before their callback */
 };
 
 /* Info for function map */
 struct hg_core_rpc_info {
+    hg_id_t id;                     /* RPC ID */
     hg_core_rpc_cb_t rpc_cb;        /* RPC callback */
     void *data;                     /* User data */
     void (*free_callback)(void *);  /* User data free callback */
+    hg_priority_t priority;         /* Priority class */
+    struct hg_core_rpc_info *retired; /* Next retired RPC info */
+};
+
+/* Entry in function map snapshot */
+struct hg_core_func_map_entry {
+    hg_id_t id;                                 /* RPC ID */
+    struct hg_core_rpc_info *hg_core_rpc_info;  /* RPC info */
+};
+
+/* Open-addressed snapshot of the function map, published atomically by the
+ * first lookup following registrations so that lookups do not need to take
+ * the function map lock. Snapshots are never modified once published and
+ * retired snapshots are only freed at finalize since lookups do not track
+ * their use of them. Snapshots never shrink and grow by doubling so that
+ * snapshots retired when growing take less memory than the current one. */
+struct hg_core_func_map_table {
+    struct hg_core_func_map_table *retired;     /* Next retired snapshot */
+    unsigned int mask;                          /* Number of slots - 1 */
+    struct hg_core_func_map_entry entries[1];   /* Slots */
 };
 
 #ifdef HG_HAS_SELF_FORWARD
@@ -166,12 +379,20 @@ struct hg_core_self_cb_info {
 struct hg_core_addr {
     na_class_t *na_class;               /* NA class from NA address */
     na_addr_t na_addr;                  /* NA address */
-#ifdef HG_HAS_SM_ROUTING
-    na_addr_t na_sm_addr;               /* NA SM address */
-    uuid_t na_sm_uuid;                  /* NA SM UUID */
-#endif
-    hg_bool_t is_mine;                  /* Created internally or not */
+    na_addr_t na_self_addrs[HG_CORE_ROUTE_MAX]; /* Self NA addresses of other
+                                           routes (self address only) */
+    na_addr_t na_rail_addrs[HG_CORE_ROUTE_MAX]; /* NA addresses of peer on
+                                           other rails (NULL until looked up) */
+    hg_atomic_int32_t rails_looked_up;  /* Rail lookups were started */
+    struct hg_core_context *intern_context; /* Context source address is
+                                           interned on (NULL if not) */
+    HG_QUEUE_ENTRY(hg_core_addr) idle_entry; /* Entry in idle queue */
     hg_atomic_int32_t ref_count;        /* Reference count */
+    hg_thread_spin_t flow_lock;         /* Flow control lock */
+    unsigned int flow_window;           /* Requests allowed in flight by
+                                           target (0 if not advertised) */
+    unsigned int flow_outstanding;      /* Requests in flight */
+    HG_QUEUE_HEAD(hg_core_handle) flow_queue; /* Requests waiting for credit */
 };
 
 /* HG core op type */
@@ -189,6 +410,7 @@ typedef enum {
 /* HG core handle */
 struct hg_core_handle {
     struct hg_core_info hg_info;        /* HG info */
+    struct hg_core_context_route *route; /* Route of handle */
     na_class_t *na_class;               /* NA class */
     na_context_t *na_context;           /* NA context */
     hg_core_cb_t request_callback;      /* Request callback */
@@ -201,11 +423,25 @@ struct hg_core_handle {
     hg_return_t ret;                    /* Return code associated to handle */
     HG_LIST_ENTRY(hg_core_handle) created;  /* Created list entry */
     HG_LIST_ENTRY(hg_core_handle) pending;  /* Pending list entry */
+    HG_LIST_ENTRY(hg_core_handle) pool;     /* Pool list entry */
     struct hg_completion_entry hg_completion_entry; /* Entry in completion queue */
     hg_bool_t repost;                   /* Repost handle on completion (listen) */
+    hg_bool_t reuse;                    /* Return handle to pool on destroy */
     hg_bool_t is_self;                  /* Self processed */
     hg_atomic_int32_t in_use;           /* Is in use */
     hg_bool_t no_response;              /* Require response or not */
+    hg_time_t recv_time;                /* Time at which request was received */
+    hg_bool_t coalesced;                /* Request sent in coalesced message */
+    hg_bool_t flow_controlled;          /* Request holds a credit of target */
+    hg_bool_t flow_queued;              /* Request waits for a credit */
+    hg_bool_t rejected;                 /* Request rejected while overloaded */
+    HG_QUEUE_ENTRY(hg_core_handle) flow_entry; /* Entry in flow queue */
+    struct hg_core_handle *batch_next;  /* Next handle in coalesced message */
+    struct hg_core_timer deadline_timer; /* Forward deadline */
+    hg_bool_t deadline;                 /* Deadline timer armed on forward */
+    hg_bool_t timed_out;                /* Forward canceled by deadline */
+    struct hg_core_context *dispatch_context; /* Context processing request */
+    struct hg_core_context *process_context; /* Context running RPC callback */
 
     void *in_buf;                       /* Input buffer */
     void *in_buf_plugin_data;           /* Input buffer NA plugin data */
@@ -228,6 +464,8 @@ struct hg_core_handle {
 
     struct hg_core_header in_header;    /* Input header */
     struct hg_core_header out_header;   /* Output header */
+    hg_bool_t in_header_encoded;        /* Input header in buffer matches
+                                           in_header (origin only) */
 
     struct hg_core_rpc_info *hg_core_rpc_info;  /* Associated RPC info */
     void *data;                         /* User data */
@@ -251,6 +489,8 @@ struct hg_core_handle {
 struct hg_core_op_info_lookup {
     struct hg_core_addr *hg_core_addr;  /* Address */
     na_op_id_t na_lookup_op_id;         /* Operation ID for lookup */
+    char *name;                         /* Name to cache address under */
+    hg_return_t ret;                    /* Return code of lookup */
 };
 
 struct hg_core_op_id {
@@ -265,6 +505,28 @@ struct hg_core_op_id {
     struct hg_completion_entry hg_completion_entry; /* Entry in completion queue */
 };
 
+/* Lookup of a batch of addresses */
+struct hg_core_addr_batch;
+
+struct hg_core_addr_batch_entry {
+    struct hg_core_addr_batch *batch;   /* Batch of entry */
+    unsigned int index;                 /* Index of address in batch */
+};
+
+struct hg_core_addr_batch {
+    struct hg_core_op_id *hg_core_op_id; /* Completes the batch */
+    hg_core_addr_t *addrs;              /* Resolved addresses */
+    hg_atomic_int32_t remaining;        /* Lookups not yet completed */
+    struct hg_core_addr_batch_entry entries[1]; /* One entry per address */
+};
+
+/* Lookup of the NA address of a peer on one of its rails */
+struct hg_core_rail_lookup {
+    struct hg_core_class *hg_core_class; /* HG class */
+    struct hg_core_addr *hg_core_addr;  /* Address that rail belongs to */
+    unsigned int route;                 /* Route of rail */
+};
+
 /********************/
 /* Local Prototypes */
 /********************/
@@ -296,6 +558,48 @@ hg_core_int_hash(
         void *vlocation
         );
 
+/**
+ * Equal function for address cache.
+ */
+static HG_INLINE int
+hg_core_string_equal(
+        void *vlocation1,
+        void *vlocation2
+        );
+
+/**
+ * Hash function for address cache.
+ */
+static HG_INLINE unsigned int
+hg_core_string_hash(
+        void *vlocation
+        );
+
+/**
+ * Equal function for source address table.
+ */
+static HG_INLINE int
+hg_core_ptr_equal(
+        void *vlocation1,
+        void *vlocation2
+        );
+
+/**
+ * Hash function for source address table.
+ */
+static HG_INLINE unsigned int
+hg_core_ptr_hash(
+        void *vlocation
+        );
+
+/**
+ * Release addresses kept in address cache.
+ */
+static void
+hg_core_addr_cache_free(
+        struct hg_core_class *hg_core_class
+        );
+
 /**
  * Free function for value in function map.
  */
@@ -305,11 +609,44 @@ hg_core_func_map_value_free(
         );
 
 /**
- * Generate a new tag.
+ * Hash function for function map snapshot.
+ */
+static HG_INLINE unsigned int
+hg_core_func_map_hash(
+        hg_id_t id
+        );
+
+/**
+ * Publish new snapshot of function map if registrations changed it.
+ */
+static hg_return_t
+hg_core_func_map_publish(
+        struct hg_core_class *hg_core_class
+        );
+
+/**
+ * Lookup RPC info from function map snapshot (lock-free).
+ */
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_func_map_lookup(
+        struct hg_core_class *hg_core_class,
+        hg_id_t id
+        );
+
+/**
+ * Free function map snapshots and retired RPC info.
+ */
+static void
+hg_core_func_map_free(
+        struct hg_core_class *hg_core_class
+        );
+
+/**
+ * Generate a new tag within the context tag range.
  */
 static HG_INLINE na_tag_t
 hg_core_gen_request_tag(
-        struct hg_core_class *hg_core_class
+        struct hg_core_context *context
         );
 
 /**
@@ -351,18 +688,8 @@ hg_core_proc_header_response(
  */
 static hg_return_t
 hg_core_pending_list_cancel(
-        struct hg_core_context *context
-        );
-
-#ifdef HG_HAS_SM_ROUTING
-/**
- * Cancel entries from pending list.
- */
-static hg_return_t
-hg_core_sm_pending_list_cancel(
-        struct hg_core_context *context
+        struct hg_core_context_route *route
         );
-#endif
 
 /**
  * Wail until handle list is empty.
@@ -390,6 +717,48 @@ hg_core_finalize(
         struct hg_core_class *hg_core_class
         );
 
+/**
+ * Get route of context used with NA class.
+ */
+static HG_INLINE struct hg_core_context_route *
+hg_core_context_route_get(
+        struct hg_core_context *context,
+        na_class_t *na_class
+        );
+
+/**
+ * Check whether NA address string belongs to route.
+ */
+static hg_bool_t
+hg_core_route_match(
+        struct hg_core_route *route,
+        const char *na_name
+        );
+
+/**
+ * Split address string into the NA address strings it advertises.
+ */
+static hg_return_t
+hg_core_addr_split(
+        const char *name,
+        const char **names,
+        size_t *name_lens,
+        unsigned int *n_names
+        );
+
+/**
+ * Select fastest route reaching address string and extract NA address string
+ * of that route.
+ */
+static hg_return_t
+hg_core_route_select(
+        struct hg_core_class *hg_core_class,
+        const char *name,
+        char *na_name,
+        size_t na_name_size,
+        unsigned int *route_index
+        );
+
 /**
  * Create addr.
  */
@@ -398,6 +767,24 @@ hg_core_addr_create(
         struct hg_core_class *hg_core_class
         );
 
+/**
+ * Get the address of a request source, one address is kept per peer.
+ */
+static struct hg_core_addr *
+hg_core_addr_intern(
+        struct hg_core_context *context,
+        na_class_t *na_class,
+        na_addr_t na_addr
+        );
+
+/**
+ * Release source addresses of context.
+ */
+static void
+hg_core_addr_table_free(
+        struct hg_core_context *context
+        );
+
 /**
  * Lookup addr.
  */
@@ -426,6 +813,54 @@ hg_core_addr_lookup_complete(
         struct hg_core_op_id *hg_core_op_id
         );
 
+/**
+ * Lookup batch of addrs.
+ */
+static hg_return_t
+hg_core_addr_lookup_batch(
+        struct hg_core_context *context,
+        hg_core_cb_t callback,
+        void *arg,
+        const char **names,
+        unsigned int count,
+        hg_core_addr_t *addrs,
+        hg_core_op_id_t *op_id
+        );
+
+/**
+ * Lookup callback of addr in batch.
+ */
+static hg_return_t
+hg_core_addr_lookup_batch_cb(
+        const struct hg_core_cb_info *callback_info
+        );
+
+/**
+ * Complete one lookup of batch, batch completes with its last lookup.
+ */
+static void
+hg_core_addr_lookup_batch_done(
+        struct hg_core_addr_batch *batch
+        );
+
+/**
+ * Look up NA addresses of peer on the other rails of the route of addr.
+ */
+static hg_return_t
+hg_core_addr_lookup_rails(
+        struct hg_core_context *context,
+        struct hg_core_addr *hg_core_addr,
+        const char *name
+        );
+
+/**
+ * Rail lookup callback.
+ */
+static int
+hg_core_addr_lookup_rail_cb(
+        const struct na_cb_info *callback_info
+        );
+
 /**
  * Free addr.
  */
@@ -470,8 +905,16 @@ hg_core_addr_to_string(
  */
 static struct hg_core_handle *
 hg_core_create(
-        struct hg_core_context *context,
-        hg_bool_t use_sm
+        struct hg_core_context_route *route
+        );
+
+/**
+ * Create handle with internal address for receiving requests.
+ */
+static hg_return_t
+hg_core_create_target(
+        struct hg_core_context_route *route,
+        struct hg_core_handle **hg_core_handle_ptr
         );
 
 /**
@@ -482,6 +925,38 @@ hg_core_destroy(
         struct hg_core_handle *hg_core_handle
         );
 
+/**
+ * Free handle resources.
+ */
+static void
+hg_core_free(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Get handle from context pool.
+ */
+static struct hg_core_handle *
+hg_core_handle_pool_get(
+        struct hg_core_context_route *route
+        );
+
+/**
+ * Reset handle and return it to context pool.
+ */
+static hg_bool_t
+hg_core_handle_pool_put(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Free all handles from pool.
+ */
+static void
+hg_core_handle_pool_drain(
+        struct hg_core_handle_pool *hg_core_handle_pool
+        );
+
 /**
  * Reset handle.
  */
@@ -587,66 +1062,227 @@ hg_core_process_input(
         );
 
 /**
- * Send output callback.
- */
-static int
-hg_core_send_output_cb(
-        const struct na_cb_info *callback_info
-        );
-
-/**
- * Recv output callback.
+ * Check whether context is too loaded to accept request.
  */
-static int
-hg_core_recv_output_cb(
-        const struct na_cb_info *callback_info
+static hg_bool_t
+hg_core_overloaded(
+        struct hg_core_handle *hg_core_handle
         );
 
 /**
- * Process output.
+ * Split coalesced requests into separate handles and process them.
  */
 static hg_return_t
-hg_core_process_output(
-        struct hg_core_handle *hg_core_handle,
-        hg_bool_t *completed
+hg_core_process_batch(
+        struct hg_core_handle *hg_core_handle
         );
 
-#ifdef HG_HAS_SELF_FORWARD
 /**
- * Wrapper for local callback execution.
+ * Select context that a received request is processed on.
  */
-static hg_return_t
-hg_core_self_cb(
-        const struct hg_core_cb_info *callback_info
+static struct hg_core_context *
+hg_core_dispatch_select(
+        struct hg_core_handle *hg_core_handle
         );
 
 /**
- * Process handle thread (used for self execution).
+ * Request is no longer queued on its dispatch context.
  */
-static HG_INLINE HG_THREAD_RETURN_TYPE
-hg_core_process_thread(
-        void *arg
+static HG_INLINE void
+hg_core_dispatch_release(
+        struct hg_core_handle *hg_core_handle
         );
-#endif
 
 /**
- * Process handle.
+ * Add context to dispatch targets of its class.
  */
 static hg_return_t
-hg_core_process(
-        struct hg_core_handle *hg_core_handle
+hg_core_dispatch_register(
+        struct hg_core_context *context
         );
 
 /**
- * Complete handle and add to completion queue.
+ * Remove context from dispatch targets of its class.
  */
-static HG_INLINE hg_return_t
-hg_core_complete(
-        struct hg_core_handle *hg_core_handle
+static void
+hg_core_dispatch_deregister(
+        struct hg_core_context *context
         );
 
 /**
- * Add entry to completion queue.
+ * Encode 32-bit value of coalesced message entry.
+ */
+static HG_INLINE void
+hg_core_batch_encode32(
+        char *buf,
+        hg_uint32_t value
+        );
+
+/**
+ * Decode 32-bit value of coalesced message entry.
+ */
+static HG_INLINE hg_uint32_t
+hg_core_batch_decode32(
+        const char *buf
+        );
+
+/**
+ * Get size of coalesced messages for NA class.
+ */
+static HG_INLINE na_size_t
+hg_core_batch_get_size(
+        struct hg_core_class *hg_core_class,
+        na_class_t *na_class
+        );
+
+/**
+ * Add request to coalesced message of target.
+ */
+static hg_return_t
+hg_core_batch_add(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Open coalesced message to target of handle (batch mutex must be held).
+ */
+static hg_return_t
+hg_core_batch_create(
+        struct hg_core_handle *hg_core_handle,
+        struct hg_core_batch **hg_core_batch_ptr
+        );
+
+/**
+ * Send coalesced message.
+ */
+static void
+hg_core_batch_send(
+        struct hg_core_batch *hg_core_batch
+        );
+
+/**
+ * Release coalesced message and complete send of its requests.
+ */
+static int
+hg_core_batch_complete(
+        struct hg_core_batch *hg_core_batch,
+        hg_return_t hg_ret
+        );
+
+/**
+ * Send coalesced messages whose delay has expired (all if force is set) and
+ * return time remaining until the next one must be sent (negative if none).
+ */
+static void
+hg_core_batch_flush(
+        struct hg_core_context *context,
+        hg_bool_t force,
+        double *remaining
+        );
+
+/**
+ * Send coalesced messages that are due and return timeout bounded by the
+ * time at which the next ones are.
+ */
+static unsigned int
+hg_core_batch_progress_timeout(
+        struct hg_core_context *context,
+        unsigned int timeout
+        );
+
+/**
+ * Wake up progress when a coalesced message is opened.
+ */
+static HG_INLINE void
+hg_core_batch_wake(
+        struct hg_core_context *context
+        );
+
+/**
+ * Send coalesced message callback.
+ */
+static int
+hg_core_batch_send_cb(
+        const struct na_cb_info *callback_info
+        );
+
+/**
+ * Free coalesced messages kept for reuse.
+ */
+static void
+hg_core_batch_free_list(
+        struct hg_core_context *context
+        );
+
+/**
+ * Send output callback.
+ */
+static int
+hg_core_send_output_cb(
+        const struct na_cb_info *callback_info
+        );
+
+/**
+ * Recv output callback.
+ */
+static int
+hg_core_recv_output_cb(
+        const struct na_cb_info *callback_info
+        );
+
+/**
+ * Process output.
+ */
+static hg_return_t
+hg_core_process_output(
+        struct hg_core_handle *hg_core_handle,
+        hg_bool_t *completed
+        );
+
+#ifdef HG_HAS_SELF_FORWARD
+/**
+ * Wrapper for local callback execution.
+ */
+static hg_return_t
+hg_core_self_cb(
+        const struct hg_core_cb_info *callback_info
+        );
+
+/**
+ * Process handle thread (used for self execution).
+ */
+static HG_INLINE HG_THREAD_RETURN_TYPE
+hg_core_process_thread(
+        void *arg
+        );
+#endif
+
+/**
+ * Progress thread.
+ */
+static HG_THREAD_RETURN_TYPE
+hg_core_progress_thread(
+        void *arg
+        );
+
+/**
+ * Process handle.
+ */
+static hg_return_t
+hg_core_process(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Complete handle and add to completion queue.
+ */
+static HG_INLINE hg_return_t
+hg_core_complete(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Add entry to completion queue.
  */
 hg_return_t
 hg_core_completion_add(
@@ -655,15 +1291,68 @@ hg_core_completion_add(
         hg_bool_t self_notify
         );
 
+/**
+ * Get current tick of timer wheel.
+ */
+static HG_INLINE hg_util_uint64_t
+hg_core_timer_tick(
+        struct hg_core_timer_wheel *hg_core_timer_wheel
+        );
+
+/**
+ * Insert timer in slot matching its expiration (wheel lock must be held).
+ */
+static void
+hg_core_timer_insert(
+        struct hg_core_timer_wheel *hg_core_timer_wheel,
+        struct hg_core_timer *hg_core_timer
+        );
+
+/**
+ * Arm timer so that its callback gets called from progress after timeout
+ * (in milliseconds).
+ */
+void
+hg_core_timer_add(
+        struct hg_core_context *context,
+        struct hg_core_timer *hg_core_timer,
+        unsigned int timeout
+        );
+
+/**
+ * Disarm timer, wait for its callback to return if it is being called.
+ */
+void
+hg_core_timer_remove(
+        struct hg_core_context *context,
+        struct hg_core_timer *hg_core_timer
+        );
+
+/**
+ * Call callbacks of expired timers and return time in milliseconds until
+ * the next timer may expire.
+ */
+static unsigned int
+hg_core_timer_expire(
+        struct hg_core_context *context
+        );
+
+/**
+ * Cancel forward once its deadline has expired.
+ */
+static void
+hg_core_deadline_cb(
+        void *arg
+        );
+
 /**
  * Start listening for incoming RPC requests.
  */
 static hg_return_t
 hg_core_context_post(
-        struct hg_core_context *context,
+        struct hg_core_context_route *route,
         unsigned int request_count,
-        hg_bool_t repost,
-        hg_bool_t use_sm
+        hg_bool_t repost
         );
 
 /**
@@ -682,6 +1371,52 @@ hg_core_reset_post(
         struct hg_core_handle *hg_core_handle
         );
 
+/**
+ * Initialize post info.
+ */
+static void
+hg_core_post_info_init(
+        struct hg_core_post_info *hg_core_post_info,
+        unsigned int min,
+        unsigned int max
+        );
+
+/**
+ * Update arrival rate if sampling window has elapsed (lock must be held).
+ */
+static void
+hg_core_post_info_update(
+        struct hg_core_post_info *hg_core_post_info,
+        hg_time_t now
+        );
+
+/**
+ * Record arrival of a request and return number of handles to post.
+ */
+static unsigned int
+hg_core_post_info_arrival(
+        struct hg_core_post_info *hg_core_post_info,
+        hg_time_t now,
+        hg_bool_t pending_empty
+        );
+
+/**
+ * Record repost of a handle and return whether handle should be reposted.
+ */
+static hg_bool_t
+hg_core_post_info_repost(
+        struct hg_core_post_info *hg_core_post_info,
+        hg_time_t recv_time
+        );
+
+/**
+ * Cancel posted handles in excess after idle periods.
+ */
+static hg_return_t
+hg_core_post_info_shrink(
+        struct hg_core_context_route *route
+        );
+
 /**
  * Make progress on NA layer.
  */
@@ -704,7 +1439,8 @@ hg_core_completion_queue_notify_cb(
 #endif
 
 /**
- * Progress callback on NA layer when hg_core_progress_poll() is used.
+ * Progress callback on NA layer of a route when hg_core_progress_poll() is
+ * used.
  */
 static int
 hg_core_progress_na_cb(
@@ -713,18 +1449,6 @@ hg_core_progress_na_cb(
         hg_util_bool_t *progressed
         );
 
-#ifdef HG_HAS_SM_ROUTING
-/**
- * Progress callback on NA SM layer when hg_core_progress_poll() is used.
- */
-static int
-hg_core_progress_na_sm_cb(
-        void *arg,
-        unsigned int timeout,
-        hg_util_bool_t *progressed
-        );
-#endif
-
 /**
  * Callback for HG poll progress that determines when it is safe to block.
  */
@@ -742,6 +1466,100 @@ hg_core_progress_poll(
         unsigned int timeout
         );
 
+/**
+ * Allocate completion queue shards.
+ */
+static hg_return_t
+hg_core_completion_queue_init(
+        struct hg_core_context *context,
+        unsigned int n_shards
+        );
+
+/**
+ * Free completion queue shards.
+ */
+static void
+hg_core_completion_queue_free(
+        struct hg_core_context *context
+        );
+
+/**
+ * Get completion queue shard of the calling thread.
+ */
+static HG_INLINE unsigned int
+hg_core_completion_queue_shard(
+        struct hg_core_context *context
+        );
+
+/**
+ * Push entry to the calling thread's shard, growing it if full.
+ */
+static int
+hg_core_completion_queue_push(
+        struct hg_core_context *context,
+        struct hg_completion_entry *hg_completion_entry
+        );
+
+/**
+ * Pop entry from the calling thread's shard or steal from other shards.
+ */
+static struct hg_completion_entry *
+hg_core_completion_queue_pop(
+        struct hg_core_context *context
+        );
+
+/**
+ * Pop entry from high or low priority queue.
+ */
+static HG_INLINE struct hg_completion_entry *
+hg_core_completion_priority_pop(
+        struct hg_core_context *context,
+        hg_priority_t priority
+        );
+
+/**
+ * Pop next entry to trigger, high priority entries are taken first.
+ */
+static struct hg_completion_entry *
+hg_core_completion_pop(
+        struct hg_core_context *context
+        );
+
+/**
+ * Check whether completion queues (including backfill queue) are empty.
+ */
+static HG_INLINE hg_bool_t
+hg_core_completion_queue_is_empty(
+        struct hg_core_context *context
+        );
+
+/**
+ * Make progress and release posted handles that are no longer needed.
+ */
+static hg_return_t
+hg_core_progress(
+        struct hg_core_context *context,
+        unsigned int timeout
+        );
+
+/**
+ * Get number of CPUs available to the process (0 if unknown).
+ */
+static unsigned int
+hg_core_get_cpu_count(
+        void
+        );
+
+/**
+ * Poll without blocking for an adaptive window before progress blocks,
+ * timeout is updated with the time left.
+ */
+static hg_return_t
+hg_core_progress_spin(
+        struct hg_core_context *context,
+        unsigned int *timeout
+        );
+
 /**
  * Trigger callbacks.
  */
@@ -753,6 +1571,26 @@ hg_core_trigger(
         unsigned int *actual_count
         );
 
+/**
+ * Make progress and execute callbacks of operations that completed during
+ * progress without going through the completion queue.
+ */
+static hg_return_t
+hg_core_progress_and_trigger(
+        struct hg_core_context *context,
+        unsigned int timeout,
+        unsigned int max_count,
+        unsigned int *actual_count
+        );
+
+/**
+ * Trigger callback from completion entry.
+ */
+static hg_return_t
+hg_core_trigger_completion(
+        struct hg_completion_entry *hg_completion_entry
+        );
+
 /**
  * Trigger callback from HG lookup op ID.
  */
@@ -785,6 +1623,23 @@ hg_core_cancel(
         struct hg_core_handle *hg_core_handle
         );
 
+/**
+ * Take a credit of target, queue request if none is left.
+ */
+static hg_bool_t
+hg_core_flow_acquire(
+        struct hg_core_handle *hg_core_handle
+        );
+
+/**
+ * Return credit of request and send requests waiting for one.
+ */
+static void
+hg_core_flow_release(
+        struct hg_core_handle *hg_core_handle,
+        unsigned int credits
+        );
+
 #ifdef HG_HAS_COLLECT_STATS
 /**
  * Print stats.
@@ -801,7 +1656,10 @@ hg_core_print_stats(void);
 static hg_bool_t hg_core_print_stats_registered_g = HG_FALSE;
 static hg_core_stat_t hg_core_rpc_count_g = HG_CORE_STAT_INIT(0);
 static hg_core_stat_t hg_core_rpc_extra_count_g = HG_CORE_STAT_INIT(0);
+static hg_core_stat_t hg_core_rpc_busy_count_g = HG_CORE_STAT_INIT(0);
 static hg_core_stat_t hg_core_bulk_count_g = HG_CORE_STAT_INIT(0);
+static hg_core_stat_t hg_core_handle_pool_hit_count_g = HG_CORE_STAT_INIT(0);
+static hg_core_stat_t hg_core_handle_pool_miss_count_g = HG_CORE_STAT_INIT(0);
 #endif
 
 /*---------------------------------------------------------------------------*/
@@ -816,8 +1674,14 @@ hg_core_print_stats(void)
         (unsigned long) hg_core_stat_get(&hg_core_rpc_count_g));
     printf("RPC count (overflow): %lu\n",
         (unsigned long) hg_core_stat_get(&hg_core_rpc_extra_count_g));
+    printf("RPC count (rejected): %lu\n",
+        (unsigned long) hg_core_stat_get(&hg_core_rpc_busy_count_g));
     printf("Bulk transfer count:  %lu\n",
         (unsigned long) hg_core_stat_get(&hg_core_bulk_count_g));
+    printf("Handle pool hits:     %lu\n",
+        (unsigned long) hg_core_stat_get(&hg_core_handle_pool_hit_count_g));
+    printf("Handle pool misses:   %lu\n",
+        (unsigned long) hg_core_stat_get(&hg_core_handle_pool_miss_count_g));
 }
 #endif
 
@@ -872,6 +1736,54 @@ hg_core_int_hash(void *vlocation)
     return *((unsigned int *) vlocation);
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_core_string_equal(void *vlocation1, void *vlocation2)
+{
+    return strcmp((const char *) vlocation1, (const char *) vlocation2) == 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_string_hash(void *vlocation)
+{
+    return hg_hash_string((const char *) vlocation);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE int
+hg_core_ptr_equal(void *vlocation1, void *vlocation2)
+{
+    return vlocation1 == vlocation2;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_ptr_hash(void *vlocation)
+{
+    /* Low bits of heap pointers are not significant */
+    return (unsigned int) (((hg_ptr_t) vlocation) >> 4);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_cache_free(struct hg_core_class *hg_core_class)
+{
+    hg_hash_table_iter_t iter;
+
+    if (!hg_core_class->addr_cache)
+        return;
+
+    /* Drop references held by cache, keys are freed with the table */
+    hg_hash_table_iterate(hg_core_class->addr_cache, &iter);
+    while (hg_hash_table_iter_has_more(&iter))
+        hg_core_addr_free(hg_core_class,
+            (struct hg_core_addr *) hg_hash_table_iter_next(&iter));
+    hg_hash_table_free(hg_core_class->addr_cache);
+    hg_core_class->addr_cache = NULL;
+    hg_thread_spin_destroy(&hg_core_class->addr_cache_lock);
+}
+
 /*---------------------------------------------------------------------------*/
 static void
 hg_core_func_map_value_free(hg_hash_table_value_t value)
@@ -884,19 +1796,139 @@ hg_core_func_map_value_free(hg_hash_table_value_t value)
 }
 
 /*---------------------------------------------------------------------------*/
-static HG_INLINE na_tag_t
-hg_core_gen_request_tag(struct hg_core_class *hg_core_class)
+static HG_INLINE unsigned int
+hg_core_func_map_hash(hg_id_t id)
+{
+    /* Fibonacci hashing of the folded 64-bit ID */
+    return (unsigned int) (id ^ (id >> 32)) * 2654435761U;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_func_map_publish(struct hg_core_class *hg_core_class)
 {
-    na_tag_t request_tag = 0;
+    struct hg_core_func_map_table *new_table, *old_table;
+    hg_hash_table_iter_t iter;
+    unsigned int n_slots;
+    hg_return_t ret = HG_SUCCESS;
 
-    /* Compare and swap tag if reached max tag */
-    if (!hg_atomic_cas32(&hg_core_class->request_tag,
-        (hg_util_int32_t) hg_core_class->request_max_tag, 0)) {
-        /* Increment tag */
-        request_tag = (na_tag_t) hg_atomic_incr32(&hg_core_class->request_tag);
+    hg_thread_spin_lock(&hg_core_class->func_map_lock);
+
+    /* Another lookup may have published it already */
+    if (!hg_atomic_get32(&hg_core_class->func_map_dirty))
+        goto done;
+
+    /* Keep load factor under 1/2 without shrinking */
+    old_table = (struct hg_core_func_map_table *) hg_atomic_get64(
+        &hg_core_class->func_map_table);
+    n_slots = old_table ? old_table->mask + 1 : HG_CORE_FUNC_MAP_MIN_SIZE;
+    while (n_slots < 2 * hg_hash_table_num_entries(hg_core_class->func_map))
+        n_slots <<= 1;
+
+    new_table = (struct hg_core_func_map_table *) calloc(1,
+        sizeof(struct hg_core_func_map_table)
+        + (n_slots - 1) * sizeof(struct hg_core_func_map_entry));
+    if (!new_table) {
+        HG_LOG_ERROR("Could not allocate function map snapshot");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    new_table->mask = n_slots - 1;
+
+    hg_hash_table_iterate(hg_core_class->func_map, &iter);
+    while (hg_hash_table_iter_has_more(&iter)) {
+        struct hg_core_rpc_info *hg_core_rpc_info =
+            (struct hg_core_rpc_info *) hg_hash_table_iter_next(&iter);
+        unsigned int i = hg_core_func_map_hash(hg_core_rpc_info->id)
+            & new_table->mask;
+
+        while (new_table->entries[i].hg_core_rpc_info)
+            i = (i + 1) & new_table->mask;
+        new_table->entries[i].id = hg_core_rpc_info->id;
+        new_table->entries[i].hg_core_rpc_info = hg_core_rpc_info;
+    }
+
+    /* Publish new snapshot, lookups may still be using the old one */
+    hg_atomic_set64(&hg_core_class->func_map_table,
+        (hg_util_int64_t) new_table);
+    hg_atomic_set32(&hg_core_class->func_map_dirty, 0);
+    if (old_table) {
+        old_table->retired = hg_core_class->func_map_retired;
+        hg_core_class->func_map_retired = old_table;
+    }
+
+done:
+    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_rpc_info *
+hg_core_func_map_lookup(struct hg_core_class *hg_core_class, hg_id_t id)
+{
+    struct hg_core_func_map_table *table;
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    unsigned int i;
+
+    /* Publish registrations made since last snapshot, look up the function
+     * map itself if the snapshot cannot be built */
+    if (hg_atomic_get32(&hg_core_class->func_map_dirty)
+        && hg_core_func_map_publish(hg_core_class) != HG_SUCCESS) {
+        hg_thread_spin_lock(&hg_core_class->func_map_lock);
+        hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
+            hg_core_class->func_map, (hg_hash_table_key_t) &id);
+        hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+        return hg_core_rpc_info;
+    }
+
+    table = (struct hg_core_func_map_table *) hg_atomic_get64(
+        &hg_core_class->func_map_table);
+    if (table) {
+        for (i = hg_core_func_map_hash(id) & table->mask;
+            table->entries[i].hg_core_rpc_info; i = (i + 1) & table->mask) {
+            if (table->entries[i].id == id) {
+                hg_core_rpc_info = table->entries[i].hg_core_rpc_info;
+                break;
+            }
+        }
     }
 
-    return request_tag;
+    return hg_core_rpc_info;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_func_map_free(struct hg_core_class *hg_core_class)
+{
+    struct hg_core_func_map_table *table =
+        (struct hg_core_func_map_table *) hg_atomic_get64(
+            &hg_core_class->func_map_table);
+
+    free(table);
+    hg_atomic_set64(&hg_core_class->func_map_table, 0);
+
+    while (hg_core_class->func_map_retired) {
+        table = hg_core_class->func_map_retired;
+        hg_core_class->func_map_retired = table->retired;
+        free(table);
+    }
+
+    while (hg_core_class->rpc_info_retired) {
+        struct hg_core_rpc_info *hg_core_rpc_info =
+            hg_core_class->rpc_info_retired;
+        hg_core_class->rpc_info_retired = hg_core_rpc_info->retired;
+        free(hg_core_rpc_info);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_tag_t
+hg_core_gen_request_tag(struct hg_core_context *context)
+{
+    /* Range is a power of two so counter wrap-around is seamless */
+    return context->request_tag_base + ((na_tag_t) hg_atomic_incr32(
+        &context->request_tag->value)
+        & (context->hg_core_class->request_tag_range - 1));
 }
 
 /*---------------------------------------------------------------------------*/
@@ -989,15 +2021,16 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_pending_list_cancel(struct hg_core_context *context)
+hg_core_pending_list_cancel(struct hg_core_context_route *route)
 {
     hg_return_t ret = HG_SUCCESS;
 
-    hg_thread_spin_lock(&context->pending_list_lock);
+    hg_thread_spin_lock(&route->pending_list_lock);
 
-    while (!HG_LIST_IS_EMPTY(&context->pending_list)) {
-        struct hg_core_handle *hg_core_handle = HG_LIST_FIRST(&context->pending_list);
+    while (!HG_LIST_IS_EMPTY(&route->pending_list)) {
+        struct hg_core_handle *hg_core_handle = HG_LIST_FIRST(&route->pending_list);
         HG_LIST_REMOVE(hg_core_handle, pending);
+        hg_core_handle->pending.prev = NULL;
 
         /* Prevent reposts */
         hg_core_handle->repost = HG_FALSE;
@@ -1010,40 +2043,10 @@ hg_core_pending_list_cancel(struct hg_core_context *context)
         }
     }
 
-    hg_thread_spin_unlock(&context->pending_list_lock);
-
-    return ret;
-}
-
-/*---------------------------------------------------------------------------*/
-#ifdef HG_HAS_SM_ROUTING
-static hg_return_t
-hg_core_sm_pending_list_cancel(struct hg_core_context *context)
-{
-    hg_return_t ret = HG_SUCCESS;
-
-    hg_thread_spin_lock(&context->sm_pending_list_lock);
-
-    while (!HG_LIST_IS_EMPTY(&context->sm_pending_list)) {
-        struct hg_core_handle *hg_core_handle = HG_LIST_FIRST(&context->sm_pending_list);
-        HG_LIST_REMOVE(hg_core_handle, pending);
-
-        /* Prevent reposts */
-        hg_core_handle->repost = HG_FALSE;
-
-        /* Cancel handle */
-        ret = hg_core_cancel(hg_core_handle);
-        if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not cancel SM handle");
-            break;
-        }
-    }
-
-    hg_thread_spin_unlock(&context->sm_pending_list_lock);
+    hg_thread_spin_unlock(&route->pending_list_lock);
 
     return ret;
 }
-#endif
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
@@ -1070,7 +2073,8 @@ hg_core_created_list_wait(struct hg_core_context *context)
         created_list_empty = HG_LIST_IS_EMPTY(&context->created_list);
         hg_thread_spin_unlock(&context->created_list_lock);
 
-        if (created_list_empty)
+        /* Also process requests dispatched to this context */
+        if (created_list_empty && !hg_atomic_get32(&context->dispatch_load))
             break;
 
         ret = context->progress(context, (unsigned int) (remaining * 1000.0));
@@ -1092,11 +2096,12 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
     const struct hg_init_info *hg_init_info)
 {
     struct hg_core_class *hg_core_class = NULL;
+    struct na_init_info na_init_info;
+    const struct na_init_info *na_init_info_ptr = NULL;
     na_tag_t na_max_tag;
-#ifdef HG_HAS_SM_ROUTING
-    na_tag_t na_sm_max_tag;
+    hg_util_uint64_t tag_range;
+    unsigned int i;
     hg_bool_t auto_sm = HG_FALSE;
-#endif
     hg_return_t ret = HG_SUCCESS;
 
     /* Create new HG class */
@@ -1116,19 +2121,65 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
             hg_core_class->na_ext_init = HG_TRUE;
         }
         hg_core_class->progress_mode = hg_init_info->na_init_info.progress_mode;
+        hg_core_class->progress_spin = hg_init_info->progress_spin;
+        /* Spinning only delays the peer when there is a single CPU */
+        if (hg_core_class->progress_spin && hg_core_get_cpu_count() == 1)
+            hg_core_class->progress_spin = HG_FALSE;
+        hg_core_class->handle_pool_size = hg_init_info->handle_pool_size;
+        hg_core_class->request_post_min = hg_init_info->request_post_min;
+        hg_core_class->request_post_max = hg_init_info->request_post_max;
+        hg_core_class->completion_queue_shards =
+            hg_init_info->completion_queue_shards;
+        hg_core_class->request_credits = hg_init_info->request_credits;
+        if (hg_core_class->request_credits > 0xFFFF)
+            hg_core_class->request_credits = 0xFFFF;
+        hg_core_class->busy_queue_depth = hg_init_info->busy_queue_depth;
+        hg_core_class->busy_latency = hg_init_info->busy_latency * 1000;
+        hg_core_class->self_inline = hg_init_info->self_inline;
+        hg_core_class->coalesce_count = hg_init_info->coalesce_count;
+        hg_core_class->coalesce_size = hg_init_info->coalesce_size;
+        hg_core_class->coalesce_timeout =
+            hg_init_info->coalesce_timeout / 1000000.0;
+        hg_core_class->bulk_stripe_size = hg_init_info->bulk_stripe_size;
+        if (hg_core_class->request_post_max
+            && hg_core_class->request_post_min > hg_core_class->request_post_max) {
+            HG_LOG_ERROR("Min number of posted handles (%u) exceeds max (%u)",
+                hg_core_class->request_post_min,
+                hg_core_class->request_post_max);
+            ret = HG_INVALID_PARAM;
+            goto done;
+        }
+        hg_core_class->dispatch_policy = hg_init_info->dispatch_policy;
+        if (hg_core_class->dispatch_policy != HG_DISPATCH_NONE) {
+            hg_thread_rwlock_init(&hg_core_class->dispatch_lock);
+            hg_atomic_init32(&hg_core_class->dispatch_next, 0);
+        }
 
 #ifdef HG_HAS_SM_ROUTING
         auto_sm = hg_init_info->auto_sm;
-#elif
+#else
         if (hg_init_info->auto_sm) {
             HG_LOG_ERROR("Shared memory routing not supported. Please enable through CMake `-DMERCURY_USE_SM_ROUTING`");
             ret = HG_PROTOCOL_ERROR;
             goto done;
         }
 #endif
+        if (hg_init_info->na_route_count + (auto_sm ? 2 : 1)
+            > HG_CORE_ROUTE_MAX) {
+            HG_LOG_ERROR("Too many NA routes (%u), max is %d",
+                hg_init_info->na_route_count, HG_CORE_ROUTE_MAX);
+            ret = HG_INVALID_PARAM;
+            goto done;
+        }
+
+        na_init_info = hg_init_info->na_init_info;
+        na_init_info_ptr = &na_init_info;
 
 #ifdef HG_HAS_COLLECT_STATS
         hg_core_class->stats = hg_init_info->stats;
+        /* NA classes print their stats along with ours */
+        if (hg_core_class->stats)
+            na_init_info.stats = NA_TRUE;
         if (hg_core_class->stats && !hg_core_print_stats_registered_g) {
             if (atexit(hg_core_print_stats) != 0) {
                 HG_LOG_ERROR("Could not register hg_core_print_stats");
@@ -1140,10 +2191,17 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
 #endif
     }
 
+#ifdef HG_HAS_POST_LIMIT
+    /* Post limit is the default max number of posted handles */
+    if (!hg_core_class->request_post_min && !hg_core_class->request_post_max
+        && HG_POST_LIMIT > 0)
+        hg_core_class->request_post_max = HG_POST_LIMIT;
+#endif
+
     /* Initialize NA if not provided externally */
     if (!hg_core_class->na_ext_init) {
         hg_core_class->na_class = NA_Initialize_opt(na_info_string, na_listen,
-            &hg_init_info->na_init_info);
+            na_init_info_ptr);
         if (!hg_core_class->na_class) {
             HG_LOG_ERROR("Could not initialize NA class");
             ret = HG_NA_ERROR;
@@ -1152,8 +2210,11 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
     }
 
 #ifdef HG_HAS_SM_ROUTING
-    /* Initialize SM plugin */
+    /* Initialize SM plugin, preferred for local addresses */
     if (auto_sm) {
+        struct hg_core_route *route =
+            &hg_core_class->routes[hg_core_class->n_routes];
+
         if (strcmp(NA_Get_class_name(hg_core_class->na_class), "na") == 0) {
             HG_LOG_ERROR("Cannot use auto SM mode if initialized NA class is "
                 "already using SM");
@@ -1162,13 +2223,15 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
         }
 
         /* Initialize NA SM first so that tmp directories are created */
-        hg_core_class->na_sm_class = NA_Initialize_opt("na+sm", na_listen,
-            &hg_init_info->na_init_info);
-        if (!hg_core_class->na_sm_class) {
+        route->na_class = NA_Initialize_opt("na+sm", na_listen,
+            na_init_info_ptr);
+        if (!route->na_class) {
             HG_LOG_ERROR("Could not initialize NA SM class");
             ret = HG_NA_ERROR;
             goto done;
         }
+        route->local = HG_TRUE;
+        hg_core_class->n_routes++;
 
         /* Get SM UUID */
         ret = hg_core_get_sm_uuid(&hg_core_class->na_sm_uuid);
@@ -1179,30 +2242,87 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
     }
 #endif
 
-    /* Compute max request tag */
-    na_max_tag = NA_Msg_get_max_tag(hg_core_class->na_class);
-    if (!na_max_tag) {
-        HG_LOG_ERROR("NA Max tag is not defined");
-        ret = HG_NA_ERROR;
-        goto done;
+    /* Main route */
+    hg_core_class->main_route = hg_core_class->n_routes;
+    hg_core_class->routes[hg_core_class->n_routes++].na_class =
+        hg_core_class->na_class;
+
+    /* Additional routes, used when peers do not advertise the main one,
+     * peers look up rails by name to reach memory striped across them so
+     * that these must listen once striping is enabled */
+    for (i = 0; hg_init_info && i < hg_init_info->na_route_count; i++) {
+        struct hg_core_route *route =
+            &hg_core_class->routes[hg_core_class->n_routes];
+
+        route->na_class = NA_Initialize_opt(hg_init_info->na_routes[i],
+            (na_listen || hg_init_info->bulk_stripe_size) ? NA_TRUE : NA_FALSE,
+            na_init_info_ptr);
+        if (!route->na_class) {
+            HG_LOG_ERROR("Could not initialize NA class for %s",
+                hg_init_info->na_routes[i]);
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+        hg_core_class->n_routes++;
     }
-    hg_core_class->request_max_tag = na_max_tag;
 
-#ifdef HG_HAS_SM_ROUTING
-    if (auto_sm) {
-        na_sm_max_tag = NA_Msg_get_max_tag(hg_core_class->na_sm_class);
+    /* Routes of the same class and protocol are rails to the same peers,
+     * local routes only reach processes of node and are never rails */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        struct hg_core_route *route = &hg_core_class->routes[i];
+        unsigned int j;
+
+        route->rail_group = i;
+        if (route->local)
+            continue;
+        for (j = 0; j < i; j++) {
+            struct hg_core_route *prev = &hg_core_class->routes[j];
+
+            if (!prev->local
+                && strcmp(NA_Get_class_name(prev->na_class),
+                    NA_Get_class_name(route->na_class)) == 0
+                && strcmp(NA_Get_class_protocol(prev->na_class),
+                    NA_Get_class_protocol(route->na_class)) == 0) {
+                route->rail_group = j;
+                hg_core_class->has_rails = HG_TRUE;
+                break;
+            }
+        }
+    }
+
+    /* Compute max request tag, tags must be valid on every route */
+    hg_core_class->request_max_tag = 0;
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        na_max_tag = NA_Msg_get_max_tag(hg_core_class->routes[i].na_class);
         if (!na_max_tag) {
             HG_LOG_ERROR("NA Max tag is not defined");
             ret = HG_NA_ERROR;
             goto done;
         }
-        hg_core_class->request_max_tag = HG_CORE_MIN(hg_core_class->request_max_tag,
-            na_sm_max_tag);
-    }
-#endif
-
-    /* Initialize atomic for tags */
-    hg_atomic_init32(&hg_core_class->request_tag, 0);
+        hg_core_class->request_max_tag = (i == 0) ? na_max_tag :
+            HG_CORE_MIN(hg_core_class->request_max_tag, na_max_tag);
+    }
+
+    /* Split tag space into one range per context expected (max_contexts of
+     * NA init info) so that contexts do not share a counter, ranges are
+     * powers of two that fit within max tag. A single context keeps the
+     * whole tag space, contexts sharing a range still get distinct tags */
+    tag_range = 1;
+    while (tag_range < 0x80000000ULL
+        && tag_range * 2 <= (hg_util_uint64_t) hg_core_class->request_max_tag + 1)
+        tag_range <<= 1;
+    hg_core_class->request_tag_range = (na_tag_t) tag_range;
+    hg_core_class->request_tag_partitions = 1;
+    while (hg_core_class->request_tag_partitions < HG_CORE_TAG_PARTITIONS_MAX
+        && hg_init_info && hg_core_class->request_tag_partitions
+            < hg_init_info->na_init_info.max_contexts
+        && hg_core_class->request_tag_range / 2 >= HG_CORE_TAG_RANGE_MIN) {
+        hg_core_class->request_tag_partitions <<= 1;
+        hg_core_class->request_tag_range >>= 1;
+    }
+    for (i = 0; i < HG_CORE_TAG_PARTITIONS_MAX; i++)
+        hg_atomic_init32(&hg_core_class->request_tags[i].value, 0);
+    hg_atomic_init32(&hg_core_class->request_tag_next, 0);
 
     /* No context created yet */
     hg_atomic_init32(&hg_core_class->n_contexts, 0);
@@ -1217,13 +2337,85 @@ hg_core_init(const char *na_info_string, hg_bool_t na_listen,
         ret = HG_NOMEM_ERROR;
         goto done;
     }
-    /* Automatically free all the values with the hash map */
-    hg_hash_table_register_free_functions(hg_core_class->func_map, free,
-            hg_core_func_map_value_free);
+    /* Automatically free keys with the hash map, values may still be
+     * referenced from a function map snapshot and are freed separately */
+    hg_hash_table_register_free_functions(hg_core_class->func_map, free, NULL);
+
+    /* Create address cache */
+    if (hg_init_info && hg_init_info->addr_cache) {
+        hg_core_class->addr_cache = hg_hash_table_new(hg_core_string_hash,
+            hg_core_string_equal);
+        if (!hg_core_class->addr_cache) {
+            HG_LOG_ERROR("Could not create address cache");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        /* Cached addresses are released separately */
+        hg_hash_table_register_free_functions(hg_core_class->addr_cache, free,
+            NULL);
+        hg_thread_spin_init(&hg_core_class->addr_cache_lock);
+    }
+
+    /* No function map snapshot published yet */
+    hg_atomic_init64(&hg_core_class->func_map_table, 0);
+    hg_atomic_init32(&hg_core_class->func_map_dirty, 0);
 
     /* Initialize mutex */
     hg_thread_spin_init(&hg_core_class->func_map_lock);
 
+    /* Create key for inline completion queues */
+    if (hg_thread_key_create(&hg_core_class->inline_key) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not create thread key");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_core_class->inline_key_created = HG_TRUE;
+
+    /* Create key for thread index of completion queue shards */
+    if (hg_thread_key_create(&hg_core_class->trigger_key) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not create thread key");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_core_class->trigger_key_created = HG_TRUE;
+    hg_atomic_init32(&hg_core_class->trigger_index, 0);
+
+    /* Create key for timer callbacks */
+    if (hg_thread_key_create(&hg_core_class->timer_key) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not create thread key");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_core_class->timer_key_created = HG_TRUE;
+
+    /* Keep self address string so that bulk handles can tell peers how to
+     * reach their memory on every rail */
+    if (hg_core_class->has_rails) {
+        struct hg_core_addr *self_addr = NULL;
+        char addr_str[HG_CORE_ADDR_MAX_SIZE];
+        hg_size_t addr_str_size = sizeof(addr_str);
+
+        ret = hg_core_addr_self(hg_core_class, &self_addr);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not get self address");
+            hg_core_addr_free(hg_core_class, self_addr);
+            goto done;
+        }
+        ret = hg_core_addr_to_string(hg_core_class, addr_str, &addr_str_size,
+            self_addr);
+        hg_core_addr_free(hg_core_class, self_addr);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not convert self address to string");
+            goto done;
+        }
+        hg_core_class->rail_addr_string = strdup(addr_str);
+        if (!hg_core_class->rail_addr_string) {
+            HG_LOG_ERROR("Could not duplicate self address string");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+    }
+
 done:
     if (ret != HG_SUCCESS) {
         hg_core_finalize(hg_core_class);
@@ -1237,6 +2429,7 @@ static hg_return_t
 hg_core_finalize(struct hg_core_class *hg_core_class)
 {
     hg_util_int32_t n_addrs, n_contexts;
+    unsigned int i;
     hg_return_t ret = HG_SUCCESS;
 
     if (!hg_core_class) goto done;
@@ -1249,6 +2442,9 @@ hg_core_finalize(struct hg_core_class *hg_core_class)
         goto done;
     }
 
+    /* Release cached addresses first */
+    hg_core_addr_cache_free(hg_core_class);
+
     n_addrs = hg_atomic_get32(&hg_core_class->n_addrs);
     if (n_addrs != 0) {
         HG_LOG_ERROR("HG addrs must be freed before finalizing HG"
@@ -1258,9 +2454,16 @@ hg_core_finalize(struct hg_core_class *hg_core_class)
     }
 
     /* Delete function map */
-    if(hg_core_class->func_map)
+    if(hg_core_class->func_map) {
+        hg_hash_table_iter_t iter;
+
+        hg_hash_table_iterate(hg_core_class->func_map, &iter);
+        while (hg_hash_table_iter_has_more(&iter))
+            hg_core_func_map_value_free(hg_hash_table_iter_next(&iter));
         hg_hash_table_free(hg_core_class->func_map);
+    }
     hg_core_class->func_map = NULL;
+    hg_core_func_map_free(hg_core_class);
 
     /* Free user data */
     if (hg_core_class->data_free_callback)
@@ -1268,6 +2471,21 @@ hg_core_finalize(struct hg_core_class *hg_core_class)
 
     /* Destroy mutex */
     hg_thread_spin_destroy(&hg_core_class->func_map_lock);
+    if (hg_core_class->dispatch_policy != HG_DISPATCH_NONE)
+        hg_thread_rwlock_destroy(&hg_core_class->dispatch_lock);
+    free(hg_core_class->dispatch_contexts);
+    free(hg_core_class->rail_addr_string);
+
+    /* Delete inline key */
+    if (hg_core_class->inline_key_created)
+        hg_thread_key_delete(hg_core_class->inline_key);
+    hg_core_class->inline_key_created = HG_FALSE;
+    if (hg_core_class->trigger_key_created)
+        hg_thread_key_delete(hg_core_class->trigger_key);
+    hg_core_class->trigger_key_created = HG_FALSE;
+    if (hg_core_class->timer_key_created)
+        hg_thread_key_delete(hg_core_class->timer_key);
+    hg_core_class->timer_key_created = HG_FALSE;
 
     if (!hg_core_class->na_ext_init) {
         /* Finalize interface */
@@ -1276,22 +2494,170 @@ hg_core_finalize(struct hg_core_class *hg_core_class)
             ret = HG_NA_ERROR;
             goto done;
         }
-        hg_core_class->na_class = NULL;
+        hg_core_class->na_class = NULL;
+    }
+
+    /* Finalize interfaces of other routes */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        if (i == hg_core_class->main_route)
+            continue;
+        if (NA_Finalize(hg_core_class->routes[i].na_class) != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not finalize NA interface");
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+        hg_core_class->routes[i].na_class = NULL;
+    }
+
+done:
+    /* Free HG class */
+    free(hg_core_class);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_core_context_route *
+hg_core_context_route_get(struct hg_core_context *context, na_class_t *na_class)
+{
+    unsigned int i;
+
+    for (i = 0; i < context->hg_core_class->n_routes; i++)
+        if (context->routes[i].na_class == na_class)
+            return &context->routes[i];
+
+    return &context->routes[context->hg_core_class->main_route];
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_route_match(struct hg_core_route *route, const char *na_name)
+{
+    const char *class_name = NA_Get_class_name(route->na_class);
+    const char *protocol = NA_Get_class_protocol(route->na_class);
+    size_t class_len, protocol_len;
+
+    if (!class_name || !protocol)
+        return HG_FALSE;
+    class_len = strlen(class_name);
+    protocol_len = strlen(protocol);
+
+    /* NA address strings are prefixed by "class+protocol" */
+    if (strncmp(na_name, class_name, class_len) != 0
+        || na_name[class_len] != '+'
+        || strncmp(na_name + class_len + 1, protocol, protocol_len) != 0)
+        return HG_FALSE;
+
+    switch (na_name[class_len + 1 + protocol_len]) {
+        case ':':
+        case ';':
+        case '\0':
+            return HG_TRUE;
+        default:
+            return HG_FALSE;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_split(const char *name, const char **names, size_t *name_lens,
+    unsigned int *n_names)
+{
+    const char *str = name;
+    unsigned int n = 1;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* NA address strings may contain delimiters themselves so only those
+     * followed by a class name or by the UUID start a new one */
+    names[0] = name;
+    while ((str = strstr(str, HG_CORE_ADDR_DELIMITER))) {
+        const char *next = str + 1;
+        size_t span = strcspn(next, HG_CORE_PROTO_DELIMITER
+            HG_CORE_ADDR_DELIMITER);
+
+        str = next;
+        if (!memchr(next, '+', span) && !(span == 3
+            && strncmp(next, "uid", 3) == 0))
+            continue;
+        if (n == HG_CORE_ROUTE_MAX + 1) {
+            HG_LOG_ERROR("Malformed address format");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        name_lens[n - 1] = (size_t) (next - 1 - names[n - 1]);
+        names[n++] = next;
+    }
+    name_lens[n - 1] = strlen(names[n - 1]);
+    *n_names = n;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_route_select(struct hg_core_class *hg_core_class, const char *name,
+    char *na_name, size_t na_name_size, unsigned int *route_index)
+{
+    const char *names[HG_CORE_ROUTE_MAX + 1];
+    size_t name_lens[HG_CORE_ROUTE_MAX + 1];
+    unsigned int n_names, i, j;
+    hg_bool_t local = HG_FALSE;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Split string into NA address strings */
+    ret = hg_core_addr_split(name, names, name_lens, &n_names);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+#ifdef HG_HAS_SM_ROUTING
+    /* Addresses of processes sharing node with SM carry its UUID */
+    for (i = 0; i < n_names; i++) {
+        char uuid_str[HG_CORE_UUID_MAX_LEN + 1];
+        uuid_t na_sm_uuid;
+
+        if (strncmp(names[i], "uid://", 6) != 0)
+            continue;
+        if (name_lens[i] - 6 > HG_CORE_UUID_MAX_LEN) {
+            HG_LOG_ERROR("Malformed address format");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+        memcpy(uuid_str, names[i] + 6, name_lens[i] - 6);
+        uuid_str[name_lens[i] - 6] = '\0';
+        if (uuid_parse(uuid_str, na_sm_uuid) == 0
+            && uuid_compare(na_sm_uuid, hg_core_class->na_sm_uuid) == 0)
+            local = HG_TRUE;
+    }
+#endif
+
+    /* Pick fastest route among those advertised, local routes can only be
+     * used with processes sharing node */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        struct hg_core_route *route = &hg_core_class->routes[i];
+
+        if (route->local && n_names > 1 && !local)
+            continue;
+        for (j = 0; j < n_names; j++)
+            if (hg_core_route_match(route, names[j]))
+                goto found;
     }
 
-#ifdef HG_HAS_SM_ROUTING
-    /* Finalize SM interface */
-    if (NA_Finalize(hg_core_class->na_sm_class) != NA_SUCCESS) {
-        HG_LOG_ERROR("Could not finalize NA SM interface");
-        ret = HG_NA_ERROR;
+    /* Otherwise use main route with last address string */
+    i = hg_core_class->main_route;
+    j = n_names - 1;
+
+found:
+    if (name_lens[j] >= na_name_size) {
+        HG_LOG_ERROR("Address string exceeds max size (%zu)", na_name_size);
+        ret = HG_SIZE_ERROR;
         goto done;
     }
-#endif
+    memcpy(na_name, names[j], name_lens[j]);
+    na_name[name_lens[j]] = '\0';
+    *route_index = i;
 
 done:
-    /* Free HG class */
-    free(hg_core_class);
-
     return ret;
 }
 
@@ -1308,10 +2674,9 @@ hg_core_addr_create(struct hg_core_class *hg_core_class)
     }
     memset(hg_core_addr, 0, sizeof(struct hg_core_addr));
     hg_core_addr->na_addr = NA_ADDR_NULL;
-#ifdef HG_HAS_SM_ROUTING
-    hg_core_addr->na_sm_addr = NA_ADDR_NULL;
-#endif
     hg_atomic_init32(&hg_core_addr->ref_count, 1);
+    hg_thread_spin_init(&hg_core_addr->flow_lock);
+    HG_QUEUE_INIT(&hg_core_addr->flow_queue);
 
     /* Increment N addrs from HG class */
     hg_atomic_incr32(&hg_core_class->n_addrs);
@@ -1320,20 +2685,89 @@ done:
     return hg_core_addr;
 }
 
+/*---------------------------------------------------------------------------*/
+static struct hg_core_addr *
+hg_core_addr_intern(struct hg_core_context *context, na_class_t *na_class,
+    na_addr_t na_addr)
+{
+    struct hg_core_addr *hg_core_addr;
+
+    /* NA keeps one address per peer for most plugins, key on it so that
+     * requests from the same peer share the same HG address */
+    hg_thread_spin_lock(&context->addr_table_lock);
+    hg_core_addr = (struct hg_core_addr *) hg_hash_table_lookup(
+        context->addr_table, (hg_hash_table_key_t) na_addr);
+    if (hg_core_addr) {
+        /* Address is referenced again */
+        if (hg_atomic_incr32(&hg_core_addr->ref_count) == 1) {
+            HG_QUEUE_REMOVE(&context->addr_idle_queue, hg_core_addr,
+                hg_core_addr, idle_entry);
+            context->addr_idle_count--;
+        }
+        hg_thread_spin_unlock(&context->addr_table_lock);
+        /* Interned address already holds a reference to NA address */
+        NA_Addr_free(na_class, na_addr);
+        goto done;
+    }
+
+    hg_core_addr = hg_core_addr_create(context->hg_core_class);
+    if (!hg_core_addr) {
+        hg_thread_spin_unlock(&context->addr_table_lock);
+        HG_LOG_ERROR("Could not create HG addr");
+        NA_Addr_free(na_class, na_addr);
+        goto done;
+    }
+    hg_core_addr->na_class = na_class;
+    hg_core_addr->na_addr = na_addr;
+    if (hg_hash_table_insert(context->addr_table, (hg_hash_table_key_t) na_addr,
+        (hg_hash_table_value_t) hg_core_addr))
+        hg_core_addr->intern_context = context;
+    hg_thread_spin_unlock(&context->addr_table_lock);
+
+done:
+    return hg_core_addr;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_table_free(struct hg_core_context *context)
+{
+    struct hg_core_addr *hg_core_addr;
+    hg_hash_table_iter_t iter;
+
+    if (!context->addr_table)
+        return;
+
+    hg_thread_spin_lock(&context->addr_table_lock);
+    /* Addresses still referenced by user are no longer interned */
+    hg_hash_table_iterate(context->addr_table, &iter);
+    while (hg_hash_table_iter_has_more(&iter))
+        ((struct hg_core_addr *) hg_hash_table_iter_next(&iter))
+            ->intern_context = NULL;
+    hg_hash_table_free(context->addr_table);
+    context->addr_table = NULL;
+    hg_thread_spin_unlock(&context->addr_table_lock);
+
+    /* Free idle addresses, nothing else can reach them at this point */
+    while ((hg_core_addr = HG_QUEUE_FIRST(&context->addr_idle_queue))) {
+        HG_QUEUE_POP_HEAD(&context->addr_idle_queue, idle_entry);
+        context->addr_idle_count--;
+        hg_atomic_set32(&hg_core_addr->ref_count, 1);
+        hg_core_addr_free(context->hg_core_class, hg_core_addr);
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_addr_lookup(struct hg_core_context *context, hg_core_cb_t callback, void *arg,
     const char *name, hg_core_op_id_t *op_id)
 {
-    na_class_t *na_class = context->hg_core_class->na_class;
-    na_context_t *na_context = context->na_context;
+    struct hg_core_context_route *route;
     struct hg_core_op_id *hg_core_op_id = NULL;
     struct hg_core_addr *hg_core_addr = NULL;
     na_return_t na_ret;
-#ifdef HG_HAS_SM_ROUTING
-    char lookup_name[HG_CORE_ADDR_MAX_SIZE] = {'\0'};
-#endif
-    const char *name_str = name;
+    char name_str[HG_CORE_ADDR_MAX_SIZE];
+    unsigned int route_index;
     hg_return_t ret = HG_SUCCESS, progress_ret;
 
     /* Allocate op_id */
@@ -1350,6 +2784,36 @@ hg_core_addr_lookup(struct hg_core_context *context, hg_core_cb_t callback, void
     hg_atomic_init32(&hg_core_op_id->completed, 0);
     hg_core_op_id->info.lookup.hg_core_addr = NULL;
     hg_core_op_id->info.lookup.na_lookup_op_id = NA_OP_ID_NULL;
+    hg_core_op_id->info.lookup.name = NULL;
+    hg_core_op_id->info.lookup.ret = HG_SUCCESS;
+
+    /* Complete lookup right away if address was already looked up */
+    if (context->hg_core_class->addr_cache) {
+        hg_core_op_id->info.lookup.name = strdup(name);
+        if (!hg_core_op_id->info.lookup.name) {
+            HG_LOG_ERROR("Could not duplicate lookup name");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+
+        hg_thread_spin_lock(&context->hg_core_class->addr_cache_lock);
+        hg_core_addr = (struct hg_core_addr *) hg_hash_table_lookup(
+            context->hg_core_class->addr_cache,
+            (hg_hash_table_key_t) hg_core_op_id->info.lookup.name);
+        if (hg_core_addr)
+            hg_atomic_incr32(&hg_core_addr->ref_count);
+        hg_thread_spin_unlock(&context->hg_core_class->addr_cache_lock);
+
+        if (hg_core_addr) {
+            hg_core_op_id->info.lookup.hg_core_addr = hg_core_addr;
+            if (op_id && op_id != HG_CORE_OP_ID_IGNORE)
+                *op_id = (hg_core_op_id_t) hg_core_op_id;
+            ret = hg_core_addr_lookup_complete(hg_core_op_id);
+            if (ret != HG_SUCCESS)
+                HG_LOG_ERROR("Could not complete operation");
+            goto done;
+        }
+    }
 
     /* Allocate addr */
     hg_core_addr = hg_core_addr_create(context->hg_core_class);
@@ -1360,57 +2824,36 @@ hg_core_addr_lookup(struct hg_core_context *context, hg_core_cb_t callback, void
     }
     hg_core_op_id->info.lookup.hg_core_addr = hg_core_addr;
 
-#ifdef HG_HAS_SM_ROUTING
     /* Parse name string */
-    if (strstr(name, HG_CORE_ADDR_DELIMITER)) {
-        char *lookup_names, *local_id_str;
-        char *remote_name, *local_name;
-
-        strcpy(lookup_name, name);
-
-        /* Get first part of address string with UUID */
-        strtok_r(lookup_name, HG_CORE_ADDR_DELIMITER, &lookup_names);
-
-        if (!strstr(name, HG_CORE_PROTO_DELIMITER)) {
-            HG_LOG_ERROR("Malformed address format");
-            ret = HG_PROTOCOL_ERROR;
-            goto done;
-        }
-        /* Get address SM UUID */
-        strtok_r(lookup_name, HG_CORE_PROTO_DELIMITER, &local_id_str);
-        uuid_parse(local_id_str + 2, hg_core_addr->na_sm_uuid);
-
-        /* Separate remaining two parts */
-        strtok_r(lookup_names, HG_CORE_ADDR_DELIMITER, &remote_name);
-        local_name = lookup_names;
-
-        /* Compare UUIDs, if they match it's local address */
-        if (context->na_sm_context && uuid_compare(hg_core_addr->na_sm_uuid,
-            context->hg_core_class->na_sm_uuid) == 0) {
-            name_str = local_name;
-            na_class = context->hg_core_class->na_sm_class;
-            na_context = context->na_sm_context;
-        } else {
-            /* Remote lookup */
-            name_str = remote_name;
-        }
+    ret = hg_core_route_select(context->hg_core_class, name, name_str,
+        sizeof(name_str), &route_index);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not select route for address %s", name);
+        goto done;
     }
-#endif
+    route = &context->routes[route_index];
+
     /* Assign corresponding NA class */
-    hg_core_addr->na_class = na_class;
+    hg_core_addr->na_class = route->na_class;
 
     /* Assign op_id */
     if (op_id && op_id != HG_CORE_OP_ID_IGNORE)
         *op_id = (hg_core_op_id_t) hg_core_op_id;
 
-    na_ret = NA_Addr_lookup(na_class, na_context, hg_core_addr_lookup_cb,
-        hg_core_op_id, name_str, &hg_core_op_id->info.lookup.na_lookup_op_id);
+    na_ret = NA_Addr_lookup(route->na_class, route->na_context,
+        hg_core_addr_lookup_cb, hg_core_op_id, name_str,
+        &hg_core_op_id->info.lookup.na_lookup_op_id);
     if (na_ret != NA_SUCCESS) {
         HG_LOG_ERROR("Could not start lookup for address %s", name_str);
         ret = HG_NA_ERROR;
         goto done;
     }
 
+    /* Also look up peer on other rails so that bulk transfers can use them,
+     * address is usable without them */
+    if (hg_core_addr_lookup_rails(context, hg_core_addr, name) != HG_SUCCESS)
+        HG_LOG_WARNING("Could not look up rails of address %s", name);
+
     /* TODO to avoid blocking after lookup make progress on the HG layer with
      * timeout of 0 */
     progress_ret = context->progress(context, 0);
@@ -1422,6 +2865,8 @@ hg_core_addr_lookup(struct hg_core_context *context, hg_core_cb_t callback, void
 
 done:
     if (ret != HG_SUCCESS) {
+        if (hg_core_op_id)
+            free(hg_core_op_id->info.lookup.name);
         free(hg_core_op_id);
         if (hg_core_addr != NULL)
             hg_core_addr_free(context->hg_core_class, hg_core_addr);
@@ -1438,13 +2883,40 @@ hg_core_addr_lookup_cb(const struct na_cb_info *callback_info)
     na_return_t na_ret = NA_SUCCESS;
     int ret = 0;
 
+    /* Report failure to user, no address is returned */
     if (callback_info->ret != NA_SUCCESS) {
-        return ret;
+        HG_LOG_ERROR("Could not lookup address");
+        hg_core_op_id->info.lookup.ret = HG_NA_ERROR;
+        hg_core_addr_free(hg_core_op_id->context->hg_core_class,
+            hg_core_op_id->info.lookup.hg_core_addr);
+        hg_core_op_id->info.lookup.hg_core_addr = NULL;
+        goto complete;
     }
 
     /* Assign addr */
     hg_core_op_id->info.lookup.hg_core_addr->na_addr = callback_info->info.lookup.addr;
 
+    /* Keep address for later lookups of the same name, unless a concurrent
+     * lookup of that name already added one */
+    if (hg_core_op_id->info.lookup.name) {
+        struct hg_core_class *hg_core_class =
+            hg_core_op_id->context->hg_core_class;
+
+        hg_thread_spin_lock(&hg_core_class->addr_cache_lock);
+        if (!hg_hash_table_lookup(hg_core_class->addr_cache,
+            (hg_hash_table_key_t) hg_core_op_id->info.lookup.name)
+            && hg_hash_table_insert(hg_core_class->addr_cache,
+                (hg_hash_table_key_t) hg_core_op_id->info.lookup.name,
+                (hg_hash_table_value_t) hg_core_op_id->info.lookup.hg_core_addr)) {
+            hg_atomic_incr32(
+                &hg_core_op_id->info.lookup.hg_core_addr->ref_count);
+            /* Name is now owned by cache */
+            hg_core_op_id->info.lookup.name = NULL;
+        }
+        hg_thread_spin_unlock(&hg_core_class->addr_cache_lock);
+    }
+
+complete:
     /* Mark as completed */
     if (hg_core_addr_lookup_complete(hg_core_op_id) != HG_SUCCESS) {
         HG_LOG_ERROR("Could not complete operation");
@@ -1482,16 +2954,240 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_batch(struct hg_core_context *context, hg_core_cb_t callback,
+    void *arg, const char **names, unsigned int count, hg_core_addr_t *addrs,
+    hg_core_op_id_t *op_id)
+{
+    struct hg_core_addr_batch *batch = NULL;
+    struct hg_core_op_id *hg_core_op_id = NULL;
+    unsigned int i;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Allocate op_id that completes the whole batch */
+    hg_core_op_id = (struct hg_core_op_id *) malloc(sizeof(struct hg_core_op_id));
+    if (!hg_core_op_id) {
+        HG_LOG_ERROR("Could not allocate HG operation ID");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    hg_core_op_id->context = context;
+    hg_core_op_id->type = HG_CB_LOOKUP;
+    hg_core_op_id->callback = callback;
+    hg_core_op_id->arg = arg;
+    hg_atomic_init32(&hg_core_op_id->completed, 0);
+    hg_core_op_id->info.lookup.hg_core_addr = NULL;
+    hg_core_op_id->info.lookup.na_lookup_op_id = NA_OP_ID_NULL;
+    hg_core_op_id->info.lookup.name = NULL;
+    hg_core_op_id->info.lookup.ret = HG_SUCCESS;
+
+    batch = (struct hg_core_addr_batch *) malloc(
+        sizeof(struct hg_core_addr_batch)
+        + (count - 1) * sizeof(struct hg_core_addr_batch_entry));
+    if (!batch) {
+        HG_LOG_ERROR("Could not allocate batch of lookups");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    batch->hg_core_op_id = hg_core_op_id;
+    batch->addrs = addrs;
+    /* Extra count held while lookups are issued so that the batch cannot
+     * complete before all of them are */
+    hg_atomic_init32(&batch->remaining, (hg_util_int32_t) count + 1);
+    for (i = 0; i < count; i++) {
+        batch->entries[i].batch = batch;
+        batch->entries[i].index = i;
+        addrs[i] = HG_CORE_ADDR_NULL;
+    }
+
+    /* Assign op_id */
+    if (op_id && op_id != HG_CORE_OP_ID_IGNORE)
+        *op_id = (hg_core_op_id_t) hg_core_op_id;
+
+    /* Issue all lookups, failures are reported when batch completes */
+    for (i = 0; i < count; i++) {
+        hg_return_t lookup_ret = hg_core_addr_lookup(context,
+            hg_core_addr_lookup_batch_cb, &batch->entries[i], names[i], NULL);
+        if (lookup_ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not lookup address %s", names[i]);
+            hg_core_op_id->info.lookup.ret = lookup_ret;
+            hg_core_addr_lookup_batch_done(batch);
+        }
+    }
+    hg_core_addr_lookup_batch_done(batch);
+
+done:
+    if (ret != HG_SUCCESS)
+        free(hg_core_op_id);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_batch_cb(const struct hg_core_cb_info *callback_info)
+{
+    struct hg_core_addr_batch_entry *entry =
+        (struct hg_core_addr_batch_entry *) callback_info->arg;
+    struct hg_core_addr_batch *batch = entry->batch;
+
+    batch->addrs[entry->index] = callback_info->info.lookup.addr;
+    if (callback_info->ret != HG_SUCCESS)
+        batch->hg_core_op_id->info.lookup.ret = callback_info->ret;
+    hg_core_addr_lookup_batch_done(batch);
+
+    return HG_SUCCESS;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_addr_lookup_batch_done(struct hg_core_addr_batch *batch)
+{
+    if (hg_atomic_decr32(&batch->remaining))
+        return;
+
+    /* Last lookup, user callback is triggered from completion queue */
+    if (hg_core_addr_lookup_complete(batch->hg_core_op_id) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not complete operation");
+    free(batch);
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_addr_lookup_rails(struct hg_core_context *context,
+    struct hg_core_addr *hg_core_addr, const char *name)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    const char *names[HG_CORE_ROUTE_MAX + 1];
+    size_t name_lens[HG_CORE_ROUTE_MAX + 1];
+    unsigned int n_names, addr_route, i, j;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_core_class->has_rails)
+        goto done;
+
+    /* Rails of an address are only looked up once */
+    if (!hg_atomic_cas32(&hg_core_addr->rails_looked_up, 0, 1))
+        goto done;
+
+    for (addr_route = 0; addr_route < hg_core_class->n_routes; addr_route++)
+        if (hg_core_class->routes[addr_route].na_class
+            == hg_core_addr->na_class)
+            break;
+    if (addr_route == hg_core_class->n_routes)
+        goto done;
+
+    ret = hg_core_addr_split(name, names, name_lens, &n_names);
+    if (ret != HG_SUCCESS)
+        goto done;
+
+    /* Rails are paired in order, the n-th NA address string of the protocol
+     * is reached through the n-th route of that protocol */
+    for (i = 0, j = 0; i < hg_core_class->n_routes && j < n_names; i++) {
+        struct hg_core_route *route = &hg_core_class->routes[i];
+        struct hg_core_rail_lookup *rail_lookup;
+        char na_name[HG_CORE_ADDR_MAX_SIZE];
+        na_op_id_t na_op_id = NA_OP_ID_NULL;
+        na_return_t na_ret;
+
+        if (route->rail_group
+            != hg_core_class->routes[addr_route].rail_group)
+            continue;
+        while (j < n_names && !hg_core_route_match(route, names[j]))
+            j++;
+        if (j == n_names)
+            break;
+        if (i == addr_route || name_lens[j] >= sizeof(na_name)) {
+            j++;
+            continue;
+        }
+        memcpy(na_name, names[j], name_lens[j]);
+        na_name[name_lens[j++]] = '\0';
+
+        rail_lookup = (struct hg_core_rail_lookup *) malloc(
+            sizeof(struct hg_core_rail_lookup));
+        if (!rail_lookup) {
+            HG_LOG_ERROR("Could not allocate rail lookup");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        rail_lookup->hg_core_class = hg_core_class;
+        rail_lookup->hg_core_addr = hg_core_addr;
+        rail_lookup->route = i;
+        /* Address must outlive lookup */
+        hg_atomic_incr32(&hg_core_addr->ref_count);
+
+        na_ret = NA_Addr_lookup(route->na_class, context->routes[i].na_context,
+            hg_core_addr_lookup_rail_cb, rail_lookup, na_name, &na_op_id);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not start lookup for rail address %s",
+                na_name);
+            hg_core_addr_free(hg_core_class, hg_core_addr);
+            free(rail_lookup);
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_addr_lookup_rail_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_rail_lookup *rail_lookup =
+        (struct hg_core_rail_lookup *) callback_info->arg;
+
+    /* Transfers keep using the other rails if lookup failed */
+    if (callback_info->ret == NA_SUCCESS)
+        rail_lookup->hg_core_addr->na_rail_addrs[rail_lookup->route] =
+            callback_info->info.lookup.addr;
+    else
+        HG_LOG_WARNING("Could not lookup rail address");
+
+    hg_core_addr_free(rail_lookup->hg_core_class, rail_lookup->hg_core_addr);
+    free(rail_lookup);
+
+    return 0;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_addr_free(struct hg_core_class *hg_core_class, struct hg_core_addr *hg_core_addr)
 {
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
+    unsigned int i;
 
     if (!hg_core_addr) goto done;
 
-    if (hg_atomic_decr32(&hg_core_addr->ref_count)) {
+    if (hg_core_addr->intern_context) {
+        struct hg_core_context *context = hg_core_addr->intern_context;
+
+        /* Release last reference under table lock, unreferenced addresses
+         * stay interned so that later requests from that peer reuse them,
+         * only the oldest one is freed once there are too many */
+        hg_thread_spin_lock(&context->addr_table_lock);
+        if (hg_atomic_decr32(&hg_core_addr->ref_count)) {
+            hg_thread_spin_unlock(&context->addr_table_lock);
+            goto done;
+        }
+        HG_QUEUE_PUSH_TAIL(&context->addr_idle_queue, hg_core_addr,
+            idle_entry);
+        if (++context->addr_idle_count <= HG_CORE_ADDR_IDLE_MAX) {
+            hg_thread_spin_unlock(&context->addr_table_lock);
+            goto done;
+        }
+        hg_core_addr = HG_QUEUE_FIRST(&context->addr_idle_queue);
+        HG_QUEUE_POP_HEAD(&context->addr_idle_queue, idle_entry);
+        context->addr_idle_count--;
+        hg_hash_table_remove(context->addr_table,
+            (hg_hash_table_key_t) hg_core_addr->na_addr);
+        hg_thread_spin_unlock(&context->addr_table_lock);
+    } else if (hg_atomic_decr32(&hg_core_addr->ref_count)) {
         /* Cannot free yet */
         goto done;
     }
@@ -1499,16 +3195,31 @@ hg_core_addr_free(struct hg_core_class *hg_core_class, struct hg_core_addr *hg_c
     /* Decrement N addrs from HG class */
     hg_atomic_decr32(&hg_core_class->n_addrs);
 
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_addr->na_sm_addr != NA_ADDR_NULL) { /* Self address case with SM */
-        na_ret = NA_Addr_free(hg_core_class->na_sm_class, hg_core_addr->na_sm_addr);
+    /* Addresses of peer on rails */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        if (hg_core_addr->na_rail_addrs[i] == NA_ADDR_NULL)
+            continue;
+        na_ret = NA_Addr_free(hg_core_class->routes[i].na_class,
+            hg_core_addr->na_rail_addrs[i]);
         if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not free NA SM address");
+            HG_LOG_ERROR("Could not free rail address");
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+    }
+
+    /* Self address case with several routes */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        if (hg_core_addr->na_self_addrs[i] == NA_ADDR_NULL)
+            continue;
+        na_ret = NA_Addr_free(hg_core_class->routes[i].na_class,
+            hg_core_addr->na_self_addrs[i]);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not free self address of route");
             ret = HG_NA_ERROR;
             goto done;
         }
     }
-#endif
 
     /* Free NA address */
     na_ret = NA_Addr_free(hg_core_addr->na_class, hg_core_addr->na_addr);
@@ -1517,6 +3228,7 @@ hg_core_addr_free(struct hg_core_class *hg_core_class, struct hg_core_addr *hg_c
         ret = HG_NA_ERROR;
         goto done;
     }
+    hg_thread_spin_destroy(&hg_core_addr->flow_lock);
     free(hg_core_addr);
 
 done:
@@ -1530,6 +3242,7 @@ hg_core_addr_self(struct hg_core_class *hg_core_class, struct hg_core_addr **sel
     struct hg_core_addr *hg_core_addr = NULL;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
+    unsigned int i;
 
     hg_core_addr = hg_core_addr_create(hg_core_class);
     if (!hg_core_addr) {
@@ -1546,20 +3259,18 @@ hg_core_addr_self(struct hg_core_class *hg_core_class, struct hg_core_addr **sel
         goto done;
     }
 
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_class->na_sm_class) {
-        /* Get SM address */
-        na_ret = NA_Addr_self(hg_core_class->na_sm_class, &hg_core_addr->na_sm_addr);
+    /* Get address on other routes */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        if (i == hg_core_class->main_route)
+            continue;
+        na_ret = NA_Addr_self(hg_core_class->routes[i].na_class,
+            &hg_core_addr->na_self_addrs[i]);
         if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not get self SM address");
+            HG_LOG_ERROR("Could not get self address of route");
             ret = HG_NA_ERROR;
             goto done;
         }
-
-        /* Copy local UUID */
-        uuid_copy(hg_core_addr->na_sm_uuid, hg_core_class->na_sm_uuid);
     }
-#endif
 
     *self_addr = hg_core_addr;
 
@@ -1573,37 +3284,14 @@ hg_core_addr_dup(struct hg_core_class *hg_core_class, struct hg_core_addr *hg_co
     struct hg_core_addr **hg_new_addr)
 {
     hg_return_t ret = HG_SUCCESS;
-    na_return_t na_ret;
 
-    /**
-     * If address is internal, create a new copy to prevent repost
-     * operations to modify underlying NA address, otherwise simply increment
-     * refcount of original address.
-     */
-    if (hg_core_addr->is_mine) {
-        struct hg_core_addr *dup = NULL;
+    (void) hg_core_class;
 
-        dup = hg_core_addr_create(hg_core_class);
-        if (!dup) {
-            HG_LOG_ERROR("Could not create HG addr");
-            ret = HG_NOMEM_ERROR;
-            goto done;
-        }
-        na_ret = NA_Addr_dup(hg_core_addr->na_class, hg_core_addr->na_addr,
-            &dup->na_addr);
-        if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not duplicate address");
-            ret = HG_NA_ERROR;
-            goto done;
-        }
-        dup->na_class = hg_core_addr->na_class;
-        *hg_new_addr = dup;
-    } else {
-        hg_atomic_incr32(&hg_core_addr->ref_count);
-        *hg_new_addr = hg_core_addr;
-    }
+    /* Addresses are never modified once they are set, including source
+     * addresses of received requests, simply increment refcount */
+    hg_atomic_incr32(&hg_core_addr->ref_count);
+    *hg_new_addr = hg_core_addr;
 
-done:
     return ret;
 }
 
@@ -1612,26 +3300,35 @@ static hg_return_t
 hg_core_addr_to_string(struct hg_core_class *hg_core_class, char *buf, hg_size_t *buf_size,
     struct hg_core_addr *hg_core_addr)
 {
-    char *buf_ptr = buf;
-    hg_size_t new_buf_size = 0, buf_size_used = 0;
+    hg_size_t buf_size_used = 0;
+    hg_bool_t multi_route = HG_FALSE, na_string_used = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
     na_return_t na_ret;
+    unsigned int i;
 
     if (!buf_size) {
         HG_LOG_ERROR("NULL buffer size");
         ret = HG_INVALID_PARAM;
         goto done;
     }
-    new_buf_size = *buf_size;
+
+    /* Self address advertises every route */
+    for (i = 0; i < hg_core_class->n_routes; i++)
+        if (hg_core_addr->na_self_addrs[i] != NA_ADDR_NULL)
+            multi_route = HG_TRUE;
 
 #ifdef HG_HAS_SM_ROUTING
-    if (hg_core_addr->na_sm_addr) {
+    /* Local routes can only be used with the same UUID */
+    for (i = 0; multi_route && i < hg_core_class->n_routes; i++) {
         char addr_str[HG_CORE_ADDR_MAX_SIZE];
         char uuid_str[HG_CORE_UUID_MAX_LEN + 1];
         int desc_len;
 
+        if (!hg_core_class->routes[i].local)
+            continue;
+
         /* Convert UUID to string and generate addr string */
-        uuid_unparse(hg_core_addr->na_sm_uuid, uuid_str);
+        uuid_unparse(hg_core_class->na_sm_uuid, uuid_str);
         desc_len = snprintf(addr_str, HG_CORE_ADDR_MAX_SIZE,
             "uid://%s" HG_CORE_ADDR_DELIMITER, uuid_str);
         if (desc_len > HG_CORE_ADDR_MAX_SIZE) {
@@ -1639,41 +3336,47 @@ hg_core_addr_to_string(struct hg_core_class *hg_core_class, char *buf, hg_size_t
             ret = HG_SIZE_ERROR;
             goto done;
         }
-        if (buf_ptr) {
-            strcpy(buf_ptr, addr_str);
-            buf_ptr += desc_len;
+        if (buf) {
+            if (*buf_size <= (hg_size_t) desc_len) {
+                HG_LOG_ERROR("Buffer size too small to copy addr");
+                ret = HG_SIZE_ERROR;
+                goto done;
+            }
+            strcpy(buf, addr_str);
         }
         buf_size_used += (hg_size_t) desc_len;
-        if (*buf_size > (unsigned int) desc_len)
-            new_buf_size = *buf_size - (hg_size_t) desc_len;
+        break;
+    }
+#endif
+
+    /* Get NA address strings, fastest route first */
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        na_class_t *na_class = hg_core_class->routes[i].na_class;
+        na_addr_t na_addr = hg_core_addr->na_self_addrs[i];
+        na_size_t na_buf_size = 0;
 
-        /* Get NA SM address string */
-        na_ret = NA_Addr_to_string(hg_core_class->na_sm_class, buf_ptr,
-            &new_buf_size, hg_core_addr->na_sm_addr);
+        if (i == hg_core_class->main_route) {
+            na_class = hg_core_addr->na_class;
+            na_addr = hg_core_addr->na_addr;
+        } else if (!multi_route || na_addr == NA_ADDR_NULL)
+            continue;
+
+        if (buf && *buf_size > buf_size_used)
+            na_buf_size = (na_size_t) (*buf_size - buf_size_used);
+        na_ret = NA_Addr_to_string(na_class, buf ? buf + buf_size_used : NULL,
+            &na_buf_size, na_addr);
         if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not convert SM address to string");
+            HG_LOG_ERROR("Could not convert address to string");
             ret = HG_NA_ERROR;
             goto done;
         }
-        if (buf_ptr) {
-            buf_ptr[new_buf_size - 1] = *HG_CORE_ADDR_DELIMITER;
-            buf_ptr += new_buf_size;
-        }
-        buf_size_used += new_buf_size;
-        if (*buf_size > new_buf_size)
-            new_buf_size = *buf_size - new_buf_size;
-    }
-#endif
-
-    /* Get NA address string */
-    na_ret = NA_Addr_to_string(hg_core_class->na_class, buf_ptr, &new_buf_size,
-        hg_core_addr->na_addr);
-    if (na_ret != NA_SUCCESS) {
-        HG_LOG_ERROR("Could not convert address to string");
-        ret = HG_NA_ERROR;
-        goto done;
+        /* Replace terminator of previous string by delimiter */
+        if (buf && na_string_used)
+            buf[buf_size_used - 1] = *HG_CORE_ADDR_DELIMITER;
+        buf_size_used += na_buf_size;
+        na_string_used = HG_TRUE;
     }
-    *buf_size = new_buf_size + buf_size_used;
+    *buf_size = buf_size_used;
 
 done:
     return ret;
@@ -1681,10 +3384,10 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static struct hg_core_handle *
-hg_core_create(struct hg_core_context *context, hg_bool_t HG_UNUSED use_sm)
+hg_core_create(struct hg_core_context_route *route)
 {
-    na_class_t *na_class = context->hg_core_class->na_class;
-    na_context_t *na_context = context->na_context;
+    struct hg_core_context *context = route->context;
+    na_class_t *na_class = route->na_class;
     struct hg_core_handle *hg_core_handle = NULL;
     hg_return_t ret = HG_SUCCESS;
 
@@ -1701,14 +3404,9 @@ hg_core_create(struct hg_core_context *context, hg_bool_t HG_UNUSED use_sm)
     hg_core_handle->hg_info.addr = HG_CORE_ADDR_NULL;
     hg_core_handle->hg_info.id = 0;
     hg_core_handle->hg_info.context_id = 0;
-#ifdef HG_HAS_SM_ROUTING
-    if (use_sm) {
-        na_class = context->hg_core_class->na_sm_class;
-        na_context = context->na_sm_context;
-    }
-#endif
+    hg_core_handle->route = route;
     hg_core_handle->na_class = na_class;
-    hg_core_handle->na_context = na_context;
+    hg_core_handle->na_context = route->na_context;
     hg_core_handle->ret = HG_SUCCESS;
 
     /* Add handle to handle list so that we can track it */
@@ -1758,31 +3456,66 @@ hg_core_create(struct hg_core_context *context, hg_bool_t HG_UNUSED use_sm)
             ret = HG_NOMEM_ERROR;
             goto done;
         }
-        hg_core_handle->na_op_id_mine = HG_TRUE;
+        hg_core_handle->na_op_id_mine = HG_TRUE;
+    }
+    hg_core_handle->na_op_count = 1; /* Default (no response) */
+    hg_atomic_init32(&hg_core_handle->na_op_completed_count, 0);
+
+    /* Set refcount to 1 */
+    hg_atomic_init32(&hg_core_handle->ref_count, 1);
+
+    /* Increment N handles from HG context */
+    hg_atomic_incr32(&context->n_handles);
+
+done:
+    if (ret != HG_SUCCESS) {
+        hg_core_destroy(hg_core_handle);
+        hg_core_handle = NULL;
+    }
+    return hg_core_handle;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_create_target(struct hg_core_context_route *route,
+    struct hg_core_handle **hg_core_handle_ptr)
+{
+    struct hg_core_context *context = route->context;
+    struct hg_core_handle *hg_core_handle = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Create a new handle */
+    hg_core_handle = hg_core_create(route);
+    if (!hg_core_handle) {
+        HG_LOG_ERROR("Could not create HG core handle");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+
+    /* Execute class callback on handle, this allows upper layers to
+     * allocate private data on handle creation */
+    if (context->handle_create) {
+        ret = context->handle_create(hg_core_handle,
+            context->handle_create_arg);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Error in HG core handle create callback");
+            goto done;
+        }
     }
-    hg_core_handle->na_op_count = 1; /* Default (no response) */
-    hg_atomic_init32(&hg_core_handle->na_op_completed_count, 0);
 
-    /* Set refcount to 1 */
-    hg_atomic_init32(&hg_core_handle->ref_count, 1);
-
-    /* Increment N handles from HG context */
-    hg_atomic_incr32(&context->n_handles);
+    /* Source address is set when a request is received */
+    *hg_core_handle_ptr = hg_core_handle;
 
 done:
-    if (ret != HG_SUCCESS) {
+    if (ret != HG_SUCCESS)
         hg_core_destroy(hg_core_handle);
-        hg_core_handle = NULL;
-    }
-    return hg_core_handle;
+    return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static void
 hg_core_destroy(struct hg_core_handle *hg_core_handle)
 {
-    na_return_t na_ret;
-
     if (!hg_core_handle) goto done;
 
     if (hg_atomic_decr32(&hg_core_handle->ref_count)) {
@@ -1798,13 +3531,29 @@ hg_core_destroy(struct hg_core_handle *hg_core_handle)
     /* Decrement N handles from HG context */
     hg_atomic_decr32(&hg_core_handle->hg_info.context->n_handles);
 
+    /* Keep origin handles around for later HG_Core_create() calls */
+    if (hg_core_handle->reuse && hg_core_handle_pool_put(hg_core_handle))
+        goto done;
+
     /* Remove reference to HG addr */
     hg_core_addr_free(hg_core_handle->hg_info.hg_core_class, hg_core_handle->hg_info.addr);
 
+    hg_core_free(hg_core_handle);
+
+done:
+    return;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_free(struct hg_core_handle *hg_core_handle)
+{
+    na_return_t na_ret;
+
     na_ret = NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_send_op_id);
     if (na_ret != NA_SUCCESS)
         HG_LOG_ERROR("Could not destroy NA op ID");
-    NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
+    na_ret = NA_Op_destroy(hg_core_handle->na_class, hg_core_handle->na_recv_op_id);
     if (na_ret != NA_SUCCESS)
         HG_LOG_ERROR("Could not destroy NA op ID");
 
@@ -1830,9 +3579,122 @@ hg_core_destroy(struct hg_core_handle *hg_core_handle)
         hg_core_handle->data_free_callback(hg_core_handle->data);
 
     free(hg_core_handle);
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_handle *
+hg_core_handle_pool_get(struct hg_core_context_route *route)
+{
+    struct hg_core_context *context = route->context;
+    struct hg_core_handle_pool *hg_core_handle_pool = &route->handle_pool;
+    struct hg_core_handle *hg_core_handle;
+
+    hg_thread_spin_lock(&hg_core_handle_pool->lock);
+    hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->list);
+    if (hg_core_handle) {
+        HG_LIST_REMOVE(hg_core_handle, pool);
+        hg_core_handle_pool->count--;
+    }
+    hg_thread_spin_unlock(&hg_core_handle_pool->lock);
+
+    if (!hg_core_handle) {
+#ifdef HG_HAS_COLLECT_STATS
+        hg_core_stat_incr(&hg_core_handle_pool_miss_count_g);
+#endif
+        goto done;
+    }
+#ifdef HG_HAS_COLLECT_STATS
+    hg_core_stat_incr(&hg_core_handle_pool_hit_count_g);
+#endif
+
+    /* Only mark handle reusable once HG_Core_create() has succeeded */
+    hg_core_handle->reuse = HG_FALSE;
+
+    /* Add handle back to handle list so that we can track it */
+    hg_thread_spin_lock(&context->created_list_lock);
+    HG_LIST_INSERT_HEAD(&context->created_list, hg_core_handle, created);
+    hg_thread_spin_unlock(&context->created_list_lock);
+
+    /* Set refcount to 1 */
+    hg_atomic_set32(&hg_core_handle->ref_count, 1);
+
+    /* Increment N handles from HG context */
+    hg_atomic_incr32(&context->n_handles);
 
 done:
-    return;
+    return hg_core_handle;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_handle_pool_put(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    struct hg_core_handle_pool *hg_core_handle_pool =
+        &hg_core_handle->route->handle_pool;
+    unsigned int pool_size = context->hg_core_class->handle_pool_size;
+    hg_bool_t ret = HG_FALSE;
+
+    /* Do not bother resetting the handle if the pool is already full */
+    if (context->finalizing || hg_core_handle_pool->count >= pool_size)
+        goto done;
+
+    if (hg_core_reset(hg_core_handle, HG_FALSE) != HG_SUCCESS)
+        goto done;
+
+    /* Release target addr / RPC so that handle looks freshly created */
+    hg_core_addr_free(context->hg_core_class, hg_core_handle->hg_info.addr);
+    hg_core_handle->hg_info.addr = HG_CORE_ADDR_NULL;
+    hg_core_handle->hg_info.id = 0;
+    hg_core_handle->hg_core_rpc_info = NULL;
+    hg_core_handle->is_self = HG_FALSE;
+    hg_core_handle->forward = NULL;
+    if (!hg_core_handle->na_op_id_mine) {
+        hg_core_handle->na_send_op_id = NA_OP_ID_NULL;
+        hg_core_handle->na_recv_op_id = NA_OP_ID_NULL;
+    }
+
+    /* Upper layers may keep their private data attached to the handle,
+     * otherwise release it now */
+    if (context->handle_release)
+        context->handle_release((hg_core_handle_t) hg_core_handle,
+            context->handle_release_arg);
+    else {
+        if (hg_core_handle->data_free_callback)
+            hg_core_handle->data_free_callback(hg_core_handle->data);
+        hg_core_handle->data = NULL;
+        hg_core_handle->data_free_callback = NULL;
+    }
+
+    hg_thread_spin_lock(&hg_core_handle_pool->lock);
+    if (hg_core_handle_pool->count < pool_size) {
+        HG_LIST_INSERT_HEAD(&hg_core_handle_pool->list, hg_core_handle, pool);
+        hg_core_handle_pool->count++;
+        ret = HG_TRUE;
+    }
+    hg_thread_spin_unlock(&hg_core_handle_pool->lock);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_handle_pool_drain(struct hg_core_handle_pool *hg_core_handle_pool)
+{
+    struct hg_core_handle *hg_core_handle;
+
+    hg_thread_spin_lock(&hg_core_handle_pool->lock);
+    while ((hg_core_handle = HG_LIST_FIRST(&hg_core_handle_pool->list))) {
+        HG_LIST_REMOVE(hg_core_handle, pool);
+        hg_core_handle_pool->count--;
+        hg_thread_spin_unlock(&hg_core_handle_pool->lock);
+
+        hg_core_free(hg_core_handle);
+
+        hg_thread_spin_lock(&hg_core_handle_pool->lock);
+    }
+    hg_thread_spin_unlock(&hg_core_handle_pool->lock);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1850,13 +3712,11 @@ hg_core_reset(struct hg_core_handle *hg_core_handle, hg_bool_t reset_info)
         goto done;
     }
 
-    /* Reset source address */
+    /* Release source address */
     if (reset_info) {
-        if (hg_core_handle->hg_info.addr != HG_CORE_ADDR_NULL
-            && hg_core_handle->hg_info.addr->na_addr != NA_ADDR_NULL) {
-            NA_Addr_free(hg_core_handle->na_class, hg_core_handle->hg_info.addr->na_addr);
-            hg_core_handle->hg_info.addr->na_addr = NA_ADDR_NULL;
-        }
+        hg_core_addr_free(hg_core_handle->hg_info.hg_core_class,
+            hg_core_handle->hg_info.addr);
+        hg_core_handle->hg_info.addr = HG_CORE_ADDR_NULL;
         hg_core_handle->hg_info.id = 0;
     }
     hg_core_handle->hg_info.context_id = 0;
@@ -1873,6 +3733,8 @@ hg_core_reset(struct hg_core_handle *hg_core_handle, hg_bool_t reset_info)
     hg_core_handle->na_op_count = 1; /* Default (no response) */
     hg_atomic_set32(&hg_core_handle->na_op_completed_count, 0);
     hg_core_handle->no_response = HG_FALSE;
+    hg_core_handle->rejected = HG_FALSE;
+    hg_core_handle->process_context = NULL;
 
     /* Free extra data here if needed */
     if (hg_core_handle->hg_info.hg_core_class->more_data_release)
@@ -1881,6 +3743,7 @@ hg_core_reset(struct hg_core_handle *hg_core_handle, hg_bool_t reset_info)
 
     hg_core_header_request_reset(&hg_core_handle->in_header);
     hg_core_header_response_reset(&hg_core_handle->out_header);
+    hg_core_handle->in_header_encoded = HG_FALSE;
 
 done:
     return ret;
@@ -1919,10 +3782,7 @@ hg_core_set_rpc(struct hg_core_handle *hg_core_handle, hg_core_addr_t addr, hg_i
         hg_core_context_t *context = hg_core_handle->hg_info.context;
 
         /* Retrieve ID function from function map */
-        hg_thread_spin_lock(&context->hg_core_class->func_map_lock);
-        hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-            context->hg_core_class->func_map, (hg_hash_table_key_t) &id);
-        hg_thread_spin_unlock(&context->hg_core_class->func_map_lock);
+        hg_core_rpc_info = hg_core_func_map_lookup(context->hg_core_class, id);
         if (!hg_core_rpc_info) {
             /* HG_LOG_ERROR("Could not find RPC ID in function map"); */
             ret = HG_NO_MATCH;
@@ -1939,95 +3799,487 @@ done:
 }
 
 /*---------------------------------------------------------------------------*/
-void *
-hg_core_get_rpc_data(struct hg_core_handle *hg_core_handle)
+void *
+hg_core_get_rpc_data(struct hg_core_handle *hg_core_handle)
+{
+    void *data = NULL;
+
+    if (hg_core_handle->hg_core_rpc_info)
+        data = hg_core_handle->hg_core_rpc_info->data;
+
+    return data;
+}
+
+/*---------------------------------------------------------------------------*/
+#ifdef HG_HAS_SELF_FORWARD
+static hg_return_t
+hg_core_forward_self(struct hg_core_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+
+    /* Input only needs its header decoded before the RPC callback is queued,
+     * do it here rather than paying for a hand-off to the thread pool */
+    if (hg_core_handle->hg_info.hg_core_class->self_inline) {
+        hg_core_process_thread(hg_core_handle);
+        goto done;
+    }
+
+    /* Initialize thread pool if not initialized yet */
+    if (!hg_core_handle->hg_info.context->self_processing_pool) {
+        hg_thread_pool_init(HG_CORE_MAX_SELF_THREADS,
+            &hg_core_handle->hg_info.context->self_processing_pool);
+    }
+
+    /* Post operation to self processing pool */
+    hg_core_handle->thread_work.func = hg_core_process_thread;
+    hg_core_handle->thread_work.args = hg_core_handle;
+    hg_thread_pool_post(hg_core_handle->hg_info.context->self_processing_pool,
+        &hg_core_handle->thread_work);
+
+done:
+    return ret;
+}
+#endif
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_forward_na(struct hg_core_handle *hg_core_handle)
+{
+    na_return_t na_ret;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Set operation type for trigger */
+    hg_core_handle->op_type = HG_CORE_FORWARD;
+
+    /* Generate tag */
+    hg_core_handle->tag = hg_core_gen_request_tag(
+        hg_core_handle->hg_info.context);
+
+    if (!hg_core_handle->no_response) {
+        /* Increment number of expected NA operations */
+        hg_core_handle->na_op_count++;
+
+        /* Pre-post the recv message (output) if response is expected */
+        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
+            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
+            hg_core_handle->out_buf, hg_core_handle->out_buf_size,
+            hg_core_handle->out_buf_plugin_data, hg_core_handle->hg_info.addr->na_addr,
+            hg_core_handle->hg_info.context_id, hg_core_handle->tag,
+            &hg_core_handle->na_recv_op_id);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not post recv for output buffer");
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+    }
+
+    /* Coalesce request with other requests to the same target if it fits,
+     * requests that carry extra data are sent on their own */
+    hg_core_handle->coalesced = HG_FALSE;
+    if (hg_core_handle->hg_info.hg_core_class->coalesce_count > 1
+        && !(hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA)
+        && hg_core_header_request_get_size() + HG_CORE_BATCH_ENTRY_SIZE
+        + hg_core_handle->in_buf_used <= hg_core_batch_get_size(
+            hg_core_handle->hg_info.hg_core_class, hg_core_handle->na_class)
+        && hg_core_batch_add(hg_core_handle) == HG_SUCCESS)
+        goto done;
+
+    /* And post the send message (input) */
+    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class, hg_core_handle->na_context,
+        hg_core_send_input_cb, hg_core_handle, hg_core_handle->in_buf,
+        hg_core_handle->in_buf_used, hg_core_handle->in_buf_plugin_data,
+        hg_core_handle->hg_info.addr->na_addr, hg_core_handle->hg_info.context_id,
+        hg_core_handle->tag, &hg_core_handle->na_send_op_id);
+    if (na_ret != NA_SUCCESS) {
+        HG_LOG_ERROR("Could not post send for input buffer");
+        /* Cancel the above posted recv op */
+        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
+            hg_core_handle->na_recv_op_id);
+        if (na_ret != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not cancel recv op id");
+        }
+        ret = HG_NA_ERROR;
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_batch_encode32(char *buf, hg_uint32_t value)
+{
+    /* Little-endian regardless of host byte order */
+    buf[0] = (char) (value & 0xff);
+    buf[1] = (char) ((value >> 8) & 0xff);
+    buf[2] = (char) ((value >> 16) & 0xff);
+    buf[3] = (char) ((value >> 24) & 0xff);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_uint32_t
+hg_core_batch_decode32(const char *buf)
+{
+    const unsigned char *ubuf = (const unsigned char *) buf;
+
+    return (hg_uint32_t) ubuf[0] | ((hg_uint32_t) ubuf[1] << 8)
+        | ((hg_uint32_t) ubuf[2] << 16) | ((hg_uint32_t) ubuf[3] << 24);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE na_size_t
+hg_core_batch_get_size(struct hg_core_class *hg_core_class,
+    na_class_t *na_class)
+{
+    na_size_t size = NA_Msg_get_max_unexpected_size(na_class);
+
+    if (hg_core_class->coalesce_size && hg_core_class->coalesce_size < size)
+        size = (na_size_t) hg_core_class->coalesce_size;
+
+    return size;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_batch_add(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    na_addr_t na_addr = hg_core_handle->hg_info.addr->na_addr;
+    na_size_t entry_size = hg_core_handle->in_buf_used
+        - hg_core_handle->na_in_header_offset;
+    struct hg_core_batch *hg_core_batch = NULL;
+    struct hg_core_batch *send_batch[2] = {NULL, NULL};
+    char *buf;
+    hg_time_t now;
+    unsigned int i;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_time_get_current(&now);
+
+    hg_thread_mutex_lock(&context->batch_mutex);
+
+    /* Look for message open to target, NA addresses are compared by pointer
+     * so separate lookups of the same target are coalesced separately */
+    HG_LIST_FOREACH(hg_core_batch, &context->batch_list, entry) {
+        if (hg_core_batch->na_class == hg_core_handle->na_class
+            && hg_core_batch->na_addr == na_addr
+            && hg_core_batch->context_id == hg_core_handle->hg_info.context_id)
+            break;
+    }
+
+    /* Send open message first if request does not fit */
+    if (hg_core_batch && hg_core_batch->buf_used + HG_CORE_BATCH_ENTRY_SIZE
+        + entry_size > hg_core_batch->buf_size) {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        send_batch[0] = hg_core_batch;
+        hg_core_batch = NULL;
+    }
+
+    if (!hg_core_batch) {
+        ret = hg_core_batch_create(hg_core_handle, &hg_core_batch);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not create coalesced message");
+            goto done;
+        }
+        hg_core_batch->start = now;
+    }
+
+    /* Append request with tag used for its response */
+    buf = (char *) hg_core_batch->buf + hg_core_batch->buf_used;
+    hg_core_batch_encode32(buf, (hg_uint32_t) hg_core_handle->tag);
+    hg_core_batch_encode32(buf + 4, (hg_uint32_t) entry_size);
+    memcpy(buf + HG_CORE_BATCH_ENTRY_SIZE, (char *) hg_core_handle->in_buf
+        + hg_core_handle->na_in_header_offset, entry_size);
+    hg_core_batch->buf_used += HG_CORE_BATCH_ENTRY_SIZE + entry_size;
+    hg_core_handle->batch_next = hg_core_batch->handles;
+    hg_core_batch->handles = hg_core_handle;
+    hg_core_handle->coalesced = HG_TRUE;
+
+    /* Send message once it is full or due */
+    if (++hg_core_batch->count >= hg_core_class->coalesce_count
+        || (hg_core_class->coalesce_timeout > 0 && hg_time_to_double(
+            hg_time_subtract(now, hg_core_batch->start))
+            >= hg_core_class->coalesce_timeout)) {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        send_batch[1] = hg_core_batch;
+    } else if (hg_core_batch->count == 1 && hg_core_class->coalesce_timeout > 0)
+        hg_core_batch_wake(context);
+
+done:
+    hg_thread_mutex_unlock(&context->batch_mutex);
+
+    for (i = 0; i < 2; i++)
+        if (send_batch[i])
+            hg_core_batch_send(send_batch[i]);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_batch_create(struct hg_core_handle *hg_core_handle,
+    struct hg_core_batch **hg_core_batch_ptr)
+{
+    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    struct hg_core_batch *hg_core_batch = NULL;
+    struct hg_core_header hg_core_header;
+    na_size_t header_offset;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Reuse message of same NA class if any */
+    HG_LIST_FOREACH(hg_core_batch, &context->batch_free_list, entry) {
+        if (hg_core_batch->na_class == hg_core_handle->na_class)
+            break;
+    }
+
+    if (hg_core_batch)
+        HG_LIST_REMOVE(hg_core_batch, entry);
+    else {
+        hg_core_batch = (struct hg_core_batch *) malloc(
+            sizeof(struct hg_core_batch));
+        if (!hg_core_batch) {
+            HG_LOG_ERROR("Could not allocate coalesced message");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        memset(hg_core_batch, 0, sizeof(struct hg_core_batch));
+        hg_core_batch->context = context;
+        hg_core_batch->na_class = hg_core_handle->na_class;
+        hg_core_batch->na_context = hg_core_handle->na_context;
+        hg_core_batch->buf_size = hg_core_batch_get_size(
+            context->hg_core_class, hg_core_handle->na_class);
+        hg_core_batch->buf = NA_Msg_buf_alloc(hg_core_batch->na_class,
+            hg_core_batch->buf_size, &hg_core_batch->buf_plugin_data);
+        if (!hg_core_batch->buf) {
+            HG_LOG_ERROR("Could not allocate buffer for coalesced message");
+            free(hg_core_batch);
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        NA_Msg_init_unexpected(hg_core_batch->na_class, hg_core_batch->buf,
+            hg_core_batch->buf_size);
+        hg_core_batch->na_op_id = NA_Op_create(hg_core_batch->na_class);
+        hg_core_batch->na_op_id_mine =
+            (hg_core_batch->na_op_id != NA_OP_ID_NULL);
+    }
+
+    /* Message header only carries flags, each request has its own header */
+    header_offset = NA_Msg_get_unexpected_header_size(hg_core_batch->na_class);
+    hg_core_header_request_init(&hg_core_header);
+    hg_core_header.msg.request.flags = HG_CORE_COALESCED;
+    hg_core_header.msg.request.cookie = context->id;
+    ret = hg_core_header_request_proc(HG_ENCODE,
+        (char *) hg_core_batch->buf + header_offset,
+        hg_core_batch->buf_size - header_offset, &hg_core_header);
+    hg_core_header_request_finalize(&hg_core_header);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not encode header");
+        HG_LIST_INSERT_HEAD(&context->batch_free_list, hg_core_batch, entry);
+        goto done;
+    }
+
+    hg_core_batch->na_addr = hg_core_handle->hg_info.addr->na_addr;
+    hg_core_batch->context_id = hg_core_handle->hg_info.context_id;
+    hg_core_batch->buf_used = header_offset + hg_core_header_request_get_size();
+    hg_core_batch->handles = NULL;
+    hg_core_batch->count = 0;
+    HG_LIST_INSERT_HEAD(&context->batch_list, hg_core_batch, entry);
+
+    *hg_core_batch_ptr = hg_core_batch;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_batch_send(struct hg_core_batch *hg_core_batch)
 {
-    void *data = NULL;
-
-    if (hg_core_handle->hg_core_rpc_info)
-        data = hg_core_handle->hg_core_rpc_info->data;
+    na_return_t na_ret;
 
-    return data;
+    na_ret = NA_Msg_send_unexpected(hg_core_batch->na_class,
+        hg_core_batch->na_context, hg_core_batch_send_cb, hg_core_batch,
+        hg_core_batch->buf, hg_core_batch->buf_used,
+        hg_core_batch->buf_plugin_data, hg_core_batch->na_addr,
+        hg_core_batch->context_id, 0, &hg_core_batch->na_op_id);
+    if (na_ret != NA_SUCCESS) {
+        HG_LOG_ERROR("Could not post send for coalesced requests");
+        /* Report error through each of the requests */
+        hg_core_batch_complete(hg_core_batch, HG_NA_ERROR);
+    }
 }
 
 /*---------------------------------------------------------------------------*/
-#ifdef HG_HAS_SELF_FORWARD
-static hg_return_t
-hg_core_forward_self(struct hg_core_handle *hg_core_handle)
+static int
+hg_core_batch_complete(struct hg_core_batch *hg_core_batch, hg_return_t hg_ret)
 {
-    hg_return_t ret = HG_SUCCESS;
+    struct hg_core_context *context = hg_core_batch->context;
+    struct hg_core_handle *hg_core_handle = hg_core_batch->handles;
+    int ret = 0;
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD_SELF;
+    /* Release message first, completed handles may be destroyed right away */
+    hg_core_batch->handles = NULL;
+    hg_thread_mutex_lock(&context->batch_mutex);
+    HG_LIST_INSERT_HEAD(&context->batch_free_list, hg_core_batch, entry);
+    hg_thread_mutex_unlock(&context->batch_mutex);
+
+    while (hg_core_handle) {
+        struct hg_core_handle *next = hg_core_handle->batch_next;
+
+        hg_core_handle->batch_next = NULL;
+        if (hg_ret != HG_SUCCESS) {
+            hg_core_handle->ret = hg_ret;
+            /* Response will never come */
+            if (!hg_core_handle->no_response && NA_Cancel(
+                hg_core_handle->na_class, hg_core_handle->na_context,
+                hg_core_handle->na_recv_op_id) != NA_SUCCESS)
+                HG_LOG_ERROR("Could not cancel recv op id");
+        }
 
-    /* Initialize thread pool if not initialized yet */
-    if (!hg_core_handle->hg_info.context->self_processing_pool) {
-        hg_thread_pool_init(HG_CORE_MAX_SELF_THREADS,
-            &hg_core_handle->hg_info.context->self_processing_pool);
+        /* Add handle to completion queue only when all operations have
+         * completed */
+        if (hg_atomic_incr32(&hg_core_handle->na_op_completed_count)
+            == (hg_util_int32_t) hg_core_handle->na_op_count) {
+            if (hg_core_complete(hg_core_handle) != HG_SUCCESS)
+                HG_LOG_ERROR("Could not complete operation");
+            else
+                ret++;
+        }
+        hg_core_handle = next;
     }
 
-    /* Post operation to self processing pool */
-    hg_core_handle->thread_work.func = hg_core_process_thread;
-    hg_core_handle->thread_work.args = hg_core_handle;
-    hg_thread_pool_post(hg_core_handle->hg_info.context->self_processing_pool,
-        &hg_core_handle->thread_work);
-
     return ret;
 }
-#endif
 
 /*---------------------------------------------------------------------------*/
-static hg_return_t
-hg_core_forward_na(struct hg_core_handle *hg_core_handle)
+static void
+hg_core_batch_flush(struct hg_core_context *context, hg_bool_t force,
+    double *remaining)
 {
-    struct hg_core_class *hg_core_class = hg_core_handle->hg_info.hg_core_class;
-    na_return_t na_ret;
-    hg_return_t ret = HG_SUCCESS;
+    HG_LIST_HEAD(hg_core_batch) send_list = HG_LIST_HEAD_INITIALIZER(send_list);
+    double timeout = context->hg_core_class->coalesce_timeout;
+    struct hg_core_batch *hg_core_batch;
+    hg_time_t now;
+
+    if (remaining)
+        *remaining = -1;
+    if (HG_LIST_IS_EMPTY(&context->batch_list))
+        return;
+
+    hg_time_get_current(&now);
+
+    hg_thread_mutex_lock(&context->batch_mutex);
+    hg_core_batch = HG_LIST_FIRST(&context->batch_list);
+    while (hg_core_batch) {
+        struct hg_core_batch *next = HG_LIST_NEXT(hg_core_batch, entry);
+        double left = timeout - hg_time_to_double(
+            hg_time_subtract(now, hg_core_batch->start));
+
+        if (force || left <= 0) {
+            HG_LIST_REMOVE(hg_core_batch, entry);
+            HG_LIST_INSERT_HEAD(&send_list, hg_core_batch, entry);
+        } else if (remaining && (*remaining < 0 || left < *remaining))
+            *remaining = left;
+        hg_core_batch = next;
+    }
+    hg_thread_mutex_unlock(&context->batch_mutex);
+
+    /* Errors are reported through the requests themselves */
+    while ((hg_core_batch = HG_LIST_FIRST(&send_list))) {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        hg_core_batch_send(hg_core_batch);
+    }
+}
 
-    /* Set operation type for trigger */
-    hg_core_handle->op_type = HG_CORE_FORWARD;
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_batch_progress_timeout(struct hg_core_context *context,
+    unsigned int timeout)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    double remaining;
 
-    /* Generate tag */
-    hg_core_handle->tag = hg_core_gen_request_tag(hg_core_class);
+    hg_core_batch_flush(context, HG_FALSE, &remaining);
 
-    if (!hg_core_handle->no_response) {
-        /* Increment number of expected NA operations */
-        hg_core_handle->na_op_count++;
+    /* Without notification, requests coalesced while blocking are only sent
+     * on the next call so bound blocking time to the coalescing delay, round
+     * up to 1 ms so that progress does not busy poll */
+#ifdef HG_HAS_SELF_FORWARD
+    if (remaining < 0 && hg_core_class->coalesce_timeout > 0
+        && !(context->completion_queue_notify
+            && context->progress == hg_core_progress_poll))
+#else
+    if (remaining < 0 && hg_core_class->coalesce_timeout > 0)
+#endif
+        remaining = (hg_core_class->coalesce_timeout > 0.001) ?
+            hg_core_class->coalesce_timeout : 0.001;
+    if (remaining >= 0 && timeout > (unsigned int) (remaining * 1000.0))
+        timeout = (unsigned int) (remaining * 1000.0);
 
-        /* Pre-post the recv message (output) if response is expected */
-        na_ret = NA_Msg_recv_expected(hg_core_handle->na_class,
-            hg_core_handle->na_context, hg_core_recv_output_cb, hg_core_handle,
-            hg_core_handle->out_buf, hg_core_handle->out_buf_size,
-            hg_core_handle->out_buf_plugin_data, hg_core_handle->hg_info.addr->na_addr,
-            hg_core_handle->hg_info.context_id, hg_core_handle->tag,
-            &hg_core_handle->na_recv_op_id);
-        if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not post recv for output buffer");
-            ret = HG_NA_ERROR;
-            goto done;
-        }
-    }
+    return timeout;
+}
 
-    /* And post the send message (input) */
-    na_ret = NA_Msg_send_unexpected(hg_core_handle->na_class, hg_core_handle->na_context,
-        hg_core_send_input_cb, hg_core_handle, hg_core_handle->in_buf,
-        hg_core_handle->in_buf_used, hg_core_handle->in_buf_plugin_data,
-        hg_core_handle->hg_info.addr->na_addr, hg_core_handle->hg_info.context_id,
-        hg_core_handle->tag, &hg_core_handle->na_send_op_id);
-    if (na_ret != NA_SUCCESS) {
-        HG_LOG_ERROR("Could not post send for input buffer");
-        /* Cancel the above posted recv op */
-        na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
-            hg_core_handle->na_recv_op_id);
-        if (na_ret != NA_SUCCESS) {
-            HG_LOG_ERROR("Could not cancel recv op id");
-        }
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_batch_wake(struct hg_core_context *context)
+{
+#ifdef HG_HAS_SELF_FORWARD
+    if (!context->completion_queue_notify
+        || context->progress != hg_core_progress_poll)
+        return;
+
+    /* Blocking progress recomputes its timeout once woken up */
+    hg_atomic_set32(&context->batch_wake, 1);
+    if (hg_event_set(context->completion_queue_notify) != HG_UTIL_SUCCESS)
+        HG_LOG_ERROR("Could not signal completion queue");
+#else
+    (void) context;
+#endif
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_batch_send_cb(const struct na_cb_info *callback_info)
+{
+    struct hg_core_batch *hg_core_batch =
+        (struct hg_core_batch *) callback_info->arg;
+    hg_return_t ret = HG_SUCCESS;
+
+    /* Reset op ID value */
+    if (!hg_core_batch->na_op_id_mine)
+        hg_core_batch->na_op_id = NA_OP_ID_NULL;
+
+    if (callback_info->ret == NA_CANCELED)
+        ret = HG_CANCELED;
+    else if (callback_info->ret != NA_SUCCESS) {
+        HG_LOG_ERROR("Error in NA callback");
         ret = HG_NA_ERROR;
-        goto done;
     }
 
-done:
-    return ret;
+    return hg_core_batch_complete(hg_core_batch, ret);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_batch_free_list(struct hg_core_context *context)
+{
+    struct hg_core_batch *hg_core_batch;
+
+    while ((hg_core_batch = HG_LIST_FIRST(&context->batch_free_list))) {
+        HG_LIST_REMOVE(hg_core_batch, entry);
+        if (NA_Op_destroy(hg_core_batch->na_class, hg_core_batch->na_op_id)
+            != NA_SUCCESS)
+            HG_LOG_ERROR("Could not destroy NA op ID");
+        if (NA_Msg_buf_free(hg_core_batch->na_class, hg_core_batch->buf,
+            hg_core_batch->buf_plugin_data) != NA_SUCCESS)
+            HG_LOG_ERROR("Could not destroy NA coalesced msg buffer");
+        free(hg_core_batch);
+    }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -2137,6 +4389,9 @@ hg_core_send_input_cb(const struct na_cb_info *callback_info)
     } else if (callback_info->ret != NA_SUCCESS) {
         HG_LOG_ERROR("Error in NA callback");
         na_ret = NA_PROTOCOL_ERROR;
+        /* No response returns credit of request that was not sent */
+        if (hg_core_handle->flow_controlled)
+            hg_core_flow_release(hg_core_handle, 0);
         goto done;
     }
 
@@ -2165,12 +4420,8 @@ hg_core_recv_input_cb(const struct na_cb_info *callback_info)
     struct hg_core_context *hg_core_context = hg_core_handle->hg_info.context;
     const struct na_cb_info_recv_unexpected *na_cb_info_recv_unexpected =
         &callback_info->info.recv_unexpected;
-#ifndef HG_HAS_POST_LIMIT
     hg_bool_t pending_empty = NA_FALSE;
-# ifdef HG_HAS_SM_ROUTING
-    hg_bool_t sm_pending_empty = NA_FALSE;
-# endif
-#endif
+    unsigned int post_count;
     na_return_t na_ret = NA_SUCCESS;
     hg_bool_t completed = HG_FALSE;
     int ret = 0;
@@ -2194,8 +4445,14 @@ hg_core_recv_input_cb(const struct na_cb_info *callback_info)
     /* Increment NA completed count */
     hg_atomic_incr32(&hg_core_handle->na_op_completed_count);
 
-    /* Fill unexpected info */
-    hg_core_handle->hg_info.addr->na_addr = na_cb_info_recv_unexpected->source;
+    /* Fill unexpected info, source address is shared with other requests
+     * from the same peer */
+    hg_core_handle->hg_info.addr = hg_core_addr_intern(hg_core_context,
+        hg_core_handle->na_class, na_cb_info_recv_unexpected->source);
+    if (!hg_core_handle->hg_info.addr) {
+        HG_LOG_ERROR("Could not get source address");
+        goto done;
+    }
     hg_core_handle->tag = na_cb_info_recv_unexpected->tag;
     if (na_cb_info_recv_unexpected->actual_buf_size > hg_core_handle->in_buf_size) {
         HG_LOG_ERROR("Actual transfer size is too large for unexpected recv");
@@ -2203,43 +4460,35 @@ hg_core_recv_input_cb(const struct na_cb_info *callback_info)
     }
     hg_core_handle->in_buf_used = na_cb_info_recv_unexpected->actual_buf_size;
 
-    /* Remove handle from pending list */
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_handle->na_class == hg_core_handle->hg_info.hg_core_class->na_sm_class) {
-        hg_thread_spin_lock(&hg_core_context->sm_pending_list_lock);
-        HG_LIST_REMOVE(hg_core_handle, pending);
-# ifndef HG_HAS_POST_LIMIT
-        sm_pending_empty = HG_LIST_IS_EMPTY(&hg_core_context->sm_pending_list);
-# endif
-        hg_thread_spin_unlock(&hg_core_context->sm_pending_list_lock);
-    } else {
-#endif
-        hg_thread_spin_lock(&hg_core_context->pending_list_lock);
+    /* Remove handle from pending list (unless it was canceled meanwhile) */
+    hg_thread_spin_lock(&hg_core_handle->route->pending_list_lock);
+    if (hg_core_handle->pending.prev) {
         HG_LIST_REMOVE(hg_core_handle, pending);
-#ifndef HG_HAS_POST_LIMIT
-        pending_empty = HG_LIST_IS_EMPTY(&hg_core_context->pending_list);
-#endif
-        hg_thread_spin_unlock(&hg_core_context->pending_list_lock);
-#ifdef HG_HAS_SM_ROUTING
+        hg_core_handle->pending.prev = NULL;
+        pending_empty = HG_LIST_IS_EMPTY(&hg_core_handle->route->pending_list);
     }
+    hg_thread_spin_unlock(&hg_core_handle->route->pending_list_lock);
+
+    /* Adapt number of posted handles to arrival rate */
+    hg_time_get_current(&hg_core_handle->recv_time);
+    if (hg_core_handle->repost)
+        post_count = hg_core_post_info_arrival(
+            &hg_core_handle->route->post_info, hg_core_handle->recv_time,
+            pending_empty);
+    else
+#ifdef HG_HAS_POST_LIMIT
+        post_count = 0;
+#else
+        post_count = pending_empty ? HG_CORE_PENDING_INCR : 0;
 #endif
 
-#ifndef HG_HAS_POST_LIMIT
     /* If pending list is empty, post more handles */
-    if (pending_empty && hg_core_context_post(hg_core_context,
-        HG_CORE_PENDING_INCR, hg_core_handle->repost, HG_FALSE) != HG_SUCCESS) {
+    if (post_count && !hg_core_context->finalizing
+        && hg_core_context_post(hg_core_handle->route, post_count,
+            hg_core_handle->repost) != HG_SUCCESS) {
         HG_LOG_ERROR("Could not post additional handles");
         goto done;
     }
-# ifdef HG_HAS_SM_ROUTING
-    /* If pending list is empty, post more handles */
-    if (sm_pending_empty && hg_core_context_post(hg_core_context,
-        HG_CORE_PENDING_INCR, hg_core_handle->repost, HG_TRUE) != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not post additional SM handles");
-        goto done;
-    }
-# endif
-#endif
 
     /* Set operation type for trigger */
     hg_core_handle->op_type = HG_CORE_PROCESS;
@@ -2265,11 +4514,6 @@ hg_core_process_input(struct hg_core_handle *hg_core_handle, hg_bool_t *complete
     struct hg_core_context *hg_core_context = hg_core_handle->hg_info.context;
     hg_return_t ret = HG_SUCCESS;
 
-#ifdef HG_HAS_COLLECT_STATS
-    /* Increment counter */
-    hg_core_stat_incr(&hg_core_rpc_count_g);
-#endif
-
     /* Get and verify input header */
     ret = hg_core_proc_header_request(hg_core_handle, &hg_core_handle->in_header,
         HG_DECODE);
@@ -2278,6 +4522,23 @@ hg_core_process_input(struct hg_core_handle *hg_core_handle, hg_bool_t *complete
         goto done;
     }
 
+    /* Message carries several requests */
+    if (hg_core_handle->in_header.msg.request.flags & HG_CORE_COALESCED) {
+        ret = hg_core_process_batch(hg_core_handle);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not process coalesced requests");
+            goto done;
+        }
+        if (completed)
+            *completed = HG_TRUE;
+        goto done;
+    }
+
+#ifdef HG_HAS_COLLECT_STATS
+    /* Increment counter */
+    hg_core_stat_incr(&hg_core_rpc_count_g);
+#endif
+
     /* Get operation ID from header */
     hg_core_handle->hg_info.id = hg_core_handle->in_header.msg.request.id;
     hg_core_handle->cookie = hg_core_handle->in_header.msg.request.cookie;
@@ -2301,6 +4562,41 @@ hg_core_process_input(struct hg_core_handle *hg_core_handle, hg_bool_t *complete
     hg_core_handle->no_respond = hg_core_no_respond_na;
 #endif
 
+    /* Look up RPC info now so that completion is queued according to the
+     * priority class of the RPC */
+    hg_core_handle->hg_core_rpc_info = hg_core_func_map_lookup(
+        hg_core_context->hg_core_class, hg_core_handle->hg_info.id);
+
+    /* Reject request from its header alone when overloaded, the RPC
+     * callback is not run and extra payload is not acquired */
+    if (hg_core_overloaded(hg_core_handle)) {
+#ifdef HG_HAS_COLLECT_STATS
+        /* Increment counter */
+        hg_core_stat_incr(&hg_core_rpc_busy_count_g);
+#endif
+        hg_core_handle->ret = HG_BUSY;
+        hg_core_handle->rejected = HG_TRUE;
+        if (hg_core_handle->no_response)
+            ret = hg_core_handle->no_respond(hg_core_handle);
+        else
+            ret = HG_Core_respond((hg_core_handle_t) hg_core_handle, NULL,
+                NULL, 0, 0);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not reject request");
+            goto done;
+        }
+        if (completed)
+            *completed = HG_FALSE;
+        goto done;
+    }
+    hg_atomic_incr32(&hg_core_context->process_count);
+
+    /* Hand off request to the context selected by the dispatch policy, extra
+     * payload is still acquired on the receiving context */
+    if (hg_core_context->hg_core_class->dispatch_policy != HG_DISPATCH_NONE)
+        hg_core_handle->dispatch_context =
+            hg_core_dispatch_select(hg_core_handle);
+
     /* Must let upper layer get extra payload if HG_CORE_MORE_DATA is set */
     if (hg_core_handle->in_header.msg.request.flags & HG_CORE_MORE_DATA) {
         if (!hg_core_context->hg_core_class->more_data_acquire) {
@@ -2316,6 +4612,8 @@ hg_core_process_input(struct hg_core_handle *hg_core_handle, hg_bool_t *complete
             hg_core_complete);
         if (ret != HG_SUCCESS) {
             HG_LOG_ERROR("Error in HG core handle more data acquire callback");
+            hg_core_dispatch_release(hg_core_handle);
+            hg_atomic_decr32(&hg_core_context->process_count);
             goto done;
         }
         if (completed)
@@ -2326,12 +4624,233 @@ hg_core_process_input(struct hg_core_handle *hg_core_handle, hg_bool_t *complete
             HG_LOG_ERROR("Could not complete operation");
             goto done;
         }
-        if (completed)
-            *completed = HG_TRUE;
+        if (completed)
+            *completed = HG_TRUE;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_overloaded(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    unsigned int count;
+
+    /* High priority requests are never rejected */
+    if (hg_core_handle->hg_core_rpc_info
+        && hg_core_handle->hg_core_rpc_info->priority == HG_PRIORITY_HIGH)
+        return HG_FALSE;
+
+    count = (unsigned int) hg_atomic_get32(&context->process_count);
+    if (hg_core_class->busy_queue_depth
+        && count >= hg_core_class->busy_queue_depth)
+        return HG_TRUE;
+
+    /* Average wait only gets updated while requests are admitted */
+    if (hg_core_class->busy_latency && count
+        && (unsigned int) hg_atomic_get32(&context->process_delay)
+        > hg_core_class->busy_latency)
+        return HG_TRUE;
+
+    return HG_FALSE;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_process_batch(struct hg_core_handle *hg_core_handle)
+{
+    const char *buf = (const char *) hg_core_handle->in_buf;
+    na_size_t offset = hg_core_handle->na_in_header_offset
+        + hg_core_header_request_get_size();
+    hg_return_t ret = HG_SUCCESS;
+
+    while (offset + HG_CORE_BATCH_ENTRY_SIZE <= hg_core_handle->in_buf_used) {
+        struct hg_core_handle *hg_core_entry = NULL;
+        na_tag_t tag = (na_tag_t) hg_core_batch_decode32(buf + offset);
+        na_size_t size = hg_core_batch_decode32(buf + offset + 4);
+
+        offset += HG_CORE_BATCH_ENTRY_SIZE;
+        if (size > hg_core_handle->in_buf_used - offset) {
+            HG_LOG_ERROR("Coalesced request exceeds message size");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        /* Each request gets its own handle that is not reposted */
+        ret = hg_core_create_target(hg_core_handle->route, &hg_core_entry);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not create HG core handle");
+            goto done;
+        }
+        /* Requests share source address of message */
+        hg_atomic_incr32(&hg_core_handle->hg_info.addr->ref_count);
+        hg_core_entry->hg_info.addr = hg_core_handle->hg_info.addr;
+        memcpy((char *) hg_core_entry->in_buf
+            + hg_core_entry->na_in_header_offset, buf + offset, size);
+        hg_core_entry->in_buf_used = hg_core_entry->na_in_header_offset + size;
+        hg_core_entry->tag = tag;
+        hg_core_entry->recv_time = hg_core_handle->recv_time;
+        hg_atomic_set32(&hg_core_entry->in_use, HG_TRUE);
+        hg_atomic_incr32(&hg_core_entry->na_op_completed_count);
+        offset += size;
+
+        ret = hg_core_process_input(hg_core_entry, NULL);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not process input");
+            hg_core_destroy(hg_core_entry);
+            goto done;
+        }
+    }
+
+done:
+    /* Message itself does not expect a response, release it */
+    hg_core_handle->op_type = HG_CORE_NO_RESPOND;
+    if (hg_core_complete(hg_core_handle) != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not complete operation");
+        ret = HG_PROTOCOL_ERROR;
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_core_context *
+hg_core_dispatch_select(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_class *hg_core_class = hg_core_handle->hg_info.hg_core_class;
+    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    hg_bool_t high = hg_core_handle->hg_core_rpc_info
+        && hg_core_handle->hg_core_rpc_info->priority == HG_PRIORITY_HIGH;
+    unsigned int count, i;
+
+    hg_thread_rwlock_rdlock(&hg_core_class->dispatch_lock);
+    count = hg_core_class->dispatch_count;
+    if (count <= 1)
+        goto done;
+
+    switch (hg_core_class->dispatch_policy) {
+        case HG_DISPATCH_ROUND_ROBIN:
+            context = hg_core_class->dispatch_contexts[(unsigned int)
+                hg_atomic_incr32(&hg_core_class->dispatch_next) % count];
+            break;
+        case HG_DISPATCH_LEAST_LOADED: {
+            /* Start from a rotating index so that ties are spread */
+            unsigned int start = (unsigned int)
+                hg_atomic_incr32(&hg_core_class->dispatch_next) % count;
+            hg_util_int32_t min_load = -1;
+
+            for (i = 0; i < count; i++) {
+                struct hg_core_context *target =
+                    hg_core_class->dispatch_contexts[(start + i) % count];
+                /* High priority requests are triggered ahead of others */
+                hg_util_int32_t load = hg_atomic_get32(high ?
+                    &target->dispatch_high_load : &target->dispatch_load);
+
+                if (min_load < 0 || load < min_load) {
+                    context = target;
+                    min_load = load;
+                    if (!load)
+                        break;
+                }
+            }
+            break;
+        }
+        case HG_DISPATCH_HASH: {
+            hg_uint64_t hash = hg_core_class->dispatch_key ?
+                hg_core_class->dispatch_key((hg_core_handle_t) hg_core_handle,
+                    hg_core_class->dispatch_key_arg) : 0;
+
+            /* Mix RPC ID and key (64-bit finalizer of MurmurHash3) */
+            hash = (hash * 0x9e3779b97f4a7c15ULL) ^ hg_core_handle->hg_info.id;
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            context = hg_core_class->dispatch_contexts[hash % count];
+            break;
+        }
+        case HG_DISPATCH_NONE:
+        default:
+            break;
+    }
+
+done:
+    /* Context remains registered as long as it has requests queued */
+    hg_atomic_incr32(&context->dispatch_load);
+    if (high)
+        hg_atomic_incr32(&context->dispatch_high_load);
+    hg_thread_rwlock_release_rdlock(&hg_core_class->dispatch_lock);
+
+    return context;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE void
+hg_core_dispatch_release(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_context *context = hg_core_handle->dispatch_context;
+
+    if (!context)
+        return;
+
+    hg_atomic_decr32(&context->dispatch_load);
+    if (hg_core_handle->hg_core_rpc_info
+        && hg_core_handle->hg_core_rpc_info->priority == HG_PRIORITY_HIGH)
+        hg_atomic_decr32(&context->dispatch_high_load);
+    hg_core_handle->dispatch_context = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_dispatch_register(struct hg_core_context *context)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    hg_return_t ret = HG_SUCCESS;
+
+    hg_thread_rwlock_wrlock(&hg_core_class->dispatch_lock);
+    if (hg_core_class->dispatch_count == hg_core_class->dispatch_size) {
+        unsigned int new_size = hg_core_class->dispatch_size ?
+            hg_core_class->dispatch_size * 2 : 8;
+        struct hg_core_context **new_contexts = (struct hg_core_context **)
+            realloc(hg_core_class->dispatch_contexts,
+                new_size * sizeof(struct hg_core_context *));
+
+        if (!new_contexts) {
+            HG_LOG_ERROR("Could not grow dispatch targets");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        hg_core_class->dispatch_contexts = new_contexts;
+        hg_core_class->dispatch_size = new_size;
+    }
+    hg_core_class->dispatch_contexts[hg_core_class->dispatch_count++] = context;
+
+done:
+    hg_thread_rwlock_release_wrlock(&hg_core_class->dispatch_lock);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_dispatch_deregister(struct hg_core_context *context)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    unsigned int i;
+
+    hg_thread_rwlock_wrlock(&hg_core_class->dispatch_lock);
+    for (i = 0; i < hg_core_class->dispatch_count; i++) {
+        if (hg_core_class->dispatch_contexts[i] == context) {
+            hg_core_class->dispatch_contexts[i] =
+                hg_core_class->dispatch_contexts[--hg_core_class->dispatch_count];
+            break;
+        }
     }
-
-done:
-    return ret;
+    hg_thread_rwlock_release_wrlock(&hg_core_class->dispatch_lock);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -2365,6 +4884,19 @@ hg_core_send_output_cb(const struct na_cb_info *callback_info)
             hg_core_handle->na_op_count);
     }
 
+    /* Rejected requests have no callback to run, release them now so that
+     * handles do not wait for trigger before taking new requests */
+    if (hg_core_handle->rejected) {
+        hg_atomic_set32(&hg_core_handle->in_use, HG_FALSE);
+        if (hg_core_handle->repost
+            && !hg_core_handle->hg_info.context->finalizing) {
+            if (hg_core_reset_post(hg_core_handle) != HG_SUCCESS)
+                HG_LOG_ERROR("Cannot repost handle");
+        } else
+            hg_core_destroy(hg_core_handle);
+        goto done;
+    }
+
     if (hg_core_complete(hg_core_handle) != HG_SUCCESS) {
         HG_LOG_ERROR("Could not complete operation");
         goto done;
@@ -2395,14 +4927,25 @@ hg_core_recv_output_cb(const struct na_cb_info *callback_info)
     } else if (callback_info->ret == NA_SUCCESS) {
         if (hg_core_process_output(hg_core_handle, NULL) != HG_SUCCESS) {
             HG_LOG_ERROR("Could not process output");
+            /* Return credit of request, window of target is unknown */
+            if (hg_core_handle->flow_controlled)
+                hg_core_flow_release(hg_core_handle, 0);
             goto done;
         }
     } else {
         HG_LOG_ERROR("Error in NA callback");
         na_ret = NA_PROTOCOL_ERROR;
+        if (hg_core_handle->flow_controlled)
+            hg_core_flow_release(hg_core_handle, 0);
         goto done;
     }
 
+    /* Response returns credit of request along with window of target */
+    if (hg_core_handle->flow_controlled)
+        hg_core_flow_release(hg_core_handle,
+            (callback_info->ret == NA_SUCCESS) ?
+            hg_core_handle->out_header.msg.response.credits : 0);
+
     /* Add handle to completion queue only when all operations have completed */
     if (hg_atomic_incr32(&hg_core_handle->na_op_completed_count)
         == (hg_util_int32_t) hg_core_handle->na_op_count) {
@@ -2540,10 +5083,8 @@ hg_core_process(struct hg_core_handle *hg_core_handle)
     hg_return_t ret = HG_SUCCESS;
 
     /* Retrieve exe function from function map */
-    hg_thread_spin_lock(&hg_core_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
-        hg_core_class->func_map, (hg_hash_table_key_t) &hg_core_handle->hg_info.id);
-    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(hg_core_class,
+        hg_core_handle->hg_info.id);
     if (!hg_core_rpc_info) {
         HG_LOG_WARNING("Could not find RPC ID in function map");
         ret = HG_NO_MATCH;
@@ -2581,13 +5122,27 @@ hg_core_complete(struct hg_core_handle *hg_core_handle)
     struct hg_core_context *context = hg_core_handle->hg_info.context;
     struct hg_completion_entry *hg_completion_entry =
         &hg_core_handle->hg_completion_entry;
+    hg_bool_t self_notify = hg_core_handle->is_self;
     hg_return_t ret = HG_SUCCESS;
 
+    /* Disarm deadline, waits for its callback if it is already running */
+    if (hg_core_handle->deadline) {
+        hg_core_handle->deadline = HG_FALSE;
+        hg_core_timer_remove(context, &hg_core_handle->deadline_timer);
+    }
+
     hg_completion_entry->op_type = HG_RPC;
     hg_completion_entry->op_id.hg_core_handle = hg_core_handle;
 
-    ret = hg_core_completion_add(context, hg_completion_entry,
-        hg_core_handle->is_self);
+    /* Received request is processed on its dispatch context, wake it up as
+     * it may be blocking on its own NA context */
+    if (hg_core_handle->dispatch_context
+        && hg_core_handle->dispatch_context != context) {
+        context = hg_core_handle->dispatch_context;
+        self_notify = HG_TRUE;
+    }
+
+    ret = hg_core_completion_add(context, hg_completion_entry, self_notify);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not add HG completion entry to completion queue");
         goto done;
@@ -2597,6 +5152,230 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_completion_queue_init(struct hg_core_context *context,
+    unsigned int n_shards)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
+
+    if (!n_shards)
+        n_shards = 1;
+
+    context->completion_shards = (struct hg_core_completion_shard *) calloc(
+        n_shards, sizeof(struct hg_core_completion_shard));
+    if (!context->completion_shards) {
+        HG_LOG_ERROR("Could not allocate completion shards");
+        ret = HG_NOMEM_ERROR;
+        goto done;
+    }
+    context->n_completion_shards = n_shards;
+
+    for (i = 0; i < n_shards; i++) {
+        struct hg_core_completion_shard *shard = &context->completion_shards[i];
+
+        shard->queues[0] = hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
+        if (!shard->queues[0]) {
+            HG_LOG_ERROR("Could not allocate queue");
+            ret = HG_NOMEM_ERROR;
+            goto done;
+        }
+        hg_atomic_init32(&shard->n_queues, 1);
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_completion_queue_free(struct hg_core_context *context)
+{
+    unsigned int i;
+
+    if (!context->completion_shards)
+        return;
+
+    for (i = 0; i < context->n_completion_shards; i++) {
+        struct hg_core_completion_shard *shard = &context->completion_shards[i];
+        unsigned int j;
+
+        for (j = 0; j <= HG_CORE_ATOMIC_QUEUE_GROW_MAX; j++)
+            if (shard->queues[j])
+                hg_atomic_queue_free(shard->queues[j]);
+    }
+    free(context->completion_shards);
+    context->completion_shards = NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE unsigned int
+hg_core_completion_queue_shard(struct hg_core_context *context)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    size_t index;
+
+    if (context->n_completion_shards < 2)
+        return 0;
+
+    /* Each thread gets its own shard, to push to and pop from first */
+    index = (size_t) hg_thread_getspecific(hg_core_class->trigger_key);
+    if (!index) {
+        index = (size_t) hg_atomic_incr32(&hg_core_class->trigger_index);
+        hg_thread_setspecific(hg_core_class->trigger_key, (void *) index);
+    }
+
+    return (unsigned int) ((index - 1) % context->n_completion_shards);
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+hg_core_completion_queue_push(struct hg_core_context *context,
+    struct hg_completion_entry *hg_completion_entry)
+{
+    struct hg_core_completion_shard *shard =
+        &context->completion_shards[hg_core_completion_queue_shard(context)];
+    int ret = HG_UTIL_SUCCESS;
+
+    for (;;) {
+        hg_util_int32_t n_queues = hg_atomic_get32(&shard->n_queues);
+
+        if (hg_atomic_queue_push(shard->queues[n_queues - 1],
+            hg_completion_entry) == HG_UTIL_SUCCESS)
+            break;
+
+        /* Queue is full, allocate a larger one unless max size reached */
+        if (n_queues > HG_CORE_ATOMIC_QUEUE_GROW_MAX) {
+            ret = HG_UTIL_FAIL;
+            break;
+        }
+        hg_thread_mutex_lock(&context->completion_queue_mutex);
+        if (hg_atomic_get32(&shard->n_queues) == n_queues) {
+            shard->queues[n_queues] =
+                hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE << n_queues);
+            if (!shard->queues[n_queues]) {
+                hg_thread_mutex_unlock(&context->completion_queue_mutex);
+                ret = HG_UTIL_FAIL;
+                break;
+            }
+            hg_atomic_set32(&shard->n_queues, n_queues + 1);
+        }
+        hg_thread_mutex_unlock(&context->completion_queue_mutex);
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_completion_entry *
+hg_core_completion_queue_pop(struct hg_core_context *context)
+{
+    struct hg_completion_entry *hg_completion_entry = NULL;
+    unsigned int n_shards = context->n_completion_shards, i;
+    unsigned int home = hg_core_completion_queue_shard(context);
+
+    /* Pop from home shard first, then steal from others */
+    for (i = 0; i < n_shards && !hg_completion_entry; i++) {
+        struct hg_core_completion_shard *shard =
+            &context->completion_shards[(home + i) % n_shards];
+        hg_util_int32_t n_queues = hg_atomic_get32(&shard->n_queues), j;
+
+        /* Oldest queues are drained first */
+        for (j = 0; j < n_queues && !hg_completion_entry; j++)
+            hg_completion_entry = (struct hg_completion_entry *)
+                hg_atomic_queue_pop_mc(shard->queues[j]);
+    }
+
+    return hg_completion_entry;
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_bool_t
+hg_core_completion_queue_is_empty(struct hg_core_context *context)
+{
+    unsigned int i;
+
+    for (i = 0; i < context->n_completion_shards; i++) {
+        struct hg_core_completion_shard *shard = &context->completion_shards[i];
+        hg_util_int32_t n_queues = hg_atomic_get32(&shard->n_queues), j;
+
+        for (j = 0; j < n_queues; j++)
+            if (!hg_atomic_queue_is_empty(shard->queues[j]))
+                return HG_FALSE;
+    }
+
+    return !hg_atomic_get32(&context->backfill_queue_count)
+        && !hg_atomic_get32(&context->priority_queue_count);
+}
+
+/*---------------------------------------------------------------------------*/
+static HG_INLINE struct hg_completion_entry *
+hg_core_completion_priority_pop(struct hg_core_context *context,
+    hg_priority_t priority)
+{
+    struct hg_completion_entry *hg_completion_entry;
+
+    hg_thread_spin_lock(&context->priority_queue_lock);
+    if (priority == HG_PRIORITY_HIGH) {
+        hg_completion_entry = HG_QUEUE_FIRST(&context->high_queue);
+        if (hg_completion_entry)
+            HG_QUEUE_POP_HEAD(&context->high_queue, entry);
+    } else {
+        hg_completion_entry = HG_QUEUE_FIRST(&context->low_queue);
+        if (hg_completion_entry)
+            HG_QUEUE_POP_HEAD(&context->low_queue, entry);
+    }
+    if (hg_completion_entry)
+        hg_atomic_decr32(&context->priority_queue_count);
+    hg_thread_spin_unlock(&context->priority_queue_lock);
+
+    return hg_completion_entry;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct hg_completion_entry *
+hg_core_completion_pop(struct hg_core_context *context)
+{
+    struct hg_completion_entry *hg_completion_entry = NULL;
+    unsigned int served;
+
+    /* Only RPCs of default priority have completed */
+    if (!hg_atomic_get32(&context->priority_queue_count))
+        return hg_core_completion_queue_pop(context);
+
+    /* Higher classes first, except that every HG_CORE_PRIORITY_AGING entries
+     * normal and low classes alternately go first so that neither starves */
+    served = (unsigned int) hg_atomic_incr32(&context->priority_served);
+    if (served % HG_CORE_PRIORITY_AGING) {
+        hg_completion_entry =
+            hg_core_completion_priority_pop(context, HG_PRIORITY_HIGH);
+        if (!hg_completion_entry)
+            hg_completion_entry = hg_core_completion_queue_pop(context);
+        if (!hg_completion_entry)
+            hg_completion_entry =
+                hg_core_completion_priority_pop(context, HG_PRIORITY_LOW);
+    } else if ((served / HG_CORE_PRIORITY_AGING) % 2) {
+        hg_completion_entry =
+            hg_core_completion_priority_pop(context, HG_PRIORITY_LOW);
+        if (!hg_completion_entry)
+            hg_completion_entry = hg_core_completion_queue_pop(context);
+        if (!hg_completion_entry)
+            hg_completion_entry =
+                hg_core_completion_priority_pop(context, HG_PRIORITY_HIGH);
+    } else {
+        hg_completion_entry = hg_core_completion_queue_pop(context);
+        if (!hg_completion_entry)
+            hg_completion_entry =
+                hg_core_completion_priority_pop(context, HG_PRIORITY_LOW);
+        if (!hg_completion_entry)
+            hg_completion_entry =
+                hg_core_completion_priority_pop(context, HG_PRIORITY_HIGH);
+    }
+
+    return hg_completion_entry;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 hg_core_completion_add(struct hg_core_context *context,
@@ -2610,9 +5389,37 @@ hg_core_completion_add(struct hg_core_context *context,
         hg_core_stat_incr(&hg_core_bulk_count_g);
 #endif
 
-    if (hg_atomic_queue_push(context->completion_queue, hg_completion_entry)
+    /* Completed from HG_Core_progress_and_trigger(), execute inline */
+    if (hg_atomic_get32(&context->inline_count)) {
+        struct hg_core_inline_queue *inline_queue =
+            (struct hg_core_inline_queue *) hg_thread_getspecific(
+                context->hg_core_class->inline_key);
+
+        if (inline_queue && inline_queue->context == context) {
+            HG_QUEUE_PUSH_TAIL(&inline_queue->queue, hg_completion_entry,
+                entry);
+            goto done;
+        }
+    }
+
+    if (hg_completion_entry->op_type == HG_RPC
+        && hg_completion_entry->op_id.hg_core_handle->hg_core_rpc_info
+        && hg_completion_entry->op_id.hg_core_handle->hg_core_rpc_info->priority
+            != HG_PRIORITY_NORMAL) {
+        /* RPCs of other priority classes are queued separately */
+        hg_thread_spin_lock(&context->priority_queue_lock);
+        if (hg_completion_entry->op_id.hg_core_handle->hg_core_rpc_info->priority
+            == HG_PRIORITY_HIGH)
+            HG_QUEUE_PUSH_TAIL(&context->high_queue, hg_completion_entry,
+                entry);
+        else
+            HG_QUEUE_PUSH_TAIL(&context->low_queue, hg_completion_entry,
+                entry);
+        hg_atomic_incr32(&context->priority_queue_count);
+        hg_thread_spin_unlock(&context->priority_queue_lock);
+    } else if (hg_core_completion_queue_push(context, hg_completion_entry)
         != HG_UTIL_SUCCESS) {
-        /* Queue is full */
+        /* Queues are full and cannot grow */
         hg_thread_mutex_lock(&context->completion_queue_mutex);
         HG_QUEUE_PUSH_TAIL(&context->backfill_queue, hg_completion_entry,
             entry);
@@ -2639,13 +5446,208 @@ hg_core_completion_add(struct hg_core_context *context,
     (void) self_notify;
 #endif
 
+done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_INLINE hg_util_uint64_t
+hg_core_timer_tick(struct hg_core_timer_wheel *hg_core_timer_wheel)
+{
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+
+    return (hg_util_uint64_t) (hg_time_to_double(
+        hg_time_subtract(now, hg_core_timer_wheel->start)) * 1000.0);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_timer_insert(struct hg_core_timer_wheel *hg_core_timer_wheel,
+    struct hg_core_timer *hg_core_timer)
+{
+    hg_util_uint64_t now = hg_core_timer_wheel->now;
+    hg_util_uint64_t expire = hg_core_timer->expire;
+    hg_util_uint64_t delta;
+    unsigned int level;
+
+    /* Timers that are due go to the slot of the tick being processed */
+    if (expire < now)
+        expire = now;
+    delta = expire - now;
+
+    for (level = 0; level < HG_CORE_TIMER_LEVELS - 1
+        && (delta >> (HG_CORE_TIMER_SLOT_BITS * (level + 1))); level++)
+        continue;
+
+    /* Beyond wheel range, timer is cascaded again once top slot is reached */
+    if (delta >> (HG_CORE_TIMER_SLOT_BITS * HG_CORE_TIMER_LEVELS))
+        expire = now
+            + ((hg_util_uint64_t) 1 << (HG_CORE_TIMER_SLOT_BITS * HG_CORE_TIMER_LEVELS))
+            - 1;
+
+    HG_LIST_INSERT_HEAD(&hg_core_timer_wheel->slots[level][
+        (expire >> (HG_CORE_TIMER_SLOT_BITS * level)) & HG_CORE_TIMER_SLOT_MASK],
+        hg_core_timer, entry);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_timer_add(struct hg_core_context *context,
+    struct hg_core_timer *hg_core_timer, unsigned int timeout)
+{
+    struct hg_core_timer_wheel *hg_core_timer_wheel = &context->timer_wheel;
+    hg_util_uint64_t tick = hg_core_timer_tick(hg_core_timer_wheel);
+
+    hg_thread_spin_lock(&hg_core_timer_wheel->lock);
+
+    /* Wheel is empty, skip ticks that elapsed since it was last processed */
+    if (!hg_atomic_get32(&hg_core_timer_wheel->count))
+        hg_core_timer_wheel->now = tick;
+
+    /* Current tick is already partially elapsed, round up */
+    hg_core_timer->expire = tick + timeout + 1;
+    hg_atomic_set32(&hg_core_timer->state, HG_CORE_TIMER_ARMED);
+    hg_core_timer_insert(hg_core_timer_wheel, hg_core_timer);
+    hg_atomic_incr32(&hg_core_timer_wheel->count);
+
+    hg_thread_spin_unlock(&hg_core_timer_wheel->lock);
+}
+
+/*---------------------------------------------------------------------------*/
+void
+hg_core_timer_remove(struct hg_core_context *context,
+    struct hg_core_timer *hg_core_timer)
+{
+    struct hg_core_timer_wheel *hg_core_timer_wheel = &context->timer_wheel;
+
+    hg_thread_spin_lock(&hg_core_timer_wheel->lock);
+    if (hg_atomic_get32(&hg_core_timer->state) == HG_CORE_TIMER_ARMED) {
+        HG_LIST_REMOVE(hg_core_timer, entry);
+        hg_atomic_set32(&hg_core_timer->state, HG_CORE_TIMER_IDLE);
+        hg_atomic_decr32(&hg_core_timer_wheel->count);
+    }
+    hg_thread_spin_unlock(&hg_core_timer_wheel->lock);
+
+    /* Callback is completing the operation synchronously, do not wait for
+     * ourselves and let hg_core_timer_expire() know it must not touch the
+     * timer anymore */
+    if (hg_thread_getspecific(context->hg_core_class->timer_key)
+        == hg_core_timer) {
+        hg_thread_setspecific(context->hg_core_class->timer_key, NULL);
+        hg_atomic_set32(&hg_core_timer->state, HG_CORE_TIMER_IDLE);
+        return;
+    }
+
+    /* Owner may release timer once this returns */
+    while (hg_atomic_get32(&hg_core_timer->state) == HG_CORE_TIMER_EXPIRING)
+        hg_thread_yield();
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_timer_expire(struct hg_core_context *context)
+{
+    struct hg_core_timer_wheel *hg_core_timer_wheel = &context->timer_wheel;
+    HG_LIST_HEAD(hg_core_timer) expired = HG_LIST_HEAD_INITIALIZER(expired);
+    hg_util_uint64_t tick = hg_core_timer_tick(hg_core_timer_wheel);
+    struct hg_core_timer *hg_core_timer, *prev_timer;
+    unsigned int next = (unsigned int) -1;
+
+    hg_thread_spin_lock(&hg_core_timer_wheel->lock);
+    while (hg_core_timer_wheel->now < tick
+        && hg_atomic_get32(&hg_core_timer_wheel->count)) {
+        unsigned int index, level;
+
+        index = (unsigned int) (++hg_core_timer_wheel->now
+            & HG_CORE_TIMER_SLOT_MASK);
+
+        /* Move timers of next slot of upper levels down once lower level
+         * wraps around */
+        for (level = 1; !index && level < HG_CORE_TIMER_LEVELS; level++) {
+            unsigned int level_index = (unsigned int)
+                (hg_core_timer_wheel->now >> (HG_CORE_TIMER_SLOT_BITS * level))
+                & HG_CORE_TIMER_SLOT_MASK;
+
+            hg_core_timer = HG_LIST_FIRST(
+                &hg_core_timer_wheel->slots[level][level_index]);
+            HG_LIST_INIT(&hg_core_timer_wheel->slots[level][level_index]);
+            while (hg_core_timer) {
+                struct hg_core_timer *next_timer =
+                    HG_LIST_NEXT(hg_core_timer, entry);
+
+                hg_core_timer_insert(hg_core_timer_wheel, hg_core_timer);
+                hg_core_timer = next_timer;
+            }
+            if (level_index)
+                break;
+        }
+
+        while ((hg_core_timer = HG_LIST_FIRST(
+            &hg_core_timer_wheel->slots[0][index]))) {
+            HG_LIST_REMOVE(hg_core_timer, entry);
+            hg_atomic_set32(&hg_core_timer->state, HG_CORE_TIMER_EXPIRING);
+            hg_atomic_decr32(&hg_core_timer_wheel->count);
+            HG_LIST_INSERT_HEAD(&expired, hg_core_timer, entry);
+        }
+    }
+
+    if (hg_atomic_get32(&hg_core_timer_wheel->count)) {
+        unsigned int i;
+
+        /* Next non-empty slot, or next cascade of upper levels */
+        next = HG_CORE_TIMER_SLOTS
+            - (unsigned int) (hg_core_timer_wheel->now & HG_CORE_TIMER_SLOT_MASK);
+        for (i = 1; i < next; i++) {
+            if (!HG_LIST_IS_EMPTY(&hg_core_timer_wheel->slots[0][
+                (hg_core_timer_wheel->now + i) & HG_CORE_TIMER_SLOT_MASK])) {
+                next = i;
+                break;
+            }
+        }
+    } else
+        hg_core_timer_wheel->now = tick;
+    hg_thread_spin_unlock(&hg_core_timer_wheel->lock);
+
+    /* Call callbacks without holding the lock, progress may be nested */
+    prev_timer = (struct hg_core_timer *) hg_thread_getspecific(
+        context->hg_core_class->timer_key);
+    while ((hg_core_timer = HG_LIST_FIRST(&expired))) {
+        hg_bool_t removed;
+
+        HG_LIST_REMOVE(hg_core_timer, entry);
+        hg_thread_setspecific(context->hg_core_class->timer_key, hg_core_timer);
+        hg_core_timer->callback(hg_core_timer->arg);
+        /* Timer was already removed by its owner from within the callback */
+        removed = (hg_thread_getspecific(context->hg_core_class->timer_key)
+            != hg_core_timer);
+        hg_thread_setspecific(context->hg_core_class->timer_key, prev_timer);
+        if (removed)
+            continue;
+        /* Timer must not be accessed after this point */
+        hg_atomic_set32(&hg_core_timer->state, HG_CORE_TIMER_IDLE);
+    }
+
+    return next;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_deadline_cb(void *arg)
+{
+    struct hg_core_handle *hg_core_handle = (struct hg_core_handle *) arg;
+
+    /* Reported as HG_TIMEOUT instead of HG_CANCELED */
+    hg_core_handle->timed_out = HG_TRUE;
+    if (hg_core_cancel(hg_core_handle) != HG_SUCCESS)
+        HG_LOG_ERROR("Could not cancel handle");
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_context_post(struct hg_core_context *context, unsigned int request_count,
-    hg_bool_t repost, hg_bool_t use_sm)
+hg_core_context_post(struct hg_core_context_route *route,
+    unsigned int request_count, hg_bool_t repost)
 {
     unsigned int nentry = 0;
     hg_return_t ret = HG_SUCCESS;
@@ -2653,38 +5655,13 @@ hg_core_context_post(struct hg_core_context *context, unsigned int request_count
     /* Create a bunch of handles and post unexpected receives */
     for (nentry = 0; nentry < request_count; nentry++) {
         struct hg_core_handle *hg_core_handle = NULL;
-        struct hg_core_addr *hg_core_addr = NULL;
 
         /* Create a new handle */
-        hg_core_handle = hg_core_create(context, use_sm);
-        if (!hg_core_handle) {
+        ret = hg_core_create_target(route, &hg_core_handle);
+        if (ret != HG_SUCCESS) {
             HG_LOG_ERROR("Could not create HG core handle");
-            ret = HG_NOMEM_ERROR;
-            goto done;
-        }
-
-        /* Execute class callback on handle, this allows upper layers to
-         * allocate private data on handle creation */
-        if (context->handle_create) {
-            ret = context->handle_create(hg_core_handle,
-                context->handle_create_arg);
-            if (ret != HG_SUCCESS) {
-                HG_LOG_ERROR("Error in HG core handle create callback");
-                goto done;
-            }
-        }
-
-        /* Create internal addresses */
-        hg_core_addr = hg_core_addr_create(context->hg_core_class);
-        if (!hg_core_addr) {
-            HG_LOG_ERROR("Could not create HG addr");
-            ret = HG_NOMEM_ERROR;
             goto done;
         }
-        /* To safely repost handle and prevent externally referenced address */
-        hg_core_addr->is_mine = HG_TRUE;
-        hg_core_handle->hg_info.addr = hg_core_addr;
-        hg_core_addr->na_class = hg_core_handle->na_class;
 
         /* Repost handle on completion if told so */
         hg_core_handle->repost = repost;
@@ -2697,6 +5674,18 @@ hg_core_context_post(struct hg_core_context *context, unsigned int request_count
     }
 
 done:
+    /* Keep track of handles that get reposted */
+    if (repost && nentry) {
+        struct hg_core_post_info *hg_core_post_info = &route->post_info;
+
+        hg_thread_spin_lock(&hg_core_post_info->lock);
+        hg_core_post_info->count += nentry;
+        if (hg_core_post_info->count > hg_core_post_info->target)
+            hg_core_post_info->target = hg_core_post_info->count;
+        if (!hg_core_post_info->min)
+            hg_core_post_info->min = nentry;
+        hg_thread_spin_unlock(&hg_core_post_info->lock);
+    }
     return ret;
 }
 
@@ -2704,26 +5693,16 @@ done:
 static hg_return_t
 hg_core_post(struct hg_core_handle *hg_core_handle)
 {
-    struct hg_core_context *context = hg_core_handle->hg_info.context;
+    struct hg_core_context_route *route = hg_core_handle->route;
     na_return_t na_ret;
     hg_return_t ret = HG_SUCCESS;
 
     /* Handle is now in use */
     hg_atomic_set32(&hg_core_handle->in_use, HG_TRUE);
 
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_handle->na_class == hg_core_handle->hg_info.hg_core_class->na_sm_class) {
-        hg_thread_spin_lock(&context->sm_pending_list_lock);
-        HG_LIST_INSERT_HEAD(&context->sm_pending_list, hg_core_handle, pending);
-        hg_thread_spin_unlock(&context->sm_pending_list_lock);
-    } else {
-#endif
-        hg_thread_spin_lock(&context->pending_list_lock);
-        HG_LIST_INSERT_HEAD(&context->pending_list, hg_core_handle, pending);
-        hg_thread_spin_unlock(&context->pending_list_lock);
-#ifdef HG_HAS_SM_ROUTING
-    }
-#endif
+    hg_thread_spin_lock(&route->pending_list_lock);
+    HG_LIST_INSERT_HEAD(&route->pending_list, hg_core_handle, pending);
+    hg_thread_spin_unlock(&route->pending_list_lock);
 
     /* Post a new unexpected receive */
     na_ret = NA_Msg_recv_unexpected(hg_core_handle->na_class, hg_core_handle->na_context,
@@ -2736,35 +5715,199 @@ hg_core_post(struct hg_core_handle *hg_core_handle)
         goto done;
     }
 
-done:
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_reset_post(struct hg_core_handle *hg_core_handle)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (hg_atomic_decr32(&hg_core_handle->ref_count))
+        goto done;
+
+    if (!hg_core_post_info_repost(&hg_core_handle->route->post_info,
+        hg_core_handle->recv_time)) {
+        /* More handles posted than needed, destroy handle instead */
+        hg_atomic_set32(&hg_core_handle->ref_count, 1);
+        hg_core_destroy(hg_core_handle);
+        goto done;
+    }
+
+    /* Reset the handle */
+    ret = hg_core_reset(hg_core_handle, HG_TRUE);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Cannot reset handle");
+        goto done;
+    }
+    /* Also reset additional handle parameters */
+    hg_atomic_set32(&hg_core_handle->ref_count, 1);
+    hg_core_handle->hg_core_rpc_info = NULL;
+
+    /* Safe to repost */
+    ret = hg_core_post(hg_core_handle);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Cannot post handle");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_post_info_init(struct hg_core_post_info *hg_core_post_info,
+    unsigned int min, unsigned int max)
+{
+    memset(hg_core_post_info, 0, sizeof(struct hg_core_post_info));
+    hg_thread_spin_init(&hg_core_post_info->lock);
+    hg_core_post_info->min = min;
+    hg_core_post_info->max = max;
+    hg_time_get_current(&hg_core_post_info->window_start);
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_post_info_update(struct hg_core_post_info *hg_core_post_info,
+    hg_time_t now)
+{
+    double elapsed = hg_time_to_double(
+        hg_time_subtract(now, hg_core_post_info->window_start));
+
+    if (elapsed < HG_CORE_POST_WINDOW)
+        return;
+
+    hg_core_post_info->arrival_rate = HG_CORE_POST_EWMA(
+        hg_core_post_info->arrival_rate,
+        (double) hg_core_post_info->window_arrivals / elapsed);
+    if (hg_core_post_info->window_arrivals)
+        hg_core_post_info->idle_windows = 0;
+    else
+        hg_core_post_info->idle_windows +=
+            (unsigned int) (elapsed / HG_CORE_POST_WINDOW);
+    hg_core_post_info->window_arrivals = 0;
+    hg_core_post_info->window_start = now;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_post_info_arrival(struct hg_core_post_info *hg_core_post_info,
+    hg_time_t now, hg_bool_t pending_empty)
+{
+    unsigned int post_count = 0;
+
+    hg_thread_spin_lock(&hg_core_post_info->lock);
+    hg_core_post_info->window_arrivals++;
+    hg_core_post_info_update(hg_core_post_info, now);
+
+    if (pending_empty) {
+        /* Number of handles that are expected to be in use at once given
+         * the arrival rate and the time that it takes to repost a handle,
+         * with some headroom for bursts */
+        unsigned int demand = (unsigned int) (2.0
+            * hg_core_post_info->arrival_rate * hg_core_post_info->repost_time)
+            + 1;
+        unsigned int target = hg_core_post_info->count + HG_CORE_PENDING_INCR;
+
+        if (demand > target)
+            target = demand;
+        if (hg_core_post_info->max && target > hg_core_post_info->max)
+            target = hg_core_post_info->max;
+        if (target > hg_core_post_info->target)
+            hg_core_post_info->target = target;
+        if (hg_core_post_info->target > hg_core_post_info->count)
+            post_count = hg_core_post_info->target - hg_core_post_info->count;
+    }
+    hg_thread_spin_unlock(&hg_core_post_info->lock);
+
+    return post_count;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_post_info_repost(struct hg_core_post_info *hg_core_post_info,
+    hg_time_t recv_time)
+{
+    hg_bool_t ret = HG_TRUE;
+    hg_time_t now;
+
+    hg_time_get_current(&now);
+
+    hg_thread_spin_lock(&hg_core_post_info->lock);
+    hg_core_post_info->repost_time = HG_CORE_POST_EWMA(
+        hg_core_post_info->repost_time,
+        hg_time_to_double(hg_time_subtract(now, recv_time)));
+    hg_core_post_info_update(hg_core_post_info, now);
+
+    /* Drop handle if there are more handles than needed */
+    if (hg_core_post_info->count > hg_core_post_info->target) {
+        hg_core_post_info->count--;
+        ret = HG_FALSE;
+    }
+    hg_thread_spin_unlock(&hg_core_post_info->lock);
+
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
-hg_core_reset_post(struct hg_core_handle *hg_core_handle)
+hg_core_post_info_shrink(struct hg_core_context_route *route)
 {
+    struct hg_core_post_info *hg_core_post_info = &route->post_info;
+    struct hg_core_handle *hg_core_handle;
+    unsigned int excess = 0, canceled = 0;
+    hg_time_t now;
     hg_return_t ret = HG_SUCCESS;
 
-    if (hg_atomic_decr32(&hg_core_handle->ref_count))
+    /* Nothing to release */
+    if (hg_core_post_info->count <= hg_core_post_info->min)
         goto done;
 
-    /* Reset the handle */
-    ret = hg_core_reset(hg_core_handle, HG_TRUE);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Cannot reset handle");
-        goto done;
+    hg_time_get_current(&now);
+
+    hg_thread_spin_lock(&hg_core_post_info->lock);
+    hg_core_post_info_update(hg_core_post_info, now);
+    if (hg_core_post_info->idle_windows >= HG_CORE_POST_IDLE_WINDOWS) {
+        hg_core_post_info->idle_windows = 0;
+        hg_core_post_info->target /= 2;
+        if (hg_core_post_info->target < hg_core_post_info->min)
+            hg_core_post_info->target = hg_core_post_info->min;
+        if (hg_core_post_info->count > hg_core_post_info->target)
+            excess = hg_core_post_info->count - hg_core_post_info->target;
     }
-    /* Also reset additional handle parameters */
-    hg_atomic_set32(&hg_core_handle->ref_count, 1);
-    hg_core_handle->hg_core_rpc_info = NULL;
+    hg_thread_spin_unlock(&hg_core_post_info->lock);
 
-    /* Safe to repost */
-    ret = hg_core_post(hg_core_handle);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Cannot post handle");
+    if (!excess || route->context->finalizing)
         goto done;
+
+    /* Cancel handles that are still posted, handles that are in use are
+     * dropped when they get reposted */
+    hg_thread_spin_lock(&route->pending_list_lock);
+    while (canceled < excess) {
+        hg_core_handle = HG_LIST_FIRST(&route->pending_list);
+        if (!hg_core_handle)
+            break;
+        HG_LIST_REMOVE(hg_core_handle, pending);
+        hg_core_handle->pending.prev = NULL;
+
+        /* Prevent reposts */
+        hg_core_handle->repost = HG_FALSE;
+
+        ret = hg_core_cancel(hg_core_handle);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not cancel handle");
+            break;
+        }
+        canceled++;
     }
+    hg_thread_spin_unlock(&route->pending_list_lock);
+
+    hg_thread_spin_lock(&hg_core_post_info->lock);
+    hg_core_post_info->count -= canceled;
+    hg_thread_spin_unlock(&hg_core_post_info->lock);
 
 done:
     return ret;
@@ -2786,8 +5929,7 @@ hg_core_completion_queue_notify_cb(void *arg, unsigned int timeout,
         ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    if (notified || !hg_atomic_queue_is_empty(context->completion_queue)
-        || hg_atomic_get32(&context->backfill_queue_count)) {
+    if (notified || !hg_core_completion_queue_is_empty(context)) {
         *progressed = HG_UTIL_TRUE; /* Progressed */
         goto done;
     }
@@ -2804,8 +5946,8 @@ static int
 hg_core_progress_na_cb(void *arg, unsigned int timeout,
     hg_util_bool_t *progressed)
 {
-    struct hg_core_context *context = (struct hg_core_context *) arg;
-    struct hg_core_class *hg_core_class = context->hg_core_class;
+    struct hg_core_context_route *route = (struct hg_core_context_route *) arg;
+    struct hg_core_context *context = route->context;
     unsigned int actual_count = 0;
     na_return_t na_ret;
     unsigned int completed_count = 0;
@@ -2813,7 +5955,7 @@ hg_core_progress_na_cb(void *arg, unsigned int timeout,
     int ret = HG_UTIL_SUCCESS;
 
     /* Check progress on NA (no need to call try_wait here) */
-    na_ret = NA_Progress(hg_core_class->na_class, context->na_context, timeout);
+    na_ret = NA_Progress(route->na_class, route->na_context, timeout);
     if (na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT) {
         HG_LOG_ERROR("Could not make progress on NA");
         ret = HG_UTIL_FAIL;
@@ -2828,59 +5970,7 @@ hg_core_progress_na_cb(void *arg, unsigned int timeout,
     /* Trigger everything we can from NA, if something completed it will
      * be moved to the HG context completion queue */
     do {
-        na_ret = NA_Trigger(context->na_context, 0, 1, cb_ret, &actual_count);
-
-        /* Return value of callback is completion count */
-        completed_count += (unsigned int) cb_ret[0];
-    } while ((na_ret == NA_SUCCESS) && actual_count);
-
-    /* We can't only verify that the completion queue is not empty, we need
-     * to check what was added to the completion queue, as the completion queue
-     * may have been concurrently emptied */
-    if (!completed_count && hg_atomic_queue_is_empty(context->completion_queue)
-        && !hg_atomic_get32(&context->backfill_queue_count)) {
-        /* Nothing progressed */
-        *progressed = HG_UTIL_FALSE;
-        goto done;
-    }
-
-    *progressed = HG_UTIL_TRUE;
-
-done:
-    return ret;
-}
-
-/*---------------------------------------------------------------------------*/
-#ifdef HG_HAS_SM_ROUTING
-static int
-hg_core_progress_na_sm_cb(void *arg, unsigned int timeout,
-    hg_util_bool_t *progressed)
-{
-    struct hg_core_context *context = (struct hg_core_context *) arg;
-    struct hg_core_class *hg_core_class = context->hg_core_class;
-    unsigned int actual_count = 0;
-    na_return_t na_ret;
-    unsigned int completed_count = 0;
-    int cb_ret[1] = {0};
-    int ret = HG_UTIL_SUCCESS;
-
-    /* Check progress on NA SM (no need to call try_wait here) */
-    na_ret = NA_Progress(hg_core_class->na_sm_class, context->na_sm_context, timeout);
-    if (na_ret != NA_SUCCESS && na_ret != NA_TIMEOUT) {
-        HG_LOG_ERROR("Could not make progress on NA SM");
-        ret = HG_UTIL_FAIL;
-        goto done;
-    }
-    if (na_ret != NA_SUCCESS) {
-        /* Nothing progressed */
-        *progressed = HG_UTIL_FALSE;
-        goto done;
-    }
-
-    /* Trigger everything we can from NA, if something completed it will
-     * be moved to the HG context completion queue */
-    do {
-        na_ret = NA_Trigger(context->na_sm_context, 0, 1, cb_ret, &actual_count);
+        na_ret = NA_Trigger(route->na_context, 0, 1, cb_ret, &actual_count);
 
         /* Return value of callback is completion count */
         completed_count += (unsigned int) cb_ret[0];
@@ -2889,8 +5979,7 @@ hg_core_progress_na_sm_cb(void *arg, unsigned int timeout,
     /* We can't only verify that the completion queue is not empty, we need
      * to check what was added to the completion queue, as the completion queue
      * may have been concurrently emptied */
-    if (!completed_count && hg_atomic_queue_is_empty(context->completion_queue)
-        && !hg_atomic_get32(&context->backfill_queue_count)) {
+    if (!completed_count && hg_core_completion_queue_is_empty(context)) {
         /* Nothing progressed */
         *progressed = HG_UTIL_FALSE;
         goto done;
@@ -2901,7 +5990,6 @@ hg_core_progress_na_sm_cb(void *arg, unsigned int timeout,
 done:
     return ret;
 }
-#endif
 
 /*---------------------------------------------------------------------------*/
 static hg_return_t
@@ -2940,9 +6028,7 @@ hg_core_progress_na(struct hg_core_context *context, unsigned int timeout)
         /* We can't only verify that the completion queue is not empty, we need
          * to check what was added to the completion queue, as the completion
          * queue may have been concurrently emptied */
-        if (completed_count
-            || !hg_atomic_queue_is_empty(context->completion_queue)
-            || hg_atomic_get32(&context->backfill_queue_count)) {
+        if (completed_count || !hg_core_completion_queue_is_empty(context)) {
             ret = HG_SUCCESS; /* Progressed */
             break;
         }
@@ -2990,28 +6076,24 @@ static HG_INLINE hg_util_bool_t
 hg_core_poll_try_wait_cb(void *arg)
 {
     struct hg_core_context *hg_core_context = (struct hg_core_context *) arg;
+    unsigned int i;
 
     /* Do not try to wait if NA_NO_BLOCK is set */
     if (hg_core_context->hg_core_class->progress_mode == NA_NO_BLOCK)
         return NA_FALSE;
 
     /* Something is in one of the completion queues */
-    if (!hg_atomic_queue_is_empty(hg_core_context->completion_queue) ||
-        hg_atomic_get32(&hg_core_context->backfill_queue_count)) {
+    if (!hg_core_completion_queue_is_empty(hg_core_context)) {
         return NA_FALSE;
     }
 
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_context->hg_core_class->na_sm_class) {
-        na_bool_t ret = NA_Poll_try_wait(hg_core_context->hg_core_class->na_sm_class,
-            hg_core_context->na_sm_context);
-        if (ret)
-            return ret;
-    }
-#endif
+    /* Only block if it is safe to do so on every route */
+    for (i = 0; i < hg_core_context->hg_core_class->n_routes; i++)
+        if (!NA_Poll_try_wait(hg_core_context->routes[i].na_class,
+            hg_core_context->routes[i].na_context))
+            return NA_FALSE;
 
-    return NA_Poll_try_wait(hg_core_context->hg_core_class->na_class,
-        hg_core_context->na_context);
+    return NA_TRUE;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -3060,6 +6142,202 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_THREAD_RETURN_TYPE
+hg_core_progress_thread(void *arg)
+{
+    hg_thread_ret_t thread_ret = (hg_thread_ret_t) 0;
+    struct hg_core_context *context = (struct hg_core_context *) arg;
+    const struct hg_progress_info *info = &context->progress_info;
+    unsigned int block_timeout = info->timeout ? info->timeout :
+        HG_CORE_PROGRESS_TIMEOUT;
+    unsigned int idle_count = 0;
+
+    while (!hg_atomic_get32(&context->progress_thread_stop)) {
+        unsigned int timeout = block_timeout;
+        hg_return_t ret;
+
+        /* Only block once policy allows it */
+        if (info->mode == HG_PROGRESS_BUSY
+            || (info->mode == HG_PROGRESS_SPIN_BLOCK
+                && idle_count < info->spin_count))
+            timeout = 0;
+
+        if (info->trigger_callback) {
+            /* Hand completed operations over to user executor */
+            ret = hg_core_progress(context, timeout);
+            if (ret == HG_SUCCESS)
+                info->trigger_callback(info->trigger_arg);
+        } else {
+            unsigned int actual_count = 0;
+
+            ret = hg_core_progress_and_trigger(context, timeout,
+                HG_CORE_PROGRESS_TRIGGER_MAX, &actual_count);
+        }
+        if (ret == HG_SUCCESS)
+            idle_count = 0;
+        else if (ret == HG_TIMEOUT)
+            idle_count++;
+        else {
+            HG_LOG_ERROR("Could not make progress, exiting progress thread");
+            break;
+        }
+    }
+
+    return thread_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_progress(struct hg_core_context *context, unsigned int timeout)
+{
+    unsigned int wait_timeout;
+    hg_return_t ret = HG_TIMEOUT;
+    unsigned int i;
+
+    /* Expire deadlines and do not block past the next one */
+    if (hg_atomic_get32(&context->timer_wheel.count)) {
+        unsigned int next = hg_core_timer_expire(context);
+
+        if (timeout > next)
+            timeout = next;
+    }
+
+    /* Send coalesced requests that are due and do not block past the time
+     * at which the next ones are */
+    wait_timeout = timeout;
+    if (context->hg_core_class->coalesce_count > 1)
+        timeout = hg_core_batch_progress_timeout(context, timeout);
+
+    /* Spin first so that ping-pong traffic does not pay for a wake-up */
+    if (context->hg_core_class->progress_spin && timeout
+        && context->hg_core_class->progress_mode != NA_NO_BLOCK) {
+        ret = hg_core_progress_spin(context, &timeout);
+        if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
+            HG_LOG_ERROR("Could not make progress");
+            goto done;
+        }
+    }
+
+    /* Make progress on the HG layer */
+    while (ret == HG_TIMEOUT) {
+        hg_time_t t1, t2;
+        unsigned int elapsed;
+
+        if (wait_timeout)
+            hg_time_get_current(&t1);
+
+        ret = context->progress(context, timeout);
+        if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
+            HG_LOG_ERROR("Could not make progress");
+            goto done;
+        }
+
+        /* Woken up by a coalesced message that was opened while blocking,
+         * block again but not past the time at which it is due */
+        if (ret != HG_SUCCESS || !wait_timeout
+            || !hg_atomic_cas32(&context->batch_wake, 1, 0)
+            || !hg_core_completion_queue_is_empty(context))
+            break;
+        ret = HG_TIMEOUT;
+
+        hg_time_get_current(&t2);
+        elapsed = (unsigned int) (hg_time_to_double(
+            hg_time_subtract(t2, t1)) * 1000.0);
+        if (elapsed >= wait_timeout)
+            break;
+        wait_timeout -= elapsed;
+        timeout = hg_core_batch_progress_timeout(context, wait_timeout);
+    }
+
+    /* Track completion gaps to size the spin window, several threads may
+     * progress the context and an update racing with another one may then be
+     * lost, which does not matter for an average */
+    if (ret == HG_SUCCESS && context->hg_core_class->progress_spin) {
+        hg_time_t now;
+        hg_util_int64_t now_us;
+        double gap, avg;
+
+        hg_time_get_current(&now);
+        now_us = HG_CORE_SPIN_TIME(now);
+        gap = (double) (now_us - hg_atomic_get64(&context->spin_last))
+            / 1000000.0;
+        /* Cap gap so that the window recovers quickly after idle periods */
+        if (gap < 0)
+            gap = 0;
+        else if (gap > 2 * HG_CORE_SPIN_MAX)
+            gap = 2 * HG_CORE_SPIN_MAX;
+        avg = hg_atomic_get32(&context->spin_gap) / 1000000000.0;
+        hg_atomic_set32(&context->spin_gap,
+            (hg_util_int32_t) (1000000000.0 * HG_CORE_SPIN_EWMA(avg, gap)));
+        hg_atomic_set64(&context->spin_last, now_us);
+    }
+
+    /* Release posted handles that are no longer needed */
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        if (hg_core_post_info_shrink(&context->routes[i]) != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not release posted handles");
+            ret = HG_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static unsigned int
+hg_core_get_cpu_count(void)
+{
+    unsigned int ret = 0;
+#if defined(__linux__)
+    cpu_set_t cpu_mask;
+
+    if (sched_getaffinity(0, sizeof(cpu_mask), &cpu_mask) == 0)
+        ret = (unsigned int) CPU_COUNT(&cpu_mask);
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (n > 0)
+        ret = (unsigned int) n;
+#endif
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_progress_spin(struct hg_core_context *context, unsigned int *timeout)
+{
+    double window = HG_CORE_SPIN_FACTOR * hg_atomic_get32(&context->spin_gap)
+        / 1000000000.0, elapsed = 0;
+    hg_time_t t1, t2;
+    hg_return_t ret = HG_TIMEOUT;
+
+    /* Completions are too far apart for spinning to pay off */
+    if (window > HG_CORE_SPIN_MAX)
+        goto done;
+    if (window > *timeout / 1000.0)
+        window = *timeout / 1000.0;
+
+    hg_time_get_current(&t1);
+    do {
+        ret = context->progress(context, 0);
+        if (ret != HG_TIMEOUT)
+            break;
+        hg_time_get_current(&t2);
+        elapsed = hg_time_to_double(hg_time_subtract(t2, t1));
+    } while (elapsed < window);
+
+    /* Deduct spin time from timeout */
+    *timeout = (elapsed * 1000.0 >= *timeout) ? 0 :
+        *timeout - (unsigned int) (elapsed * 1000.0);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_trigger(struct hg_core_context *context, unsigned int timeout,
@@ -3080,8 +6358,7 @@ hg_core_trigger(struct hg_core_context *context, unsigned int timeout,
     while (count < max_count) {
         struct hg_completion_entry *hg_completion_entry = NULL;
 
-        hg_completion_entry =
-            hg_atomic_queue_pop_mc(context->completion_queue);
+        hg_completion_entry = hg_core_completion_pop(context);
         if (!hg_completion_entry) {
             /* Check backfill queue */
             if (hg_atomic_get32(&context->backfill_queue_count)) {
@@ -3110,8 +6387,7 @@ hg_core_trigger(struct hg_core_context *context, unsigned int timeout,
                 hg_atomic_incr32(&context->trigger_waiting);
                 hg_thread_mutex_lock(&context->completion_queue_mutex);
                 /* Otherwise wait timeout ms */
-                while (hg_atomic_queue_is_empty(context->completion_queue) &&
-                    !hg_atomic_get32(&context->backfill_queue_count)) {
+                while (hg_core_completion_queue_is_empty(context)) {
                     if (hg_thread_cond_timedwait(&context->completion_queue_cond,
                         &context->completion_queue_mutex, timeout)
                         != HG_UTIL_SUCCESS) {
@@ -3139,32 +6415,10 @@ hg_core_trigger(struct hg_core_context *context, unsigned int timeout,
         }
 
         /* Trigger entry */
-        switch(hg_completion_entry->op_type) {
-            case HG_ADDR:
-                ret = hg_core_trigger_lookup_entry(hg_completion_entry->op_id.hg_core_op_id);
-                if (ret != HG_SUCCESS) {
-                    HG_LOG_ERROR("Could not trigger completion entry");
-                    goto done;
-                }
-                break;
-            case HG_RPC:
-                ret = hg_core_trigger_entry(hg_completion_entry->op_id.hg_core_handle);
-                if (ret != HG_SUCCESS) {
-                    HG_LOG_ERROR("Could not trigger completion entry");
-                    goto done;
-                }
-                break;
-            case HG_BULK:
-                ret = hg_bulk_trigger_entry(hg_completion_entry->op_id.hg_bulk_op_id);
-                if (ret != HG_SUCCESS) {
-                    HG_LOG_ERROR("Could not trigger completion entry");
-                    goto done;
-                }
-                break;
-            default:
-                HG_LOG_ERROR("Invalid type of completion entry");
-                ret = HG_PROTOCOL_ERROR;
-                goto done;
+        ret = hg_core_trigger_completion(hg_completion_entry);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not trigger completion entry");
+            goto done;
         }
 
         count++;
@@ -3176,6 +6430,112 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_progress_and_trigger(struct hg_core_context *context,
+    unsigned int timeout, unsigned int max_count, unsigned int *actual_count)
+{
+    struct hg_core_class *hg_core_class = context->hg_core_class;
+    struct hg_core_inline_queue inline_queue, *prev_inline_queue;
+    unsigned int count = 0;
+    hg_return_t ret = HG_SUCCESS, progress_ret;
+
+    /* Trigger what has already been queued first */
+    ret = hg_core_trigger(context, 0, max_count, &count);
+    if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
+        HG_LOG_ERROR("Could not trigger callbacks");
+        goto done;
+    }
+    if (count) {
+        ret = HG_SUCCESS;
+        goto done;
+    }
+
+    /* Redirect completions from this thread to the inline queue */
+    inline_queue.context = context;
+    HG_QUEUE_INIT(&inline_queue.queue);
+    prev_inline_queue = (struct hg_core_inline_queue *) hg_thread_getspecific(
+        hg_core_class->inline_key);
+    hg_thread_setspecific(hg_core_class->inline_key, &inline_queue);
+    hg_atomic_incr32(&context->inline_count);
+
+    progress_ret = hg_core_progress(context, timeout);
+
+    hg_atomic_decr32(&context->inline_count);
+    hg_thread_setspecific(hg_core_class->inline_key, prev_inline_queue);
+
+    /* Execute callbacks now that NA callbacks have returned, entries that
+     * exceed max_count are handed over to the completion queue */
+    ret = HG_SUCCESS;
+    while (!HG_QUEUE_IS_EMPTY(&inline_queue.queue)) {
+        struct hg_completion_entry *hg_completion_entry =
+            HG_QUEUE_FIRST(&inline_queue.queue);
+
+        HG_QUEUE_POP_HEAD(&inline_queue.queue, entry);
+        if (count < max_count && ret == HG_SUCCESS) {
+            ret = hg_core_trigger_completion(hg_completion_entry);
+            if (ret != HG_SUCCESS)
+                HG_LOG_ERROR("Could not trigger completion entry");
+            count++;
+        } else if (hg_core_completion_add(context, hg_completion_entry,
+            HG_FALSE) != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not add HG completion entry to completion queue");
+            ret = HG_PROTOCOL_ERROR;
+        }
+    }
+    if (ret != HG_SUCCESS)
+        goto done;
+    if (progress_ret != HG_SUCCESS && progress_ret != HG_TIMEOUT) {
+        HG_LOG_ERROR("Could not make progress");
+        ret = progress_ret;
+        goto done;
+    }
+
+    /* Other threads may have completed operations concurrently */
+    if (!count && progress_ret == HG_SUCCESS) {
+        ret = hg_core_trigger(context, 0, max_count, &count);
+        if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
+            HG_LOG_ERROR("Could not trigger callbacks");
+            goto done;
+        }
+    }
+
+    ret = count ? HG_SUCCESS : HG_TIMEOUT;
+
+done:
+    if ((ret == HG_SUCCESS || ret == HG_TIMEOUT) && actual_count)
+        *actual_count = count;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static hg_return_t
+hg_core_trigger_completion(struct hg_completion_entry *hg_completion_entry)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    switch(hg_completion_entry->op_type) {
+        case HG_ADDR:
+            ret = hg_core_trigger_lookup_entry(
+                hg_completion_entry->op_id.hg_core_op_id);
+            break;
+        case HG_RPC:
+            ret = hg_core_trigger_entry(
+                hg_completion_entry->op_id.hg_core_handle);
+            break;
+        case HG_BULK:
+            ret = hg_bulk_trigger_entry(
+                hg_completion_entry->op_id.hg_bulk_op_id);
+            break;
+        default:
+            HG_LOG_ERROR("Invalid type of completion entry");
+            ret = HG_PROTOCOL_ERROR;
+            break;
+    }
+
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
@@ -3187,7 +6547,7 @@ hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
         struct hg_core_cb_info hg_core_cb_info;
 
         hg_core_cb_info.arg = hg_core_op_id->arg;
-        hg_core_cb_info.ret =  HG_SUCCESS; /* TODO report failure */
+        hg_core_cb_info.ret = hg_core_op_id->info.lookup.ret;
         hg_core_cb_info.type = HG_CB_LOOKUP;
         hg_core_cb_info.info.lookup.addr = hg_core_op_id->info.lookup.hg_core_addr;
 
@@ -3195,6 +6555,7 @@ hg_core_trigger_lookup_entry(struct hg_core_op_id *hg_core_op_id)
     }
 
     /* Free op */
+    free(hg_core_op_id->info.lookup.name);
     free(hg_core_op_id);
     return ret;
 }
@@ -3206,6 +6567,26 @@ hg_core_trigger_entry(struct hg_core_handle *hg_core_handle)
     hg_return_t ret = HG_SUCCESS;
 
     if (hg_core_handle->op_type == HG_CORE_PROCESS) {
+        struct hg_core_context *context = hg_core_handle->hg_info.context;
+
+        /* No longer queued on dispatch context */
+        hg_core_handle->process_context = (hg_core_handle->dispatch_context) ?
+            hg_core_handle->dispatch_context : context;
+        hg_core_dispatch_release(hg_core_handle);
+
+        /* Keep average wait of requests for admission of new ones */
+        if (context->hg_core_class->busy_latency) {
+            hg_time_t now;
+            hg_util_int32_t delay, avg;
+
+            hg_time_get_current(&now);
+            delay = (hg_util_int32_t) (1000000 * hg_time_to_double(
+                hg_time_subtract(now, hg_core_handle->recv_time)));
+            avg = hg_atomic_get32(&context->process_delay);
+            hg_atomic_set32(&context->process_delay, avg + (delay - avg) / 8);
+        }
+        hg_atomic_decr32(&context->process_count);
+
         /* Run RPC callback */
         ret = hg_core_process(hg_core_handle);
         if (ret != HG_SUCCESS && !hg_core_handle->no_response) {
@@ -3245,6 +6626,10 @@ hg_core_trigger_entry(struct hg_core_handle *hg_core_handle)
                 hg_cb = hg_core_handle->request_callback;
                 hg_core_cb_info.arg = hg_core_handle->request_arg;
                 hg_core_cb_info.type = HG_CB_FORWARD;
+                /* Canceled by its deadline */
+                if (hg_core_handle->timed_out
+                    && hg_core_cb_info.ret == HG_CANCELED)
+                    hg_core_cb_info.ret = HG_TIMEOUT;
                 hg_core_cb_info.info.forward.handle = (hg_core_handle_t) hg_core_handle;
                 break;
             case HG_CORE_RESPOND:
@@ -3291,12 +6676,113 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static hg_bool_t
+hg_core_flow_acquire(struct hg_core_handle *hg_core_handle)
+{
+    struct hg_core_addr *hg_core_addr = hg_core_handle->hg_info.addr;
+    unsigned int window;
+    hg_bool_t acquired = HG_TRUE;
+
+    hg_thread_spin_lock(&hg_core_addr->flow_lock);
+    /* Use local window until target advertises its own */
+    window = hg_core_addr->flow_window ? hg_core_addr->flow_window :
+        hg_core_handle->hg_info.hg_core_class->request_credits;
+    if (hg_core_addr->flow_outstanding >= window
+        || !HG_QUEUE_IS_EMPTY(&hg_core_addr->flow_queue)) {
+        HG_QUEUE_PUSH_TAIL(&hg_core_addr->flow_queue, hg_core_handle,
+            flow_entry);
+        hg_core_handle->flow_queued = HG_TRUE;
+        acquired = HG_FALSE;
+    } else {
+        hg_core_addr->flow_outstanding++;
+        hg_core_handle->flow_controlled = HG_TRUE;
+    }
+    hg_thread_spin_unlock(&hg_core_addr->flow_lock);
+
+    return acquired;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+hg_core_flow_release(struct hg_core_handle *hg_core_handle,
+    unsigned int credits)
+{
+    struct hg_core_addr *hg_core_addr = hg_core_handle->hg_info.addr;
+    HG_QUEUE_HEAD(hg_core_handle) ready_queue =
+        HG_QUEUE_HEAD_INITIALIZER(ready_queue);
+    struct hg_core_handle *hg_core_next;
+    unsigned int window;
+
+    hg_thread_spin_lock(&hg_core_addr->flow_lock);
+    /* Credit may already have been returned on error */
+    if (!hg_core_handle->flow_controlled) {
+        hg_thread_spin_unlock(&hg_core_addr->flow_lock);
+        return;
+    }
+    hg_core_handle->flow_controlled = HG_FALSE;
+    hg_core_addr->flow_outstanding--;
+    if (credits)
+        hg_core_addr->flow_window = credits;
+    window = hg_core_addr->flow_window ? hg_core_addr->flow_window :
+        hg_core_handle->hg_info.hg_core_class->request_credits;
+    while (hg_core_addr->flow_outstanding < window
+        && (hg_core_next = HG_QUEUE_FIRST(&hg_core_addr->flow_queue))) {
+        HG_QUEUE_POP_HEAD(&hg_core_addr->flow_queue, flow_entry);
+        hg_core_next->flow_queued = HG_FALSE;
+        hg_core_next->flow_controlled = HG_TRUE;
+        hg_core_addr->flow_outstanding++;
+        HG_QUEUE_PUSH_TAIL(&ready_queue, hg_core_next, flow_entry);
+    }
+    hg_thread_spin_unlock(&hg_core_addr->flow_lock);
+
+    /* Send requests outside of lock */
+    while ((hg_core_next = HG_QUEUE_FIRST(&ready_queue))) {
+        hg_return_t ret;
+
+        HG_QUEUE_POP_HEAD(&ready_queue, flow_entry);
+        ret = hg_core_next->forward(hg_core_next);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not forward buffer");
+            hg_core_flow_release(hg_core_next, 0);
+            /* Forward call has already returned, report error in callback */
+            hg_core_next->ret = ret;
+            if (hg_core_complete(hg_core_next) != HG_SUCCESS)
+                HG_LOG_ERROR("Could not complete operation");
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 static hg_return_t
 hg_core_cancel(struct hg_core_handle *hg_core_handle)
 {
     hg_return_t ret = HG_SUCCESS;
 
+    /* Request is still waiting for a credit, nothing was issued yet */
+    if (hg_core_handle->flow_queued) {
+        struct hg_core_addr *hg_core_addr = hg_core_handle->hg_info.addr;
+        hg_bool_t dequeued = HG_FALSE;
+
+        hg_thread_spin_lock(&hg_core_addr->flow_lock);
+        if (hg_core_handle->flow_queued) {
+            HG_QUEUE_REMOVE(&hg_core_addr->flow_queue, hg_core_handle,
+                hg_core_handle, flow_entry);
+            hg_core_handle->flow_queued = HG_FALSE;
+            dequeued = HG_TRUE;
+        }
+        hg_thread_spin_unlock(&hg_core_addr->flow_lock);
+
+        if (dequeued) {
+            /* Forward callback was never set as operation type */
+            hg_core_handle->op_type = HG_CORE_FORWARD;
+            hg_core_handle->ret = HG_CANCELED;
+            ret = hg_core_complete(hg_core_handle);
+            goto done;
+        }
+    }
+
     /* Cancel all NA operations issued */
     if (hg_core_handle->na_recv_op_id != NA_OP_ID_NULL) {
         na_return_t na_ret;
@@ -3310,7 +6796,9 @@ hg_core_cancel(struct hg_core_handle *hg_core_handle)
         }
     }
 
-    if (hg_core_handle->na_send_op_id != NA_OP_ID_NULL) {
+    /* Coalesced requests share the send of other requests */
+    if (hg_core_handle->na_send_op_id != NA_OP_ID_NULL
+        && !hg_core_handle->coalesced) {
         na_return_t na_ret;
 
         na_ret = NA_Cancel(hg_core_handle->na_class, hg_core_handle->na_context,
@@ -3400,6 +6888,26 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_class_set_dispatch_key_callback(struct hg_core_class *hg_core_class,
+    hg_uint64_t (*callback)(hg_core_handle_t, void *), void *arg)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_core_class->dispatch_key = callback;
+    hg_core_class->dispatch_key_arg = arg;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 const char *
 HG_Core_class_get_name(const hg_core_class_t *hg_core_class)
@@ -3457,19 +6965,98 @@ na_class_t *
 HG_Core_class_get_na_sm(const hg_core_class_t *hg_core_class)
 {
     na_class_t *ret = NULL;
+    unsigned int i;
 
     if (!hg_core_class) {
         HG_LOG_ERROR("NULL HG core class");
         goto done;
     }
 
-    ret = hg_core_class->na_sm_class;
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        if (hg_core_class->routes[i].local) {
+            ret = hg_core_class->routes[i].na_class;
+            break;
+        }
+    }
 
 done:
     return ret;
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+unsigned int
+HG_Core_class_get_na_route_count(const hg_core_class_t *hg_core_class)
+{
+    unsigned int ret = 0;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        goto done;
+    }
+
+    ret = hg_core_class->n_routes;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+na_class_t *
+HG_Core_class_get_na_route(const hg_core_class_t *hg_core_class,
+    unsigned int index)
+{
+    na_class_t *ret = NULL;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        goto done;
+    }
+    if (index >= hg_core_class->n_routes) {
+        HG_LOG_ERROR("Invalid route index (%u)", index);
+        goto done;
+    }
+
+    ret = hg_core_class->routes[index].na_class;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+const char *
+HG_Core_class_get_rail_addr_string(const hg_core_class_t *hg_core_class)
+{
+    const char *ret = NULL;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        goto done;
+    }
+
+    ret = hg_core_class->rail_addr_string;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_size_t
+HG_Core_class_get_bulk_stripe_size(const hg_core_class_t *hg_core_class)
+{
+    hg_size_t ret = 0;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        goto done;
+    }
+
+    ret = hg_core_class->has_rails ? hg_core_class->bulk_stripe_size : 0;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_size_t
 HG_Core_class_get_input_eager_size(const hg_core_class_t *hg_core_class)
@@ -3562,7 +7149,10 @@ HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
 {
     hg_return_t ret = HG_SUCCESS;
     struct hg_core_context *context = NULL;
+    unsigned int tag_partition;
+    hg_time_t now;
     int na_poll_fd;
+    unsigned int i;
 #ifdef HG_HAS_SELF_FORWARD
     int fd;
 #endif
@@ -3581,20 +7171,30 @@ HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
     }
     memset(context, 0, sizeof(struct hg_core_context));
     context->hg_core_class = hg_core_class;
-    context->completion_queue =
-        hg_atomic_queue_alloc(HG_CORE_ATOMIC_QUEUE_SIZE);
-    if (!context->completion_queue) {
-        HG_LOG_ERROR("Could not allocate queue");
-        ret = HG_NOMEM_ERROR;
+    ret = hg_core_completion_queue_init(context,
+        hg_core_class->completion_queue_shards);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not allocate completion queues");
         goto done;
     }
     HG_QUEUE_INIT(&context->backfill_queue);
     hg_atomic_init32(&context->backfill_queue_count, 0);
-    HG_LIST_INIT(&context->pending_list);
-#ifdef HG_HAS_SM_ROUTING
-    HG_LIST_INIT(&context->sm_pending_list);
-#endif
     HG_LIST_INIT(&context->created_list);
+    HG_LIST_INIT(&context->batch_list);
+    hg_atomic_init32(&context->batch_wake, 0);
+    HG_LIST_INIT(&context->batch_free_list);
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
+
+        route->context = context;
+        route->na_class = hg_core_class->routes[i].na_class;
+        HG_LIST_INIT(&route->pending_list);
+        hg_thread_spin_init(&route->pending_list_lock);
+        hg_core_post_info_init(&route->post_info,
+            hg_core_class->request_post_min, hg_core_class->request_post_max);
+        HG_LIST_INIT(&route->handle_pool.list);
+        hg_thread_spin_init(&route->handle_pool.lock);
+    }
 
     /* No handle created yet */
     hg_atomic_init32(&context->n_handles, 0);
@@ -3603,29 +7203,60 @@ HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
     hg_thread_mutex_init(&context->completion_queue_mutex);
     hg_thread_cond_init(&context->completion_queue_cond);
     hg_atomic_init32(&context->trigger_waiting, 0);
+    hg_atomic_init32(&context->inline_count, 0);
+    hg_atomic_init32(&context->dispatch_load, 0);
+    hg_atomic_init32(&context->dispatch_high_load, 0);
+    hg_atomic_init32(&context->process_count, 0);
+    hg_atomic_init32(&context->process_delay, 0);
+    HG_QUEUE_INIT(&context->high_queue);
+    HG_QUEUE_INIT(&context->low_queue);
+    hg_atomic_init32(&context->priority_queue_count, 0);
+    hg_atomic_init32(&context->priority_served, 0);
+    hg_thread_spin_init(&context->priority_queue_lock);
+    hg_thread_mutex_init(&context->batch_mutex);
+
+    /* Initialize timer wheel, slots are already empty */
+    hg_thread_spin_init(&context->timer_wheel.lock);
+    hg_time_get_current(&context->timer_wheel.start);
+    hg_atomic_init32(&context->timer_wheel.count, 0);
+
+    /* Assign tag range, contexts beyond number of ranges share counters */
+    tag_partition = (unsigned int) hg_atomic_incr32(
+        &hg_core_class->request_tag_next) - 1;
+    tag_partition %= hg_core_class->request_tag_partitions;
+    context->request_tag = &hg_core_class->request_tags[tag_partition];
+    context->request_tag_base =
+        (na_tag_t) tag_partition * hg_core_class->request_tag_range;
+    hg_time_get_current(&now);
+    hg_atomic_init64(&context->spin_last, HG_CORE_SPIN_TIME(now));
+    hg_atomic_init32(&context->spin_gap, (hg_util_int32_t) (1000000000.0
+        * HG_CORE_SPIN_MAX / HG_CORE_SPIN_FACTOR));
 
-    hg_thread_spin_init(&context->pending_list_lock);
-#ifdef HG_HAS_SM_ROUTING
-    hg_thread_spin_init(&context->sm_pending_list_lock);
-#endif
     hg_thread_spin_init(&context->created_list_lock);
+    hg_thread_spin_init(&context->addr_table_lock);
+    HG_QUEUE_INIT(&context->addr_idle_queue);
 
-    context->na_context = NA_Context_create_id(hg_core_class->na_class, id);
-    if (!context->na_context) {
-        HG_LOG_ERROR("Could not create NA context");
-        ret = HG_NA_ERROR;
+    /* Create source address table */
+    context->addr_table = hg_hash_table_new(hg_core_ptr_hash, hg_core_ptr_equal);
+    if (!context->addr_table) {
+        HG_LOG_ERROR("Could not create source address table");
+        ret = HG_NOMEM_ERROR;
         goto done;
     }
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_class->na_sm_class) {
-        context->na_sm_context = NA_Context_create(hg_core_class->na_sm_class);
-        if (!context->na_sm_context) {
-            HG_LOG_ERROR("Could not create NA SM context");
+
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
+
+        route->na_context = hg_core_class->routes[i].local ?
+            NA_Context_create(route->na_class) :
+            NA_Context_create_id(route->na_class, id);
+        if (!route->na_context) {
+            HG_LOG_ERROR("Could not create NA context");
             ret = HG_NA_ERROR;
             goto done;
         }
     }
-#endif
+    context->na_context = context->routes[hg_core_class->main_route].na_context;
 
     /* Create poll set */
     context->poll_set = hg_poll_create();
@@ -3650,50 +7281,48 @@ HG_Core_context_create_id(hg_core_class_t *hg_core_class, hg_uint8_t id)
         hg_core_completion_queue_notify_cb, context);
 #endif
 
-    if (context->hg_core_class->progress_mode == NA_NO_BLOCK)
-        /* Force to use progress poll */
-        na_poll_fd = 0;
-    else
-        /* If NA plugin exposes fd, add it to poll set and use appropriate
-         * progress function */
-        na_poll_fd = NA_Poll_get_fd(hg_core_class->na_class, context->na_context);
-    if (na_poll_fd >= 0) {
-        hg_poll_add(context->poll_set, na_poll_fd, HG_POLLIN,
-            hg_core_progress_na_cb, context);
-        hg_poll_set_try_wait(context->poll_set, hg_core_poll_try_wait_cb,
-            context);
-        context->progress = hg_core_progress_poll;
-    } else
-        context->progress = hg_core_progress_na;
+    for (i = 0; i < hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
 
-#ifdef HG_HAS_SM_ROUTING
-    /* Auto SM requires hg_core_progress_poll */
-    if (context->na_sm_context) {
-        if (context->progress != hg_core_progress_poll) {
-            HG_LOG_ERROR("Auto SM mode not supported with selected plugin");
-            ret = HG_PROTOCOL_ERROR;
-            goto done;
-        }
         if (context->hg_core_class->progress_mode == NA_NO_BLOCK)
             /* Force to use progress poll */
             na_poll_fd = 0;
-        else {
-            na_poll_fd = NA_Poll_get_fd(hg_core_class->na_sm_class,
-                context->na_sm_context);
-            if (na_poll_fd < 0) {
-                HG_LOG_ERROR("Could not get NA SM poll fd");
-                ret = HG_NA_ERROR;
+        else
+            /* If NA plugin exposes fd, add it to poll set and use appropriate
+             * progress function */
+            na_poll_fd = NA_Poll_get_fd(route->na_class, route->na_context);
+        if (na_poll_fd < 0) {
+            /* Several routes require hg_core_progress_poll */
+            if (hg_core_class->n_routes > 1) {
+                HG_LOG_ERROR("Multiple routes not supported with %s plugin",
+                    NA_Get_class_name(route->na_class));
+                ret = HG_PROTOCOL_ERROR;
                 goto done;
             }
+            context->progress = hg_core_progress_na;
+            break;
         }
         hg_poll_add(context->poll_set, na_poll_fd, HG_POLLIN,
-            hg_core_progress_na_sm_cb, context);
+            hg_core_progress_na_cb, route);
+        context->progress = hg_core_progress_poll;
     }
-#endif
+    if (context->progress == hg_core_progress_poll)
+        hg_poll_set_try_wait(context->poll_set, hg_core_poll_try_wait_cb,
+            context);
 
     /* Assign context ID */
     context->id = id;
 
+    /* Receive requests dispatched from other contexts */
+    if (hg_core_class->dispatch_policy != HG_DISPATCH_NONE) {
+        ret = hg_core_dispatch_register(context);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not register context for dispatch");
+            goto done;
+        }
+        context->dispatch_registered = HG_TRUE;
+    }
+
     /* Increment context count of parent class */
     hg_atomic_incr32(&hg_core_class->n_contexts);
 
@@ -3714,44 +7343,51 @@ HG_Core_context_destroy(hg_core_context_t *context)
     unsigned int actual_count;
     int na_poll_fd;
     hg_util_int32_t n_handles;
+    unsigned int i;
 
     if (!context) goto done;
 
+    /* Stop progress thread if any */
+    ret = HG_Core_context_stop_progress(context);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not stop progress thread");
+        goto done;
+    }
+
+    /* Stop receiving requests from other contexts, the ones already
+     * dispatched are processed while waiting for handles below */
+    if (context->dispatch_registered) {
+        hg_core_dispatch_deregister(context);
+        context->dispatch_registered = HG_FALSE;
+    }
+
     /* Prevent repost of handles */
     context->finalizing = HG_TRUE;
 
-    /* Check pending list and cancel posted handles */
-    if (!HG_LIST_IS_EMPTY(&context->pending_list)) {
-        ret = hg_core_pending_list_cancel(context);
-        if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Cannot cancel list of pending entries");
-            goto done;
-        }
-    }
-#ifdef HG_HAS_SM_ROUTING
-    /* Check pending list and cancel posted handles */
-    if (!HG_LIST_IS_EMPTY(&context->sm_pending_list)) {
-        ret = hg_core_sm_pending_list_cancel(context);
-        if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Cannot cancel list of SM pending entries");
-            goto done;
-        }
-    }
-#endif
+    /* Send requests that are still being coalesced */
+    hg_core_batch_flush(context, HG_TRUE, NULL);
 
-    /* Trigger everything we can from NA, if something completed it will
-     * be moved to the HG context completion queue */
-    do {
-        na_ret = NA_Trigger(context->na_context, 0, 1, NULL, &actual_count);
-    } while ((na_ret == NA_SUCCESS) && actual_count);
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
 
-#ifdef HG_HAS_SM_ROUTING
-    if (context->na_sm_context) {
+        if (!route->na_context)
+            continue;
+
+        /* Check pending list and cancel posted handles */
+        if (!HG_LIST_IS_EMPTY(&route->pending_list)) {
+            ret = hg_core_pending_list_cancel(route);
+            if (ret != HG_SUCCESS) {
+                HG_LOG_ERROR("Cannot cancel list of pending entries");
+                goto done;
+            }
+        }
+
+        /* Trigger everything we can from NA, if something completed it will
+         * be moved to the HG context completion queue */
         do {
-            na_ret = NA_Trigger(context->na_sm_context, 0, 1, NULL, &actual_count);
+            na_ret = NA_Trigger(route->na_context, 0, 1, NULL, &actual_count);
         } while ((na_ret == NA_SUCCESS) && actual_count);
     }
-#endif
 
     /* Check that operations have completed */
     ret = hg_core_created_list_wait(context);
@@ -3765,6 +7401,16 @@ HG_Core_context_destroy(hg_core_context_t *context)
     hg_thread_pool_destroy(context->self_processing_pool);
 #endif
 
+    /* Free handles kept for reuse */
+    for (i = 0; i < context->hg_core_class->n_routes; i++)
+        hg_core_handle_pool_drain(&context->routes[i].handle_pool);
+
+    /* Free coalesced messages kept for reuse */
+    hg_core_batch_free_list(context);
+
+    /* Free source addresses */
+    hg_core_addr_table_free(context);
+
     /* Number of handles for that context should be 0 */
     n_handles = hg_atomic_get32(&context->n_handles);
     if (n_handles != 0) {
@@ -3782,12 +7428,12 @@ HG_Core_context_destroy(hg_core_context_t *context)
     }
 
     /* Check that completion queue is empty now */
-    if (!hg_atomic_queue_is_empty(context->completion_queue)) {
+    if (!hg_core_completion_queue_is_empty(context)) {
         HG_LOG_ERROR("Completion queue should be empty");
         ret = HG_PROTOCOL_ERROR;
         goto done;
     }
-    hg_atomic_queue_free(context->completion_queue);
+    hg_core_completion_queue_free(context);
 
     /* Check that completion queue is empty now */
     hg_thread_mutex_lock(&context->completion_queue_mutex);
@@ -3815,29 +7461,17 @@ HG_Core_context_destroy(hg_core_context_t *context)
     }
 #endif
 
-    if (context->hg_core_class->progress_mode == NA_NO_BLOCK)
-        /* Was forced to use progress poll */
-        na_poll_fd = 0;
-    else
-        /* If NA plugin exposes fd, remove it from poll set */
-        na_poll_fd = NA_Poll_get_fd(context->hg_core_class->na_class,
-            context->na_context);
-    if ((na_poll_fd >= 0)
-        && hg_poll_remove(context->poll_set, na_poll_fd) != HG_UTIL_SUCCESS) {
-        HG_LOG_ERROR("Could not remove NA poll descriptor from poll set");
-        ret = HG_PROTOCOL_ERROR;
-        goto done;
-    }
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
 
-#ifdef HG_HAS_SM_ROUTING
-    if (context->na_sm_context) {
+        if (!route->na_context)
+            continue;
         if (context->hg_core_class->progress_mode == NA_NO_BLOCK)
             /* Was forced to use progress poll */
             na_poll_fd = 0;
         else
             /* If NA plugin exposes fd, remove it from poll set */
-            na_poll_fd = NA_Poll_get_fd(context->hg_core_class->na_sm_class,
-                context->na_sm_context);
+            na_poll_fd = NA_Poll_get_fd(route->na_class, route->na_context);
         if ((na_poll_fd >= 0)
             && hg_poll_remove(context->poll_set, na_poll_fd) != HG_UTIL_SUCCESS) {
             HG_LOG_ERROR("Could not remove NA poll descriptor from poll set");
@@ -3845,7 +7479,6 @@ HG_Core_context_destroy(hg_core_context_t *context)
             goto done;
         }
     }
-#endif
 
     /* Destroy poll set */
     if (hg_poll_destroy(context->poll_set) != HG_UTIL_SUCCESS) {
@@ -3854,23 +7487,18 @@ HG_Core_context_destroy(hg_core_context_t *context)
         goto done;
     }
 
-    /* Destroy NA context */
-    if (context->na_context && NA_Context_destroy(context->hg_core_class->na_class,
-            context->na_context) != NA_SUCCESS) {
-        HG_LOG_ERROR("Could not destroy NA context");
-        ret = HG_NA_ERROR;
-        goto done;
-    }
+    /* Destroy NA contexts */
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        struct hg_core_context_route *route = &context->routes[i];
 
-#ifdef HG_HAS_SM_ROUTING
-    /* Destroy NA SM context */
-    if (context->na_sm_context && NA_Context_destroy(
-        context->hg_core_class->na_sm_class, context->na_sm_context) != NA_SUCCESS) {
-        HG_LOG_ERROR("Could not destroy NA SM context");
-        ret = HG_NA_ERROR;
-        goto done;
+        if (route->na_context && NA_Context_destroy(route->na_class,
+            route->na_context) != NA_SUCCESS) {
+            HG_LOG_ERROR("Could not destroy NA context");
+            ret = HG_NA_ERROR;
+            goto done;
+        }
+        route->na_context = NULL;
     }
-#endif
 
     /* Free user data */
     if (context->data_free_callback)
@@ -3879,11 +7507,16 @@ HG_Core_context_destroy(hg_core_context_t *context)
     /* Destroy completion queue mutex/cond */
     hg_thread_mutex_destroy(&context->completion_queue_mutex);
     hg_thread_cond_destroy(&context->completion_queue_cond);
-    hg_thread_spin_destroy(&context->pending_list_lock);
-#ifdef HG_HAS_SM_ROUTING
-    hg_thread_spin_destroy(&context->sm_pending_list_lock);
-#endif
+    hg_thread_mutex_destroy(&context->batch_mutex);
+    hg_thread_spin_destroy(&context->timer_wheel.lock);
+    hg_thread_spin_destroy(&context->priority_queue_lock);
     hg_thread_spin_destroy(&context->created_list_lock);
+    hg_thread_spin_destroy(&context->addr_table_lock);
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        hg_thread_spin_destroy(&context->routes[i].pending_list_lock);
+        hg_thread_spin_destroy(&context->routes[i].handle_pool.lock);
+        hg_thread_spin_destroy(&context->routes[i].post_info.lock);
+    }
 
     /* Decrement context count of parent class */
     hg_atomic_decr32(&context->hg_core_class->n_contexts);
@@ -3934,19 +7567,47 @@ na_context_t *
 HG_Core_context_get_na_sm(const hg_core_context_t *context)
 {
     na_context_t *ret = NULL;
+    unsigned int i;
 
     if (!context) {
         HG_LOG_ERROR("NULL HG core context");
         goto done;
     }
 
-    ret = context->na_sm_context;
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        if (context->hg_core_class->routes[i].local) {
+            ret = context->routes[i].na_context;
+            break;
+        }
+    }
 
 done:
     return ret;
 }
 #endif
 
+/*---------------------------------------------------------------------------*/
+na_context_t *
+HG_Core_context_get_na_route(const hg_core_context_t *context,
+    unsigned int index)
+{
+    na_context_t *ret = NULL;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        goto done;
+    }
+    if (index >= context->hg_core_class->n_routes) {
+        HG_LOG_ERROR("Invalid route index (%u)", index);
+        goto done;
+    }
+
+    ret = context->routes[index].na_context;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_uint8_t
 HG_Core_context_get_id(const hg_core_context_t *context)
@@ -3965,6 +7626,30 @@ HG_Core_context_get_id(const hg_core_context_t *context)
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+unsigned int
+HG_Core_context_get_post_count(hg_core_context_t *context)
+{
+    unsigned int ret = 0, i;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        goto done;
+    }
+
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        struct hg_core_post_info *hg_core_post_info =
+            &context->routes[i].post_info;
+
+        hg_thread_spin_lock(&hg_core_post_info->lock);
+        ret += hg_core_post_info->count;
+        hg_thread_spin_unlock(&hg_core_post_info->lock);
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_context_set_data(hg_core_context_t *context, void *data,
@@ -3989,23 +7674,102 @@ HG_Core_context_set_data(hg_core_context_t *context, void *data,
 void *
 HG_Core_context_get_data(const hg_core_context_t *context)
 {
-    void *ret = NULL;
+    void *ret = NULL;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        goto done;
+    }
+
+    ret = context->data;
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
+    hg_return_t (*callback)(hg_core_handle_t, void *), void *arg)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    context->handle_create = callback;
+    context->handle_create_arg = arg;
+
+ done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_set_handle_release_callback(hg_core_context_t *context,
+    void (*callback)(hg_core_handle_t, void *), void *arg)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    context->handle_release = callback;
+    context->handle_release_arg = arg;
+
+ done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_context_post(hg_core_context_t *context, unsigned int request_count,
+    hg_bool_t repost)
+{
+    hg_return_t ret = HG_SUCCESS;
+    unsigned int i;
 
     if (!context) {
         HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (!request_count) {
+        HG_LOG_ERROR("Request count must be greater than 0");
+        ret = HG_INVALID_PARAM;
         goto done;
     }
 
-    ret = context->data;
+    /* Keep initial number of posted handles within bounds */
+    if (context->hg_core_class->request_post_max
+        && request_count > context->hg_core_class->request_post_max)
+        request_count = context->hg_core_class->request_post_max;
+    if (request_count < context->hg_core_class->request_post_min)
+        request_count = context->hg_core_class->request_post_min;
 
-done:
+    /* Requests may be received through any route */
+    for (i = 0; i < context->hg_core_class->n_routes; i++) {
+        ret = hg_core_context_post(&context->routes[i], request_count, repost);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not post requests on context");
+            goto done;
+        }
+    }
+
+ done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
-    hg_return_t (*callback)(hg_core_handle_t, void *), void *arg)
+HG_Core_context_start_progress(hg_core_context_t *context,
+    const struct hg_progress_info *info)
 {
     hg_return_t ret = HG_SUCCESS;
 
@@ -4014,20 +7778,54 @@ HG_Core_context_set_handle_create_callback(hg_core_context_t *context,
         ret = HG_INVALID_PARAM;
         goto done;
     }
+    if (context->progress_thread_started) {
+        HG_LOG_ERROR("Progress thread already started");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
 
-    context->handle_create = callback;
-    context->handle_create_arg = arg;
+    if (info)
+        context->progress_info = *info;
+    else
+        memset(&context->progress_info, 0, sizeof(struct hg_progress_info));
+    hg_atomic_init32(&context->progress_thread_stop, 0);
 
- done:
+    if (hg_thread_create(&context->progress_thread, hg_core_progress_thread,
+        context) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not create progress thread");
+        ret = HG_OTHER_ERROR;
+        goto done;
+    }
+    context->progress_thread_started = HG_TRUE;
+
+    if (context->progress_info.bind_cpu) {
+        hg_cpu_set_t cpu_mask;
+
+#if defined(_WIN32)
+        cpu_mask = (hg_cpu_set_t) 1 << context->progress_info.cpu_id;
+#elif defined(__APPLE__)
+        memset(&cpu_mask, 0, sizeof(cpu_mask));
+#else
+        CPU_ZERO(&cpu_mask);
+        CPU_SET(context->progress_info.cpu_id, &cpu_mask);
+#endif
+        if (hg_thread_setaffinity(context->progress_thread, &cpu_mask)
+            != HG_UTIL_SUCCESS) {
+            HG_LOG_ERROR("Could not set progress thread affinity");
+            HG_Core_context_stop_progress(context);
+            ret = HG_OTHER_ERROR;
+            goto done;
+        }
+    }
+
+done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 hg_return_t
-HG_Core_context_post(hg_core_context_t *context, unsigned int request_count,
-    hg_bool_t repost)
+HG_Core_context_stop_progress(hg_core_context_t *context)
 {
-    hg_bool_t use_sm = HG_FALSE;
     hg_return_t ret = HG_SUCCESS;
 
     if (!context) {
@@ -4035,27 +7833,26 @@ HG_Core_context_post(hg_core_context_t *context, unsigned int request_count,
         ret = HG_INVALID_PARAM;
         goto done;
     }
-    if (!request_count) {
-        HG_LOG_ERROR("Request count must be greater than 0");
-        ret = HG_INVALID_PARAM;
+    if (!context->progress_thread_started)
         goto done;
-    }
 
-#ifdef HG_HAS_SM_ROUTING
-    do {
-#endif
-        ret = hg_core_context_post(context, request_count, repost, use_sm);
-        if (ret != HG_SUCCESS) {
-            HG_LOG_ERROR("Could not post requests on context");
-            goto done;
-        }
-#ifdef HG_HAS_SM_ROUTING
-        if (context->na_sm_context)
-            use_sm = !use_sm;
-    } while (use_sm);
+    /* Wake up thread if it blocks on the poll set, otherwise it exits at the
+     * latest once its block timeout expires */
+    hg_atomic_set32(&context->progress_thread_stop, 1);
+#ifdef HG_HAS_SELF_FORWARD
+    if (context->completion_queue_notify
+        && context->progress == hg_core_progress_poll
+        && hg_event_set(context->completion_queue_notify) != HG_UTIL_SUCCESS)
+        HG_LOG_ERROR("Could not signal completion queue");
 #endif
+    if (hg_thread_join(context->progress_thread) != HG_UTIL_SUCCESS) {
+        HG_LOG_ERROR("Could not join progress thread");
+        ret = HG_OTHER_ERROR;
+        goto done;
+    }
+    context->progress_thread_started = HG_FALSE;
 
- done:
+done:
     return ret;
 }
 
@@ -4101,19 +7898,27 @@ HG_Core_register(hg_core_class_t *hg_core_class, hg_id_t id,
             goto done;
         }
 
+        hg_core_rpc_info->id = id;
         hg_core_rpc_info->rpc_cb = rpc_cb;
         hg_core_rpc_info->data = NULL;
         hg_core_rpc_info->free_callback = NULL;
+        hg_core_rpc_info->priority = HG_PRIORITY_NORMAL;
+        hg_core_rpc_info->retired = NULL;
 
         hg_thread_spin_lock(&hg_core_class->func_map_lock);
         hash_ret = hg_hash_table_insert(hg_core_class->func_map,
             (hg_hash_table_key_t) func_key, hg_core_rpc_info);
-        hg_thread_spin_unlock(&hg_core_class->func_map_lock);
         if (!hash_ret) {
+            hg_thread_spin_unlock(&hg_core_class->func_map_lock);
             HG_LOG_ERROR("Could not insert RPC ID into function map (already registered?)");
             ret = HG_INVALID_PARAM;
             goto done;
         }
+        /* Key and value are now owned by the function map, snapshot is
+         * published by next lookup */
+        func_key = NULL;
+        hg_atomic_set32(&hg_core_class->func_map_dirty, 1);
+        hg_thread_spin_unlock(&hg_core_class->func_map_lock);
     }
 
 done:
@@ -4128,6 +7933,7 @@ done:
 hg_return_t
 HG_Core_deregister(hg_core_class_t *hg_core_class, hg_id_t id)
 {
+    struct hg_core_rpc_info *hg_core_rpc_info;
     hg_return_t ret = HG_SUCCESS;
     int hash_ret;
 
@@ -4138,14 +7944,28 @@ HG_Core_deregister(hg_core_class_t *hg_core_class, hg_id_t id)
     }
 
     hg_thread_spin_lock(&hg_core_class->func_map_lock);
+    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(
+        hg_core_class->func_map, (hg_hash_table_key_t) &id);
     hash_ret = hg_hash_table_remove(hg_core_class->func_map,
         (hg_hash_table_key_t) &id);
-    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
     if (!hash_ret) {
+        hg_thread_spin_unlock(&hg_core_class->func_map_lock);
         HG_LOG_ERROR("Could not deregister RPC ID from function map");
         ret = HG_INVALID_PARAM;
         goto done;
     }
+    hg_atomic_set32(&hg_core_class->func_map_dirty, 1);
+
+    /* Snapshots and handles may still reference RPC info, defer free */
+    hg_core_rpc_info->retired = hg_core_class->rpc_info_retired;
+    hg_core_class->rpc_info_retired = hg_core_rpc_info;
+    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+
+    /* Free user data */
+    if (hg_core_rpc_info->free_callback)
+        hg_core_rpc_info->free_callback(hg_core_rpc_info->data);
+    hg_core_rpc_info->data = NULL;
+    hg_core_rpc_info->free_callback = NULL;
 
 done:
     return ret;
@@ -4168,10 +7988,7 @@ HG_Core_registered(hg_core_class_t *hg_core_class, hg_id_t id, hg_bool_t *flag)
         goto done;
     }
 
-    hg_thread_spin_lock(&hg_core_class->func_map_lock);
-    *flag = (hg_bool_t) (hg_hash_table_lookup(hg_core_class->func_map,
-            (hg_hash_table_key_t) &id) != HG_HASH_TABLE_NULL);
-    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+    *flag = (hg_bool_t) (hg_core_func_map_lookup(hg_core_class, id) != NULL);
 
 done:
     return ret;
@@ -4191,10 +8008,7 @@ HG_Core_register_data(hg_core_class_t *hg_core_class, hg_id_t id, void *data,
         goto done;
     }
 
-    hg_thread_spin_lock(&hg_core_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(hg_core_class->func_map,
-            (hg_hash_table_key_t) &id);
-    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(hg_core_class, id);
     if (!hg_core_rpc_info) {
         HG_LOG_ERROR("Could not find RPC ID in function map");
         ret = HG_NO_MATCH;
@@ -4222,10 +8036,7 @@ HG_Core_registered_data(hg_core_class_t *hg_core_class, hg_id_t id)
         goto done;
     }
 
-    hg_thread_spin_lock(&hg_core_class->func_map_lock);
-    hg_core_rpc_info = (struct hg_core_rpc_info *) hg_hash_table_lookup(hg_core_class->func_map,
-            (hg_hash_table_key_t) &id);
-    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(hg_core_class, id);
     if (!hg_core_rpc_info) {
         HG_LOG_ERROR("Could not find RPC ID in function map");
         goto done;
@@ -4237,6 +8048,40 @@ done:
    return data;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_registered_priority(hg_core_class_t *hg_core_class, hg_id_t id,
+    hg_priority_t priority)
+{
+    struct hg_core_rpc_info *hg_core_rpc_info = NULL;
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (priority > HG_PRIORITY_LOW) {
+        HG_LOG_ERROR("Invalid priority class");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    hg_thread_spin_lock(&hg_core_class->func_map_lock);
+    hg_core_rpc_info = hg_core_func_map_lookup(hg_core_class, id);
+    if (!hg_core_rpc_info) {
+        hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+        HG_LOG_ERROR("Could not find RPC ID in function map");
+        ret = HG_NO_MATCH;
+        goto done;
+    }
+    hg_core_rpc_info->priority = priority;
+    hg_thread_spin_unlock(&hg_core_class->func_map_lock);
+
+done:
+   return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_lookup(hg_core_context_t *context, hg_core_cb_t callback, void *arg,
@@ -4270,6 +8115,41 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_lookup_batch(hg_core_context_t *context, hg_core_cb_t callback,
+    void *arg, const char **names, unsigned int count, hg_core_addr_t *addrs,
+    hg_core_op_id_t *op_id)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (!callback) {
+        HG_LOG_ERROR("NULL callback");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (!names || !addrs || !count) {
+        HG_LOG_ERROR("NULL lookup names or addresses");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = hg_core_addr_lookup_batch(context, callback, arg, names, count,
+        addrs, op_id);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not lookup addresses");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_free(hg_core_class_t *hg_core_class, hg_core_addr_t addr)
@@ -4326,6 +8206,60 @@ done:
      return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+na_addr_t
+HG_Core_addr_get_na_rail(hg_core_addr_t addr, unsigned int index)
+{
+    na_addr_t ret = NA_ADDR_NULL;
+
+    if (addr == HG_CORE_ADDR_NULL) {
+        HG_LOG_ERROR("NULL addr");
+        goto done;
+    }
+    if (index >= HG_CORE_ROUTE_MAX) {
+        HG_LOG_ERROR("Invalid route index (%u)", index);
+        goto done;
+    }
+
+    ret = addr->na_rail_addrs[index];
+
+done:
+     return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_addr_lookup_rails(hg_core_context_t *context, hg_core_addr_t addr,
+    const char *name)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (addr == HG_CORE_ADDR_NULL) {
+        HG_LOG_ERROR("NULL addr");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+    if (!name) {
+        HG_LOG_ERROR("NULL address string");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = hg_core_addr_lookup_rails(context, addr, name);
+    if (ret != HG_SUCCESS) {
+        HG_LOG_ERROR("Could not look up rails of address");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_self(hg_core_class_t *hg_core_class, hg_core_addr_t *addr)
@@ -4353,6 +8287,27 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_bool_t
+HG_Core_addr_is_self(hg_core_class_t *hg_core_class, hg_core_addr_t addr)
+{
+    hg_bool_t ret = HG_FALSE;
+
+    if (!hg_core_class) {
+        HG_LOG_ERROR("NULL HG core class");
+        goto done;
+    }
+    if (addr == HG_CORE_ADDR_NULL) {
+        HG_LOG_ERROR("NULL addr");
+        goto done;
+    }
+
+    ret = (hg_bool_t) NA_Addr_is_self(addr->na_class, addr->na_addr);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_addr_dup(hg_core_class_t *hg_core_class, hg_core_addr_t addr, hg_core_addr_t *new_addr)
@@ -4414,10 +8369,7 @@ HG_Core_create(hg_core_context_t *context, hg_core_addr_t addr, hg_id_t id,
     hg_core_handle_t *handle)
 {
     struct hg_core_handle *hg_core_handle = NULL;
-#ifdef HG_HAS_SM_ROUTING
-    struct hg_core_addr *hg_core_addr = addr;
-#endif
-    hg_bool_t use_sm = HG_FALSE;
+    struct hg_core_context_route *route;
     hg_return_t ret = HG_SUCCESS;
 
     if (!context) {
@@ -4431,13 +8383,16 @@ HG_Core_create(hg_core_context_t *context, hg_core_addr_t addr, hg_id_t id,
         goto done;
     }
 
-#ifdef HG_HAS_SM_ROUTING
-    if (hg_core_addr && (hg_core_addr->na_class == context->hg_core_class->na_sm_class))
-        use_sm = HG_TRUE;
-#endif
+    /* Use route of NA class address was looked up with */
+    route = (addr != HG_CORE_ADDR_NULL) ?
+        hg_core_context_route_get(context, addr->na_class) :
+        &context->routes[context->hg_core_class->main_route];
 
-    /* Create new handle */
-    hg_core_handle = hg_core_create(context, use_sm);
+    /* Reuse handle from pool if available, otherwise create new handle */
+    if (context->hg_core_class->handle_pool_size)
+        hg_core_handle = hg_core_handle_pool_get(route);
+    if (!hg_core_handle)
+        hg_core_handle = hg_core_create(route);
     if (!hg_core_handle) {
         HG_LOG_ERROR("Could not create HG core handle");
         ret = HG_NOMEM_ERROR;
@@ -4463,6 +8418,9 @@ HG_Core_create(hg_core_context_t *context, hg_core_addr_t addr, hg_id_t id,
         }
     }
 
+    /* Handle can be returned to pool once destroyed */
+    hg_core_handle->reuse = HG_TRUE;
+
     *handle = (hg_core_handle_t) hg_core_handle;
 
 done:
@@ -4616,6 +8574,25 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+hg_core_context_t *
+HG_Core_get_process_context(hg_core_handle_t handle)
+{
+    struct hg_core_handle *hg_core_handle = (struct hg_core_handle *) handle;
+    hg_core_context_t *ret = NULL;
+
+    if (!hg_core_handle) {
+        HG_LOG_ERROR("NULL handle");
+        goto done;
+    }
+
+    ret = (hg_core_handle->process_context) ? hg_core_handle->process_context
+        : hg_core_handle->hg_info.context;
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 hg_return_t
 HG_Core_set_target_id(hg_core_handle_t handle, hg_uint8_t id)
@@ -4689,6 +8666,14 @@ done:
 hg_return_t
 HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_uint8_t flags, hg_size_t payload_size)
+{
+    return HG_Core_forward_timed(handle, callback, arg, flags, payload_size, 0);
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_forward_timed(hg_core_handle_t handle, hg_core_cb_t callback,
+    void *arg, hg_uint8_t flags, hg_size_t payload_size, unsigned int timeout)
 {
     struct hg_core_handle *hg_core_handle = (struct hg_core_handle *) handle;
     hg_size_t header_size;
@@ -4761,22 +8746,34 @@ HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_core_handle->request_callback = callback;
     hg_core_handle->request_arg = arg;
 
-    /* Set header */
-    hg_core_handle->in_header.msg.request.id = hg_core_handle->hg_info.id;
-    hg_core_handle->in_header.msg.request.flags = flags;
-    /* Set the cookie as origin context ID, so that when the cookie is unpacked
-     * by the target and assigned to HG info context_id, the NA layer knows
-     * which context ID it needs to send the response to. */
-    hg_core_handle->in_header.msg.request.cookie = hg_core_handle->hg_info.context->id;
-
-    /* Encode request header */
-    ret = hg_core_proc_header_request(hg_core_handle, &hg_core_handle->in_header,
-        HG_ENCODE);
-    if (ret != HG_SUCCESS) {
-        HG_LOG_ERROR("Could not encode header");
-        /* Handle is no longer in use */
-        hg_atomic_set32(&hg_core_handle->in_use, HG_FALSE);
-        goto done;
+    /* Header of a handle forwarded again is still encoded in its buffer,
+     * only encode it (and compute its checksum) when one of its fields
+     * changed since the last forward */
+    if (!hg_core_handle->in_header_encoded
+        || hg_core_handle->in_header.msg.request.id != hg_core_handle->hg_info.id
+        || hg_core_handle->in_header.msg.request.flags != flags
+        || hg_core_handle->in_header.msg.request.cookie
+            != hg_core_handle->hg_info.context->id) {
+        /* Set header */
+        hg_core_handle->in_header.msg.request.id = hg_core_handle->hg_info.id;
+        hg_core_handle->in_header.msg.request.flags = flags;
+        /* Set the cookie as origin context ID, so that when the cookie is
+         * unpacked by the target and assigned to HG info context_id, the NA
+         * layer knows which context ID it needs to send the response to. */
+        hg_core_handle->in_header.msg.request.cookie =
+            hg_core_handle->hg_info.context->id;
+
+        /* Encode request header */
+        ret = hg_core_proc_header_request(hg_core_handle,
+            &hg_core_handle->in_header, HG_ENCODE);
+        if (ret != HG_SUCCESS) {
+            HG_LOG_ERROR("Could not encode header");
+            hg_core_handle->in_header_encoded = HG_FALSE;
+            /* Handle is no longer in use */
+            hg_atomic_set32(&hg_core_handle->in_use, HG_FALSE);
+            goto done;
+        }
+        hg_core_handle->in_header_encoded = HG_TRUE;
     }
 
     /* Increase ref count here so that a call to HG_Destroy does not free the
@@ -4784,11 +8781,35 @@ HG_Core_forward(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
      */
     hg_atomic_incr32(&hg_core_handle->ref_count);
 
+    /* Arm deadline before forwarding so that it also covers the operations
+     * issued by forward, self forwards complete without blocking on NA */
+    hg_core_handle->timed_out = HG_FALSE;
+    if (timeout && !hg_core_handle->is_self) {
+        hg_core_handle->deadline = HG_TRUE;
+        hg_core_handle->deadline_timer.callback = hg_core_deadline_cb;
+        hg_core_handle->deadline_timer.arg = hg_core_handle;
+        hg_core_timer_add(hg_core_handle->hg_info.context,
+            &hg_core_handle->deadline_timer, timeout);
+    }
+
+    /* Without credit left for target, request is sent once a response
+     * returns one, requests without response cannot return credits */
+    if (hg_core_handle->hg_info.hg_core_class->request_credits
+        && !hg_core_handle->is_self && !hg_core_handle->no_response
+        && !hg_core_flow_acquire(hg_core_handle))
+        goto done;
+
     /* If addr is self, forward locally, otherwise send the encoded buffer
      * through NA and pre-post response */
     ret = hg_core_handle->forward(hg_core_handle);
     if (ret != HG_SUCCESS) {
         HG_LOG_ERROR("Could not forward buffer");
+        hg_core_flow_release(hg_core_handle, 0);
+        if (hg_core_handle->deadline) {
+            hg_core_timer_remove(hg_core_handle->hg_info.context,
+                &hg_core_handle->deadline_timer);
+            hg_core_handle->deadline = HG_FALSE;
+        }
         /* Handle is no longer in use */
         hg_atomic_set32(&hg_core_handle->in_use, HG_FALSE);
         /* Rollback ref_count taken above */
@@ -4850,6 +8871,18 @@ HG_Core_respond(hg_core_handle_t handle, hg_core_cb_t callback, void *arg,
     hg_core_handle->out_header.msg.response.ret_code = hg_core_handle->ret;
     hg_core_handle->out_header.msg.response.flags = flags;
     hg_core_handle->out_header.msg.response.cookie = hg_core_handle->cookie;
+    /* Advertise window, only one request per origin while overloaded, i.e.
+     * while requests waiting to be processed already fill a window */
+    if (hg_core_handle->hg_info.hg_core_class->request_credits) {
+        unsigned int credits =
+            hg_core_handle->hg_info.hg_core_class->request_credits;
+
+        if (hg_core_handle->ret == HG_BUSY || (unsigned int) hg_atomic_get32(
+            &hg_core_handle->hg_info.context->process_count) >= credits)
+            credits = 1;
+        hg_core_handle->out_header.msg.response.credits =
+            (hg_uint16_t) credits;
+    }
 
     /* Encode response header */
     ret = hg_core_proc_header_response(hg_core_handle, &hg_core_handle->out_header,
@@ -4883,10 +8916,29 @@ HG_Core_progress(hg_core_context_t *context, unsigned int timeout)
         goto done;
     }
 
-    /* Make progress on the HG layer */
-    ret = context->progress(context, timeout);
+    ret = hg_core_progress(context, timeout);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+hg_return_t
+HG_Core_progress_and_trigger(hg_core_context_t *context, unsigned int timeout,
+    unsigned int max_count, unsigned int *actual_count)
+{
+    hg_return_t ret = HG_SUCCESS;
+
+    if (!context) {
+        HG_LOG_ERROR("NULL HG core context");
+        ret = HG_INVALID_PARAM;
+        goto done;
+    }
+
+    ret = hg_core_progress_and_trigger(context, timeout, max_count,
+        actual_count);
     if (ret != HG_SUCCESS && ret != HG_TIMEOUT) {
-        HG_LOG_ERROR("Could not make progress");
+        HG_LOG_ERROR("Could not progress and trigger callbacks");
         goto done;
     }
 
@@ -165,6 +165,27 @@ HG_Core_set_more_data_callback(
         void (*more_data_release_callback)(hg_core_handle_t)
         );
 
+/**
+ * Set callback returning the user key of a received request. The key is
+ * hashed together with the RPC ID when the class was initialized with the
+ * HG_DISPATCH_HASH policy so that requests sharing a key are processed on the
+ * same context. The callback is called before the RPC callback, from the
+ * context that received the request, and may only inspect the handle info
+ * and input buffer. Without callback, requests are hashed on their RPC ID.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_class_set_dispatch_key_callback(
+        struct hg_core_class *hg_core_class,
+        hg_uint64_t (*callback)(hg_core_handle_t, void *),
+        void *arg
+        );
+
 /**
  * Obtain the name of the given class.
  *
@@ -215,6 +236,61 @@ HG_Core_class_get_na_sm(
         );
 #endif
 
+/**
+ * Obtain the number of NA classes that HG core class routes RPCs through,
+ * which includes the main NA class, the NA SM class and the NA classes of
+ * additional transports passed through hg_init_info.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ *
+ * \return Number of routes or 0 if not a valid class
+ */
+HG_EXPORT unsigned int
+HG_Core_class_get_na_route_count(
+        const hg_core_class_t *hg_core_class
+        );
+
+/**
+ * Obtain the NA class of a route, routes are ordered from fastest to slowest.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param index [IN]            route index
+ *
+ * \return Pointer to NA class or NULL if not a valid class or index
+ */
+HG_EXPORT na_class_t *
+HG_Core_class_get_na_route(
+        const hg_core_class_t *hg_core_class,
+        unsigned int index
+        );
+
+/**
+ * Obtain the self address string that peers can use to reach HG core class on
+ * all its rails, i.e., routes sharing the same NA class name and protocol.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ *
+ * 
+eturn Address string or NULL if HG core class has no rails
+ */
+HG_EXPORT const char *
+HG_Core_class_get_rail_addr_string(
+        const hg_core_class_t *hg_core_class
+        );
+
+/**
+ * Obtain the minimum size of bulk transfers striped across rails.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ *
+ * 
+eturn Size or 0 if striping is disabled or not a valid class
+ */
+HG_EXPORT hg_size_t
+HG_Core_class_get_bulk_stripe_size(
+        const hg_core_class_t *hg_core_class
+        );
+
 /**
  * Obtain the maximum eager size for sending RPC inputs.
  *
@@ -349,6 +425,20 @@ HG_Core_context_get_na_sm(
         );
 #endif
 
+/**
+ * Retrieve the underlying NA context of a route.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param index [IN]            route index
+ *
+ * \return the associated context or NULL if not a valid context or index
+ */
+HG_EXPORT na_context_t *
+HG_Core_context_get_na_route(
+        const hg_core_context_t *context,
+        unsigned int index
+        );
+
 /**
  * Retrieve context ID from context.
  *
@@ -361,6 +451,20 @@ HG_Core_context_get_id(
         const hg_core_context_t *context
         );
 
+/**
+ * Retrieve number of handles that context has posted to receive requests,
+ * including those that are in use (see hg_init_info request_post_min and
+ * request_post_max).
+ *
+ * \param context [IN]          pointer to HG core context
+ *
+ * \return Number of handles posted on every route of context
+ */
+HG_EXPORT unsigned int
+HG_Core_context_get_post_count(
+        hg_core_context_t *context
+        );
+
 /**
  * Associate user data to context. When HG_Core_context_destroy() is called,
  * free_callback (if defined) is called to free the associated data.
@@ -394,7 +498,9 @@ HG_Core_context_get_data(
  * Set callback to be called on HG core handle creation. Handles are created
  * both on HG_Core_create() and HG_Core_context_post() calls. This allows
  * upper layers to create and attach data to a handle (using HG_Core_set_data())
- * and later retrieve it using HG_Core_get_data().
+ * and later retrieve it using HG_Core_get_data(). When a handle is taken from
+ * the context handle pool, the callback is called again and data that was
+ * kept by the release callback is still attached to the handle.
  *
  * \param context [IN]          pointer to HG core context
  * \param callback [IN]         pointer to function callback
@@ -409,6 +515,25 @@ HG_Core_context_set_handle_create_callback(
         void *arg
         );
 
+/**
+ * Set callback to be called when an HG core handle is returned to the context
+ * handle pool (see hg_init_info handle_pool_size). This allows upper layers to
+ * release per-RPC state while keeping data attached to the handle. If no
+ * callback is set, data attached to the handle is freed.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_context_set_handle_release_callback(
+        hg_core_context_t *context,
+        void (*callback)(hg_core_handle_t, void *),
+        void *arg
+        );
+
 /**
  * Post requests associated to context in order to receive incoming RPCs.
  * Requests are automatically re-posted after completion depending on the
@@ -429,6 +554,38 @@ HG_Core_context_post(
         hg_bool_t repost
         );
 
+/**
+ * Start a thread that makes progress on the context using the polling policy
+ * defined in info (default policy if NULL). Unless a trigger_callback is set,
+ * callbacks are also executed from that thread; otherwise trigger_callback is
+ * called whenever progress completed operations and the user is responsible
+ * for calling HG_Core_trigger() from its own executor. The thread is stopped by
+ * HG_Core_context_stop_progress() or when the context is destroyed.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param info [IN]             pointer to progress info (may be NULL)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_context_start_progress(
+        hg_core_context_t *context,
+        const struct hg_progress_info *info
+        );
+
+/**
+ * Stop progress thread previously started with HG_Core_context_start_progress() and
+ * wait for its completion.
+ *
+ * \param context [IN]          pointer to HG core context
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_context_stop_progress(
+        hg_core_context_t *context
+        );
+
 /**
  * Dynamically register an RPC ID as well as the RPC callback executed
  * when the RPC request ID is received.
@@ -513,6 +670,27 @@ HG_Core_registered_data(
         hg_id_t id
         );
 
+/**
+ * Set priority class of a registered RPC ID. Completions of RPCs of higher
+ * classes are triggered first on both origin and target, lower classes still
+ * periodically get triggered first so that they do not starve. When requests
+ * are dispatched with the HG_DISPATCH_LEAST_LOADED policy, high priority
+ * requests only account for the high priority load of contexts. By default,
+ * all RPCs are of class HG_PRIORITY_NORMAL.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param id [IN]               registered function ID
+ * \param priority [IN]         priority class
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_registered_priority(
+        hg_core_class_t *hg_core_class,
+        hg_id_t id,
+        hg_priority_t priority
+        );
+
 /**
  * Lookup an addr from a peer address/name. Addresses need to be
  * freed by calling HG_Core_addr_free(). After completion, user callback is
@@ -535,6 +713,35 @@ HG_Core_addr_lookup(
         hg_core_op_id_t *op_id
         );
 
+/**
+ * Lookup addrs from a batch of peer addresses/names. All lookups are issued
+ * at once and user callback is placed into a completion queue once they have
+ * all completed, it can then be triggered using HG_Core_trigger(). Resolved
+ * addresses are stored in addrs and need to be freed by calling
+ * HG_Core_addr_free(), names that could not be resolved are set to
+ * HG_CORE_ADDR_NULL and the callback reports the error.
+ *
+ * \param context [IN]          pointer to context of execution
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param names [IN]            array of lookup names
+ * \param count [IN]            number of names
+ * \param addrs [OUT]           array of count addresses
+ * \param op_id [OUT]           pointer to returned operation ID
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_addr_lookup_batch(
+        hg_core_context_t *context,
+        hg_core_cb_t callback,
+        void *arg,
+        const char **names,
+        unsigned int count,
+        hg_core_addr_t *addrs,
+        hg_core_op_id_t *op_id
+        );
+
 /**
  * Free the addr from the list of peers.
  *
@@ -573,6 +780,44 @@ HG_Core_addr_get_na_class(
         hg_core_addr_t addr
         );
 
+/**
+ * Obtain the NA address of the peer on another rail of the route of addr.
+ * Rails of looked up addresses are looked up along with them, rails of other
+ * addresses are looked up by HG_Core_addr_lookup_rails().
+ *
+ * \param addr [IN]             abstract address
+ * \param index [IN]            route index of rail
+ *
+ * 
+eturn NA address or NA_ADDR_NULL if not a rail of addr or not looked up
+ * yet
+ */
+HG_EXPORT na_addr_t
+HG_Core_addr_get_na_rail(
+        hg_core_addr_t addr,
+        unsigned int index
+        );
+
+/**
+ * Look up the NA addresses of the peer on the other rails of the route of
+ * addr, using the address string advertised by that peer. Lookups complete
+ * in the background when progress is made on context, only the first call
+ * on an address has an effect.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param addr [IN]             abstract address
+ * \param name [IN]             address string of peer
+ *
+ * 
+eturn HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_addr_lookup_rails(
+        hg_core_context_t *context,
+        hg_core_addr_t addr,
+        const char *name
+        );
+
 /**
  * Access self address. Address must be freed with HG_Core_addr_free().
  *
@@ -587,6 +832,21 @@ HG_Core_addr_self(
         hg_core_addr_t *addr
         );
 
+/**
+ * Indicate whether address refers to self, RPCs forwarded to it are then
+ * processed locally without going through NA.
+ *
+ * \param hg_core_class [IN]    pointer to HG core class
+ * \param addr [IN]             abstract address
+ *
+ * \return HG_TRUE if address is self or HG_FALSE otherwise
+ */
+HG_EXPORT hg_bool_t
+HG_Core_addr_is_self(
+        hg_core_class_t *hg_core_class,
+        hg_core_addr_t addr
+        );
+
 /**
  * Duplicate an existing HG abstract address. The duplicated address can be
  * stored for later use and the origin address be freed safely. The duplicated
@@ -737,6 +997,21 @@ HG_Core_get_info(
         hg_core_handle_t handle
         );
 
+/**
+ * Get context that runs the RPC callback of handle. This differs from the
+ * context of the handle's info when the request was dispatched to another
+ * context than the one that received it, the latter remaining the context
+ * used for responding.
+ *
+ * \param handle [IN]           HG handle
+ *
+ * \return Pointer to HG core context or NULL in case of failure
+ */
+HG_EXPORT hg_core_context_t *
+HG_Core_get_process_context(
+        hg_core_handle_t handle
+        );
+
 /**
  * Set target context ID that will receive and process the RPC request
  * (ID is defined on target context creation, see HG_Core_context_create_id()).
@@ -811,6 +1086,31 @@ HG_Core_forward(
         hg_size_t payload_size
         );
 
+/**
+ * Forward a call using an existing HG handle and cancel it if it has not
+ * completed within \timeout milliseconds, in which case the callback reports
+ * HG_TIMEOUT. Deadlines are expired from HG_Core_progress() on the context of
+ * the handle with a resolution of one millisecond. A timeout of 0 is
+ * equivalent to HG_Core_forward().
+ *
+ * \param handle [IN]           HG handle
+ * \param callback [IN]         pointer to function callback
+ * \param arg [IN]              pointer to data passed to callback
+ * \param payload_size [IN]     size of payload to send
+ * \param timeout [IN]          timeout (in milliseconds)
+ *
+ * \return HG_SUCCESS or corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_forward_timed(
+        hg_core_handle_t handle,
+        hg_core_cb_t callback,
+        void *arg,
+        hg_uint8_t flags,
+        hg_size_t payload_size,
+        unsigned int timeout
+        );
+
 /**
  * Respond back to the origin. The output buffer, which can be used to encode
  * the response, must first be queried using HG_Core_get_output().
@@ -871,6 +1171,31 @@ HG_Core_trigger(
         unsigned int *actual_count
         );
 
+/**
+ * Make progress and execute at most max_count callbacks, combining HG_Core_progress()
+ * and HG_Core_trigger(). Callbacks of operations that complete during progress on the
+ * calling thread are executed directly once progress returns, without being
+ * placed into the completion queue, which saves a queue round trip and a
+ * wake-up per operation. Intended for event loops that use a single thread to
+ * both progress and trigger a context. Remaining callbacks are placed into the
+ * completion queue and can be triggered by a subsequent call.
+ *
+ * \param context [IN]          pointer to HG core context
+ * \param timeout [IN]          timeout (in milliseconds)
+ * \param max_count [IN]        maximum number of callbacks triggered
+ * \param actual_count [IN]     actual number of callbacks triggered
+ *
+ * \return HG_SUCCESS if any callback was triggered, HG_TIMEOUT if none or
+ * corresponding HG error code
+ */
+HG_EXPORT hg_return_t
+HG_Core_progress_and_trigger(
+        hg_core_context_t *context,
+        unsigned int timeout,
+        unsigned int max_count,
+        unsigned int *actual_count
+        );
+
 /**
  * Cancel an ongoing operation.
  *
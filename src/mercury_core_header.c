@@ -236,6 +236,9 @@ hg_core_header_response_proc(hg_proc_op_t op, void *buf, size_t buf_size,
     /* Convert cookie to network byte order */
     HG_CORE_HEADER_PROC16(hg_core_header, buf_ptr, header->cookie, op, tmp);
 
+    /* Convert credits to network byte order */
+    HG_CORE_HEADER_PROC16(hg_core_header, buf_ptr, header->credits, op, tmp);
+
 #ifdef HG_HAS_CHECKSUMS
     /* Checksum of header */
     mchecksum_get(hg_core_header->checksum, &header->hash.header,
@@ -290,7 +293,8 @@ hg_core_header_response_verify(const struct hg_core_header *hg_core_header)
     const struct hg_core_header_response *header = &hg_core_header->msg.response;
     hg_return_t ret = HG_SUCCESS;
 
-    if (header->ret_code)
+    /* Rejections of overloaded targets are expected */
+    if (header->ret_code && header->ret_code != HG_BUSY)
         HG_LOG_WARNING("Response return code: %s",
             HG_Error_to_string((hg_return_t) header->ret_code));
 
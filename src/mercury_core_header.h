@@ -50,10 +50,12 @@ struct hg_core_header_response {
     hg_int8_t   ret_code;       /* Return code */
     hg_uint8_t  flags;          /* Flags */
     hg_uint16_t cookie;         /* Cookie */
+    hg_uint16_t credits;        /* Requests origin may have in flight
+                                   (0 if not limited) */
 #ifdef HG_HAS_CHECKSUMS
     union hg_core_header_hash hash; /* Hash */
 #endif
-    /* 64/32 bits here */
+    /* 80/48 bits here */
 };
 #if defined(__GNUC__) || defined(_WIN32)
 # pragma pack(pop)
@@ -92,9 +94,10 @@ struct hg_core_header {
 #define HG_CORE_IDENTIFIER (('H' << 1) | ('G')) /* 0xD7 */
 
 /* Mercury protocol version number */
-#define HG_CORE_PROTOCOL_VERSION 0x04
+#define HG_CORE_PROTOCOL_VERSION 0x05
 
 /* Flags */
+#define HG_CORE_COALESCED    0x40   /* Message of coalesced requests */
 #define HG_CORE_SELF_FORWARD 0x80   /* Forward to self */
 
 /*********************/
@@ -21,12 +21,95 @@
 typedef hg_uint64_t hg_size_t;          /* Size */
 typedef hg_uint64_t hg_id_t;            /* RPC ID */
 
+/* Policy used to dispatch received RPCs to the contexts of a class */
+typedef enum hg_dispatch_policy {
+    HG_DISPATCH_NONE = 0,       /*!< process on receiving context (default) */
+    HG_DISPATCH_ROUND_ROBIN,    /*!< cycle through contexts */
+    HG_DISPATCH_LEAST_LOADED,   /*!< context with fewest queued RPCs */
+    HG_DISPATCH_HASH            /*!< hash of RPC ID and user key */
+} hg_dispatch_policy_t;
+
+/* Priority class of RPCs, completions of higher classes are triggered first */
+typedef enum hg_priority {
+    HG_PRIORITY_NORMAL = 0,     /*!< default */
+    HG_PRIORITY_HIGH,           /*!< latency-critical RPCs */
+    HG_PRIORITY_LOW             /*!< background RPCs */
+} hg_priority_t;
+
 /* HG init info struct */
 struct hg_init_info {
     struct na_init_info na_init_info;   /* NA Init Info */
     na_class_t *na_class;               /* NA class */
     hg_bool_t auto_sm;                  /* Use NA SM plugin with local addrs */
     hg_bool_t stats;                    /* (Debug) Print stats at exit */
+    unsigned int handle_pool_size;      /* Handles kept for reuse per context
+                                           (0 disables pooling) */
+    unsigned int request_post_min;      /* Min number of posted handles
+                                           (0 uses initial post count) */
+    unsigned int request_post_max;      /* Max number of posted handles
+                                           (0 means no limit) */
+    unsigned int completion_queue_shards; /* Completion queue shards per
+                                           context (0 uses a single queue) */
+    hg_bool_t progress_spin;            /* Poll for an adaptive window before
+                                           blocking in progress */
+    unsigned int coalesce_count;        /* Max requests coalesced into a single
+                                           message (0 or 1 disables) */
+    hg_size_t coalesce_size;            /* Max size of coalesced messages
+                                           (0 uses max unexpected size) */
+    unsigned int coalesce_timeout;      /* Max delay before coalesced requests
+                                           are sent in us (0 sends them on
+                                           next progress call) */
+    hg_dispatch_policy_t dispatch_policy; /* Context that received RPCs are
+                                           processed on */
+    unsigned int request_credits;       /* Requests each origin may have in
+                                           flight, advertised to origins by
+                                           targets and used by origins until
+                                           targets advertise one (0 disables) */
+    unsigned int busy_queue_depth;      /* Reject requests with HG_BUSY while
+                                           that many received requests wait
+                                           for their callback (0 disables) */
+    unsigned int busy_latency;          /* Reject requests with HG_BUSY while
+                                           requests wait longer than that many
+                                           ms for their callback (0 disables) */
+    hg_bool_t addr_cache;               /* Keep looked up addresses by name so
+                                           that later lookups of the same name
+                                           complete without NA (addresses stay
+                                           cached until finalize) */
+    hg_bool_t self_inline;              /* Process RPCs forwarded to self in
+                                           the forwarding thread instead of
+                                           handing them to a thread pool */
+    const char **na_routes;             /* NA info strings of additional
+                                           transports, used in that order to
+                                           reach peers that do not advertise
+                                           the main one, transports sharing a
+                                           protocol are rails to the same
+                                           peers */
+    unsigned int na_route_count;        /* Number of additional transports */
+    hg_size_t bulk_stripe_size;         /* Min size of bulk transfers striped
+                                           across transports that share a
+                                           protocol (0 disables), additional
+                                           transports then always listen */
+};
+
+/* Progress thread polling policy */
+typedef enum hg_progress_mode {
+    HG_PROGRESS_BLOCK = 0,  /*!< block until completion or timeout (default) */
+    HG_PROGRESS_BUSY,       /*!< poll without ever blocking */
+    HG_PROGRESS_SPIN_BLOCK  /*!< poll spin_count times, then block */
+} hg_progress_mode_t;
+
+/* Progress thread info struct */
+struct hg_progress_info {
+    hg_progress_mode_t mode;            /* Polling policy */
+    unsigned int spin_count;            /* Polls without progress before
+                                           blocking (HG_PROGRESS_SPIN_BLOCK) */
+    unsigned int timeout;               /* Block timeout in ms (0 for default) */
+    hg_bool_t bind_cpu;                 /* Pin progress thread to cpu_id */
+    unsigned int cpu_id;                /* CPU progress thread is pinned to */
+    void (*trigger_callback)(void *);   /* Called when callbacks are ready to
+                                           be triggered by the user (NULL
+                                           triggers from progress thread) */
+    void *trigger_arg;                  /* Argument passed to trigger_callback */
 };
 
 /* Error return codes:
@@ -42,7 +125,8 @@ typedef enum hg_return {
     HG_NO_MATCH,        /*!< no function match */
     HG_CHECKSUM_ERROR,  /*!< checksum error */
     HG_CANCELED,        /*!< operation was canceled */
-    HG_OTHER_ERROR      /*!< error from mercury_util or external to mercury */
+    HG_OTHER_ERROR,     /*!< error from mercury_util or external to mercury */
+    HG_BUSY             /*!< target rejected request while overloaded */
 } hg_return_t;
 
 /* Callback operation type */
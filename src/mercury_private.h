@@ -14,6 +14,23 @@
 #include "mercury_core.h"
 
 #include "mercury_queue.h"
+#include "mercury_list.h"
+#include "mercury_atomic.h"
+
+/*****************/
+/* Public Macros */
+/*****************/
+
+#define HG_CORE_ROUTE_MAX   4   /* Max number of NA classes of HG class */
+
+/* Remove warnings when routine does not use arguments */
+#if defined(__cplusplus)
+# define HG_UNUSED
+#elif defined(__GNUC__) && (__GNUC__ >= 4)
+# define HG_UNUSED __attribute__((unused))
+#else
+# define HG_UNUSED
+#endif
 
 /*************************************/
 /* Public Type and Struct Definition */
@@ -37,4 +54,13 @@ struct hg_completion_entry {
     HG_QUEUE_ENTRY(hg_completion_entry) entry;
 };
 
+/* Timer armed in the timer wheel of a context */
+struct hg_core_timer {
+    void (*callback)(void *arg);        /* Called once timer has expired */
+    void *arg;                          /* Callback argument */
+    hg_util_uint64_t expire;            /* Expiration tick */
+    hg_atomic_int32_t state;            /* Idle, armed or expiring */
+    HG_LIST_ENTRY(hg_core_timer) entry; /* Entry in timer wheel slot */
+};
+
 #endif /* MERCURY_PRIVATE_H */
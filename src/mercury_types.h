@@ -28,7 +28,7 @@ typedef struct hg_op_id *hg_op_id_t;    /* Abstract operation id */
 /* HG info struct */
 struct hg_info {
     hg_class_t *hg_class;       /* HG class */
-    hg_context_t *context;      /* HG context */
+    hg_context_t *context;      /* HG context (running RPC at target) */
     hg_addr_t addr;             /* HG address at target/origin */
     hg_uint8_t context_id;      /* Context ID at target/origin */
     hg_id_t id;                 /* RPC ID */
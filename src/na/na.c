@@ -2100,3 +2100,49 @@ na_cb_completion_add(na_context_t *context,
 
     return ret;
 }
+
+/*---------------------------------------------------------------------------*/
+na_return_t
+na_cb_completion_add_batch(na_context_t *context,
+    struct na_cb_completion_data *na_cb_completion_data[], unsigned int count)
+{
+    struct na_private_context *na_private_context =
+        (struct na_private_context *) context;
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+
+    if (!count)
+        goto done;
+
+    if (hg_atomic_queue_push_n(na_private_context->completion_queue,
+        (void **) na_cb_completion_data, count) != HG_UTIL_SUCCESS) {
+        /* Not enough room for the whole batch, push what fits and move the
+         * remaining entries to the backfill queue */
+        for (i = 0; i < count; i++)
+            if (hg_atomic_queue_push(na_private_context->completion_queue,
+                na_cb_completion_data[i]) != HG_UTIL_SUCCESS)
+                break;
+
+        if (i < count) {
+            hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
+            for (; i < count; i++) {
+                HG_QUEUE_PUSH_TAIL(&na_private_context->backfill_queue,
+                    na_cb_completion_data[i], entry);
+                hg_atomic_incr32(&na_private_context->backfill_queue_count);
+            }
+            hg_thread_mutex_unlock(
+                &na_private_context->completion_queue_mutex);
+        }
+    }
+
+    if (hg_atomic_get32(&na_private_context->trigger_waiting)) {
+        hg_thread_mutex_lock(&na_private_context->completion_queue_mutex);
+        /* Callbacks are pushed to the completion queue when something
+         * completes so wake up everyone waiting in the trigger */
+        hg_thread_cond_broadcast(&na_private_context->completion_queue_cond);
+        hg_thread_mutex_unlock(&na_private_context->completion_queue_mutex);
+    }
+
+done:
+    return ret;
+}
@@ -40,6 +40,8 @@ struct na_init_info {
     na_progress_mode_t progress_mode;   /* Progress mode */
     na_uint8_t max_contexts;            /* Max contexts */
     const char *auth_key;               /* Authorization key */
+    na_bool_t stats;                    /* (Debug) Print stats at context
+                                           destroy */
 };
 
 /* Segment */
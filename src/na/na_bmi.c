@@ -46,6 +46,20 @@
 #define NA_BMI_RMA_TAG (NA_BMI_RMA_REQUEST_TAG + 1)
 #define NA_BMI_MAX_RMA_TAG (NA_TAG_UB >> 1)
 
+/* Emulated RMA transfers are split into chunks, each chunk uses its own tag
+ * and at most NA_BMI_RMA_CHUNK_WINDOW chunks are in flight per operation */
+#define NA_BMI_RMA_CHUNK_SIZE   (256 * 1024)
+#define NA_BMI_RMA_CHUNK_WINDOW 8
+#define NA_BMI_RMA_CHUNK_COUNT(size, chunk_size) \
+    (((size) > 0) ? (int) (((size) + (chunk_size) - 1) / (chunk_size)) : 1)
+
+/* Version of the RMA request sent to targets, bumped whenever
+ * na_bmi_rma_info changes (2 adds chunk_size) */
+#define NA_BMI_RMA_VERSION 2
+
+/* Max number of operations retired per BMI_testcontext() call */
+#define NA_BMI_TEST_COUNT 64
+
 #define NA_BMI_PRIVATE_DATA(na_class) \
     ((struct na_bmi_private_data *)(na_class->private_data))
 
@@ -80,15 +94,33 @@ typedef enum na_bmi_rma_op {
     NA_BMI_RMA_GET  /* Request a get operation */
 } na_bmi_rma_op_t;
 
+/* Sent as-is to targets, which must run the same NA_BMI_RMA_VERSION */
 struct na_bmi_rma_info {
+    na_uint32_t version;          /* NA_BMI_RMA_VERSION */
     na_bmi_rma_op_t op;           /* Operation requested */
     na_ptr_t base;                /* Initial address of memory */
     bmi_size_t disp;              /* Offset from initial address */
     bmi_size_t count;             /* Number of entries */
-    bmi_msg_tag_t transfer_tag;   /* Tag used for the data transfer */
+    bmi_size_t chunk_size;        /* Size of transfer chunks */
+    bmi_msg_tag_t transfer_tag;   /* Tag used for the first chunk */
     bmi_msg_tag_t completion_tag; /* Tag used for completion ack */
 };
 
+struct na_bmi_rma_transfer {
+    char *buf;                    /* Local buffer sent from or recv'd into */
+    bmi_size_t size;              /* Total size of transfer */
+    bmi_size_t chunk_size;        /* Size of chunks */
+    bmi_msg_tag_t tag;            /* Tag of first chunk */
+    na_bool_t send;               /* Send or recv chunks */
+    int chunk_count;              /* Number of chunks */
+    int chunk_posted;             /* Number of chunks posted */
+    int chunk_completed;          /* Number of chunks completed */
+    na_bool_t done;               /* All chunks completed */
+    bmi_op_id_t op_ids[NA_BMI_RMA_CHUNK_WINDOW];      /* Chunks in flight */
+    bmi_size_t actual_sizes[NA_BMI_RMA_CHUNK_WINDOW]; /* Recv'd sizes */
+    hg_atomic_int32_t pending;    /* Parts left before completion */
+};
+
 struct na_bmi_info_lookup {
     na_addr_t addr;
 };
@@ -115,9 +147,7 @@ struct na_bmi_info_recv_expected {
 
 struct na_bmi_info_put {
     bmi_op_id_t request_op_id;
-    bmi_op_id_t transfer_op_id;
-    hg_atomic_int32_t transfer_completed;
-    bmi_size_t  transfer_actual_size;
+    struct na_bmi_rma_transfer transfer;
     bmi_op_id_t completion_op_id;
     na_bool_t   completion_flag;
     bmi_size_t  completion_actual_size;
@@ -128,8 +158,7 @@ struct na_bmi_info_put {
 
 struct na_bmi_info_get {
     bmi_op_id_t request_op_id;
-    bmi_op_id_t transfer_op_id;
-    bmi_size_t  transfer_actual_size;
+    struct na_bmi_rma_transfer transfer;
     na_bool_t   internal_progress;
     BMI_addr_t  remote_addr;
     struct na_bmi_rma_info *rma_info;
@@ -143,6 +172,7 @@ struct na_bmi_op_id {
     hg_atomic_int32_t ref_count;    /* Ref count */
     hg_atomic_int32_t completed;    /* Operation completed */
     uint64_t cancel;
+    hg_thread_mutex_t rma_mutex;    /* Protects RMA transfer chunks */
     union {
       struct na_bmi_info_lookup lookup;
       struct na_bmi_info_send_unexpected send_unexpected;
@@ -472,6 +502,14 @@ na_bmi_progress_expected(
         unsigned int  timeout
         );
 
+static na_return_t
+na_bmi_progress_expected_op(
+        struct na_bmi_op_id *na_bmi_op_id,
+        bmi_op_id_t          bmi_op_id,
+        bmi_error_code_t     error_code,
+        bmi_size_t           bmi_actual_size
+        );
+
 static na_return_t
 na_bmi_progress_rma(
         na_class_t                 *na_class,
@@ -484,6 +522,43 @@ na_bmi_progress_rma_completion(
         struct na_bmi_op_id *na_bmi_op_id
         );
 
+static struct na_bmi_rma_transfer *
+na_bmi_op_rma_transfer(
+        struct na_bmi_op_id *na_bmi_op_id
+        );
+
+static void
+na_bmi_rma_transfer_init(
+        struct na_bmi_rma_transfer *transfer,
+        char                       *buf,
+        bmi_size_t                  size,
+        bmi_size_t                  chunk_size,
+        bmi_msg_tag_t               tag,
+        na_bool_t                   send,
+        int                         pending
+        );
+
+static na_return_t
+na_bmi_rma_transfer_post(
+        struct na_bmi_op_id *na_bmi_op_id
+        );
+
+static na_bool_t
+na_bmi_rma_transfer_chunk_complete(
+        struct na_bmi_op_id *na_bmi_op_id,
+        bmi_op_id_t          bmi_op_id
+        );
+
+static na_return_t
+na_bmi_rma_done(
+        struct na_bmi_op_id *na_bmi_op_id
+        );
+
+static int
+na_bmi_rma_transfer_cancel(
+        struct na_bmi_op_id *na_bmi_op_id
+        );
+
 static na_return_t
 na_bmi_complete(
         struct na_bmi_op_id *na_bmi_op_id
@@ -560,20 +635,19 @@ const na_class_t na_bmi_class_g = {
 
 /*---------------------------------------------------------------------------*/
 static NA_INLINE bmi_msg_tag_t
-na_bmi_gen_rma_tag(na_class_t *na_class)
+na_bmi_gen_rma_tag(na_class_t *na_class, int count)
 {
-    bmi_msg_tag_t tag;
+    hg_util_int32_t tag, next_tag;
 
-    /* Compare and swap tag if reached max tag */
-    if (hg_atomic_cas32(&NA_BMI_PRIVATE_DATA(na_class)->rma_tag,
-            NA_BMI_MAX_RMA_TAG, NA_BMI_RMA_TAG)) {
-        tag = NA_BMI_RMA_TAG;
-    } else {
-        /* Increment tag */
-        tag = hg_atomic_incr32(&NA_BMI_PRIVATE_DATA(na_class)->rma_tag);
-    }
+    /* Reserve count consecutive tags, wrap around if reached max tag */
+    do {
+        tag = hg_atomic_get32(&NA_BMI_PRIVATE_DATA(na_class)->rma_tag);
+        next_tag = (tag > (hg_util_int32_t) NA_BMI_MAX_RMA_TAG - count) ?
+            (hg_util_int32_t) NA_BMI_RMA_TAG + count : tag + count;
+    } while (!hg_atomic_cas32(&NA_BMI_PRIVATE_DATA(na_class)->rma_tag, tag,
+        next_tag));
 
-    return tag;
+    return (bmi_msg_tag_t) (next_tag - count + 1);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -843,6 +917,7 @@ na_bmi_op_create(na_class_t NA_UNUSED *na_class)
         goto done;
     }
     memset(na_bmi_op_id, 0, sizeof(struct na_bmi_op_id));
+    hg_thread_mutex_init(&na_bmi_op_id->rma_mutex);
     hg_atomic_set32(&na_bmi_op_id->ref_count, 1);
     /* Completed by default */
     hg_atomic_set32(&na_bmi_op_id->completed, 1);
@@ -862,6 +937,7 @@ na_bmi_op_destroy(na_class_t NA_UNUSED *na_class, na_op_id_t op_id)
         /* Cannot free yet */
         goto done;
     }
+    hg_thread_mutex_destroy(&na_bmi_op_id->rma_mutex);
     free(na_bmi_op_id);
 
 done:
@@ -1629,9 +1705,6 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->arg = arg;
     hg_atomic_set32(&na_bmi_op_id->completed, 0);
     na_bmi_op_id->info.put.request_op_id = 0;
-    na_bmi_op_id->info.put.transfer_op_id = 0;
-    hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_FALSE);
-    na_bmi_op_id->info.put.transfer_actual_size = 0;
     na_bmi_op_id->info.put.completion_op_id = 0;
     na_bmi_op_id->info.put.completion_flag = NA_FALSE;
     na_bmi_op_id->info.put.completion_actual_size = 0;
@@ -1648,14 +1721,23 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         ret = NA_NOMEM_ERROR;
         goto done;
     }
+    na_bmi_rma_info->version = NA_BMI_RMA_VERSION;
     na_bmi_rma_info->op = NA_BMI_RMA_PUT;
     na_bmi_rma_info->base = bmi_remote_mem_handle->base;
     na_bmi_rma_info->disp = bmi_remote_offset;
     na_bmi_rma_info->count = bmi_length;
-    na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class);
-    na_bmi_rma_info->completion_tag = na_bmi_gen_rma_tag(na_class);
+    na_bmi_rma_info->chunk_size = NA_BMI_RMA_CHUNK_SIZE;
+    na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class,
+        NA_BMI_RMA_CHUNK_COUNT(bmi_length, NA_BMI_RMA_CHUNK_SIZE));
+    na_bmi_rma_info->completion_tag = na_bmi_gen_rma_tag(na_class, 1);
     na_bmi_op_id->info.put.rma_info = na_bmi_rma_info;
 
+    /* Completes once request, data and ack are through */
+    na_bmi_rma_transfer_init(&na_bmi_op_id->info.put.transfer,
+        (char *) bmi_local_mem_handle->base + bmi_local_offset, bmi_length,
+        na_bmi_rma_info->chunk_size, na_bmi_rma_info->transfer_tag, NA_TRUE,
+        3);
+
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE && *op_id == NA_OP_ID_NULL)
         *op_id = (na_op_id_t) na_bmi_op_id;
@@ -1670,23 +1752,8 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
-
-    /* Post the BMI send request */
-    bmi_ret = BMI_post_send(
-            &na_bmi_op_id->info.put.transfer_op_id, na_bmi_addr->bmi_addr,
-            (char *) bmi_local_mem_handle->base + bmi_local_offset, bmi_length,
-            BMI_EXT_ALLOC, na_bmi_rma_info->transfer_tag, na_bmi_op_id,
-            *bmi_context, NULL);
-    if (bmi_ret < 0) {
-        NA_LOG_ERROR("BMI_post_send() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
-    }
-
-    /* Immediate completion */
-    if (bmi_ret) {
-        hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_TRUE);
-    }
+    if (bmi_ret)
+        hg_atomic_decr32(&na_bmi_op_id->info.put.transfer.pending);
 
     /* Post the BMI recv request */
     bmi_ret = BMI_post_recv(
@@ -1700,14 +1767,15 @@ na_bmi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
+    if (bmi_ret)
+        hg_atomic_decr32(&na_bmi_op_id->info.put.transfer.pending);
 
-    /* If immediate completion, directly add to completion queue */
-    if (bmi_ret) {
-        ret = na_bmi_complete(na_bmi_op_id);
-        if (ret != NA_SUCCESS) {
-            NA_LOG_ERROR("Could not complete operation");
-            goto done;
-        }
+    /* Post first chunks, operation is completed directly if everything
+     * completed immediately */
+    ret = na_bmi_rma_transfer_post(na_bmi_op_id);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not post transfer");
+        goto done;
     }
 
 done:
@@ -1772,8 +1840,6 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_bmi_op_id->arg = arg;
     hg_atomic_set32(&na_bmi_op_id->completed, 0);
     na_bmi_op_id->info.get.request_op_id = 0;
-    na_bmi_op_id->info.get.transfer_op_id = 0;
-    na_bmi_op_id->info.get.transfer_actual_size = 0;
     na_bmi_op_id->info.get.internal_progress = NA_FALSE;
     na_bmi_op_id->info.get.remote_addr = na_bmi_addr->bmi_addr;
     na_bmi_op_id->info.get.rma_info = NULL;
@@ -1787,14 +1853,23 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         ret = NA_NOMEM_ERROR;
         goto done;
     }
+    na_bmi_rma_info->version = NA_BMI_RMA_VERSION;
     na_bmi_rma_info->op = NA_BMI_RMA_GET;
     na_bmi_rma_info->base = bmi_remote_mem_handle->base;
     na_bmi_rma_info->disp = bmi_remote_offset;
     na_bmi_rma_info->count = bmi_length;
-    na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class);
+    na_bmi_rma_info->chunk_size = NA_BMI_RMA_CHUNK_SIZE;
+    na_bmi_rma_info->transfer_tag = na_bmi_gen_rma_tag(na_class,
+        NA_BMI_RMA_CHUNK_COUNT(bmi_length, NA_BMI_RMA_CHUNK_SIZE));
     na_bmi_rma_info->completion_tag = 0; /* not used */
     na_bmi_op_id->info.get.rma_info = na_bmi_rma_info;
 
+    /* Completes once request and data are through */
+    na_bmi_rma_transfer_init(&na_bmi_op_id->info.get.transfer,
+        (char *) bmi_local_mem_handle->base + bmi_local_offset, bmi_length,
+        na_bmi_rma_info->chunk_size, na_bmi_rma_info->transfer_tag, NA_FALSE,
+        2);
+
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE && *op_id == NA_OP_ID_NULL)
         *op_id = na_bmi_op_id;
@@ -1809,28 +1884,17 @@ na_bmi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
+    if (bmi_ret)
+        hg_atomic_decr32(&na_bmi_op_id->info.get.transfer.pending);
 
-    /* Post the BMI recv request */
-    bmi_ret = BMI_post_recv(
-            &na_bmi_op_id->info.get.transfer_op_id, na_bmi_addr->bmi_addr,
-            (char *) bmi_local_mem_handle->base + bmi_local_offset, bmi_length,
-            &na_bmi_op_id->info.get.transfer_actual_size, BMI_EXT_ALLOC,
-            na_bmi_rma_info->transfer_tag, na_bmi_op_id, *bmi_context, NULL);
-    if (bmi_ret < 0) {
-        NA_LOG_ERROR("BMI_post_recv() failed");
-        ret = NA_PROTOCOL_ERROR;
+    /* Post first chunk receives, operation is completed directly if
+     * everything completed immediately */
+    ret = na_bmi_rma_transfer_post(na_bmi_op_id);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not post transfer");
         goto done;
     }
 
-    /* If immediate completion, directly add to completion queue */
-    if (bmi_ret) {
-        ret = na_bmi_complete(na_bmi_op_id);
-        if (ret != NA_SUCCESS) {
-            NA_LOG_ERROR("Could not complete operation");
-            goto done;
-        }
-    }
-
 done:
     if (ret != NA_SUCCESS) {
         na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
@@ -1982,125 +2046,130 @@ static na_return_t
 na_bmi_progress_expected(na_class_t NA_UNUSED *na_class, na_context_t *context,
         unsigned int timeout)
 {
-    bmi_op_id_t bmi_op_id = 0;
-    int outcount = 0;
-    bmi_error_code_t error_code = 0;
-    bmi_size_t  bmi_actual_size = 0;
-    struct na_bmi_op_id *na_bmi_op_id = NULL;
+    bmi_op_id_t bmi_op_ids[NA_BMI_TEST_COUNT];
+    bmi_error_code_t error_codes[NA_BMI_TEST_COUNT];
+    bmi_size_t bmi_actual_sizes[NA_BMI_TEST_COUNT];
+    void *user_ptrs[NA_BMI_TEST_COUNT];
+    int outcount = 0, i;
     bmi_context_id *bmi_context = (bmi_context_id *) context->plugin_context;
-    na_return_t ret = NA_SUCCESS;
+    na_return_t ret = NA_SUCCESS, progress_ret;
     int bmi_ret = 0;
 
-    /* Return as soon as something completes or timeout is reached */
-    bmi_ret = BMI_testcontext(1, &bmi_op_id, &outcount, &error_code,
-            &bmi_actual_size, (void **) &na_bmi_op_id, (int) timeout,
+    error_codes[0] = 0;
+
+    /* Return as soon as something completes or timeout is reached, retire
+     * as many completed operations as possible at once */
+    bmi_ret = BMI_testcontext(NA_BMI_TEST_COUNT, bmi_op_ids, &outcount,
+            error_codes, bmi_actual_sizes, user_ptrs, (int) timeout,
             *bmi_context);
 
     /* TODO Sometimes bmi_ret is weird so check error_code as well */
-    if (bmi_ret < 0 && (error_code != 0)) {
+    if (bmi_ret < 0 && (error_codes[0] != 0)) {
         NA_LOG_ERROR("BMI_testcontext failed");
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
 
-    if (outcount && na_bmi_op_id) {
-        if ((error_code != 0) &&
-            (error_code != -BMI_ECANCEL)) {
-            NA_LOG_ERROR("BMI_testcontext failed, error code set");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
+    if (!outcount) {
+        ret = NA_TIMEOUT; /* No progress */
+        goto done;
+    }
 
-        if (error_code == -BMI_ECANCEL) {
-            na_bmi_op_id->cancel |= NA_BMI_CANCEL_C;
-        }
+    /* Keep going on errors so that other completions are not lost */
+    for (i = 0; i < outcount; i++) {
+        if (!user_ptrs[i])
+            continue;
 
-        switch (na_bmi_op_id->type) {
-            case NA_CB_LOOKUP:
-                NA_LOG_ERROR("Should not complete lookup here");
-                break;
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
-            case NA_CB_SEND_UNEXPECTED:
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_RECV_EXPECTED:
-                /* Set the actual size */
-                na_bmi_op_id->info.recv_expected.actual_size = bmi_actual_size;
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_SEND_EXPECTED:
-                ret = na_bmi_complete(na_bmi_op_id);
-                break;
-            case NA_CB_PUT:
-                if (!hg_atomic_get32(&na_bmi_op_id->info.put.transfer_completed)
-                    && na_bmi_op_id->info.put.transfer_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.put.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_TRUE);
-                        /* Progress completion and send an ack after the put */
-                        ret = na_bmi_progress_rma_completion(na_bmi_op_id);
-                    } else {
-                        /* Nothing */
-                    }
-                }
-                else if (na_bmi_op_id->info.put.completion_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.put.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                        /* Transfer is now done so free RMA info */
-                        free(na_bmi_op_id->info.put.rma_info);
-                        na_bmi_op_id->info.put.rma_info = NULL;
-                        na_bmi_release(na_bmi_op_id);
-                    } else {
-                        /* Check ack completion flag */
-                        if (!na_bmi_op_id->info.put.completion_flag) {
-                            NA_LOG_ERROR("Error during transfer, ack received is %u",
-                                na_bmi_op_id->info.put.completion_flag);
-                            ret = NA_PROTOCOL_ERROR;
-                            goto done;
-                        }
-                        /* No internal progress but actual put */
-                        ret = na_bmi_complete(na_bmi_op_id);
-                    }
-                }
-                else if (na_bmi_op_id->info.put.request_op_id == bmi_op_id) {
-                    /* If request just completed, nothing to do, just ignore */
-                } else {
-                    NA_LOG_ERROR("Unexpected operation ID");
-                    ret = NA_PROTOCOL_ERROR;
-                    goto done;
-                }
-                break;
-            case NA_CB_GET:
-                if (na_bmi_op_id->info.get.transfer_op_id == bmi_op_id) {
-                    if (na_bmi_op_id->info.get.internal_progress) {
-                        hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                        /* Transfer is now done so free RMA info */
-                        free(na_bmi_op_id->info.get.rma_info);
-                        na_bmi_op_id->info.get.rma_info = NULL;
-                        na_bmi_release(na_bmi_op_id);
-                    } else {
-                        /* No internal progress but actual get */
-                        ret = na_bmi_complete(na_bmi_op_id);
-                    }
-                }
-                else if (na_bmi_op_id->info.get.request_op_id == bmi_op_id) {
-                    /* If request just completed, nothing to do, just ignore */
-                } else {
-                    NA_LOG_ERROR("Unexpected operation ID");
+        progress_ret = na_bmi_progress_expected_op(
+                (struct na_bmi_op_id *) user_ptrs[i], bmi_op_ids[i],
+                error_codes[i], bmi_actual_sizes[i]);
+        if (progress_ret != NA_SUCCESS)
+            ret = progress_ret;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_progress_expected_op(struct na_bmi_op_id *na_bmi_op_id,
+        bmi_op_id_t bmi_op_id, bmi_error_code_t error_code,
+        bmi_size_t bmi_actual_size)
+{
+    na_return_t ret = NA_SUCCESS;
+
+    if ((error_code != 0) &&
+        (error_code != -BMI_ECANCEL)) {
+        NA_LOG_ERROR("BMI_testcontext failed, error code set");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    if (error_code == -BMI_ECANCEL) {
+        na_bmi_op_id->cancel |= NA_BMI_CANCEL_C;
+    }
+
+    switch (na_bmi_op_id->type) {
+        case NA_CB_LOOKUP:
+            NA_LOG_ERROR("Should not complete lookup here");
+            break;
+        case NA_CB_RECV_UNEXPECTED:
+            NA_LOG_ERROR("Should not complete unexpected recv here");
+            break;
+        case NA_CB_SEND_UNEXPECTED:
+            ret = na_bmi_complete(na_bmi_op_id);
+            break;
+        case NA_CB_RECV_EXPECTED:
+            /* Set the actual size */
+            na_bmi_op_id->info.recv_expected.actual_size = bmi_actual_size;
+            ret = na_bmi_complete(na_bmi_op_id);
+            break;
+        case NA_CB_SEND_EXPECTED:
+            ret = na_bmi_complete(na_bmi_op_id);
+            break;
+        case NA_CB_PUT:
+            if (na_bmi_rma_transfer_chunk_complete(na_bmi_op_id, bmi_op_id)) {
+                /* Keep the pipeline full, last chunk completes transfer */
+                ret = na_bmi_rma_transfer_post(na_bmi_op_id);
+            }
+            else if (na_bmi_op_id->info.put.completion_op_id == bmi_op_id) {
+                /* Check ack completion flag if actual put */
+                if (!na_bmi_op_id->info.put.internal_progress
+                    && !na_bmi_op_id->cancel
+                    && !na_bmi_op_id->info.put.completion_flag) {
+                    NA_LOG_ERROR("Error during transfer, ack received is %u",
+                        na_bmi_op_id->info.put.completion_flag);
                     ret = NA_PROTOCOL_ERROR;
                     goto done;
                 }
-                break;
-            default:
-                NA_LOG_ERROR("Unknown type of operation ID");
+                ret = na_bmi_rma_done(na_bmi_op_id);
+            }
+            else if (na_bmi_op_id->info.put.request_op_id == bmi_op_id) {
+                ret = na_bmi_rma_done(na_bmi_op_id);
+            } else {
+                NA_LOG_ERROR("Unexpected operation ID");
                 ret = NA_PROTOCOL_ERROR;
                 goto done;
-        }
-    } else {
-        ret = NA_TIMEOUT; /* No progress */
+            }
+            break;
+        case NA_CB_GET:
+            if (na_bmi_rma_transfer_chunk_complete(na_bmi_op_id, bmi_op_id)) {
+                /* Keep the pipeline full, last chunk completes transfer */
+                ret = na_bmi_rma_transfer_post(na_bmi_op_id);
+            }
+            else if (na_bmi_op_id->info.get.request_op_id == bmi_op_id) {
+                ret = na_bmi_rma_done(na_bmi_op_id);
+            } else {
+                NA_LOG_ERROR("Unexpected operation ID");
+                ret = NA_PROTOCOL_ERROR;
+                goto done;
+            }
+            break;
+        default:
+            NA_LOG_ERROR("Unknown type of operation ID");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
     }
 
 done:
@@ -2114,12 +2183,12 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
 {
     struct na_bmi_rma_info *na_bmi_rma_info = NULL;
     struct na_bmi_op_id *na_bmi_op_id = NULL;
-    bmi_context_id *bmi_context = (bmi_context_id *) context->plugin_context;
     na_return_t ret = NA_SUCCESS;
-    int bmi_ret;
 
+    /* Requests of origins running another version differ in size */
     if (unexpected_info->size != sizeof(struct na_bmi_rma_info)) {
-        NA_LOG_ERROR("Unexpected message size does not match RMA info struct");
+        NA_LOG_ERROR("Unexpected message size does not match RMA info struct "
+            "(origin may use another RMA version)");
         ret = NA_SIZE_ERROR;
         goto done;
     }
@@ -2132,6 +2201,17 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
         goto done;
     }
     memcpy(na_bmi_rma_info, unexpected_info->buffer, (size_t) unexpected_info->size);
+    if (na_bmi_rma_info->version != NA_BMI_RMA_VERSION) {
+        NA_LOG_ERROR("RMA version %u does not match local version %u",
+            na_bmi_rma_info->version, NA_BMI_RMA_VERSION);
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (na_bmi_rma_info->chunk_size <= 0) {
+        NA_LOG_ERROR("Invalid RMA chunk size");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
 
     /* Allocate na_op_id */
     na_bmi_op_id = (struct na_bmi_op_id *) na_bmi_op_create(na_class);
@@ -2151,9 +2231,6 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
         case NA_BMI_RMA_PUT:
             na_bmi_op_id->type = NA_CB_PUT;
             na_bmi_op_id->info.put.request_op_id = 0;
-            na_bmi_op_id->info.put.transfer_op_id = 0;
-            hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_FALSE);
-            na_bmi_op_id->info.put.transfer_actual_size = 0;
             na_bmi_op_id->info.put.completion_op_id = 0;
             na_bmi_op_id->info.put.completion_flag = NA_FALSE;
             na_bmi_op_id->info.put.completion_actual_size = 0;
@@ -2162,57 +2239,28 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
             na_bmi_op_id->info.put.rma_info = na_bmi_rma_info;
             na_bmi_op_id->cancel = 0;
 
-            /* Start receiving data */
-            bmi_ret = BMI_post_recv(&na_bmi_op_id->info.put.transfer_op_id,
-                    na_bmi_op_id->info.put.remote_addr,
-                    (char *) na_bmi_rma_info->base + na_bmi_rma_info->disp,
-                    na_bmi_rma_info->count,
-                    &na_bmi_op_id->info.put.transfer_actual_size,
-                    BMI_EXT_ALLOC, na_bmi_rma_info->transfer_tag, na_bmi_op_id,
-                    *bmi_context, NULL);
-            if (bmi_ret < 0) {
-                NA_LOG_ERROR("BMI_post_recv() failed");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-            }
-
-            /* Immediate completion */
-            if (bmi_ret) {
-                hg_atomic_set32(&na_bmi_op_id->info.put.transfer_completed, NA_TRUE);
-                ret = na_bmi_progress_rma_completion(na_bmi_op_id);
-            }
+            /* Start receiving data, released once data and ack are through */
+            na_bmi_rma_transfer_init(&na_bmi_op_id->info.put.transfer,
+                (char *) na_bmi_rma_info->base + na_bmi_rma_info->disp,
+                na_bmi_rma_info->count, na_bmi_rma_info->chunk_size,
+                na_bmi_rma_info->transfer_tag, NA_FALSE, 2);
+            ret = na_bmi_rma_transfer_post(na_bmi_op_id);
             break;
             /* Remote wants to do a get so do a send */
         case NA_BMI_RMA_GET:
             na_bmi_op_id->type = NA_CB_GET;
             na_bmi_op_id->info.get.request_op_id = 0;
-            na_bmi_op_id->info.get.transfer_op_id = 0;
-            na_bmi_op_id->info.get.transfer_actual_size = 0;
             na_bmi_op_id->info.get.internal_progress = NA_TRUE;
             na_bmi_op_id->info.get.remote_addr = unexpected_info->addr;
             na_bmi_op_id->info.get.rma_info = na_bmi_rma_info;
             na_bmi_op_id->cancel = 0;
 
-            /* Start sending data */
-            bmi_ret = BMI_post_send(&na_bmi_op_id->info.get.transfer_op_id,
-                    na_bmi_op_id->info.get.remote_addr,
-                    (char *) na_bmi_rma_info->base + na_bmi_rma_info->disp,
-                    na_bmi_rma_info->count, BMI_EXT_ALLOC,
-                    na_bmi_rma_info->transfer_tag, na_bmi_op_id,
-                    *bmi_context, NULL);
-            if (bmi_ret < 0) {
-                NA_LOG_ERROR("BMI_post_send() failed");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-            }
-
-            if (bmi_ret) {
-                hg_atomic_set32(&na_bmi_op_id->completed, 1);
-
-                free(na_bmi_op_id->info.get.rma_info);
-                na_bmi_op_id->info.get.rma_info = NULL;
-                na_bmi_release(na_bmi_op_id);
-            }
+            /* Start sending data, released once data is through */
+            na_bmi_rma_transfer_init(&na_bmi_op_id->info.get.transfer,
+                (char *) na_bmi_rma_info->base + na_bmi_rma_info->disp,
+                na_bmi_rma_info->count, na_bmi_rma_info->chunk_size,
+                na_bmi_rma_info->transfer_tag, NA_TRUE, 1);
+            ret = na_bmi_rma_transfer_post(na_bmi_op_id);
             break;
         default:
             NA_LOG_ERROR("Operation not supported");
@@ -2224,7 +2272,8 @@ na_bmi_progress_rma(na_class_t NA_UNUSED *na_class, na_context_t *context,
 
 done:
     if (ret != NA_SUCCESS) {
-        free(na_bmi_op_id);
+        if (na_bmi_op_id)
+            na_bmi_op_destroy(na_class, (na_op_id_t) na_bmi_op_id);
         free(na_bmi_rma_info);
     }
     return ret;
@@ -2260,12 +2309,217 @@ na_bmi_progress_rma_completion(struct na_bmi_op_id *na_bmi_op_id)
         ret = NA_PROTOCOL_ERROR;
         goto done;
     }
-    if (bmi_ret) {
+    if (bmi_ret)
+        ret = na_bmi_rma_done(na_bmi_op_id);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static struct na_bmi_rma_transfer *
+na_bmi_op_rma_transfer(struct na_bmi_op_id *na_bmi_op_id)
+{
+    return (na_bmi_op_id->type == NA_CB_PUT) ?
+        &na_bmi_op_id->info.put.transfer : &na_bmi_op_id->info.get.transfer;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_bmi_rma_transfer_init(struct na_bmi_rma_transfer *transfer, char *buf,
+        bmi_size_t size, bmi_size_t chunk_size, bmi_msg_tag_t tag,
+        na_bool_t send, int pending)
+{
+    transfer->buf = buf;
+    transfer->size = size;
+    transfer->chunk_size = chunk_size;
+    transfer->tag = tag;
+    transfer->send = send;
+    transfer->chunk_count = NA_BMI_RMA_CHUNK_COUNT(size, chunk_size);
+    transfer->chunk_posted = 0;
+    transfer->chunk_completed = 0;
+    transfer->done = NA_FALSE;
+    memset(transfer->op_ids, 0, sizeof(transfer->op_ids));
+    memset(transfer->actual_sizes, 0, sizeof(transfer->actual_sizes));
+    hg_atomic_set32(&transfer->pending, pending);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_rma_transfer_post(struct na_bmi_op_id *na_bmi_op_id)
+{
+    struct na_bmi_rma_transfer *transfer =
+            na_bmi_op_rma_transfer(na_bmi_op_id);
+    bmi_context_id *bmi_context =
+            (bmi_context_id *) na_bmi_op_id->context->plugin_context;
+    BMI_addr_t remote_addr = (na_bmi_op_id->type == NA_CB_PUT) ?
+            na_bmi_op_id->info.put.remote_addr :
+            na_bmi_op_id->info.get.remote_addr;
+    na_bool_t transfer_done = NA_FALSE;
+    na_return_t ret = NA_SUCCESS;
+
+    hg_thread_mutex_lock(&na_bmi_op_id->rma_mutex);
+
+    /* Do not post remaining chunks once canceled */
+    if (na_bmi_op_id->cancel)
+        transfer->chunk_count = transfer->chunk_posted;
+
+    while (transfer->chunk_posted < transfer->chunk_count
+        && transfer->chunk_posted - transfer->chunk_completed
+            < NA_BMI_RMA_CHUNK_WINDOW) {
+        bmi_size_t offset =
+                (bmi_size_t) transfer->chunk_posted * transfer->chunk_size;
+        bmi_size_t size = transfer->size - offset;
+        bmi_msg_tag_t tag = transfer->tag + transfer->chunk_posted;
+        int slot, bmi_ret;
+
+        if (size > transfer->chunk_size)
+            size = transfer->chunk_size;
+
+        /* Chunks may complete out of order, look for a free slot */
+        for (slot = 0; slot < NA_BMI_RMA_CHUNK_WINDOW; slot++)
+            if (!transfer->op_ids[slot])
+                break;
+
+        if (transfer->send) {
+            bmi_ret = BMI_post_send(&transfer->op_ids[slot], remote_addr,
+                    transfer->buf + offset, size, BMI_EXT_ALLOC, tag,
+                    na_bmi_op_id, *bmi_context, NULL);
+            if (bmi_ret < 0) {
+                NA_LOG_ERROR("BMI_post_send() failed");
+                ret = NA_PROTOCOL_ERROR;
+                break;
+            }
+        } else {
+            bmi_ret = BMI_post_recv(&transfer->op_ids[slot], remote_addr,
+                    transfer->buf + offset, size,
+                    &transfer->actual_sizes[slot], BMI_EXT_ALLOC, tag,
+                    na_bmi_op_id, *bmi_context, NULL);
+            if (bmi_ret < 0) {
+                NA_LOG_ERROR("BMI_post_recv() failed");
+                ret = NA_PROTOCOL_ERROR;
+                break;
+            }
+        }
+        transfer->chunk_posted++;
+
+        /* Immediate completion */
+        if (bmi_ret) {
+            transfer->op_ids[slot] = 0;
+            transfer->chunk_completed++;
+        }
+    }
+
+    if (ret == NA_SUCCESS && !transfer->done
+        && transfer->chunk_completed == transfer->chunk_count) {
+        transfer->done = NA_TRUE;
+        transfer_done = NA_TRUE;
+    }
+
+    hg_thread_mutex_unlock(&na_bmi_op_id->rma_mutex);
+
+    if (!transfer_done)
+        goto done;
+
+    /* Data is here, tell the origin */
+    if (na_bmi_op_id->type == NA_CB_PUT
+        && na_bmi_op_id->info.put.internal_progress) {
+        if (!na_bmi_op_id->cancel)
+            ret = na_bmi_progress_rma_completion(na_bmi_op_id);
+        else
+            /* Ack is never sent, release its part so that the op is freed */
+            ret = na_bmi_rma_done(na_bmi_op_id);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not complete RMA completion ack");
+            goto done;
+        }
+    }
+
+    ret = na_bmi_rma_done(na_bmi_op_id);
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_bool_t
+na_bmi_rma_transfer_chunk_complete(struct na_bmi_op_id *na_bmi_op_id,
+        bmi_op_id_t bmi_op_id)
+{
+    struct na_bmi_rma_transfer *transfer =
+            na_bmi_op_rma_transfer(na_bmi_op_id);
+    na_bool_t ret = NA_FALSE;
+    int slot;
+
+    hg_thread_mutex_lock(&na_bmi_op_id->rma_mutex);
+
+    for (slot = 0; slot < NA_BMI_RMA_CHUNK_WINDOW; slot++) {
+        if (transfer->op_ids[slot] == bmi_op_id) {
+            transfer->op_ids[slot] = 0;
+            transfer->chunk_completed++;
+            ret = NA_TRUE;
+            break;
+        }
+    }
+
+    hg_thread_mutex_unlock(&na_bmi_op_id->rma_mutex);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static int
+na_bmi_rma_transfer_cancel(struct na_bmi_op_id *na_bmi_op_id)
+{
+    struct na_bmi_rma_transfer *transfer =
+            na_bmi_op_rma_transfer(na_bmi_op_id);
+    bmi_context_id *bmi_context =
+            (bmi_context_id *) na_bmi_op_id->context->plugin_context;
+    int bmi_ret = 0, slot;
+
+    hg_thread_mutex_lock(&na_bmi_op_id->rma_mutex);
+
+    /* Cancel chunks in flight, remaining chunks are no longer posted */
+    for (slot = 0; slot < NA_BMI_RMA_CHUNK_WINDOW; slot++)
+        if (transfer->op_ids[slot])
+            bmi_ret |= BMI_cancel(transfer->op_ids[slot], *bmi_context);
+
+    hg_thread_mutex_unlock(&na_bmi_op_id->rma_mutex);
+
+    return bmi_ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_bmi_rma_done(struct na_bmi_op_id *na_bmi_op_id)
+{
+    struct na_bmi_rma_transfer *transfer =
+            na_bmi_op_rma_transfer(na_bmi_op_id);
+    na_return_t ret = NA_SUCCESS;
+
+    /* Request, data transfer and ack may complete in any order */
+    if (hg_atomic_decr32(&transfer->pending) > 0)
+        goto done;
+
+    if (na_bmi_op_id->type == NA_CB_PUT
+        && na_bmi_op_id->info.put.internal_progress) {
         hg_atomic_set32(&na_bmi_op_id->completed, 1);
 
+        /* Transfer is now done so free RMA info */
         free(na_bmi_op_id->info.put.rma_info);
         na_bmi_op_id->info.put.rma_info = NULL;
         na_bmi_release(na_bmi_op_id);
+    } else if (na_bmi_op_id->type == NA_CB_GET
+        && na_bmi_op_id->info.get.internal_progress) {
+        hg_atomic_set32(&na_bmi_op_id->completed, 1);
+
+        /* Transfer is now done so free RMA info */
+        free(na_bmi_op_id->info.get.rma_info);
+        na_bmi_op_id->info.get.rma_info = NULL;
+        na_bmi_release(na_bmi_op_id);
+    } else {
+        /* No internal progress but actual put/get */
+        ret = na_bmi_complete(na_bmi_op_id);
     }
 
 done:
@@ -2468,9 +2722,8 @@ na_bmi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t op_id)
             bmi_ret |= BMI_cancel(na_bmi_op_id->info.put.request_op_id,
                                  *bmi_context);
 
-            /* cancel put (expected send) */
-            bmi_ret |= BMI_cancel(na_bmi_op_id->info.put.transfer_op_id,
-                                 *bmi_context);
+            /* cancel put (expected sends) */
+            bmi_ret |= na_bmi_rma_transfer_cancel(na_bmi_op_id);
 
             /* cancel ack (expected recv) */
             bmi_ret |= BMI_cancel(na_bmi_op_id->info.put.completion_op_id,
@@ -2488,9 +2741,8 @@ na_bmi_cancel(na_class_t *na_class, na_context_t *context, na_op_id_t op_id)
             bmi_ret |= BMI_cancel(na_bmi_op_id->info.get.request_op_id,
                                   *bmi_context);
 
-            /* cancel get (expected recv) */
-            bmi_ret |= BMI_cancel(na_bmi_op_id->info.get.transfer_op_id,
-                                  *bmi_context);
+            /* cancel get (expected recvs) */
+            bmi_ret |= na_bmi_rma_transfer_cancel(na_bmi_op_id);
             if (bmi_ret < 0) {
                 NA_LOG_ERROR("BMI_cancel() failed");
                 ret = NA_PROTOCOL_ERROR;
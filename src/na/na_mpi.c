@@ -23,6 +23,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef NA_MPI_HAS_RMA
+#include <stddef.h>
+#endif
 #ifdef NA_MPI_HAS_GNI_SETUP
 #include <gni_pub.h>
 #endif
@@ -48,6 +51,16 @@ static int MPI_MAX_TAG = 32767;
 #define NA_MPI_RMA_TAG (NA_MPI_RMA_REQUEST_TAG + 1)
 #define NA_MPI_MAX_RMA_TAG (MPI_MAX_TAG >> 1)
 
+/* Number of receives pre-posted on each connected remote to catch unexpected
+ * messages and RMA requests (replaces probing of each communicator) */
+#define NA_MPI_UNEXPECTED_POOL_SIZE 8
+#define NA_MPI_RMA_REQUEST_POOL_SIZE 2
+#define NA_MPI_POOL_SIZE \
+    (NA_MPI_UNEXPECTED_POOL_SIZE + NA_MPI_RMA_REQUEST_POOL_SIZE)
+
+/* Initial size of the array of active requests passed to MPI_Testsome() */
+#define NA_MPI_REQUEST_INIT_SIZE 64
+
 #define NA_MPI_PRIVATE_DATA(na_class) \
     ((struct na_mpi_private_data *)(na_class->private_data))
 
@@ -65,21 +78,48 @@ static int MPI_MAX_TAG = 32767;
 struct na_mpi_addr {
     MPI_Comm  comm;              /* Communicator */
     MPI_Comm  rma_comm;          /* Communicator used for one sided emulation */
+    MPI_Comm  unexpected_comm;   /* Communicator used for unexpected msgs */
     int       rank;              /* Rank in this communicator */
     na_bool_t unexpected;        /* Address generated from unexpected recv */
     na_bool_t self;              /* Boolean for self */
     na_bool_t dynamic;           /* Address generated using MPI DPM routines */
     char      port_name[MPI_MAX_PORT_NAME]; /* String version of addr */
+    struct na_mpi_pool_entry *pool; /* Receives posted on this remote */
+#ifdef NA_MPI_HAS_RMA
+    MPI_Win   win;               /* Dynamic window used for put/get */
+    int       win_rank_offset;   /* Offset of remote ranks in window */
+#endif
     HG_LIST_ENTRY(na_mpi_addr) entry;
 };
 
+/* na_mpi_pool_entry */
+struct na_mpi_pool_entry {
+    struct na_mpi_addr *addr;   /* Remote the receive is posted on */
+    na_bool_t rma;              /* Receives RMA requests */
+    MPI_Request request;        /* Receive request */
+    MPI_Status status;          /* Status of completed receive */
+    HG_QUEUE_ENTRY(na_mpi_pool_entry) entry;
+    char buf[NA_MPI_UNEXPECTED_SIZE]; /* Receive buffer */
+};
+
 /* na_mpi_mem_handle */
 struct na_mpi_mem_handle {
     na_ptr_t base;     /* Initial address of memory */
     MPI_Aint size;    /* Size of memory */
     na_uint8_t attr;   /* Flag of operation access */
+#ifdef NA_MPI_HAS_RMA
+    MPI_Aint disp;     /* Displacement of memory in dynamic windows */
+    HG_LIST_ENTRY(na_mpi_mem_handle) entry; /* Not serialized */
+#endif
 };
 
+#ifdef NA_MPI_HAS_RMA
+#define NA_MPI_MEM_HANDLE_SERIALIZE_SIZE \
+    offsetof(struct na_mpi_mem_handle, entry)
+#else
+#define NA_MPI_MEM_HANDLE_SERIALIZE_SIZE sizeof(struct na_mpi_mem_handle)
+#endif
+
 /* na_mpi_rma_op */
 typedef enum na_mpi_rma_op {
     NA_MPI_RMA_PUT,       /* Request a put operation */
@@ -132,6 +172,10 @@ struct na_mpi_info_put {
     MPI_Request data_request;
     struct na_mpi_rma_info *rma_info;
     na_bool_t internal_progress; /* Used for internal RMA emulation */
+#ifdef NA_MPI_HAS_RMA
+    MPI_Win win;                 /* Window flushed on completion */
+    int win_rank;                /* Target rank in window */
+#endif
 };
 
 /* na_mpi_info_get */
@@ -149,6 +193,7 @@ struct na_mpi_op_id {
     void *arg;
     na_bool_t completed; /* Operation completed */
     na_bool_t canceled;  /* Operation canceled */
+    int active_requests; /* Number of requests not completed yet */
     union {
       struct na_mpi_info_lookup lookup;
       struct na_mpi_info_send_unexpected send_unexpected;
@@ -162,6 +207,14 @@ struct na_mpi_op_id {
     struct na_cb_completion_data completion_data;
 };
 
+/* na_mpi_request_entry */
+struct na_mpi_request_entry {
+    struct na_mpi_op_id *op_id;             /* Op ID owning request */
+    struct na_mpi_pool_entry *pool_entry;   /* Or pool entry owning request */
+    MPI_Request *request;                   /* Owner's copy of request */
+    MPI_Status *status;                     /* Where to store status */
+};
+
 struct na_mpi_private_data {
     na_bool_t listening;                    /* Used in server mode */
     na_bool_t mpi_ext_initialized;          /* MPI externally initialized */
@@ -176,15 +229,25 @@ struct na_mpi_private_data {
     na_bool_t          accepting;     /* Is in MPI_Comm_accept */
 
     HG_LIST_HEAD(na_mpi_addr) remote_list;  /* List of connected remotes */
-    hg_thread_mutex_t  remote_list_mutex;   /* Mutex */
+#ifdef NA_MPI_HAS_RMA
+    HG_LIST_HEAD(na_mpi_mem_handle) mem_handle_list; /* Registered memory */
+#endif
+    hg_thread_mutex_t  remote_list_mutex;   /* Mutex (also protects
+                                               registered memory list) */
 
     HG_QUEUE_HEAD(na_mpi_op_id) unexpected_op_queue; /* Unexpected op queue */
+    HG_QUEUE_HEAD(na_mpi_pool_entry) unexpected_msg_queue; /* Received msgs */
     hg_thread_mutex_t  unexpected_op_queue_mutex;    /* Mutex */
 
     hg_atomic_int32_t  rma_tag;              /* Atomic RMA tag value */
 
-    HG_LIST_HEAD(na_mpi_op_id) op_id_list;  /* List of na_mpi_op_ids */
-    hg_thread_mutex_t  op_id_list_mutex;    /* Mutex */
+    MPI_Request *requests;                  /* Active requests */
+    struct na_mpi_request_entry *request_entries; /* Owners of requests */
+    int *request_indices;                   /* Testsome indices */
+    MPI_Status *request_statuses;           /* Testsome statuses */
+    int request_count;                      /* Number of active requests */
+    int request_max;                        /* Size of request arrays */
+    hg_thread_mutex_t  request_mutex;       /* Mutex */
 };
 
 /********************/
@@ -223,6 +286,28 @@ na_mpi_disconnect(
         struct na_mpi_addr *na_mpi_addr
         );
 
+/* remote_list_insert */
+static na_return_t
+na_mpi_remote_list_insert(
+        na_class_t         *na_class,
+        struct na_mpi_addr *na_mpi_addr
+        );
+
+#ifdef NA_MPI_HAS_RMA
+/* win_create */
+static na_return_t
+na_mpi_win_create(
+        struct na_mpi_addr *na_mpi_addr,
+        na_bool_t           high
+        );
+
+/* win_free */
+static na_return_t
+na_mpi_win_free(
+        struct na_mpi_addr *na_mpi_addr
+        );
+#endif
+
 /* remote_list_disconnect */
 static na_return_t
 na_mpi_remote_list_disconnect(
@@ -248,6 +333,45 @@ na_mpi_gen_rma_tag(
         na_class_t *na_class
         );
 
+/* request_add */
+static na_return_t
+na_mpi_request_add(
+        na_class_t               *na_class,
+        MPI_Request              *request,
+        MPI_Status               *status,
+        struct na_mpi_op_id      *na_mpi_op_id,
+        struct na_mpi_pool_entry *na_mpi_pool_entry
+        );
+
+/* request_abort */
+static void
+na_mpi_request_abort(
+        na_class_t               *na_class,
+        MPI_Request              *request,
+        na_bool_t                 cancel
+        );
+
+/* pool_entry_post */
+static na_return_t
+na_mpi_pool_entry_post(
+        na_class_t               *na_class,
+        struct na_mpi_pool_entry *na_mpi_pool_entry
+        );
+
+/* pool_create */
+static na_return_t
+na_mpi_pool_create(
+        na_class_t         *na_class,
+        struct na_mpi_addr *na_mpi_addr
+        );
+
+/* pool_destroy */
+static void
+na_mpi_pool_destroy(
+        na_class_t         *na_class,
+        struct na_mpi_addr *na_mpi_addr
+        );
+
 /* verify */
 static na_bool_t
 na_mpi_check_protocol(
@@ -482,35 +606,30 @@ na_mpi_progress(
 /* na_mpi_progress_unexpected */
 static na_return_t
 na_mpi_progress_unexpected(
-        na_class_t   *na_class,
-        na_context_t *context,
-        unsigned int  timeout
+        na_class_t   *na_class
         );
 
 /* na_mpi_progress_unexpected_msg */
 static na_return_t
 na_mpi_progress_unexpected_msg(
-        na_class_t         *na_class,
-        na_context_t       *context,
-        struct na_mpi_addr *na_mpi_addr,
-        const MPI_Status   *status
+        na_class_t               *na_class,
+        struct na_mpi_op_id      *na_mpi_op_id,
+        struct na_mpi_pool_entry *na_mpi_pool_entry
         );
 
 /* na_mpi_progress_unexpected_rma */
 static na_return_t
 na_mpi_progress_unexpected_rma(
-        na_class_t         *na_class,
-        na_context_t       *context,
-        struct na_mpi_addr *na_mpi_addr,
-        const MPI_Status   *status
+        na_class_t               *na_class,
+        na_context_t             *context,
+        struct na_mpi_pool_entry *na_mpi_pool_entry
         );
 
-/* na_mpi_progress_expected */
+/* na_mpi_progress_requests */
 static na_return_t
-na_mpi_progress_expected(
+na_mpi_progress_requests(
         na_class_t   *na_class,
-        na_context_t *context,
-        unsigned int  timeout
+        na_context_t *context
         );
 
 /* na_mpi_complete */
@@ -696,6 +815,7 @@ na_mpi_accept(na_class_t *na_class)
 {
     MPI_Comm new_comm;
     MPI_Comm new_rma_comm;
+    MPI_Comm new_unexpected_comm;
     struct na_mpi_addr *na_mpi_addr = NULL;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
@@ -735,6 +855,15 @@ na_mpi_accept(na_class_t *na_class)
         goto done;
     }
 
+    /* Unexpected messages use their own comm so that pre-posted receives
+     * cannot match expected messages */
+    mpi_ret = MPI_Comm_dup(new_comm, &new_unexpected_comm);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Comm_dup() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
     NA_MPI_PRIVATE_DATA(na_class)->accepting = NA_FALSE;
     hg_thread_cond_signal(&NA_MPI_PRIVATE_DATA(na_class)->accept_cond);
 
@@ -748,17 +877,36 @@ na_mpi_accept(na_class_t *na_class)
     }
     na_mpi_addr->comm = new_comm;
     na_mpi_addr->rma_comm = new_rma_comm;
+    na_mpi_addr->unexpected_comm = new_unexpected_comm;
     na_mpi_addr->rank = MPI_ANY_SOURCE;
     na_mpi_addr->unexpected = NA_FALSE;
     na_mpi_addr->dynamic = (na_bool_t)
             (!NA_MPI_PRIVATE_DATA(na_class)->use_static_inter_comm);
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
+    na_mpi_addr->pool = NULL;
+
+#ifdef NA_MPI_HAS_RMA
+    /* Create window exposing registered memory to remote */
+    ret = na_mpi_win_create(na_mpi_addr, NA_FALSE);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create window");
+        goto done;
+    }
+#endif
 
     /* Add comms to list of connected remotes */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
-        na_mpi_addr, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    ret = na_mpi_remote_list_insert(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add remote");
+        goto done;
+    }
+
+    /* Start receiving from remote */
+    ret = na_mpi_pool_create(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create receive pool");
+        goto done;
+    }
 
 done:
     return ret;
@@ -766,12 +914,22 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_mpi_disconnect(na_class_t NA_UNUSED *na_class,
-        struct na_mpi_addr *na_mpi_addr)
+na_mpi_disconnect(na_class_t *na_class, struct na_mpi_addr *na_mpi_addr)
 {
     na_return_t ret = NA_SUCCESS;
 
     if (na_mpi_addr && !na_mpi_addr->unexpected) {
+        na_mpi_pool_destroy(na_class, na_mpi_addr);
+
+#ifdef NA_MPI_HAS_RMA
+        ret = na_mpi_win_free(na_mpi_addr);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not free window");
+            goto done;
+        }
+#endif
+
+        MPI_Comm_free(&na_mpi_addr->unexpected_comm);
         MPI_Comm_free(&na_mpi_addr->rma_comm);
 
         if (na_mpi_addr->dynamic) {
@@ -793,6 +951,122 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_remote_list_insert(na_class_t *na_class, struct na_mpi_addr *na_mpi_addr)
+{
+    na_return_t ret = NA_SUCCESS;
+#ifdef NA_MPI_HAS_RMA
+    struct na_mpi_mem_handle *na_mpi_mem_handle;
+    int mpi_ret;
+#endif
+
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+
+#ifdef NA_MPI_HAS_RMA
+    /* Memory registered before the remote connected must also be exposed,
+     * holding the lock prevents new registrations from being missed */
+    HG_LIST_FOREACH(na_mpi_mem_handle,
+        &NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list, entry) {
+        mpi_ret = MPI_Win_attach(na_mpi_addr->win,
+            (void *) na_mpi_mem_handle->base, na_mpi_mem_handle->size);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_attach() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+#endif
+
+    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        na_mpi_addr, entry);
+
+#ifdef NA_MPI_HAS_RMA
+done:
+#endif
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    return ret;
+}
+
+#ifdef NA_MPI_HAS_RMA
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_win_create(struct na_mpi_addr *na_mpi_addr, na_bool_t high)
+{
+    MPI_Comm win_comm = na_mpi_addr->comm;
+    int is_inter = 0;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    /* Windows can only be created on intra-communicators, merge both groups
+     * (groups passing high = false are ordered first) */
+    MPI_Comm_test_inter(na_mpi_addr->comm, &is_inter);
+    if (is_inter) {
+        mpi_ret = MPI_Intercomm_merge(na_mpi_addr->comm, (int) high,
+            &win_comm);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Intercomm_merge() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+    na_mpi_addr->win_rank_offset = 0;
+    if (is_inter && !high)
+        MPI_Comm_size(na_mpi_addr->comm, &na_mpi_addr->win_rank_offset);
+
+    mpi_ret = MPI_Win_create_dynamic(MPI_INFO_NULL, win_comm,
+        &na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_create_dynamic() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    /* Keep a passive target epoch open for the lifetime of the window */
+    mpi_ret = MPI_Win_lock_all(MPI_MODE_NOCHECK, na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_lock_all() failed");
+        MPI_Win_free(&na_mpi_addr->win);
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    if (is_inter && win_comm != na_mpi_addr->comm
+        && win_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&win_comm);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_win_free(struct na_mpi_addr *na_mpi_addr)
+{
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    if (na_mpi_addr->win == MPI_WIN_NULL)
+        goto done;
+
+    mpi_ret = MPI_Win_unlock_all(na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_unlock_all() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    mpi_ret = MPI_Win_free(&na_mpi_addr->win);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Win_free() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+done:
+    return ret;
+}
+#endif
+
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_remote_list_disconnect(na_class_t *na_class)
@@ -875,6 +1149,239 @@ na_mpi_gen_rma_tag(na_class_t *na_class)
     return tag;
 }
 
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_request_add(na_class_t *na_class, MPI_Request *request,
+        MPI_Status *status, struct na_mpi_op_id *na_mpi_op_id,
+        struct na_mpi_pool_entry *na_mpi_pool_entry)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    struct na_mpi_request_entry *request_entry;
+    na_return_t ret = NA_SUCCESS;
+
+    hg_thread_mutex_lock(&priv->request_mutex);
+
+    /* Grow request arrays if full */
+    if (priv->request_count == priv->request_max) {
+        int new_max = (priv->request_max) ? priv->request_max * 2 :
+            NA_MPI_REQUEST_INIT_SIZE;
+        MPI_Request *new_requests;
+        struct na_mpi_request_entry *new_request_entries;
+        int *new_request_indices;
+        MPI_Status *new_request_statuses;
+
+        new_requests = (MPI_Request *) realloc(priv->requests,
+            (size_t) new_max * sizeof(MPI_Request));
+        if (!new_requests) {
+            NA_LOG_ERROR("Could not grow request array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->requests = new_requests;
+
+        new_request_entries = (struct na_mpi_request_entry *) realloc(
+            priv->request_entries,
+            (size_t) new_max * sizeof(struct na_mpi_request_entry));
+        if (!new_request_entries) {
+            NA_LOG_ERROR("Could not grow request entry array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_entries = new_request_entries;
+
+        new_request_indices = (int *) realloc(priv->request_indices,
+            (size_t) new_max * sizeof(int));
+        if (!new_request_indices) {
+            NA_LOG_ERROR("Could not grow request index array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_indices = new_request_indices;
+
+        new_request_statuses = (MPI_Status *) realloc(priv->request_statuses,
+            (size_t) new_max * sizeof(MPI_Status));
+        if (!new_request_statuses) {
+            NA_LOG_ERROR("Could not grow request status array");
+            ret = NA_NOMEM_ERROR;
+            goto done;
+        }
+        priv->request_statuses = new_request_statuses;
+
+        priv->request_max = new_max;
+    }
+
+    /* Array keeps its own copy of the request handle, owner's copy is only
+     * used for cancellation and reset to MPI_REQUEST_NULL on completion */
+    priv->requests[priv->request_count] = *request;
+    request_entry = &priv->request_entries[priv->request_count];
+    request_entry->op_id = na_mpi_op_id;
+    request_entry->pool_entry = na_mpi_pool_entry;
+    request_entry->request = request;
+    request_entry->status = status;
+    priv->request_count++;
+
+done:
+    hg_thread_mutex_unlock(&priv->request_mutex);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_mpi_request_abort(na_class_t *na_class, MPI_Request *request,
+        na_bool_t cancel)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    int i;
+
+    hg_thread_mutex_lock(&priv->request_mutex);
+
+    /* Drop request from active requests if it was added */
+    for (i = 0; i < priv->request_count; i++) {
+        if (priv->request_entries[i].request != request)
+            continue;
+
+        /* Fill hole with last request */
+        priv->request_count--;
+        priv->requests[i] = priv->requests[priv->request_count];
+        priv->request_entries[i] = priv->request_entries[priv->request_count];
+        break;
+    }
+
+    /* Owner's copy is reset once progress completed the request */
+    if (*request != MPI_REQUEST_NULL) {
+        if (cancel)
+            MPI_Cancel(request);
+        MPI_Wait(request, MPI_STATUS_IGNORE);
+    }
+
+    hg_thread_mutex_unlock(&priv->request_mutex);
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_pool_entry_post(na_class_t *na_class,
+        struct na_mpi_pool_entry *na_mpi_pool_entry)
+{
+    struct na_mpi_addr *na_mpi_addr = na_mpi_pool_entry->addr;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    if (na_mpi_pool_entry->rma)
+        mpi_ret = MPI_Irecv(na_mpi_pool_entry->buf,
+            sizeof(struct na_mpi_rma_info), MPI_BYTE, MPI_ANY_SOURCE,
+            NA_MPI_RMA_REQUEST_TAG, na_mpi_addr->rma_comm,
+            &na_mpi_pool_entry->request);
+    else
+        mpi_ret = MPI_Irecv(na_mpi_pool_entry->buf, NA_MPI_UNEXPECTED_SIZE,
+            MPI_BYTE, MPI_ANY_SOURCE, MPI_ANY_TAG, na_mpi_addr->unexpected_comm,
+            &na_mpi_pool_entry->request);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Irecv() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+    ret = na_mpi_request_add(na_class, &na_mpi_pool_entry->request,
+        &na_mpi_pool_entry->status, NULL, na_mpi_pool_entry);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_pool_create(na_class_t *na_class, struct na_mpi_addr *na_mpi_addr)
+{
+    na_return_t ret = NA_SUCCESS;
+    unsigned int i;
+
+    na_mpi_addr->pool = (struct na_mpi_pool_entry *) calloc(
+        NA_MPI_POOL_SIZE, sizeof(struct na_mpi_pool_entry));
+    if (!na_mpi_addr->pool) {
+        NA_LOG_ERROR("Could not allocate receive pool");
+        ret = NA_NOMEM_ERROR;
+        goto done;
+    }
+
+    for (i = 0; i < NA_MPI_POOL_SIZE; i++) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry = &na_mpi_addr->pool[i];
+
+        na_mpi_pool_entry->addr = na_mpi_addr;
+        na_mpi_pool_entry->rma =
+            (na_bool_t) (i >= NA_MPI_UNEXPECTED_POOL_SIZE);
+        na_mpi_pool_entry->request = MPI_REQUEST_NULL;
+
+        ret = na_mpi_pool_entry_post(na_class, na_mpi_pool_entry);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not post pool receive");
+            goto done;
+        }
+    }
+
+done:
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static void
+na_mpi_pool_destroy(na_class_t *na_class, struct na_mpi_addr *na_mpi_addr)
+{
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    HG_QUEUE_HEAD(na_mpi_pool_entry) unexpected_msg_queue;
+    int i;
+
+    if (!na_mpi_addr->pool)
+        return;
+
+    /* Cancel receives that are still posted */
+    hg_thread_mutex_lock(&priv->request_mutex);
+    for (i = 0; i < priv->request_count; i++) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry =
+            priv->request_entries[i].pool_entry;
+
+        if (!na_mpi_pool_entry || na_mpi_pool_entry->addr != na_mpi_addr)
+            continue;
+
+        MPI_Cancel(&priv->requests[i]);
+        MPI_Wait(&priv->requests[i], MPI_STATUS_IGNORE);
+
+        /* Fill hole with last request */
+        priv->request_count--;
+        priv->requests[i] = priv->requests[priv->request_count];
+        priv->request_entries[i] = priv->request_entries[priv->request_count];
+        i--;
+    }
+    hg_thread_mutex_unlock(&priv->request_mutex);
+
+    /* Drop messages that were received but never matched */
+    HG_QUEUE_INIT(&unexpected_msg_queue);
+    hg_thread_mutex_lock(&priv->unexpected_op_queue_mutex);
+    while (!HG_QUEUE_IS_EMPTY(&priv->unexpected_msg_queue)) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry =
+            HG_QUEUE_FIRST(&priv->unexpected_msg_queue);
+        HG_QUEUE_POP_HEAD(&priv->unexpected_msg_queue, entry);
+
+        if (na_mpi_pool_entry->addr != na_mpi_addr)
+            HG_QUEUE_PUSH_TAIL(&unexpected_msg_queue, na_mpi_pool_entry,
+                entry);
+    }
+    while (!HG_QUEUE_IS_EMPTY(&unexpected_msg_queue)) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry =
+            HG_QUEUE_FIRST(&unexpected_msg_queue);
+        HG_QUEUE_POP_HEAD(&unexpected_msg_queue, entry);
+        HG_QUEUE_PUSH_TAIL(&priv->unexpected_msg_queue, na_mpi_pool_entry,
+            entry);
+    }
+    hg_thread_mutex_unlock(&priv->unexpected_op_queue_mutex);
+
+    free(na_mpi_addr->pool);
+    na_mpi_addr->pool = NULL;
+}
+
 /*---------------------------------------------------------------------------*/
 na_return_t
 NA_MPI_Set_init_intra_comm(MPI_Comm intra_comm)
@@ -1016,8 +1523,17 @@ na_mpi_initialize(na_class_t *na_class, const struct na_info *na_info,
     }
     NA_MPI_PRIVATE_DATA(na_class)->accept_thread = 0;
     HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->remote_list);
-    HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list);
+#ifdef NA_MPI_HAS_RMA
+    HG_LIST_INIT(&NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list);
+#endif
     HG_QUEUE_INIT(&NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue);
+    HG_QUEUE_INIT(&NA_MPI_PRIVATE_DATA(na_class)->unexpected_msg_queue);
+    NA_MPI_PRIVATE_DATA(na_class)->requests = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_entries = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_indices = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_statuses = NULL;
+    NA_MPI_PRIVATE_DATA(na_class)->request_count = 0;
+    NA_MPI_PRIVATE_DATA(na_class)->request_max = 0;
 
     /* Check flags */
     if (strcmp(na_info->protocol_name, "static") == 0)
@@ -1109,7 +1625,7 @@ na_mpi_initialize(na_class_t *na_class, const struct na_info *na_info,
     hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
     hg_thread_cond_init(&NA_MPI_PRIVATE_DATA(na_class)->accept_cond);
     hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_init(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
     hg_thread_mutex_init(
             &NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
 
@@ -1214,10 +1730,15 @@ na_mpi_finalize(na_class_t *na_class)
     hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
     hg_thread_cond_destroy(&NA_MPI_PRIVATE_DATA(na_class)->accept_cond);
     hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    hg_thread_mutex_destroy(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
     hg_thread_mutex_destroy(
             &NA_MPI_PRIVATE_DATA(na_class)->unexpected_op_queue_mutex);
 
+    free(NA_MPI_PRIVATE_DATA(na_class)->requests);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_entries);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_indices);
+    free(NA_MPI_PRIVATE_DATA(na_class)->request_statuses);
+
     free(na_class->private_data);
 
  done:
@@ -1258,9 +1779,15 @@ na_mpi_addr_lookup(na_class_t *na_class, na_context_t *context,
     na_mpi_addr->rank = 0;
     na_mpi_addr->comm = MPI_COMM_NULL;
     na_mpi_addr->rma_comm = MPI_COMM_NULL;
+    na_mpi_addr->unexpected_comm = MPI_COMM_NULL;
     na_mpi_addr->unexpected = NA_FALSE;
     na_mpi_addr->self = NA_FALSE;
     na_mpi_addr->dynamic = NA_FALSE;
+    na_mpi_addr->pool = NULL;
+#ifdef NA_MPI_HAS_RMA
+    na_mpi_addr->win = MPI_WIN_NULL;
+    na_mpi_addr->win_rank_offset = 0;
+#endif
     na_mpi_op_id->info.lookup.addr = (na_addr_t) na_mpi_addr;
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
     /* get port_name and remote server rank */
@@ -1318,13 +1845,38 @@ na_mpi_addr_lookup(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
+    /* Dup comm used for unexpected messages (same order as accept) */
+    mpi_ret = MPI_Comm_dup(na_mpi_addr->comm, &na_mpi_addr->unexpected_comm);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Comm_dup() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+
+#ifdef NA_MPI_HAS_RMA
+    /* Create window exposing registered memory to remote */
+    ret = na_mpi_win_create(na_mpi_addr, NA_TRUE);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create window");
+        goto done;
+    }
+#endif
+
     hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->accept_mutex);
 
     /* Add addr to list of addresses */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->remote_list,
-        na_mpi_addr, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    ret = na_mpi_remote_list_insert(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add remote");
+        goto done;
+    }
+
+    /* Start receiving from remote */
+    ret = na_mpi_pool_create(na_class, na_mpi_addr);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not create receive pool");
+        goto done;
+    }
 
     /* TODO MPI calls are blocking and so is na_mpi_addr_lookup,
      * i.e. we always complete here for now */
@@ -1359,10 +1911,16 @@ na_mpi_addr_self(na_class_t *na_class, na_addr_t *addr)
     }
     na_mpi_addr->comm = MPI_COMM_NULL;
     na_mpi_addr->rma_comm = MPI_COMM_NULL;
+    na_mpi_addr->unexpected_comm = MPI_COMM_NULL;
     na_mpi_addr->rank = 0;
     na_mpi_addr->unexpected = NA_FALSE;
     na_mpi_addr->self = NA_TRUE;
     na_mpi_addr->dynamic = NA_FALSE;
+    na_mpi_addr->pool = NULL;
+#ifdef NA_MPI_HAS_RMA
+    na_mpi_addr->win = MPI_WIN_NULL;
+    na_mpi_addr->win_rank_offset = 0;
+#endif
     memset(na_mpi_addr->port_name, '\0', MPI_MAX_PORT_NAME);
     if (!NA_MPI_PRIVATE_DATA(na_class)->use_static_inter_comm
             && NA_MPI_PRIVATE_DATA(na_class)->listening)
@@ -1509,13 +2067,14 @@ na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
+    na_mpi_op_id->active_requests = 1;
     na_mpi_op_id->info.send_unexpected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE) *op_id = (na_op_id_t) na_mpi_op_id;
 
     mpi_ret = MPI_Isend(buf, mpi_buf_size, MPI_BYTE, mpi_addr->rank,
-            mpi_tag, mpi_addr->comm,
+            mpi_tag, mpi_addr->unexpected_comm,
             &na_mpi_op_id->info.send_unexpected.data_request);
     if (mpi_ret != MPI_SUCCESS) {
         NA_LOG_ERROR("MPI_Isend() failed");
@@ -1523,11 +2082,13 @@ na_mpi_msg_send_unexpected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add request to active requests */
+    ret = na_mpi_request_add(na_class,
+        &na_mpi_op_id->info.send_unexpected.data_request, NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1560,29 +2121,26 @@ na_mpi_msg_recv_unexpected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->canceled = NA_FALSE;
     na_mpi_op_id->info.recv_unexpected.buf = buf;
     na_mpi_op_id->info.recv_unexpected.buf_size = (int) buf_size;
+    na_mpi_op_id->active_requests = 0;
     na_mpi_op_id->info.recv_unexpected.remote_addr = NULL;
 
     /* Assign op_id */
     if (op_id && op_id != NA_OP_ID_IGNORE) *op_id = (na_op_id_t) na_mpi_op_id;
 
-    /* Add op_id to queue of pending unexpected recv ops and make some progress
-     * in case messages are already arrived */
+    /* Add op_id to queue of pending unexpected recv ops and match it in case
+     * messages have already arrived */
     ret = na_mpi_msg_unexpected_op_push(na_class, na_mpi_op_id);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("Could not push operation ID");
         goto done;
     }
 
-    do {
-        ret = na_mpi_progress_unexpected(na_class, context, 0);
-        if (ret != NA_SUCCESS && ret != NA_TIMEOUT) {
-            NA_LOG_ERROR("Could not make unexpected progress");
-            goto done;
-        }
-    } while (ret == NA_SUCCESS);
-    /* No guarantee here that ours has completed even if progressed is true,
-     * we make progress here just in case we can complete the op at the same
-     * time */
+    ret = na_mpi_progress_unexpected(na_class);
+    if (ret != NA_SUCCESS && ret != NA_TIMEOUT) {
+        NA_LOG_ERROR("Could not make unexpected progress");
+        goto done;
+    }
+    /* No guarantee here that ours has completed even if progressed is true */
     ret = NA_SUCCESS;
 
 done:
@@ -1619,6 +2177,7 @@ na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
+    na_mpi_op_id->active_requests = 1;
     na_mpi_op_id->info.send_expected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
@@ -1633,11 +2192,13 @@ na_mpi_msg_send_expected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list assign op_id */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add request to active requests */
+    ret = na_mpi_request_add(na_class,
+        &na_mpi_op_id->info.send_expected.data_request, NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1675,6 +2236,7 @@ na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->canceled = NA_FALSE;
     na_mpi_op_id->info.recv_expected.buf_size = mpi_buf_size;
     na_mpi_op_id->info.recv_expected.actual_size = 0;
+    na_mpi_op_id->active_requests = 1;
     na_mpi_op_id->info.recv_expected.data_request = MPI_REQUEST_NULL;
 
     /* Assign op_id */
@@ -1689,11 +2251,14 @@ na_mpi_msg_recv_expected(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add request to active requests */
+    ret = na_mpi_request_add(na_class,
+        &na_mpi_op_id->info.recv_expected.data_request,
+        &na_mpi_op_id->info.recv_expected.status, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -1723,6 +2288,10 @@ na_mpi_mem_handle_create(na_class_t NA_UNUSED *na_class, void *buf,
     na_mpi_mem_handle->base = mpi_buf_base;
     na_mpi_mem_handle->size = mpi_buf_size;
     na_mpi_mem_handle->attr = (na_uint8_t) flags;
+#ifdef NA_MPI_HAS_RMA
+    /* Dynamic windows are addressed with absolute addresses */
+    MPI_Get_address(buf, &na_mpi_mem_handle->disp);
+#endif
 
     *mem_handle = (na_mem_handle_t) na_mpi_mem_handle;
 
@@ -1745,6 +2314,77 @@ na_mpi_mem_handle_free(na_class_t NA_UNUSED *na_class,
     return ret;
 }
 
+#ifdef NA_MPI_HAS_RMA
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_mem_register(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+            (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_addr *na_mpi_addr;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+
+    /* Expose memory to all connected remotes */
+    HG_LIST_FOREACH(na_mpi_addr, &NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        entry) {
+        mpi_ret = MPI_Win_attach(na_mpi_addr->win,
+            (void *) na_mpi_mem_handle->base, na_mpi_mem_handle->size);
+        if (mpi_ret != MPI_SUCCESS) {
+            struct na_mpi_addr *na_mpi_attached_addr;
+
+            NA_LOG_ERROR("MPI_Win_attach() failed");
+            HG_LIST_FOREACH(na_mpi_attached_addr,
+                &NA_MPI_PRIVATE_DATA(na_class)->remote_list, entry) {
+                if (na_mpi_attached_addr == na_mpi_addr)
+                    break;
+                MPI_Win_detach(na_mpi_attached_addr->win,
+                    (void *) na_mpi_mem_handle->base);
+            }
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+    }
+
+    /* Remotes connecting later attach registered memory */
+    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->mem_handle_list,
+        na_mpi_mem_handle, entry);
+
+done:
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+static na_return_t
+na_mpi_mem_deregister(na_class_t *na_class, na_mem_handle_t mem_handle)
+{
+    struct na_mpi_mem_handle *na_mpi_mem_handle =
+            (struct na_mpi_mem_handle *) mem_handle;
+    struct na_mpi_addr *na_mpi_addr;
+    na_return_t ret = NA_SUCCESS;
+    int mpi_ret;
+
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+
+    HG_LIST_REMOVE(na_mpi_mem_handle, entry);
+
+    HG_LIST_FOREACH(na_mpi_addr, &NA_MPI_PRIVATE_DATA(na_class)->remote_list,
+        entry) {
+        mpi_ret = MPI_Win_detach(na_mpi_addr->win,
+            (void *) na_mpi_mem_handle->base);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Win_detach() failed");
+            ret = NA_PROTOCOL_ERROR;
+        }
+    }
+
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
+    return ret;
+}
+#else
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_mem_register(na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED mem_handle)
@@ -1758,13 +2398,14 @@ na_mpi_mem_deregister(na_class_t NA_UNUSED *na_class, na_mem_handle_t NA_UNUSED
 {
     return NA_SUCCESS;
 }
+#endif
 
 /*---------------------------------------------------------------------------*/
 static na_size_t
 na_mpi_mem_handle_get_serialize_size(na_class_t NA_UNUSED *na_class,
         na_mem_handle_t NA_UNUSED mem_handle)
 {
-    return sizeof(struct na_mpi_mem_handle);
+    return NA_MPI_MEM_HANDLE_SERIALIZE_SIZE;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1776,14 +2417,14 @@ na_mpi_mem_handle_serialize(na_class_t NA_UNUSED *na_class, void *buf,
             (struct na_mpi_mem_handle*) mem_handle;
     na_return_t ret = NA_SUCCESS;
 
-    if (buf_size < sizeof(struct na_mpi_mem_handle)) {
+    if (buf_size < NA_MPI_MEM_HANDLE_SERIALIZE_SIZE) {
         NA_LOG_ERROR("Buffer size too small for serializing handle");
         ret = NA_SIZE_ERROR;
         goto done;
     }
 
     /* Copy struct */
-    memcpy(buf, na_mpi_mem_handle, sizeof(struct na_mpi_mem_handle));
+    memcpy(buf, na_mpi_mem_handle, NA_MPI_MEM_HANDLE_SERIALIZE_SIZE);
 
 done:
     return ret;
@@ -1797,14 +2438,14 @@ na_mpi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     struct na_mpi_mem_handle *na_mpi_mem_handle = NULL;
     na_return_t ret = NA_SUCCESS;
 
-    if (buf_size < sizeof(struct na_mpi_mem_handle)) {
+    if (buf_size < NA_MPI_MEM_HANDLE_SERIALIZE_SIZE) {
         NA_LOG_ERROR("Buffer size too small for deserializing handle");
         ret = NA_SIZE_ERROR;
         goto done;
     }
 
     na_mpi_mem_handle = (struct na_mpi_mem_handle*)
-            malloc(sizeof(struct na_mpi_mem_handle));
+            calloc(1, sizeof(struct na_mpi_mem_handle));
     if (!na_mpi_mem_handle) {
           NA_LOG_ERROR("Could not allocate NA MPI memory handle");
           ret = NA_NOMEM_ERROR;
@@ -1812,7 +2453,7 @@ na_mpi_mem_handle_deserialize(na_class_t NA_UNUSED *na_class,
     }
 
     /* Copy struct */
-    memcpy(na_mpi_mem_handle, buf, sizeof(struct na_mpi_mem_handle));
+    memcpy(na_mpi_mem_handle, buf, NA_MPI_MEM_HANDLE_SERIALIZE_SIZE);
 
     *mem_handle = (na_mem_handle_t) na_mpi_mem_handle;
 
@@ -1869,10 +2510,45 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
+    na_mpi_op_id->active_requests = 2;
     na_mpi_op_id->info.put.rma_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.put.internal_progress = NA_FALSE;
     na_mpi_op_id->info.put.rma_info = NULL;
+#ifdef NA_MPI_HAS_RMA
+    na_mpi_op_id->info.put.win = MPI_WIN_NULL;
+
+    /* Write directly into remote window, no target involvement needed */
+    if (na_mpi_addr->win != MPI_WIN_NULL) {
+        na_mpi_op_id->active_requests = 1;
+        na_mpi_op_id->info.put.win = na_mpi_addr->win;
+        na_mpi_op_id->info.put.win_rank =
+            na_mpi_addr->rank + na_mpi_addr->win_rank_offset;
+
+        /* Assign op_id */
+        if (op_id && op_id != NA_OP_ID_IGNORE)
+            *op_id = (na_op_id_t) na_mpi_op_id;
+
+        mpi_ret = MPI_Rput(
+            (char*) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, na_mpi_op_id->info.put.win_rank,
+            mpi_remote_mem_handle->disp + mpi_remote_offset, mpi_length,
+            MPI_BYTE, na_mpi_addr->win, &na_mpi_op_id->info.put.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Rput() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.put.data_request,
+            NULL, na_mpi_op_id, NULL);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not add request");
+            goto done;
+        }
+        goto done;
+    }
+#endif
 
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
@@ -1912,14 +2588,32 @@ na_mpi_put(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add requests to active requests */
+    ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.put.rma_request,
+        NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
+    ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.put.data_request,
+        NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
+        /* Requests may already be posted, make sure that MPI no longer
+         * references the op or the RMA info before freeing them */
+        if (na_mpi_op_id) {
+            /* Window requests cannot be canceled, only waited on */
+            na_mpi_request_abort(na_class,
+                &na_mpi_op_id->info.put.data_request,
+                na_mpi_op_id->info.put.rma_info != NULL);
+            na_mpi_request_abort(na_class,
+                &na_mpi_op_id->info.put.rma_request, NA_TRUE);
+        }
         free(na_mpi_op_id);
         free(na_mpi_rma_info);
     }
@@ -1975,11 +2669,42 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
     na_mpi_op_id->arg = arg;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
+    na_mpi_op_id->active_requests = 2;
     na_mpi_op_id->info.get.rma_request = MPI_REQUEST_NULL;
     na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
-    na_mpi_op_id->info.put.internal_progress = NA_FALSE;
+    na_mpi_op_id->info.get.internal_progress = NA_FALSE;
     na_mpi_op_id->info.get.rma_info = NULL;
 
+#ifdef NA_MPI_HAS_RMA
+    /* Read directly from remote window, no target involvement needed */
+    if (na_mpi_addr->win != MPI_WIN_NULL) {
+        na_mpi_op_id->active_requests = 1;
+
+        /* Assign op_id */
+        if (op_id && op_id != NA_OP_ID_IGNORE)
+            *op_id = (na_op_id_t) na_mpi_op_id;
+
+        mpi_ret = MPI_Rget(
+            (char*) mpi_local_mem_handle->base + mpi_local_offset, mpi_length,
+            MPI_BYTE, na_mpi_addr->rank + na_mpi_addr->win_rank_offset,
+            mpi_remote_mem_handle->disp + mpi_remote_offset, mpi_length,
+            MPI_BYTE, na_mpi_addr->win, &na_mpi_op_id->info.get.data_request);
+        if (mpi_ret != MPI_SUCCESS) {
+            NA_LOG_ERROR("MPI_Rget() failed");
+            ret = NA_PROTOCOL_ERROR;
+            goto done;
+        }
+
+        ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.get.data_request,
+            NULL, na_mpi_op_id, NULL);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not add request");
+            goto done;
+        }
+        goto done;
+    }
+#endif
+
     /* Allocate rma info (use calloc to avoid uninitialized transfer) */
     na_mpi_rma_info =
             (struct na_mpi_rma_info *) calloc(1, sizeof(struct na_mpi_rma_info));
@@ -2018,14 +2743,32 @@ na_mpi_get(na_class_t *na_class, na_context_t *context, na_cb_t callback,
         goto done;
     }
 
-    /* Append op_id to op_id list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add requests to active requests */
+    ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.get.rma_request,
+        NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
+    ret = na_mpi_request_add(na_class, &na_mpi_op_id->info.get.data_request,
+        NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
+        /* Requests may already be posted, make sure that MPI no longer
+         * references the op or the RMA info before freeing them */
+        if (na_mpi_op_id) {
+            /* Window requests cannot be canceled, only waited on */
+            na_mpi_request_abort(na_class,
+                &na_mpi_op_id->info.get.data_request,
+                na_mpi_op_id->info.get.rma_info != NULL);
+            na_mpi_request_abort(na_class,
+                &na_mpi_op_id->info.get.rma_request, NA_TRUE);
+        }
         free(na_mpi_op_id);
         free(na_mpi_rma_info);
     }
@@ -2046,22 +2789,11 @@ na_mpi_progress(na_class_t *na_class, na_context_t *context,
         if (timeout)
             hg_time_get_current(&t1);
 
-        /* Try to make unexpected progress */
-        ret = na_mpi_progress_unexpected(na_class, context, 0);
-        if (ret != NA_SUCCESS) {
-            if (ret != NA_TIMEOUT) {
-                NA_LOG_ERROR("Could not make unexpected progress");
-                goto done;
-            }
-        } else
-            break; /* Progressed */
-
-        /* Try to make expected progress */
-        ret = na_mpi_progress_expected(na_class, context,
-                (unsigned int) (remaining * 1000.0));
+        /* Test all active requests at once */
+        ret = na_mpi_progress_requests(na_class, context);
         if (ret != NA_SUCCESS) {
             if (ret != NA_TIMEOUT) {
-                NA_LOG_ERROR("Could not make expected progress");
+                NA_LOG_ERROR("Could not make progress on requests");
                 goto done;
             }
         } else
@@ -2079,110 +2811,82 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_mpi_progress_unexpected(na_class_t *na_class, na_context_t *context,
-        unsigned int NA_UNUSED timeout)
+na_mpi_progress_unexpected(na_class_t *na_class)
 {
-    struct na_mpi_addr *probe_addr = NULL;
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
     na_return_t ret = NA_TIMEOUT;
-    int mpi_ret;
-
-    /* Process list of communicators */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-
-    HG_LIST_FOREACH(probe_addr, &NA_MPI_PRIVATE_DATA(na_class)->remote_list, entry) {
-        MPI_Status status1, status2;
-        int flag = 0;
-
-        /* First look for user unexpected message */
-        mpi_ret = MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, probe_addr->comm,
-            &flag, &status1);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
 
-        if (flag) {
-            ret = na_mpi_progress_unexpected_msg(na_class, context,
-                probe_addr, &status1);
-            if (ret != NA_SUCCESS) {
-                if (ret != NA_TIMEOUT) {
-                    NA_LOG_ERROR("Could not make unexpected MSG progress");
-                    goto done;
-                }
-            } else
-                break; /* Progressed */
+    for (;;) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry = NULL;
+        struct na_mpi_op_id *na_mpi_op_id = NULL;
+        na_return_t progress_ret;
+
+        /* Pair first arrived message with first posted unexpected recv */
+        hg_thread_mutex_lock(&priv->unexpected_op_queue_mutex);
+        if (!HG_QUEUE_IS_EMPTY(&priv->unexpected_msg_queue)
+            && !HG_QUEUE_IS_EMPTY(&priv->unexpected_op_queue)) {
+            na_mpi_pool_entry = HG_QUEUE_FIRST(&priv->unexpected_msg_queue);
+            HG_QUEUE_POP_HEAD(&priv->unexpected_msg_queue, entry);
+            na_mpi_op_id = HG_QUEUE_FIRST(&priv->unexpected_op_queue);
+            HG_QUEUE_POP_HEAD(&priv->unexpected_op_queue, entry);
         }
+        hg_thread_mutex_unlock(&priv->unexpected_op_queue_mutex);
 
-        /* Look for internal unexpected RMA requests */
-        mpi_ret = MPI_Iprobe(probe_addr->rank, NA_MPI_RMA_REQUEST_TAG,
-            probe_addr->rma_comm, &flag, &status2);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Iprobe() failed");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
+        if (!na_mpi_pool_entry)
+            break;
 
-        if (flag) {
-            ret = na_mpi_progress_unexpected_rma(na_class, context,
-                probe_addr, &status2);
-            if (ret != NA_SUCCESS) {
-                NA_LOG_ERROR("Could not make unexpected RMA progress");
-                goto done;
-            } else
-                break; /* Progressed */
+        progress_ret = na_mpi_progress_unexpected_msg(na_class, na_mpi_op_id,
+            na_mpi_pool_entry);
+        if (progress_ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not make unexpected MSG progress");
+            ret = progress_ret;
+            break;
         }
+        ret = NA_SUCCESS; /* Progressed */
     }
 
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->remote_list_mutex);
-
-done:
     return ret;
 }
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_mpi_progress_unexpected_msg(na_class_t *na_class, na_context_t NA_UNUSED *context,
-        struct na_mpi_addr *na_mpi_addr, const MPI_Status *status)
+na_mpi_progress_unexpected_msg(na_class_t *na_class,
+        struct na_mpi_op_id *na_mpi_op_id,
+        struct na_mpi_pool_entry *na_mpi_pool_entry)
 {
-    struct na_mpi_op_id *na_mpi_op_id = NULL;
     int unexpected_buf_size = 0;
-    na_return_t ret = NA_TIMEOUT;
-    int mpi_ret;
+    na_return_t ret = NA_SUCCESS, post_ret;
 
-    MPI_Get_count(status, MPI_BYTE, &unexpected_buf_size);
-    if (unexpected_buf_size > (int)
-            na_mpi_msg_get_max_unexpected_size(na_class)) {
-        NA_LOG_ERROR("Exceeding unexpected MSG size");
+    MPI_Get_count(&na_mpi_pool_entry->status, MPI_BYTE, &unexpected_buf_size);
+    if (unexpected_buf_size > na_mpi_op_id->info.recv_unexpected.buf_size) {
+        NA_LOG_ERROR("Unexpected MSG too large for buffer, dropping it");
         ret = NA_SIZE_ERROR;
-        goto done;
+    } else {
+        memcpy(na_mpi_op_id->info.recv_unexpected.buf, na_mpi_pool_entry->buf,
+            (size_t) unexpected_buf_size);
+        na_mpi_op_id->info.recv_unexpected.remote_addr =
+            na_mpi_pool_entry->addr;
+        memcpy(&na_mpi_op_id->info.recv_unexpected.status,
+            &na_mpi_pool_entry->status, sizeof(MPI_Status));
     }
 
-    /* Try to pop an unexpected recv op id */
-    na_mpi_op_id = na_mpi_msg_unexpected_op_pop(na_class);
-    if (!na_mpi_op_id) {
-        /* Can't process it since nobody has posted an unexpected recv yet */
-        goto done;
-    }
+    /* Buffer is free again, re-post receive */
+    post_ret = na_mpi_pool_entry_post(na_class, na_mpi_pool_entry);
+    if (post_ret != NA_SUCCESS)
+        NA_LOG_ERROR("Could not re-post unexpected receive");
 
-    mpi_ret = MPI_Recv(na_mpi_op_id->info.recv_unexpected.buf,
-            na_mpi_op_id->info.recv_unexpected.buf_size, MPI_BYTE,
-            status->MPI_SOURCE, status->MPI_TAG, na_mpi_addr->comm,
-            MPI_STATUS_IGNORE);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
-        ret = NA_PROTOCOL_ERROR;
+    if (ret != NA_SUCCESS) {
+        /* Give op id back so that it can be matched with next message */
+        na_mpi_msg_unexpected_op_push(na_class, na_mpi_op_id);
         goto done;
     }
 
-    na_mpi_op_id->info.recv_unexpected.remote_addr = na_mpi_addr;
-    memcpy(&na_mpi_op_id->info.recv_unexpected.status, status,
-            sizeof(MPI_Status));
     ret = na_mpi_complete(na_mpi_op_id);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("Could not complete op id");
         goto done;
     }
+    ret = post_ret;
 
 done:
     return ret;
@@ -2191,15 +2895,18 @@ done:
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
-        struct na_mpi_addr *na_mpi_addr, const MPI_Status *status)
+        struct na_mpi_pool_entry *na_mpi_pool_entry)
 {
+    struct na_mpi_addr *na_mpi_addr = na_mpi_pool_entry->addr;
+    int source = na_mpi_pool_entry->status.MPI_SOURCE;
     struct na_mpi_rma_info *na_mpi_rma_info = NULL;
     struct na_mpi_op_id *na_mpi_op_id = NULL;
+    MPI_Request *request = NULL;
     int unexpected_buf_size = 0;
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
-    MPI_Get_count(status, MPI_BYTE, &unexpected_buf_size);
+    MPI_Get_count(&na_mpi_pool_entry->status, MPI_BYTE, &unexpected_buf_size);
     if (unexpected_buf_size != sizeof(struct na_mpi_rma_info)) {
         NA_LOG_ERROR("Unexpected message size does not match RMA info struct");
         ret = NA_SIZE_ERROR;
@@ -2215,15 +2922,9 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
         goto done;
     }
 
-    /* Recv message (already arrived) */
-    mpi_ret = MPI_Recv(na_mpi_rma_info, sizeof(struct na_mpi_rma_info),
-            MPI_BYTE, status->MPI_SOURCE, status->MPI_TAG,
-            na_mpi_addr->rma_comm, MPI_STATUS_IGNORE);
-    if (mpi_ret != MPI_SUCCESS) {
-        NA_LOG_ERROR("MPI_Recv() failed");
-        ret = NA_PROTOCOL_ERROR;
-        goto done;
-    }
+    /* Message was received in pool buffer */
+    memcpy(na_mpi_rma_info, na_mpi_pool_entry->buf,
+        sizeof(struct na_mpi_rma_info));
 
     /* Allocate na_op_id */
     na_mpi_op_id = (struct na_mpi_op_id *) malloc(sizeof(struct na_mpi_op_id));
@@ -2238,6 +2939,7 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
     na_mpi_op_id->arg = NULL;
     na_mpi_op_id->completed = NA_FALSE;
     na_mpi_op_id->canceled = NA_FALSE;
+    na_mpi_op_id->active_requests = 1;
 
     switch (na_mpi_rma_info->op) {
         /* Remote wants to do a put so wait in a recv */
@@ -2247,12 +2949,13 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             na_mpi_op_id->info.put.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.put.internal_progress = NA_TRUE;
             na_mpi_op_id->info.put.rma_info = na_mpi_rma_info;
+            request = &na_mpi_op_id->info.put.data_request;
 
             mpi_ret = MPI_Irecv(
                     (char*) na_mpi_rma_info->base + na_mpi_rma_info->disp,
-                    na_mpi_rma_info->count, MPI_BYTE, na_mpi_addr->rank,
+                    na_mpi_rma_info->count, MPI_BYTE, source,
                     (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                    &na_mpi_op_id->info.put.data_request);
+                    request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Irecv() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2267,12 +2970,13 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
             na_mpi_op_id->info.get.data_request = MPI_REQUEST_NULL;
             na_mpi_op_id->info.get.internal_progress = NA_TRUE;
             na_mpi_op_id->info.get.rma_info = na_mpi_rma_info;
+            request = &na_mpi_op_id->info.get.data_request;
 
             mpi_ret = MPI_Isend(
                     (char*) na_mpi_rma_info->base + na_mpi_rma_info->disp,
-                    na_mpi_rma_info->count, MPI_BYTE, na_mpi_addr->rank,
+                    na_mpi_rma_info->count, MPI_BYTE, source,
                     (int) na_mpi_rma_info->tag, na_mpi_addr->rma_comm,
-                    &na_mpi_op_id->info.get.data_request);
+                    request);
             if (mpi_ret != MPI_SUCCESS) {
                 NA_LOG_ERROR("MPI_Isend() failed");
                 ret = NA_PROTOCOL_ERROR;
@@ -2282,14 +2986,16 @@ na_mpi_progress_unexpected_rma(na_class_t *na_class, na_context_t *context,
 
         default:
             NA_LOG_ERROR("Operation not supported");
-            break;
+            ret = NA_INVALID_PARAM;
+            goto done;
     }
 
-    /* Add op_id to list */
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
-    HG_LIST_INSERT_HEAD(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list,
-        na_mpi_op_id, entry);
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    /* Add request to active requests */
+    ret = na_mpi_request_add(na_class, request, NULL, na_mpi_op_id, NULL);
+    if (ret != NA_SUCCESS) {
+        NA_LOG_ERROR("Could not add request");
+        goto done;
+    }
 
 done:
     if (ret != NA_SUCCESS) {
@@ -2301,131 +3007,153 @@ done:
 
 /*---------------------------------------------------------------------------*/
 static na_return_t
-na_mpi_progress_expected(na_class_t *na_class, na_context_t NA_UNUSED *context,
-        unsigned int NA_UNUSED timeout)
+na_mpi_progress_requests(na_class_t *na_class, na_context_t *context)
 {
-    struct na_mpi_op_id *na_mpi_op_id = NULL;
-    na_return_t ret = NA_TIMEOUT;
+    struct na_mpi_private_data *priv = NA_MPI_PRIVATE_DATA(na_class);
+    HG_QUEUE_HEAD(na_mpi_pool_entry) arrived_queue;
+    na_return_t ret = NA_TIMEOUT, progress_ret;
+    int outcount = 0, i, j, mpi_ret;
 
-    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
+    HG_QUEUE_INIT(&arrived_queue);
 
-    na_mpi_op_id = HG_LIST_FIRST(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list);
-    while (na_mpi_op_id) {
-        MPI_Request *request = NULL;
-        na_bool_t internal = NA_FALSE; /* Only used to complete internal ops */
-        struct na_mpi_rma_info **rma_info = NULL;
-        na_bool_t complete_op_id = NA_TRUE;
-        int flag = 0, mpi_ret = 0;
-        MPI_Status *status = MPI_STATUS_IGNORE;
+    hg_thread_mutex_lock(&priv->request_mutex);
 
-        /* If the op_id is marked as completed, something is wrong */
-        if (na_mpi_op_id->completed) {
-            NA_LOG_ERROR("Op ID should not have completed yet");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
+    if (!priv->request_count) {
+        hg_thread_mutex_unlock(&priv->request_mutex);
+        goto done;
+    }
 
-        switch (na_mpi_op_id->type) {
-            case NA_CB_LOOKUP:
-                NA_LOG_ERROR("Should not complete lookup here");
-                break;
-            case NA_CB_RECV_UNEXPECTED:
-                NA_LOG_ERROR("Should not complete unexpected recv here");
-                break;
-            case NA_CB_SEND_UNEXPECTED:
-                request = &na_mpi_op_id->info.send_unexpected.data_request;
-                break;
-            case NA_CB_RECV_EXPECTED:
-                status = &na_mpi_op_id->info.recv_expected.status;
-                request = &na_mpi_op_id->info.recv_expected.data_request;
-                break;
-            case NA_CB_SEND_EXPECTED:
-                request = &na_mpi_op_id->info.send_expected.data_request;
-                break;
-            case NA_CB_PUT:
-                if (na_mpi_op_id->info.put.internal_progress) {
-                    request = &na_mpi_op_id->info.put.data_request;
-                    rma_info = &na_mpi_op_id->info.put.rma_info;
-                    internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.put.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.put.data_request;
-                    }
-                }
-                break;
-            case NA_CB_GET:
-                if (na_mpi_op_id->info.get.internal_progress) {
-                    request = &na_mpi_op_id->info.get.data_request;
-                    rma_info = &na_mpi_op_id->info.get.rma_info;
-                    internal = NA_TRUE;
-                } else {
-                    request = &na_mpi_op_id->info.get.rma_request;
-                    if (*request != MPI_REQUEST_NULL) {
-                        complete_op_id = NA_FALSE;
-                    } else {
-                        request = &na_mpi_op_id->info.get.data_request;
-                    }
-                }
-                break;
-            default:
-                NA_LOG_ERROR("Unknown type of operation ID");
-                ret = NA_PROTOCOL_ERROR;
-                goto done;
-        }
+    mpi_ret = MPI_Testsome(priv->request_count, priv->requests, &outcount,
+        priv->request_indices, priv->request_statuses);
+    if (mpi_ret != MPI_SUCCESS) {
+        NA_LOG_ERROR("MPI_Testsome() failed");
+        hg_thread_mutex_unlock(&priv->request_mutex);
+        ret = NA_PROTOCOL_ERROR;
+        goto done;
+    }
+    if (outcount == MPI_UNDEFINED || outcount == 0) {
+        hg_thread_mutex_unlock(&priv->request_mutex);
+        goto done;
+    }
 
-        /* If request is MPI_REQUEST_NULL, the operation should be completed */
-        if (!request || (request && (*request == MPI_REQUEST_NULL))) {
-            NA_LOG_ERROR("NULL request found");
-            ret = NA_PROTOCOL_ERROR;
-            goto done;
+    for (i = 0; i < outcount; i++) {
+        struct na_mpi_request_entry *request_entry =
+            &priv->request_entries[priv->request_indices[i]];
+        struct na_mpi_op_id *na_mpi_op_id = request_entry->op_id;
+
+        *request_entry->request = MPI_REQUEST_NULL;
+        if (request_entry->status)
+            memcpy(request_entry->status, &priv->request_statuses[i],
+                sizeof(MPI_Status));
+
+        /* Received messages are processed once the lock is released */
+        if (request_entry->pool_entry) {
+            HG_QUEUE_PUSH_TAIL(&arrived_queue, request_entry->pool_entry,
+                entry);
+            continue;
         }
 
-        mpi_ret = MPI_Test(request, &flag, status);
-        if (mpi_ret != MPI_SUCCESS) {
-            NA_LOG_ERROR("MPI_Test() failed");
+        /* If the op_id is marked as completed, something is wrong */
+        if (na_mpi_op_id->completed) {
+            NA_LOG_ERROR("Op ID should not have completed yet");
             ret = NA_PROTOCOL_ERROR;
-            goto done;
-        }
-        if (!flag) {
-            na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
             continue;
         }
 
-        *request = MPI_REQUEST_NULL;
+        /* RMA ops complete once both RMA request and data are through */
+        if (--na_mpi_op_id->active_requests > 0)
+            continue;
+
+#ifdef NA_MPI_HAS_RMA
+        /* Completion of MPI_Rput() is local, make data visible at target */
+        if (na_mpi_op_id->type == NA_CB_PUT
+            && na_mpi_op_id->info.put.win != MPI_WIN_NULL) {
+            mpi_ret = MPI_Win_flush(na_mpi_op_id->info.put.win_rank,
+                na_mpi_op_id->info.put.win);
+            if (mpi_ret != MPI_SUCCESS) {
+                NA_LOG_ERROR("MPI_Win_flush() failed");
+                ret = NA_PROTOCOL_ERROR;
+            }
+        }
+#endif
 
         /* If internal operation call release directly otherwise add callback
          * to completion queue */
-        if (internal) {
+        if (na_mpi_op_id->type == NA_CB_PUT
+            && na_mpi_op_id->info.put.internal_progress) {
             na_mpi_op_id->completed = NA_TRUE;
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
-
-            free(*rma_info);
-            *rma_info = NULL;
+            free(na_mpi_op_id->info.put.rma_info);
+            na_mpi_op_id->info.put.rma_info = NULL;
+            na_mpi_release(na_mpi_op_id);
+        } else if (na_mpi_op_id->type == NA_CB_GET
+            && na_mpi_op_id->info.get.internal_progress) {
+            na_mpi_op_id->completed = NA_TRUE;
+            free(na_mpi_op_id->info.get.rma_info);
+            na_mpi_op_id->info.get.rma_info = NULL;
             na_mpi_release(na_mpi_op_id);
         } else {
-            if (!complete_op_id) {
-                na_mpi_op_id = HG_LIST_NEXT(na_mpi_op_id, entry);
+            progress_ret = na_mpi_complete(na_mpi_op_id);
+            if (progress_ret != NA_SUCCESS) {
+                NA_LOG_ERROR("Could not complete operation");
+                ret = progress_ret;
                 continue;
             }
-            /* Remove entry from list */
-            HG_LIST_REMOVE(na_mpi_op_id, entry);
+        }
+        if (ret == NA_TIMEOUT)
+            ret = NA_SUCCESS; /* progressed */
+    }
 
-            ret = na_mpi_complete(na_mpi_op_id);
-            if (ret != NA_SUCCESS) {
-                NA_LOG_ERROR("Could not complete operation");
-                goto done;
-            }
+    /* Remove completed requests and keep remaining ones contiguous */
+    for (i = 0, j = 0; i < priv->request_count; i++) {
+        if (priv->requests[i] == MPI_REQUEST_NULL)
+            continue;
+        if (i != j) {
+            priv->requests[j] = priv->requests[i];
+            priv->request_entries[j] = priv->request_entries[i];
         }
-        ret = NA_SUCCESS; /* progressed */
-        break;
+        j++;
     }
+    priv->request_count = j;
+
+    hg_thread_mutex_unlock(&priv->request_mutex);
+
+    /* Process received RMA requests and queue received messages */
+    while (!HG_QUEUE_IS_EMPTY(&arrived_queue)) {
+        struct na_mpi_pool_entry *na_mpi_pool_entry =
+            HG_QUEUE_FIRST(&arrived_queue);
+        HG_QUEUE_POP_HEAD(&arrived_queue, entry);
+
+        if (!na_mpi_pool_entry->rma) {
+            hg_thread_mutex_lock(&priv->unexpected_op_queue_mutex);
+            HG_QUEUE_PUSH_TAIL(&priv->unexpected_msg_queue, na_mpi_pool_entry,
+                entry);
+            hg_thread_mutex_unlock(&priv->unexpected_op_queue_mutex);
+            continue;
+        }
+
+        progress_ret = na_mpi_progress_unexpected_rma(na_class, context,
+            na_mpi_pool_entry);
+        if (progress_ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not make unexpected RMA progress");
+            ret = progress_ret;
+        }
+
+        progress_ret = na_mpi_pool_entry_post(na_class, na_mpi_pool_entry);
+        if (progress_ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not re-post RMA request receive");
+            ret = progress_ret;
+        }
+    }
+
+    /* Match received messages with posted unexpected receives */
+    progress_ret = na_mpi_progress_unexpected(na_class);
+    if (progress_ret == NA_SUCCESS) {
+        if (ret == NA_TIMEOUT)
+            ret = NA_SUCCESS; /* progressed */
+    } else if (progress_ret != NA_TIMEOUT)
+        ret = progress_ret;
 
 done:
-    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->op_id_list_mutex);
     return ret;
 }
 
@@ -2488,6 +3216,12 @@ na_mpi_complete(struct na_mpi_op_id *na_mpi_op_id)
             }
             na_mpi_addr->comm = na_mpi_remote_addr->comm;
             na_mpi_addr->rma_comm = na_mpi_remote_addr->rma_comm;
+            na_mpi_addr->unexpected_comm = na_mpi_remote_addr->unexpected_comm;
+            na_mpi_addr->pool = NULL;
+#ifdef NA_MPI_HAS_RMA
+            na_mpi_addr->win = na_mpi_remote_addr->win;
+            na_mpi_addr->win_rank_offset = na_mpi_remote_addr->win_rank_offset;
+#endif
             na_mpi_addr->rank = status->MPI_SOURCE;
             na_mpi_addr->unexpected = NA_TRUE;
             na_mpi_addr->self = NA_FALSE;
@@ -2576,7 +3310,9 @@ na_mpi_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
     na_return_t ret = NA_SUCCESS;
     int mpi_ret;
 
-    /* TODO make this atomic */
+    /* Prevent requests from completing while canceling them */
+    hg_thread_mutex_lock(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
+
     if (na_mpi_op_id->completed) goto done;
 
     switch (na_mpi_op_id->type) {
@@ -2645,5 +3381,6 @@ na_mpi_cancel(na_class_t *na_class, na_context_t NA_UNUSED *context,
     }
 
 done:
+    hg_thread_mutex_unlock(&NA_MPI_PRIVATE_DATA(na_class)->request_mutex);
     return ret;
 }
@@ -52,8 +52,6 @@
 #include "mercury_list.h"
 #include "mercury_thread_mutex.h"
 #include "mercury_thread_spin.h"
-#include "mercury_thread_rwlock.h"
-#include "mercury_hash_table.h"
 #include "mercury_time.h"
 #include "mercury_atomic.h"
 #include "mercury_mem.h"
@@ -115,8 +113,17 @@
 #define NA_OFI_EXPECTED_TAG_FLAG (0x100000000ULL)
 #define NA_OFI_UNEXPECTED_TAG_IGNORE (0xFFFFFFFFULL)
 
-/* number of CQ event provided for fi_cq_read() */
+/* Number of buckets in the source address map (must be a power of 2) */
+#define NA_OFI_ADDR_MAP_SIZE (1024)
+/* Number of entries in the per-context source address cache (power of 2) */
+#define NA_OFI_ADDR_CACHE_SIZE (16)
+
+/* Initial/min number of CQ events provided for fi_cq_read(), the number of
+ * events read at once adapts to the load up to NA_OFI_CQ_MAX_EVENT_NUM */
 #define NA_OFI_CQ_EVENT_NUM (16)
+#ifndef NA_OFI_CQ_MAX_EVENT_NUM
+# define NA_OFI_CQ_MAX_EVENT_NUM (64)
+#endif
 /* CQ depth (the socket provider's default value is 256 */
 #define NA_OFI_CQ_DEPTH (8192)
 
@@ -186,16 +193,27 @@ struct na_ofi_domain {
     /* mutex to protect per domain resource like av */
     hg_thread_mutex_t nod_mutex;
     /*
-     * Address hash-table, to map the source-side address to fi_addr_t.
+     * Address map, to map the source-side address to fi_addr_t.
      * The key is 64bits value serialized from source-side IP+Port (see
-     * na_ofi_reqhdr_2_key), the value is fi_addr_t.
+     * na_ofi_reqhdr_2_key), the value is fi_addr_t. Each bucket is the head
+     * of a list of na_ofi_addr_map_entry that is only ever prepended to
+     * (using CAS) so that lookups do not require any lock.
      */
-    hg_hash_table_t *nod_addr_ht;
-    hg_thread_rwlock_t nod_rwlock;          /* RW lock to protect nod_addr_ht */
+    hg_atomic_int64_t nod_addr_map[NA_OFI_ADDR_MAP_SIZE];
     hg_atomic_int32_t nod_refcount;         /* Refcount of this domain */
     HG_LIST_ENTRY(na_ofi_domain) nod_entry; /* Entry in nog_domain_list */
 };
 
+/**
+ * Entry of the domain address map. Entries are immutable once published and
+ * are only released when the domain is closed.
+ */
+struct na_ofi_addr_map_entry {
+    na_uint64_t nae_key;                    /* Source address key */
+    fi_addr_t nae_fi_addr;                  /* Resolved FI address */
+    struct na_ofi_addr_map_entry *nae_next; /* Next entry in bucket */
+};
+
 struct na_ofi_endpoint {
     char *noe_node;             /* Fabric address */
     char *noe_service;          /* Service name */
@@ -255,6 +273,7 @@ struct na_ofi_private_data {
     HG_QUEUE_HEAD(na_ofi_mem_pool) nop_buf_pool;    /* Msg buf pool head */
     hg_thread_spin_t nop_buf_pool_lock;             /* Buf pool lock */
     na_bool_t no_wait; /* Ignore wait object */
+    na_bool_t nop_stats; /* Print stats at context destroy */
 };
 
 struct na_ofi_context {
@@ -266,6 +285,22 @@ struct na_ofi_context {
     /* Unexpected op queue per context for scalable endpoint, for regular
      * endpoint just a reference to per class op queue. */
     struct na_ofi_queue *noc_unexpected_op_queue;
+    /* Lookaside cache of recently resolved source addresses, each slot
+     * points to a na_ofi_addr_map_entry of the domain address map. */
+    hg_atomic_int64_t noc_addr_cache[NA_OFI_ADDR_CACHE_SIZE];
+    /* Number of CQ events currently read at once (only updated by the
+     * thread progressing the context) */
+    unsigned int noc_cq_event_num;
+#ifdef NA_HAS_COLLECT_STATS
+    na_uint64_t noc_cq_read_count;      /* Number of successful CQ reads */
+    na_uint64_t noc_cq_event_count;     /* Number of CQ events read */
+#endif
+};
+
+/* Completions generated while processing one batch of CQ events */
+struct na_ofi_completion_batch {
+    struct na_cb_completion_data *nob_entries[NA_OFI_CQ_MAX_EVENT_NUM];
+    unsigned int nob_count;
 };
 
 struct na_ofi_queue {
@@ -391,23 +426,30 @@ na_ofi_reqhdr_2_key(struct na_ofi_reqhdr *hdr)
     return (((na_uint64_t)hdr->fih_ip) << 32 | hdr->fih_port);
 }
 
-static NA_INLINE int
-av_addr_ht_key_equal(hg_hash_table_key_t vlocation1,
-                     hg_hash_table_key_t vlocation2)
+/**
+ * Mix the 64 bits key (IP address in the upper bits, port in the lower ones)
+ * so that both contribute to the bucket index.
+ */
+static NA_INLINE unsigned int
+na_ofi_addr_map_hash(na_uint64_t key)
 {
-    return *((na_uint64_t *) vlocation1) == *((na_uint64_t *) vlocation2);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+
+    return (unsigned int) key;
 }
 
-static NA_INLINE unsigned int
-av_addr_ht_key_hash(hg_hash_table_key_t vlocation)
+/**
+ * Walk a bucket list and return the entry matching key if any.
+ */
+static NA_INLINE struct na_ofi_addr_map_entry *
+na_ofi_addr_map_find(struct na_ofi_addr_map_entry *entry, na_uint64_t key)
 {
-    na_uint64_t key = *((na_uint64_t *) vlocation);
-    na_uint32_t hi, lo;
-
-    hi = (na_uint32_t) (key >> 32);
-    lo = (key & 0xFFFFFFFFU);
+    while (entry && entry->nae_key != key)
+        entry = entry->nae_next;
 
-    return ((hi & 0xFFFF0000U) | (lo & 0xFFFFU));
+    return entry;
 }
 
 static na_return_t
@@ -510,93 +552,136 @@ psm2_straddr_2_key(const char *addr_str)
 }
 
 /**
- * lookup the address hash-table, node should not contain the leading provider
- * name e.g. "psm2://" or "sockets://"
+ * Lock-free lookup of the address map, first look into the context cache
+ * (if a context is passed) and then into the domain map. Return NA_TRUE if
+ * the key was found.
  */
-static na_return_t
-na_ofi_addr_ht_lookup(na_class_t *na_class, const char *node,
-                      const char *service, na_uint64_t addr_key,
-                      fi_addr_t *src_addr)
+static NA_INLINE na_bool_t
+na_ofi_addr_map_lookup(struct na_ofi_domain *domain, struct na_ofi_context *ctx,
+    na_uint64_t addr_key, fi_addr_t *src_addr)
 {
-    struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
-    na_uint64_t *new_key = NULL;
-    fi_addr_t *fi_addr, tmp_addr, *new_value = NULL;
-    na_return_t ret = NA_SUCCESS;
-
-    hg_thread_rwlock_rdlock(&domain->nod_rwlock);
-    fi_addr = hg_hash_table_lookup(domain->nod_addr_ht, &addr_key);
-    if (fi_addr != HG_HASH_TABLE_NULL) {
-        *src_addr = *fi_addr;
-        hg_thread_rwlock_release_rdlock(&domain->nod_rwlock);
-        return ret;
+    unsigned int hash = na_ofi_addr_map_hash(addr_key);
+    hg_atomic_int64_t *cache_slot = NULL;
+    struct na_ofi_addr_map_entry *entry;
+
+    if (ctx) {
+        cache_slot = &ctx->noc_addr_cache[hash & (NA_OFI_ADDR_CACHE_SIZE - 1)];
+        entry = (struct na_ofi_addr_map_entry *) hg_atomic_get64(cache_slot);
+        if (entry && entry->nae_key == addr_key) {
+            *src_addr = entry->nae_fi_addr;
+            return NA_TRUE;
+        }
     }
-    hg_thread_rwlock_release_rdlock(&domain->nod_rwlock);
 
-    hg_thread_rwlock_wrlock(&domain->nod_rwlock);
+    entry = na_ofi_addr_map_find((struct na_ofi_addr_map_entry *)
+        hg_atomic_get64(
+            &domain->nod_addr_map[hash & (NA_OFI_ADDR_MAP_SIZE - 1)]),
+        addr_key);
+    if (!entry)
+        return NA_FALSE;
 
-    fi_addr = hg_hash_table_lookup(domain->nod_addr_ht, &addr_key);
-    if (fi_addr != HG_HASH_TABLE_NULL) {
-        *src_addr = *fi_addr;
-        hg_thread_rwlock_release_wrlock(&domain->nod_rwlock);
-        return ret;
-    }
+    if (cache_slot)
+        hg_atomic_set64(cache_slot, (hg_util_int64_t) entry);
+    *src_addr = entry->nae_fi_addr;
+
+    return NA_TRUE;
+}
+
+/**
+ * Resolve the address through fi AV and publish it in the address map, node
+ * should not contain the leading provider name e.g. "psm2://" or "sockets://".
+ * No lock is held while inserting into the AV, if another thread published
+ * the same key concurrently, its address is used and ours is removed unless
+ * the provider returned the same fi_addr for both insertions (FI_AV_MAP).
+ */
+static na_return_t
+na_ofi_addr_map_insert(na_class_t *na_class, struct na_ofi_context *ctx,
+    const char *node, const char *service, na_uint64_t addr_key,
+    fi_addr_t *src_addr)
+{
+    struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
+    unsigned int hash = na_ofi_addr_map_hash(addr_key);
+    hg_atomic_int64_t *bucket =
+        &domain->nod_addr_map[hash & (NA_OFI_ADDR_MAP_SIZE - 1)];
+    struct na_ofi_addr_map_entry *new_entry = NULL, *head, *entry;
+    fi_addr_t tmp_addr;
+    na_return_t ret = NA_SUCCESS;
 
     ret = na_ofi_av_insert(na_class, node, service, &tmp_addr);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("na_ofi_av_insert(%s:%s) failed, ret: %d.",
                      node, service, ret);
-        goto unlock;
+        goto out;
     }
-    *src_addr = tmp_addr;
 
-    fi_addr = hg_hash_table_lookup(domain->nod_addr_ht, &addr_key);
-    if (fi_addr != HG_HASH_TABLE_NULL) {
-        /* in race condition, use addr in HT and remove the new addr from AV */
-        *src_addr = *fi_addr;
-        hg_thread_rwlock_release_wrlock(&domain->nod_rwlock);
-        fi_av_remove(domain->nod_av, &tmp_addr, 1 /* count */, 0 /* flag */);
-        return ret;
-    }
-    new_key = (na_uint64_t *)malloc(sizeof(*new_key));
-    new_value = (fi_addr_t *)malloc(sizeof(*new_value));
-    if (new_key == NULL || new_value == NULL) {
-        NA_LOG_ERROR("cannot allocate memory for new_key/new_value.");
-        free(new_key);
-        free(new_value);
-        ret = NA_NOMEM_ERROR;
-        goto unlock;
-    }
-    *new_key = addr_key;
-    *new_value = tmp_addr;
-    if (hg_hash_table_insert(domain->nod_addr_ht, new_key, new_value) == 0) {
-        NA_LOG_ERROR("hg_hash_table_insert(%s:%s) failed.", node, service);
+    new_entry = (struct na_ofi_addr_map_entry *) malloc(
+        sizeof(struct na_ofi_addr_map_entry));
+    if (new_entry == NULL) {
+        NA_LOG_ERROR("cannot allocate memory for new address map entry.");
+        entry = na_ofi_addr_map_find(
+            (struct na_ofi_addr_map_entry *) hg_atomic_get64(bucket),
+            addr_key);
+        if (!entry || entry->nae_fi_addr != tmp_addr) {
+            na_ofi_domain_lock(domain);
+            fi_av_remove(domain->nod_av, &tmp_addr, 1 /* count */,
+                0 /* flag */);
+            na_ofi_domain_unlock(domain);
+        }
         ret = NA_NOMEM_ERROR;
-    } else {
-        /*
-        NA_LOG_DEBUG("hg_hash_table_insert(%s:%s) succeed, fi_addr: %d.",
-                     node, service, tmp_addr);
-        */
+        goto out;
     }
-unlock:
-    hg_thread_rwlock_release_wrlock(&domain->nod_rwlock);
+    new_entry->nae_key = addr_key;
+    new_entry->nae_fi_addr = tmp_addr;
+
+    do {
+        head = (struct na_ofi_addr_map_entry *) hg_atomic_get64(bucket);
+        entry = na_ofi_addr_map_find(head, addr_key);
+        if (entry) {
+            /* in race condition, use addr in map and remove the new addr
+             * from AV, unless it is the one still used by the map entry */
+            free(new_entry);
+            if (tmp_addr != entry->nae_fi_addr) {
+                na_ofi_domain_lock(domain);
+                fi_av_remove(domain->nod_av, &tmp_addr, 1 /* count */,
+                    0 /* flag */);
+                na_ofi_domain_unlock(domain);
+            }
+            new_entry = entry;
+            break;
+        }
+        new_entry->nae_next = head;
+    } while (!hg_atomic_cas64(bucket, (hg_util_int64_t) head,
+        (hg_util_int64_t) new_entry));
+
+    if (ctx)
+        hg_atomic_set64(
+            &ctx->noc_addr_cache[hash & (NA_OFI_ADDR_CACHE_SIZE - 1)],
+            (hg_util_int64_t) new_entry);
+    *src_addr = new_entry->nae_fi_addr;
+
+out:
     return ret;
 }
 
 /* lookup for psm2 */
 static NA_INLINE na_return_t
-na_ofi_addr_ht_lookup_psm2(na_class_t *na_class, const char *name,
-                           fi_addr_t *src_addr)
+na_ofi_addr_ht_lookup_psm2(na_class_t *na_class, struct na_ofi_context *ctx,
+                           const char *name, fi_addr_t *src_addr)
 {
+    struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
     na_uint64_t addr_key;
     fi_addr_t new_src_addr;
-    na_return_t ret;
+    na_return_t ret = NA_SUCCESS;
 
     addr_key = psm2_straddr_2_key(name);
+    if (na_ofi_addr_map_lookup(domain, ctx, addr_key, src_addr))
+        goto out;
 
     /* for psm2 name is in the "psm2://fi_addr_psmx2://40302:0" style */
-    ret = na_ofi_addr_ht_lookup(na_class, name + 7, NULL, addr_key, &new_src_addr);
+    ret = na_ofi_addr_map_insert(na_class, ctx, name + 7, NULL, addr_key,
+        &new_src_addr);
     if (ret != NA_SUCCESS) {
-        NA_LOG_ERROR("na_ofi_addr_ht_lookup_reqhdr failed, ret: %d.", ret);
+        NA_LOG_ERROR("na_ofi_addr_map_insert failed, ret: %d.", ret);
         goto out;
     }
     *src_addr = new_src_addr;
@@ -607,18 +692,28 @@ out:
 
 /* lookup for non psm2 */
 static NA_INLINE na_return_t
-na_ofi_addr_ht_lookup_reqhdr(na_class_t *na_class, struct na_ofi_reqhdr *reqhdr,
-                      fi_addr_t *src_addr)
+na_ofi_addr_ht_lookup_reqhdr(na_class_t *na_class, struct na_ofi_context *ctx,
+                      struct na_ofi_reqhdr *reqhdr, fi_addr_t *src_addr)
 {
+    struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
     fi_addr_t new_src_addr;
     struct in_addr in;
     na_uint64_t addr_key;
-    char *node, service[16] = {'\0'};
+    char node[INET_ADDRSTRLEN] = {'\0'}, service[16] = {'\0'};
     int port_len = 0;
-    na_return_t ret;
+    na_return_t ret = NA_SUCCESS;
+
+    addr_key = na_ofi_reqhdr_2_key(reqhdr);
+    if (na_ofi_addr_map_lookup(domain, ctx, addr_key, src_addr))
+        goto out;
 
+    /* Only convert to strings when the address must be inserted */
     in.s_addr = reqhdr->fih_ip;
-    node = inet_ntoa(in);
+    if (!inet_ntop(AF_INET, &in, node, INET_ADDRSTRLEN)) {
+        NA_LOG_ERROR("inet_ntop() failed");
+        ret = NA_PROTOCOL_ERROR;
+        goto out;
+    }
     port_len = snprintf(service, 16, "%d", reqhdr->fih_port);
     if (port_len > 16) {
         NA_LOG_ERROR("Exceeding max port name");
@@ -626,11 +721,10 @@ na_ofi_addr_ht_lookup_reqhdr(na_class_t *na_class, struct na_ofi_reqhdr *reqhdr,
         goto out;
     }
 
-    addr_key = na_ofi_reqhdr_2_key(reqhdr);
-
-    ret = na_ofi_addr_ht_lookup(na_class, node, service, addr_key, &new_src_addr);
+    ret = na_ofi_addr_map_insert(na_class, ctx, node, service, addr_key,
+        &new_src_addr);
     if (ret != NA_SUCCESS) {
-        NA_LOG_ERROR("na_ofi_addr_ht_lookup_reqhdr failed, ret: %d.", ret);
+        NA_LOG_ERROR("na_ofi_addr_map_insert failed, ret: %d.", ret);
         goto out;
     }
     *src_addr = new_src_addr;
@@ -879,6 +973,7 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
 
 static na_return_t
 na_ofi_complete(struct na_ofi_addr *na_ofi_addr, struct na_ofi_op_id *na_ofi_op_id,
+    struct na_ofi_completion_batch *batch,
     na_return_t ret);
 
 static void
@@ -1292,14 +1387,6 @@ na_ofi_domain_open(struct na_ofi_private_data *priv, const char *prov_name,
         goto out;
     }
 
-    /* Init rw lock */
-    rc = hg_thread_rwlock_init(&na_ofi_domain->nod_rwlock);
-    if (rc != HG_UTIL_SUCCESS) {
-        NA_LOG_ERROR("hg_thread_rwlock_init failed");
-        ret = NA_NOMEM_ERROR;
-        goto out;
-    }
-
     /* Keep fi_info */
     na_ofi_domain->nod_prov = fi_dupinfo(prov);
     if (!na_ofi_domain->nod_prov) {
@@ -1453,17 +1540,6 @@ na_ofi_domain_open(struct na_ofi_private_data *priv, const char *prov_name,
         goto out;
     }
 
-    /* Create addr hash-table */
-    na_ofi_domain->nod_addr_ht = hg_hash_table_new(av_addr_ht_key_hash,
-        av_addr_ht_key_equal);
-    if (na_ofi_domain->nod_addr_ht == NULL) {
-        NA_LOG_ERROR("hg_hash_table_new failed");
-        ret = NA_NOMEM_ERROR;
-        goto out;
-    }
-    hg_hash_table_register_free_functions(na_ofi_domain->nod_addr_ht,
-        free, free);
-
     /* Insert to global domain list */
     hg_thread_mutex_lock(&na_ofi_domain_list_mutex_g);
     HG_LIST_INSERT_HEAD(&na_ofi_domain_list_g, na_ofi_domain, nod_entry);
@@ -1484,6 +1560,7 @@ static na_return_t
 na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain)
 {
     na_return_t ret = NA_SUCCESS;
+    unsigned int i;
     int rc;
 
     if (!na_ofi_domain) goto out;
@@ -1495,8 +1572,8 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain)
         hg_thread_mutex_unlock(&na_ofi_domain_list_mutex_g);
         goto out;
     }
-    /* inserted to na_ofi_domain_list_g after nod_addr_ht created */
-    if (na_ofi_domain->nod_addr_ht != NULL)
+    /* inserted to na_ofi_domain_list_g only once fully opened */
+    if (na_ofi_domain->nod_entry.prev != NULL)
         HG_LIST_REMOVE(na_ofi_domain, nod_entry);
     hg_thread_mutex_unlock(&na_ofi_domain_list_mutex_g);
 
@@ -1559,11 +1636,20 @@ na_ofi_domain_close(struct na_ofi_domain *na_ofi_domain)
         na_ofi_domain->nod_prov = NULL;
     }
 
-    if (na_ofi_domain->nod_addr_ht)
-        hg_hash_table_free(na_ofi_domain->nod_addr_ht);
+    /* Free address map entries */
+    for (i = 0; i < NA_OFI_ADDR_MAP_SIZE; i++) {
+        struct na_ofi_addr_map_entry *entry = (struct na_ofi_addr_map_entry *)
+            hg_atomic_get64(&na_ofi_domain->nod_addr_map[i]);
+
+        while (entry) {
+            struct na_ofi_addr_map_entry *next = entry->nae_next;
+
+            free(entry);
+            entry = next;
+        }
+    }
 
     hg_thread_mutex_destroy(&na_ofi_domain->nod_mutex);
-    hg_thread_rwlock_destroy(&na_ofi_domain->nod_rwlock);
 
     free(na_ofi_domain->nod_prov_name);
     free(na_ofi_domain);
@@ -2299,6 +2385,8 @@ na_ofi_initialize(na_class_t *na_class, const struct na_info *na_info,
     NA_OFI_PRIVATE_DATA(na_class)->nop_listen = listen;
     NA_OFI_PRIVATE_DATA(na_class)->nop_max_contexts = max_contexts;
     NA_OFI_PRIVATE_DATA(na_class)->nop_contexts = 0;
+    NA_OFI_PRIVATE_DATA(na_class)->nop_stats =
+        na_info->na_init_info && na_info->na_init_info->stats;
 
     /* Initialize queue / mutex */
     hg_thread_mutex_init(&NA_OFI_PRIVATE_DATA(na_class)->nop_mutex);
@@ -2428,6 +2516,7 @@ na_ofi_context_create(na_class_t *na_class, void **context, na_uint8_t id)
         goto out;
     }
     ctx->noc_idx = id;
+    ctx->noc_cq_event_num = MIN(NA_OFI_CQ_EVENT_NUM, NA_OFI_CQ_MAX_EVENT_NUM);
 
     /* If not using SEP, just point to endpoint objects */
     hg_thread_mutex_lock(&priv->nop_mutex);
@@ -2584,6 +2673,16 @@ na_ofi_context_destroy(na_class_t *na_class, void *context)
     na_return_t ret = NA_SUCCESS;
     int rc;
 
+#ifdef NA_HAS_COLLECT_STATS
+    if (priv->nop_stats && ctx->noc_cq_read_count > 0)
+        printf("NA OFI context %u: %llu CQ events in %llu reads "
+            "(%.2f events per read)\n", (unsigned int) ctx->noc_idx,
+            (unsigned long long) ctx->noc_cq_event_count,
+            (unsigned long long) ctx->noc_cq_read_count,
+            (double) ctx->noc_cq_event_count
+            / (double) ctx->noc_cq_read_count);
+#endif
+
     /* Check that unexpected op queue is empty */
     if (na_ofi_with_sep(na_class) &&
         !HG_QUEUE_IS_EMPTY(&ctx->noc_unexpected_op_queue->noq_queue)) {
@@ -2893,11 +2992,12 @@ na_ofi_addr_lookup(na_class_t *na_class, na_context_t *context,
             NA_LOG_ERROR("na_ofi_gen_req_hdr(%s) failed, ret: %d.", name, ret);
             goto out;
         }
-        ret = na_ofi_addr_ht_lookup_reqhdr(na_class, &tmp_reqhdr,
-                &na_ofi_addr->noa_addr);
+        ret = na_ofi_addr_ht_lookup_reqhdr(na_class, NA_OFI_CONTEXT(context),
+                &tmp_reqhdr, &na_ofi_addr->noa_addr);
     } else if (NA_OFI_PRIVATE_DATA(na_class)->nop_domain->nod_prov_type
         == NA_OFI_PROV_PSM2) {
-        ret = na_ofi_addr_ht_lookup_psm2(na_class, name, &na_ofi_addr->noa_addr);
+        ret = na_ofi_addr_ht_lookup_psm2(na_class, NA_OFI_CONTEXT(context),
+            name, &na_ofi_addr->noa_addr);
     } else {
         NA_LOG_ERROR("Unsupported address format: %s", name);
         ret = NA_PROTOCOL_ERROR;
@@ -2909,7 +3009,7 @@ na_ofi_addr_lookup(na_class_t *na_class, na_context_t *context,
     }
 
     /* As the fi_av_insert is blocking, always complete here */
-    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_SUCCESS);
+    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NULL, NA_SUCCESS);
     if (ret != NA_SUCCESS) {
         NA_LOG_ERROR("Could not complete operation");
         goto out;
@@ -3873,7 +3973,8 @@ out:
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
-    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event)
+    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_op_id *na_ofi_op_id;
     struct na_ofi_addr *na_ofi_addr;
@@ -3901,7 +4002,7 @@ na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
 
     na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
 
-    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, batch, ret);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
@@ -3911,7 +4012,8 @@ na_ofi_handle_send_event(na_class_t NA_UNUSED *class,
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
-    fi_addr_t src_addr, struct fi_cq_tagged_entry *cq_event)
+    fi_addr_t src_addr, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_domain *domain = NA_OFI_PRIVATE_DATA(na_class)->nop_domain;
     struct na_ofi_addr *peer_addr = NULL;
@@ -3979,7 +4081,8 @@ na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
                 ret = NA_PROTOCOL_ERROR;
                 goto out;
             }
-            ret = na_ofi_addr_ht_lookup_reqhdr(na_class, reqhdr, &src_addr);
+            ret = na_ofi_addr_ht_lookup_reqhdr(na_class,
+                NA_OFI_CONTEXT(context), reqhdr, &src_addr);
             if (ret != NA_SUCCESS) {
                 NA_LOG_ERROR("na_ofi_addr_ht_lookup_reqhdr failed, ret: %d.", ret);
                 goto out;
@@ -4005,7 +4108,7 @@ na_ofi_handle_recv_event(na_class_t *na_class, na_context_t *context,
     }
 
 out:
-    ret = na_ofi_complete(peer_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete(peer_addr, na_ofi_op_id, batch, ret);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
@@ -4015,7 +4118,8 @@ out:
 /*---------------------------------------------------------------------------*/
 static void
 na_ofi_handle_rma_event(na_class_t NA_UNUSED *class,
-    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event)
+    na_context_t NA_UNUSED *context, struct fi_cq_tagged_entry *cq_event,
+    struct na_ofi_completion_batch *batch)
 {
     struct na_ofi_op_id *na_ofi_op_id;
     struct na_ofi_addr *na_ofi_addr;
@@ -4043,7 +4147,7 @@ na_ofi_handle_rma_event(na_class_t NA_UNUSED *class,
 
     na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
 
-    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, ret);
+    ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, batch, ret);
     if (ret != NA_SUCCESS)
         NA_LOG_ERROR("Unable to complete send");
 
@@ -4101,8 +4205,10 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
     na_return_t ret = NA_TIMEOUT;
 
     do {
-        struct fi_cq_tagged_entry cq_event[NA_OFI_CQ_EVENT_NUM];
-        fi_addr_t src_addr[NA_OFI_CQ_EVENT_NUM] = {FI_ADDR_UNSPEC};
+        struct fi_cq_tagged_entry cq_event[NA_OFI_CQ_MAX_EVENT_NUM];
+        fi_addr_t src_addr[NA_OFI_CQ_MAX_EVENT_NUM] = {FI_ADDR_UNSPEC};
+        struct na_ofi_completion_batch batch;
+        size_t cq_event_num = ctx->noc_cq_event_num;
         ssize_t rc, i, event_num = 0;
         hg_time_t t1, t2;
 
@@ -4126,10 +4232,9 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
 
         na_ofi_class_lock(na_class);
         if (na_ofi_with_reqhdr(na_class) == NA_FALSE) {
-            rc = fi_cq_readfrom(cq_hdl, cq_event, NA_OFI_CQ_EVENT_NUM,
-                                src_addr);
+            rc = fi_cq_readfrom(cq_hdl, cq_event, cq_event_num, src_addr);
         } else
-            rc = fi_cq_read(cq_hdl, cq_event, NA_OFI_CQ_EVENT_NUM);
+            rc = fi_cq_read(cq_hdl, cq_event, cq_event_num);
         na_ofi_class_unlock(na_class);
         if (rc == -FI_EAGAIN) {
             if (timeout) {
@@ -4213,11 +4318,26 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
         } else {
             assert(rc > 0);
             event_num = rc;
+
+            /* Grow the number of events read at once while the CQ keeps
+             * returning full batches, shrink it back when it runs dry */
+            if ((size_t) rc == cq_event_num
+                && cq_event_num < NA_OFI_CQ_MAX_EVENT_NUM)
+                ctx->noc_cq_event_num = (unsigned int) MIN(cq_event_num * 2,
+                    NA_OFI_CQ_MAX_EVENT_NUM);
+            else if ((size_t) rc <= cq_event_num / 4
+                && cq_event_num > NA_OFI_CQ_EVENT_NUM)
+                ctx->noc_cq_event_num = (unsigned int) (cq_event_num / 2);
+#ifdef NA_HAS_COLLECT_STATS
+            ctx->noc_cq_read_count++;
+            ctx->noc_cq_event_count += (na_uint64_t) rc;
+#endif
         }
 
         /* got at least one completion event */
         assert(event_num >= 1);
         ret = NA_SUCCESS;
+        batch.nob_count = 0;
         for (i = 0; i < event_num; i++) {
             /*
             NA_LOG_ERROR("got cq event[%d/%d] flags: 0x%x, src_addr %d.",
@@ -4227,17 +4347,19 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
             case FI_SEND | FI_TAGGED:
             case FI_SEND | FI_MSG:
             case FI_SEND | FI_TAGGED | FI_MSG:
-                na_ofi_handle_send_event(na_class, context, &cq_event[i]);
+                na_ofi_handle_send_event(na_class, context, &cq_event[i],
+                    &batch);
                 break;
             case FI_RECV | FI_TAGGED:
             case FI_RECV | FI_MSG:
             case FI_RECV | FI_TAGGED | FI_MSG:
                 na_ofi_handle_recv_event(na_class, context, src_addr[i],
-                                         &cq_event[i]);
+                                         &cq_event[i], &batch);
                 break;
             case FI_READ | FI_RMA:
             case FI_WRITE | FI_RMA:
-                na_ofi_handle_rma_event(na_class, context, &cq_event[i]);
+                na_ofi_handle_rma_event(na_class, context, &cq_event[i],
+                    &batch);
                 break;
             default:
                 NA_LOG_DEBUG("bad cq event[%d/%d] flags: 0x%x, src_addr %d.",
@@ -4246,6 +4368,14 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
             };
         }
 
+        /* Enqueue all completions of this batch at once */
+        if (batch.nob_count > 0 && na_cb_completion_add_batch(context,
+            batch.nob_entries, batch.nob_count) != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not add callbacks to completion queue");
+            ret = NA_PROTOCOL_ERROR;
+            break;
+        }
+
     } while (remaining > 0 && ret != NA_SUCCESS);
 
     return ret;
@@ -4254,7 +4384,8 @@ na_ofi_progress(na_class_t *na_class, na_context_t *context,
 /*---------------------------------------------------------------------------*/
 static na_return_t
 na_ofi_complete(struct na_ofi_addr *na_ofi_addr,
-    struct na_ofi_op_id *na_ofi_op_id, na_return_t op_ret)
+    struct na_ofi_op_id *na_ofi_op_id, struct na_ofi_completion_batch *batch,
+    na_return_t op_ret)
 {
     struct na_cb_info *callback_info = NULL;
     na_return_t ret = NA_SUCCESS;
@@ -4311,6 +4442,14 @@ na_ofi_complete(struct na_ofi_addr *na_ofi_addr,
     na_ofi_op_id->noo_completion_data.plugin_callback = na_ofi_release;
     na_ofi_op_id->noo_completion_data.plugin_callback_args = na_ofi_op_id;
 
+    if (batch) {
+        /* Enqueued by na_ofi_progress() once the CQ events are processed */
+        assert(batch->nob_count < NA_OFI_CQ_MAX_EVENT_NUM);
+        batch->nob_entries[batch->nob_count++] =
+            &na_ofi_op_id->noo_completion_data;
+        goto out;
+    }
+
     ret = na_cb_completion_add(na_ofi_op_id->noo_context,
        &na_ofi_op_id->noo_completion_data);
     if (ret != NA_SUCCESS) {
@@ -4394,7 +4533,7 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context,
             }
         } while (tmp != na_ofi_op_id);
 
-        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_CANCELED);
+        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NULL, NA_CANCELED);
         break;
     case NA_CB_RECV_EXPECTED:
         ep_hdl = ctx->noc_rx;
@@ -4406,7 +4545,7 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context,
                          rc, fi_strerror((int) -rc));
 
         na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
-        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_CANCELED);
+        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NULL, NA_CANCELED);
         break;
     case NA_CB_SEND_UNEXPECTED:
     case NA_CB_SEND_EXPECTED:
@@ -4421,7 +4560,7 @@ na_ofi_cancel(na_class_t *na_class, na_context_t *context,
                          na_ofi_op_id->noo_type, rc, fi_strerror((int) -rc));
 
         na_ofi_addr = (struct na_ofi_addr *)na_ofi_op_id->noo_addr;
-        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NA_CANCELED);
+        ret = na_ofi_complete(na_ofi_addr, na_ofi_op_id, NULL, NA_CANCELED);
         break;
     default:
         break;
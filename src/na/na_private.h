@@ -389,6 +389,23 @@ na_cb_completion_add(
         struct na_cb_completion_data *na_cb_completion_data
         );
 
+/**
+ * Add multiple callbacks to context completion queue at once. Waiting
+ * triggers are only signaled once for the whole batch.
+ *
+ * \param context [IN/OUT]              pointer to context of execution
+ * \param na_cb_completion_data [IN]    array of pointers to completion data
+ * \param count [IN]                    number of entries in array
+ *
+ * \return NA_SUCCESS or corresponding NA error code (failure is not an option)
+ */
+NA_EXPORT na_return_t
+na_cb_completion_add_batch(
+        na_context_t                 *context,
+        struct na_cb_completion_data *na_cb_completion_data[],
+        unsigned int                  count
+        );
+
 #ifdef __cplusplus
 }
 #endif
@@ -2945,11 +2945,14 @@ na_sm_addr_free(na_class_t *na_class, na_addr_t addr)
         }
     }
 
-    /* Close sock (delete also tmp dir if pathname is set) */
-    ret = na_sm_close_sock(na_sm_addr->sock, pathname);
-    if (ret != NA_SUCCESS) {
-        NA_LOG_ERROR("Could not close sock");
-        goto done;
+    /* Close sock (delete also tmp dir if pathname is set), self addr only
+     * has one when listening */
+    if (!na_sm_addr->self || na_sm_addr->na_sm_copy_buf) {
+        ret = na_sm_close_sock(na_sm_addr->sock, pathname);
+        if (ret != NA_SUCCESS) {
+            NA_LOG_ERROR("Could not close sock");
+            goto done;
+        }
     }
 
     /* Close ring buf (send) */
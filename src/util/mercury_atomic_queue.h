@@ -113,6 +113,20 @@ hg_atomic_queue_free(struct hg_atomic_queue *hg_atomic_queue);
 static HG_UTIL_INLINE int
 hg_atomic_queue_push(struct hg_atomic_queue *hg_atomic_queue, void *entry);
 
+/**
+ * Push count entries to the queue at once. Either all entries are pushed or
+ * none is, in which case the caller may fall back to hg_atomic_queue_push().
+ *
+ * \param hg_atomic_queue [IN/OUT]  pointer to queue
+ * \param entries [IN]              array of pointers to objects
+ * \param count [IN]                number of entries
+ *
+ * \return Non-negative on success or negative on failure
+ */
+static HG_UTIL_INLINE int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int count);
+
 /**
  * Pop an entry from the queue (multi-consumer).
  *
@@ -196,6 +210,56 @@ done:
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+static HG_UTIL_INLINE int
+hg_atomic_queue_push_n(struct hg_atomic_queue *hg_atomic_queue,
+    void *entries[], unsigned int count)
+{
+    hg_util_int32_t prod_head, prod_next, cons_tail;
+    unsigned int free_count, i;
+    int ret = HG_UTIL_SUCCESS;
+
+    do {
+        prod_head = hg_atomic_get32(&hg_atomic_queue->prod_head);
+        cons_tail = hg_atomic_get32(&hg_atomic_queue->cons_tail);
+        /* One slot is always left empty to distinguish full from empty */
+        free_count = (unsigned int) (cons_tail - prod_head - 1)
+            & hg_atomic_queue->prod_mask;
+
+        if (free_count < count) {
+            hg_atomic_fence();
+            if (prod_head == hg_atomic_get32(&hg_atomic_queue->prod_head) &&
+                cons_tail == hg_atomic_get32(&hg_atomic_queue->cons_tail)) {
+                /* Not enough room */
+                ret = HG_UTIL_FAIL;
+                goto done;
+            }
+            continue;
+        }
+        prod_next = (prod_head + (hg_util_int32_t) count)
+            & (int) hg_atomic_queue->prod_mask;
+    } while (!hg_atomic_cas32(&hg_atomic_queue->prod_head, prod_head,
+        prod_next));
+
+    for (i = 0; i < count; i++)
+        hg_atomic_set64((hg_atomic_int64_t *) &hg_atomic_queue->ring[
+            (prod_head + (hg_util_int32_t) i) & (int) hg_atomic_queue->prod_mask],
+            (hg_util_int64_t) entries[i]);
+
+    /*
+     * If there are other enqueues in progress
+     * that preceded us, we need to wait for them
+     * to complete
+     */
+    while (hg_atomic_get32(&hg_atomic_queue->prod_tail) != prod_head)
+        cpu_spinwait();
+
+    hg_atomic_set32(&hg_atomic_queue->prod_tail, prod_next);
+
+done:
+    return ret;
+}
+
 /*---------------------------------------------------------------------------*/
 static HG_UTIL_INLINE void *
 hg_atomic_queue_pop_mc(struct hg_atomic_queue *hg_atomic_queue)